@@ -44,6 +44,7 @@
 #include "playlists/PlayListFactory.h"
 #include "guilib/GUIFontManager.h"
 #include "guilib/GUIColorManager.h"
+#include "guilib/GUIXMLPreloader.h"
 #include "guilib/StereoscopicsManager.h"
 #include "guilib/GUITextLayout.h"
 #include "addons/Skin.h"
@@ -1947,6 +1948,9 @@ void CApplication::LoadSkin(const SkinPtr& skin)
   g_SkinInfo = skin;
   g_SkinInfo->Start();
 
+  CLog::Log(LOGINFO, "  preload skin files...");
+  PreloadSkinFiles(currentWindow, currentModelessWindows);
+
   CLog::Log(LOGINFO, "  load fonts for skin...");
   g_graphicsContext.SetMediaDir(skin->Path());
   g_directoryCache.ClearSubPaths(skin->Path());
@@ -1967,6 +1971,10 @@ void CApplication::LoadSkin(const SkinPtr& skin)
 
   g_fontManager.LoadFonts(CSettings::Get().GetString("lookandfeel.font"));
 
+  CLog::Log(LOGINFO, "  load texture atlas...");
+  CStdString atlasFile = StringUtils::Format("special://temp/atlas-%s-%s.bin", g_SkinInfo->ID().c_str(), g_SkinInfo->Version().c_str());
+  g_TextureManager.LoadAtlas(atlasFile);
+
   // load in the skin strings
   CStdString langPath = URIUtils::AddFileToFolder(skin->Path(), "language");
   URIUtils::AddSlashAtEnd(langPath);
@@ -2035,6 +2043,34 @@ void CApplication::LoadSkin(const SkinPtr& skin)
   }
 }
 
+void CApplication::PreloadSkinFiles(int currentWindow, const std::vector<int> &modelessWindows)
+{
+  // parse the includes and the windows shown once the skin is loaded in the
+  // background, any other window is loaded when it is opened
+  std::vector<int> windows(modelessWindows);
+  if (currentWindow != WINDOW_INVALID)
+    windows.push_back(currentWindow);
+  else
+  {
+    windows.push_back(g_SkinInfo->GetFirstWindow());
+    windows.push_back(g_SkinInfo->GetStartWindow());
+  }
+
+  std::vector<std::string> files;
+  files.push_back(g_SkinInfo->GetSkinPath("includes.xml"));
+  for (std::vector<int>::const_iterator i = windows.begin(); i != windows.end(); ++i)
+  {
+    CGUIWindow *window = g_windowManager.GetWindow(*i);
+    if (!window)
+      continue;
+    CStdString xmlFile = window->GetProperty("xmlfile").asString();
+    if (!xmlFile.empty() && g_SkinInfo->HasSkinFile(xmlFile))
+      files.push_back(g_SkinInfo->GetSkinPath(xmlFile));
+  }
+  CStdString cacheFile = StringUtils::Format("special://temp/skin-%s-%s.bin", g_SkinInfo->ID().c_str(), g_SkinInfo->Version().c_str());
+  CGUIXMLPreloader::Get().Preload(files, cacheFile, g_SkinInfo->Path());
+}
+
 void CApplication::UnloadSkin(bool forReload /* = false */)
 {
   m_skinReloading = forReload;
@@ -2058,6 +2094,8 @@ void CApplication::UnloadSkin(bool forReload /* = false */)
 
   g_infoManager.Clear();
 
+  CGUIXMLPreloader::Get().Clear();
+
 //  The g_SkinInfo boost shared_ptr ought to be reset here
 // but there are too many places it's used without checking for NULL
 // and as a result a race condition on exit can cause a crash.
@@ -2291,8 +2329,8 @@ void CApplication::Render()
 
   // reset our info cache - we do this at the end of Render so that it is
   // fresh for the next process(), or after a windowclose animation (where process()
-  // isn't called)
-  g_infoManager.ResetCache();
+  // isn't called). Only the bools of inputs we aren't told of changes to.
+  g_infoManager.ResetChangedCache(true);
   lock.Leave();
 
   unsigned int now = XbmcThreads::SystemClockMillis();
@@ -2972,6 +3010,8 @@ void CApplication::FrameMove(bool processEvents, bool processGUI)
   }
   if (processGUI && m_renderGUI)
   {
+    // input may have changed windows or the player since the last frame
+    g_infoManager.ResetChangedCache(false);
     if (!m_bStop)
       g_windowManager.Process(CTimeUtils::GetFrameTime());
     g_windowManager.FrameMove();
@@ -153,6 +153,7 @@ public:
   void RestartApp();
   void UnloadSkin(bool forReload = false);
   bool LoadUserWindows();
+  void PreloadSkinFiles(int currentWindow, const std::vector<int> &modelessWindows);
   void ReloadSkin(bool confirm = false);
   const CStdString& CurrentFile();
   CFileItem& CurrentFileItem();
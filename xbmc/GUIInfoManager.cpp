@@ -114,6 +114,7 @@ CGUIInfoManager::CGUIInfoManager(void) :
   m_playerSeeking = false;
   m_performingSeek = false;
   m_nextWindowID = WINDOW_INVALID;
+  m_timeState = -1;
   m_prevWindowID = WINDOW_INVALID;
   m_stringParameters.push_back("__ZZZZ__");   // to offset the string parameters by 1 to assure that all entries are non-zero
   m_currentFile = new CFileItem;
@@ -2180,6 +2181,110 @@ INFO::InfoPtr CGUIInfoManager::Register(const CStdString &expression, int contex
   return m_bools.back();
 }
 
+unsigned int CGUIInfoManager::GetDependencies(int condition) const
+{
+  condition = abs(condition);
+  if (condition >= MULTI_INFO_START && condition <= MULTI_INFO_END)
+  {
+    if (condition - MULTI_INFO_START >= (int)m_multiInfo.size())
+      return INFO::DEPENDS_FRAME;
+    const GUIInfo &info = m_multiInfo[condition - MULTI_INFO_START];
+    switch (abs(info.m_info))
+    {
+      case SKIN_BOOL:
+      case SKIN_STRING:
+      case SKIN_HAS_THEME:
+        return INFO::DEPENDS_SKIN;
+      case SYSTEM_HAS_CORE_ID:
+        return INFO::DEPENDS_NONE;
+      case WINDOW_NEXT:
+      case WINDOW_PREVIOUS:
+      case WINDOW_IS_VISIBLE:
+      case WINDOW_IS_TOPMOST:
+      case WINDOW_IS_ACTIVE:
+      case CONTROL_HAS_FOCUS:
+      case CONTROL_GROUP_HAS_FOCUS:
+        return INFO::DEPENDS_WINDOW;
+      case SYSTEM_TIME:
+      case SYSTEM_DATE:
+        return INFO::DEPENDS_TIME;
+      case STRING_IS_EMPTY:
+      case STRING_STR:
+      case STRING_STR_LEFT:
+      case STRING_STR_RIGHT:
+      case INTEGER_GREATER_THAN:
+        return GetLabelDependencies(info.GetData1());
+      case STRING_COMPARE:
+        if (info.GetData2() < 0) // info labels are stored with negative numbers
+          return GetLabelDependencies(info.GetData1()) | GetLabelDependencies(-info.GetData2());
+        return GetLabelDependencies(info.GetData1());
+      default:
+        return INFO::DEPENDS_FRAME;
+    }
+  }
+
+  switch (condition)
+  {
+    case SYSTEM_ALWAYS_TRUE:
+    case SYSTEM_ALWAYS_FALSE:
+    case SYSTEM_ETHERNET_LINK_ACTIVE:
+    case SYSTEM_PLATFORM_LINUX:
+    case SYSTEM_PLATFORM_WINDOWS:
+    case SYSTEM_PLATFORM_DARWIN:
+    case SYSTEM_PLATFORM_DARWIN_OSX:
+    case SYSTEM_PLATFORM_DARWIN_IOS:
+    case SYSTEM_PLATFORM_DARWIN_ATV2:
+    case SYSTEM_PLATFORM_ANDROID:
+    case SYSTEM_PLATFORM_LINUX_RASPBERRY_PI:
+      return INFO::DEPENDS_NONE;
+    case LIBRARY_HAS_MUSIC:
+    case LIBRARY_HAS_VIDEO:
+    case LIBRARY_HAS_MOVIES:
+    case LIBRARY_HAS_MOVIE_SETS:
+    case LIBRARY_HAS_TVSHOWS:
+    case LIBRARY_HAS_MUSICVIDEOS:
+      return INFO::DEPENDS_LIBRARY;
+    case PLAYER_HAS_MEDIA:
+    case PLAYER_HAS_AUDIO:
+    case PLAYER_HAS_VIDEO:
+    case PLAYER_PLAYING:
+    case PLAYER_PAUSED:
+    case PLAYER_REWINDING:
+    case PLAYER_FORWARDING:
+    case PLAYER_REWINDING_2x:
+    case PLAYER_REWINDING_4x:
+    case PLAYER_REWINDING_8x:
+    case PLAYER_REWINDING_16x:
+    case PLAYER_REWINDING_32x:
+    case PLAYER_FORWARDING_2x:
+    case PLAYER_FORWARDING_4x:
+    case PLAYER_FORWARDING_8x:
+    case PLAYER_FORWARDING_16x:
+    case PLAYER_FORWARDING_32x:
+    case PLAYER_MUTED:
+      return INFO::DEPENDS_PLAYER;
+    case WINDOW_IS_MEDIA:
+      return INFO::DEPENDS_WINDOW;
+    case SYSTEM_TIME:
+    case SYSTEM_DATE:
+      return INFO::DEPENDS_TIME;
+    default:
+      // anything else is read from the player, lists or the system
+      // without being told of changes, so is looked at every frame
+      return INFO::DEPENDS_FRAME;
+  }
+}
+
+unsigned int CGUIInfoManager::GetLabelDependencies(int info) const
+{
+  // only window properties are looked after, they change with the windows
+  if (info >= MULTI_INFO_START && info <= MULTI_INFO_END &&
+      info - MULTI_INFO_START < (int)m_multiInfo.size() &&
+      m_multiInfo[info - MULTI_INFO_START].m_info == WINDOW_PROPERTY)
+    return INFO::DEPENDS_WINDOW;
+  return INFO::DEPENDS_FRAME;
+}
+
 bool CGUIInfoManager::EvaluateBool(const CStdString &expression, int contextWindow)
 {
   bool result = false;
@@ -5196,14 +5301,60 @@ bool CGUIInfoManager::GetItemBool(const CGUIListItem *item, int condition) const
   return false;
 }
 
-void CGUIInfoManager::ResetCache()
+void CGUIInfoManager::ResetChangedCache(bool everyFrame)
+{
+  unsigned int changed = everyFrame ? INFO::DEPENDS_FRAME : INFO::DEPENDS_NONE;
+
+  std::vector<int> playerState;
+  if (g_application.m_pPlayer->IsPlaying())
+  {
+    playerState.push_back(g_application.m_pPlayer->IsPlayingAudio());
+    playerState.push_back(g_application.m_pPlayer->IsPlayingVideo());
+    playerState.push_back(g_application.m_pPlayer->IsPausedPlayback());
+    playerState.push_back(g_application.m_pPlayer->GetPlaySpeed());
+  }
+  playerState.push_back(g_application.IsMuted());
+  if (playerState != m_playerState)
+  {
+    m_playerState.swap(playerState);
+    changed |= INFO::DEPENDS_PLAYER;
+  }
+
+  std::vector<int> windowState;
+  windowState.push_back(m_nextWindowID);
+  windowState.push_back(m_prevWindowID);
+  windowState.push_back(CGUIWindow::GetPropertiesChanged());
+  g_windowManager.GetActiveState(windowState);
+  if (windowState != m_windowState)
+  {
+    m_windowState.swap(windowState);
+    changed |= INFO::DEPENDS_WINDOW;
+  }
+
+  CDateTime now = CDateTime::GetCurrentDateTime();
+  int timeState = now.GetDay() * 24 * 60 + now.GetMinuteOfDay();
+  if (timeState != m_timeState)
+  {
+    m_timeState = timeState;
+    changed |= INFO::DEPENDS_TIME;
+  }
+
+  if (changed)
+    ResetCache(changed);
+}
+
+void CGUIInfoManager::ResetCache(unsigned int dependencies)
 {
   // reset any animation triggers as well
-  m_containerMoves.clear();
-  // mark our infobools as dirty
+  if (dependencies & INFO::DEPENDS_FRAME)
+    m_containerMoves.clear();
+  // mark the infobools that may have changed as dirty
   CSingleLock lock(m_critInfo);
   for (vector<InfoPtr>::iterator i = m_bools.begin(); i != m_bools.end(); ++i)
-    (*i)->SetDirty();
+  {
+    if (dependencies == INFO::DEPENDS_ALL || ((*i)->GetDependencies() & dependencies))
+      (*i)->SetDirty();
+  }
 }
 
 // Called from tuxbox service thread to update current status
@@ -5403,6 +5554,7 @@ void CGUIInfoManager::SetLibraryBool(int condition, bool value)
     default:
       break;
   }
+  ResetCache(INFO::DEPENDS_LIBRARY);
 }
 
 void CGUIInfoManager::ResetLibraryBools()
@@ -5412,6 +5564,7 @@ void CGUIInfoManager::ResetLibraryBools()
   m_libraryHasTVShows = -1;
   m_libraryHasMusicVideos = -1;
   m_libraryHasMovieSets = -1;
+  ResetCache(INFO::DEPENDS_LIBRARY);
 }
 
 bool CGUIInfoManager::GetLibraryBool(int condition)
@@ -806,7 +806,17 @@ public:
   void SetNextWindow(int windowID) { m_nextWindowID = windowID; };
   void SetPreviousWindow(int windowID) { m_prevWindowID = windowID; };
 
-  void ResetCache();
+  /*! \brief Set dirty the info bools that depend on the given inputs
+   \param dependencies INFO::InfoDependency flags of the inputs that changed
+   */
+  void ResetCache(unsigned int dependencies = INFO::DEPENDS_ALL);
+
+  /*! \brief Set dirty the info bools of the player, windows and time if they changed
+   Nothing tells us of changes to these, they are compared with how they were at the last call.
+   Called by the GUI thread before processing and after rendering a frame.
+   \param everyFrame also set dirty the bools that are updated every frame
+   */
+  void ResetChangedCache(bool everyFrame);
   bool GetItemInt(int &value, const CGUIListItem *item, int info) const;
   CStdString GetItemLabel(const CFileItem *item, int info, CStdString *fallback = NULL);
   CStdString GetItemImage(const CFileItem *item, int info, CStdString *fallback = NULL);
@@ -832,6 +842,11 @@ public:
 
   int TranslateSingleString(const CStdString &strCondition);
 
+  /*! \brief INFO::InfoDependency flags of the inputs of a condition from TranslateSingleString
+   */
+  unsigned int GetDependencies(int condition) const;
+  unsigned int GetLabelDependencies(int info) const;
+
   int RegisterSkinVariableString(const INFO::CSkinVariableString* info);
   int TranslateSkinVariableString(const CStdString& name, int context);
   CStdString GetSkinVariableString(int info, bool preferImage = false, const CGUIListItem *item=NULL);
@@ -944,6 +959,11 @@ protected:
   int m_libraryHasMusicVideos;
   int m_libraryHasMovieSets;
 
+  // state of the inputs compared by ResetChangedCache
+  std::vector<int> m_playerState;
+  std::vector<int> m_windowState;
+  int m_timeState;
+
   SPlayerVideoStreamInfo m_videoInfo;
   SPlayerAudioStreamInfo m_audioInfo;
 
@@ -20,6 +20,7 @@
 
 #include "threads/SystemClock.h"
 #include "GUILargeTextureManager.h"
+#include "settings/AdvancedSettings.h"
 #include "settings/Settings.h"
 #include "guilib/Texture.h"
 #include "threads/SingleLock.h"
@@ -81,8 +82,9 @@ bool CImageLoader::DoWork()
 CGUILargeTextureManager::CLargeTexture::CLargeTexture(const CStdString &path)
 {
   m_path = path;
-  m_refCount = 1;
+  m_refCount = 0;
   m_timeToDelete = 0;
+  m_memoryUsage = 0;
 }
 
 CGUILargeTextureManager::CLargeTexture::~CLargeTexture()
@@ -96,36 +98,31 @@ void CGUILargeTextureManager::CLargeTexture::AddRef()
   m_refCount++;
 }
 
-bool CGUILargeTextureManager::CLargeTexture::DecrRef(bool deleteImmediately)
+bool CGUILargeTextureManager::CLargeTexture::DecrRef()
 {
   assert(m_refCount);
   m_refCount--;
   if (m_refCount == 0)
   {
-    if (deleteImmediately)
-      delete this;
-    else
-      m_timeToDelete = CTimeUtils::GetFrameTime() + TIME_TO_DELETE;
+    m_timeToDelete = CTimeUtils::GetFrameTime() + TIME_TO_DELETE;
     return true;
   }
   return false;
 }
 
-bool CGUILargeTextureManager::CLargeTexture::DeleteIfRequired(bool deleteImmediately)
+bool CGUILargeTextureManager::CLargeTexture::IsExpired() const
 {
-  if (m_refCount == 0 && (deleteImmediately || m_timeToDelete < CTimeUtils::GetFrameTime()))
-  {
-    delete this;
-    return true;
-  }
-  return false;
+  return m_refCount == 0 && m_timeToDelete < CTimeUtils::GetFrameTime();
 }
 
 void CGUILargeTextureManager::CLargeTexture::SetTexture(CBaseTexture* texture)
 {
   assert(!m_texture.size());
   if (texture)
+  {
     m_texture.Set(texture, texture->GetWidth(), texture->GetHeight());
+    m_memoryUsage = (size_t)texture->GetPitch() * texture->GetRows();
+  }
 }
 
 CGUILargeTextureManager::CGUILargeTextureManager()
@@ -136,18 +133,35 @@ CGUILargeTextureManager::~CGUILargeTextureManager()
 {
 }
 
+CGUILargeTextureManager::CShard &CGUILargeTextureManager::GetShard(const CStdString &path)
+{
+  unsigned int hash = 0;
+  for (const char *c = path.c_str(); *c; c++)
+    hash = hash * 31 + (unsigned char)*c;
+  return m_shards[hash % NUM_SHARDS];
+}
+
+size_t CGUILargeTextureManager::GetShardBudget()
+{
+  return (size_t)g_advancedSettings.m_largeTextureCacheSize * 1024 * 1024 / NUM_SHARDS;
+}
+
 void CGUILargeTextureManager::CleanupUnusedImages(bool immediately)
 {
-  CSingleLock lock(m_listSection);
-  // check for items to remove from allocated list, and remove
-  listIterator it = m_allocated.begin();
-  while (it != m_allocated.end())
+  bool budgeted = GetShardBudget() > 0;
+  for (unsigned int i = 0; i < NUM_SHARDS; i++)
   {
-    CLargeTexture *image = *it;
-    if (image->DeleteIfRequired(immediately))
-      it = m_allocated.erase(it);
-    else
-      ++it;
+    CShard &shard = m_shards[i];
+    CSingleLock lock(shard.m_section);
+    // unused textures are in the order they were released, so the expired ones are at the back
+    while (!shard.m_unused.empty() && (immediately || (!budgeted && shard.m_unused.back()->IsExpired())))
+      Unload(shard, shard.m_allocated.find(shard.m_unused.back()->GetPath()));
+    // loaders only flag a shard that went over its budget, textures are freed on this thread
+    if (shard.m_overBudget)
+    {
+      shard.m_overBudget = false;
+      Trim(shard);
+    }
   }
 }
 
@@ -155,90 +169,168 @@ void CGUILargeTextureManager::CleanupUnusedImages(bool immediately)
 // else, add to the queue list if appropriate.
 bool CGUILargeTextureManager::GetImage(const CStdString &path, CTextureArray &texture, bool firstRequest, const bool useCache)
 {
-  CSingleLock lock(m_listSection);
-  for (listIterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
+  CShard &shard = GetShard(path);
+  CSingleLock lock(shard.m_section);
+  TextureMap::iterator it = shard.m_allocated.find(path);
+  if (it != shard.m_allocated.end())
   {
-    CLargeTexture *image = *it;
-    if (image->GetPath() == path)
-    {
-      if (firstRequest)
-        image->AddRef();
-      texture = image->GetTexture();
-      return texture.size() > 0;
-    }
+    CLargeTexture *image = it->second;
+    if (firstRequest)
+      SetUsed(shard, image);
+    texture = image->GetTexture();
+    return texture.size() > 0;
   }
 
   if (firstRequest)
-    QueueImage(path, useCache);
+  {
+    QueueMap::iterator queued = shard.m_queued.find(path);
+    if (queued != shard.m_queued.end())
+      queued->second.second->AddRef(); // already queued
+    else
+      QueueImage(shard, path, useCache, CJob::PRIORITY_NORMAL)->AddRef();
+  }
 
   return true;
 }
 
 void CGUILargeTextureManager::ReleaseImage(const CStdString &path, bool immediately)
 {
-  CSingleLock lock(m_listSection);
-  for (listIterator it = m_allocated.begin(); it != m_allocated.end(); ++it)
+  CShard &shard = GetShard(path);
+  CSingleLock lock(shard.m_section);
+  TextureMap::iterator it = shard.m_allocated.find(path);
+  if (it != shard.m_allocated.end())
   {
-    CLargeTexture *image = *it;
-    if (image->GetPath() == path)
+    CLargeTexture *image = it->second;
+    if (image->DecrRef())
     {
-      if (image->DecrRef(immediately) && immediately)
-        m_allocated.erase(it);
-      return;
+      if (immediately)
+        Unload(shard, it);
+      else
+        SetUnused(shard, image);
     }
+    return;
   }
-  for (queueIterator it = m_queued.begin(); it != m_queued.end(); ++it)
+  QueueMap::iterator queued = shard.m_queued.find(path);
+  if (queued != shard.m_queued.end())
   {
-    unsigned int id = it->first;
-    CLargeTexture *image = it->second;
-    if (image->GetPath() == path && image->DecrRef(true))
+    unsigned int id = queued->second.first;
+    CLargeTexture *image = queued->second.second;
+    if (image->DecrRef())
     {
       // cancel this job
       CJobManager::GetInstance().CancelJob(id);
-      m_queued.erase(it);
-      return;
+      shard.m_queued.erase(queued);
+      delete image;
     }
   }
 }
 
-// queue the image, and start the background loader if necessary
-void CGUILargeTextureManager::QueueImage(const CStdString &path, bool useCache)
+void CGUILargeTextureManager::PrefetchImage(const CStdString &path, CJob::PRIORITY priority, bool useCache)
 {
-  CSingleLock lock(m_listSection);
-  for (queueIterator it = m_queued.begin(); it != m_queued.end(); ++it)
-  {
+  if (!GetShardBudget() || path.empty())
+    return;
+
+  CShard &shard = GetShard(path);
+  CSingleLock lock(shard.m_section);
+  TextureMap::iterator it = shard.m_allocated.find(path);
+  if (it != shard.m_allocated.end())
+  { // already loaded, keep it around a bit longer if unused
     CLargeTexture *image = it->second;
-    if (image->GetPath() == path)
+    if (image->IsUnused())
     {
-      image->AddRef();
-      return; // already queued
+      shard.m_unused.erase(image->m_unusedPos);
+      shard.m_unused.push_front(image);
+      image->m_unusedPos = shard.m_unused.begin();
     }
+    return;
   }
+  if (shard.m_queued.find(path) != shard.m_queued.end())
+    return;
+
+  QueueImage(shard, path, useCache, priority);
+}
 
-  // queue the item
+void CGUILargeTextureManager::CancelPrefetch(const CStdString &path)
+{
+  CShard &shard = GetShard(path);
+  CSingleLock lock(shard.m_section);
+  QueueMap::iterator queued = shard.m_queued.find(path);
+  if (queued != shard.m_queued.end() && queued->second.second->IsUnused())
+  { // nobody asked for it since
+    CJobManager::GetInstance().CancelJob(queued->second.first);
+    delete queued->second.second;
+    shard.m_queued.erase(queued);
+  }
+}
+
+// queue the image, and start the background loader
+CGUILargeTextureManager::CLargeTexture *CGUILargeTextureManager::QueueImage(CShard &shard, const CStdString &path, bool useCache, CJob::PRIORITY priority)
+{
   CLargeTexture *image = new CLargeTexture(path);
-  unsigned int jobID = CJobManager::GetInstance().AddJob(new CImageLoader(path, useCache), this, CJob::PRIORITY_NORMAL);
-  m_queued.push_back(make_pair(jobID, image));
+  unsigned int jobID = CJobManager::GetInstance().AddJob(new CImageLoader(path, useCache), this, priority);
+  shard.m_queued.insert(make_pair(path, make_pair(jobID, image)));
+  return image;
 }
 
 void CGUILargeTextureManager::OnJobComplete(unsigned int jobID, bool success, CJob *job)
 {
   // see if we still have this job id
-  CSingleLock lock(m_listSection);
-  for (queueIterator it = m_queued.begin(); it != m_queued.end(); ++it)
-  {
-    if (it->first == jobID)
-    { // found our job
-      CImageLoader *loader = (CImageLoader *)job;
-      CLargeTexture *image = it->second;
-      image->SetTexture(loader->m_texture);
-      loader->m_texture = NULL; // we want to keep the texture, and jobs are auto-deleted.
-      m_queued.erase(it);
-      m_allocated.push_back(image);
-      return;
+  CImageLoader *loader = (CImageLoader *)job;
+  CShard &shard = GetShard(loader->m_path);
+  CSingleLock lock(shard.m_section);
+  QueueMap::iterator it = shard.m_queued.find(loader->m_path);
+  if (it != shard.m_queued.end() && it->second.first == jobID)
+  { // found our job
+    CLargeTexture *image = it->second.second;
+    image->SetTexture(loader->m_texture);
+    loader->m_texture = NULL; // we want to keep the texture, and jobs are auto-deleted.
+    shard.m_queued.erase(it);
+    shard.m_allocated.insert(make_pair(image->GetPath(), image));
+    shard.m_memoryUsage += image->GetMemoryUsage();
+    if (image->IsUnused())
+    { // prefetched and not asked for yet, the first to go under pressure
+      shard.m_unused.push_back(image);
+      image->m_unusedPos = --shard.m_unused.end();
     }
+    // freeing textures takes the graphics context, which must not be
+    // waited for under the shard lock here, so leave that to the GUI thread
+    size_t budget = GetShardBudget();
+    if (budget && shard.m_memoryUsage > budget)
+      shard.m_overBudget = true;
   }
 }
 
+void CGUILargeTextureManager::SetUnused(CShard &shard, CLargeTexture *image)
+{
+  shard.m_unused.push_front(image);
+  image->m_unusedPos = shard.m_unused.begin();
+  Trim(shard);
+}
 
+void CGUILargeTextureManager::SetUsed(CShard &shard, CLargeTexture *image)
+{
+  if (image->IsUnused())
+    shard.m_unused.erase(image->m_unusedPos);
+  image->AddRef();
+}
 
+void CGUILargeTextureManager::Unload(CShard &shard, TextureMap::iterator it)
+{
+  CLargeTexture *image = it->second;
+  if (image->IsUnused())
+    shard.m_unused.erase(image->m_unusedPos);
+  shard.m_memoryUsage -= image->GetMemoryUsage();
+  shard.m_allocated.erase(it);
+  delete image;
+}
+
+void CGUILargeTextureManager::Trim(CShard &shard)
+{
+  size_t budget = GetShardBudget();
+  if (!budget)
+    return;
+
+  // only unused textures can go, those in use may keep the shard above its budget
+  while (shard.m_memoryUsage > budget && !shard.m_unused.empty())
+    Unload(shard, shard.m_allocated.find(shard.m_unused.back()->GetPath()));
+}
@@ -20,6 +20,9 @@
  *
  */
 
+#include <list>
+#include <map>
+
 #include "threads/CriticalSection.h"
 #include "utils/Job.h"
 #include "guilib/TextureManager.h"
@@ -55,6 +58,14 @@ public:
  Used to load textures for the user interface asynchronously, allowing fluid framerates
  while background loading textures.
 
+ Textures that are no longer used are kept for a while in case they are asked for again.
+ With a budget set (CAdvancedSettings::m_largeTextureCacheSize) they are kept for as long as
+ the decoded size of all loaded textures fits into it, the least recently used ones going
+ first. Without a budget they are unloaded after a short delay.
+
+ Textures are spread over a few shards by path, each with its own lock and its own share of
+ the budget, so that loaders finishing on other threads don't hold up the GUI thread.
+
  \sa IJobCallback, CGUITexture
  */
 class CGUILargeTextureManager : public IJobCallback
@@ -101,12 +112,35 @@ public:
    */
   void ReleaseImage(const CStdString &path, bool immediately = false);
 
+  /*!
+   \brief Load a texture in the background ahead of it being requested.
+
+   The texture is kept as an unused one, so a later GetImage() finds it loaded unless it had to
+   make room for others first. Does nothing without a budget, as it would be unloaded again
+   before it is likely to be asked for.
+
+   \param path path of the image to load.
+   \param priority priority of the load, images that are about to be shown should go ahead of other background work.
+   */
+  void PrefetchImage(const CStdString &path, CJob::PRIORITY priority = CJob::PRIORITY_LOW, bool useCache = true);
+
+  /*!
+   \brief Cancel loading a prefetched texture that is no longer expected to be shown.
+
+   Does nothing if the texture has been requested since, or is loaded already.
+
+   \param path path of the image.
+   */
+  void CancelPrefetch(const CStdString &path);
+
   /*!
    \brief Cleanup images that are no longer in use.
 
    Loaded textures are reference counted, and upon reaching reference count 0 through ReleaseImage()
    they are flagged as unused with the current time.  After a delay they may be unloaded, hence
-   CleanupUnusedImages() should be called periodically to ensure this occurs.
+   CleanupUnusedImages() should be called periodically to ensure this occurs. It also brings
+   shards that background loads took over the budget back within it. Call it from the GUI thread,
+   as textures are freed.
 
    \param immediately set to true to cleanup images regardless of whether the delay has passed
    */
@@ -120,12 +154,16 @@ private:
     virtual ~CLargeTexture();
 
     void AddRef();
-    bool DecrRef(bool deleteImmediately);
-    bool DeleteIfRequired(bool deleteImmediately = false);
+    bool DecrRef();
+    bool IsUnused() const { return m_refCount == 0; };
+    bool IsExpired() const;
     void SetTexture(CBaseTexture* texture);
 
     const CStdString &GetPath() const { return m_path; };
     const CTextureArray &GetTexture() const { return m_texture; };
+    size_t GetMemoryUsage() const { return m_memoryUsage; };
+
+    std::list<CLargeTexture *>::iterator m_unusedPos; ///< position in the unused list of the shard, if unused
 
   private:
     static const unsigned int TIME_TO_DELETE = 2000;
@@ -134,16 +172,37 @@ private:
     CStdString m_path;
     CTextureArray m_texture;
     unsigned int m_timeToDelete;
+    size_t m_memoryUsage;
+  };
+
+  typedef std::map<CStdString, CLargeTexture *> TextureMap;
+  typedef std::map<CStdString, std::pair<unsigned int, CLargeTexture *> > QueueMap;
+
+  class CShard
+  {
+  public:
+    CShard() : m_memoryUsage(0), m_overBudget(false) {};
+
+    TextureMap m_allocated;
+    QueueMap m_queued;
+    std::list<CLargeTexture *> m_unused; ///< unused textures, most recently released first
+    size_t m_memoryUsage;                ///< decoded size of the allocated textures
+    bool m_overBudget;                   ///< a loader went over the budget, trimmed by CleanupUnusedImages()
+    CCriticalSection m_section;
   };
 
-  void QueueImage(const CStdString &path, bool useCache = true);
+  static const unsigned int NUM_SHARDS = 8;
+
+  CShard &GetShard(const CStdString &path);
+  static size_t GetShardBudget();
 
-  std::vector< std::pair<unsigned int, CLargeTexture *> > m_queued;
-  std::vector<CLargeTexture *> m_allocated;
-  typedef std::vector<CLargeTexture *>::iterator listIterator;
-  typedef std::vector< std::pair<unsigned int, CLargeTexture *> >::iterator queueIterator;
+  CLargeTexture *QueueImage(CShard &shard, const CStdString &path, bool useCache, CJob::PRIORITY priority);
+  void SetUnused(CShard &shard, CLargeTexture *image);
+  void SetUsed(CShard &shard, CLargeTexture *image);
+  void Unload(CShard &shard, TextureMap::iterator it);
+  void Trim(CShard &shard);
 
-  CCriticalSection m_listSection;
+  CShard m_shards[NUM_SHARDS];
 };
 
 extern CGUILargeTextureManager g_largeTextureManager;
@@ -102,7 +102,14 @@ bool CTextureCacheJob::CacheTexture(CBaseTexture **out_texture)
     return true;
   }
 #endif
-  CBaseTexture *texture = LoadImage(image, width, height, additional_info, true);
+  // decode no larger than what is cached, jpegs are then scaled down while decoding
+  unsigned int decodeWidth = width, decodeHeight = height;
+  if (!decodeWidth && !decodeHeight)
+  {
+    decodeHeight = std::max(g_advancedSettings.m_imageRes, g_advancedSettings.m_fanartRes);
+    decodeWidth  = decodeHeight * 16/9;
+  }
+  CBaseTexture *texture = LoadImage(image, decodeWidth, decodeHeight, additional_info, true);
   if (texture)
   {
     if (texture->HasAlpha())
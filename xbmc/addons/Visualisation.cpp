@@ -19,7 +19,6 @@
  */
 #include "system.h"
 #include "Visualisation.h"
-#include "utils/fft.h"
 #include "GUIInfoManager.h"
 #include "Application.h"
 #include "music/tags/MusicInfoTag.h"
@@ -175,6 +174,7 @@ void CVisualisation::Stop()
 {
   g_application.m_pPlayer->UnRegisterAudioCallback();
   CAEFactory::UnregisterAudioCallback();
+  m_analyser.Stop();
   if (Initialized())
   {
     CAddonDll<DllVisualisation, Visualisation, VIS_PROPS>::Stop();
@@ -275,29 +275,15 @@ void CVisualisation::OnAudioData(const float* pAudioData, int iAudioDataLength)
 
   auto_ptr<CAudioBuffer> ptrAudioBuffer ( m_vecBuffers.front() );
   m_vecBuffers.pop_front();
-  // Fourier transform the data if the vis wants it...
-  if (m_bWantsFreq)
+  // Fourier transform the data off this thread, then transfer every block
+  // that has been analysed so far to our visualisation
+  m_analyser.Submit(ptrAudioBuffer->Get(), AUDIO_BUFFER_SIZE);
+  while (m_analyser.GetAnalysis(m_analysis))
   {
-    const float *psAudioData = ptrAudioBuffer->Get();
-    memcpy(m_fFreq, psAudioData, AUDIO_BUFFER_SIZE * sizeof(float));
-
-    // FFT the data
-    twochanwithwindow(m_fFreq, AUDIO_BUFFER_SIZE);
-
-    // Normalize the data
-    float fMinData = (float)AUDIO_BUFFER_SIZE * AUDIO_BUFFER_SIZE * 3 / 8 * 0.5 * 0.5; // 3/8 for the Hann window, 0.5 as minimum amplitude
-    float fInvMinData = 1.0f/fMinData;
-    for (int i = 0; i < AUDIO_BUFFER_SIZE + 2; i++)
-    {
-      m_fFreq[i] *= fInvMinData;
-    }
-
-    // Transfer data to our visualisation
-    AudioData(psAudioData, AUDIO_BUFFER_SIZE, m_fFreq, AUDIO_BUFFER_SIZE);
-  }
-  else
-  { // Transfer data to our visualisation
-    AudioData(ptrAudioBuffer->Get(), AUDIO_BUFFER_SIZE, NULL, 0);
+    if (m_bWantsFreq)
+      AudioData(&m_analysis.samples[0], AUDIO_BUFFER_SIZE, &m_analysis.spectrum[0], AUDIO_BUFFER_SIZE);
+    else
+      AudioData(&m_analysis.samples[0], AUDIO_BUFFER_SIZE, NULL, 0);
   }
   return ;
 }
@@ -315,10 +301,18 @@ void CVisualisation::CreateBuffers()
     m_iNumBuffers = MAX_AUDIO_BUFFERS;
   if (m_iNumBuffers < 1)
     m_iNumBuffers = 1;
+
+  // Fourier transform the data if the vis wants it...
+  // the buffer holds AUDIO_BUFFER_SIZE/2 stereo frames, zero padded to AUDIO_BUFFER_SIZE points
+  int iFrames = AUDIO_BUFFER_SIZE / 2;
+  float fMinData = (float)iFrames * iFrames * 3 / 8 * 0.5 * 0.5; // 3/8 for the Hann window, 0.5 as minimum amplitude
+  m_analyser.Start(AUDIO_BUFFER_SIZE, m_bWantsFreq ? AUDIO_BUFFER_SIZE : 0, 0, 1.0f/fMinData);
 }
 
 void CVisualisation::ClearBuffers()
 {
+  m_analyser.Stop();
+  m_analysis = AudioAnalysis();
   m_bWantsFreq = false;
   m_iNumBuffers = 0;
 
@@ -328,10 +322,6 @@ void CVisualisation::ClearBuffers()
     delete pAudioBuffer;
     m_vecBuffers.pop_front();
   }
-  for (int j = 0; j < AUDIO_BUFFER_SIZE*2; j++)
-  {
-    m_fFreq[j] = 0.0f;
-  }
 }
 
 bool CVisualisation::UpdateTrack()
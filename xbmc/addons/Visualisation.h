@@ -23,6 +23,7 @@
 #include "cores/IAudioCallback.h"
 #include "include/xbmc_vis_types.h"
 #include "guilib/IRenderingCallback.h"
+#include "utils/AudioAnalyser.h"
 
 #include <map>
 #include <list>
@@ -102,8 +103,8 @@ namespace ADDON
     std::list<CAudioBuffer*> m_vecBuffers;
     int m_iNumBuffers;        // Number of Audio buffers
     bool m_bWantsFreq;
-    float m_fFreq[2*AUDIO_BUFFER_SIZE];         // Frequency data
-    bool m_bCalculate_Freq;       // True if the vis wants freq data
+    CAudioAnalyser m_analyser;    // FFTs the delayed audio off the audio thread
+    AudioAnalysis m_analysis;     // analysis being passed to the vis
 
     // track information
     CStdString m_AlbumThumb;
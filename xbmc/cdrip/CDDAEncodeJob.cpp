@@ -0,0 +1,131 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "CDDAEncodeJob.h"
+#include "CDDARipBuffer.h"
+#include "Encoder.h"
+#include "dialogs/GUIDialogExtendedProgressBar.h"
+#include "filesystem/File.h"
+#include "utils/log.h"
+
+#include <vector>
+
+using namespace XFILE;
+
+CCDDAEncodeJob::CCDDAEncodeJob(CEncoder* encoder,
+                               const boost::shared_ptr<CCDDARipBuffer>& buffer,
+                               const CStdString& output,
+                               const CStdString& destination,
+                               int64_t length,
+                               CGUIDialogProgressBarHandle* handle) :
+  m_encoder(encoder), m_buffer(buffer), m_output(output),
+  m_destination(destination), m_length(length), m_handle(handle)
+{
+}
+
+CCDDAEncodeJob::~CCDDAEncodeJob()
+{
+  // never processed, e.g. cancelled while queued
+  if (m_encoder)
+    Finish(false);
+}
+
+bool CCDDAEncodeJob::DoWork()
+{
+  std::vector<uint8_t> chunk;
+  int64_t encoded = 0;
+  int oldpercent = 0;
+  bool success = true;
+
+  while (m_buffer->Read(chunk))
+  {
+    if (!m_encoder->Encode(chunk.size(), &chunk[0]))
+    {
+      CLog::Log(LOGERROR, "CDDARipper: Error encoding %s", m_destination.c_str());
+      success = false;
+      break;
+    }
+
+    encoded += chunk.size();
+    int percent = m_length > 0 ? (int)(encoded * 100 / m_length) : 0;
+    if (ShouldCancel(percent, 100))
+    {
+      CLog::Log(LOGWARNING, "User Cancelled CDDA Rip");
+      success = false;
+      break;
+    }
+    if (percent > oldpercent)
+    {
+      oldpercent = percent;
+      m_handle->SetPercentage(percent);
+    }
+  }
+
+  // reading failed or was cancelled
+  if (m_buffer->IsAborted())
+    success = false;
+
+  Finish(success);
+
+  if (success && m_output != m_destination)
+  {
+    // copy the ripped track to the share
+    if (!CFile::Cache(m_output, m_destination))
+    {
+      CLog::Log(LOGERROR, "CDDARipper: Error copying file from %s to %s",
+                m_output.c_str(), m_destination.c_str());
+      success = false;
+    }
+    // delete cached file
+    CFile::Delete(m_output);
+  }
+
+  if (success)
+    CLog::Log(LOGINFO, "Finished ripping %s", m_destination.c_str());
+
+  return success;
+}
+
+void CCDDAEncodeJob::Finish(bool success)
+{
+  // stop the reader if it is still working on this track
+  if (!success)
+    m_buffer->Abort();
+
+  m_encoder->Close();
+  delete m_encoder;
+  m_encoder = NULL;
+
+  if (!success)
+    CFile::Delete(m_output);
+
+  m_handle->MarkFinished();
+}
+
+bool CCDDAEncodeJob::operator==(const CJob* job) const
+{
+  if (strcmp(job->GetType(),GetType()) == 0)
+  {
+    const CCDDAEncodeJob* ejob = dynamic_cast<const CCDDAEncodeJob*>(job);
+    if (ejob)
+      return m_output == ejob->m_output;
+  }
+  return false;
+}
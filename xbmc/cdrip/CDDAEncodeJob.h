@@ -0,0 +1,68 @@
+#pragma once
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <boost/shared_ptr.hpp>
+
+#include "utils/Job.h"
+#include "utils/StdString.h"
+
+class CCDDARipBuffer;
+class CEncoder;
+class CGUIDialogProgressBarHandle;
+
+/*! \brief Encode a track while (or after) it is read from the CD
+
+ Consumes the PCM that a CCDDARipJob writes to the buffer of the track, so
+ the drive can move on to the next track while this one is still encoding.
+ If the job fails, is cancelled or destroyed unprocessed, the buffer is
+ aborted to stop the reader and the partial output is deleted.
+ */
+class CCDDAEncodeJob : public CJob
+{
+public:
+  //! \brief Construct an encoder job
+  //! \param encoder The initialized encoder, owned by the job from now on
+  //! \param buffer The buffer the track is read into
+  //! \param output The file the encoder writes to
+  //! \param destination Where the track should end up, may differ from output for remote paths
+  //! \param length The size of the track's PCM data in bytes
+  //! \param handle Progress bar of the track, marked finished by the job
+  CCDDAEncodeJob(CEncoder* encoder, const boost::shared_ptr<CCDDARipBuffer>& buffer,
+                 const CStdString& output, const CStdString& destination,
+                 int64_t length, CGUIDialogProgressBarHandle* handle);
+  virtual ~CCDDAEncodeJob();
+
+  virtual const char* GetType() const { return "cdencode"; };
+  virtual bool operator==(const CJob *job) const;
+  virtual bool DoWork();
+  CStdString GetOutput() const { return m_destination; }
+
+private:
+  //! \brief Close the encoder and remove the output unless the track is complete
+  void Finish(bool success);
+
+  CEncoder* m_encoder; //< The audio encoder, NULL once closed
+  boost::shared_ptr<CCDDARipBuffer> m_buffer; //< PCM of the track
+  CStdString m_output; //< The file written by the encoder
+  CStdString m_destination; //< The final location of the track
+  int64_t m_length; //< Size of the track in bytes, for progress
+  CGUIDialogProgressBarHandle* m_handle; //< Progress bar of the track
+};
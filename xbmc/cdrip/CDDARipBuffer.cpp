@@ -0,0 +1,98 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "CDDARipBuffer.h"
+#include "threads/SingleLock.h"
+
+CCriticalSection CCDDARipBuffer::m_section;
+XbmcThreads::ConditionVariable CCDDARipBuffer::m_changed;
+unsigned int CCDDARipBuffer::m_buffered = 0;
+
+CCDDARipBuffer::CCDDARipBuffer()
+  : m_eof(false), m_aborted(false)
+{
+}
+
+CCDDARipBuffer::~CCDDARipBuffer()
+{
+  Abort();
+}
+
+bool CCDDARipBuffer::Write(const uint8_t* data, unsigned int size)
+{
+  CSingleLock lock(m_section);
+  // an empty budget always takes the chunk, so a single track can never stall
+  while (!m_aborted && m_buffered && m_buffered + size > CDDARIP_BUFFER_BUDGET)
+    m_changed.wait(lock);
+
+  if (m_aborted)
+    return false;
+
+  m_chunks.push_back(std::vector<uint8_t>(data, data + size));
+  m_buffered += size;
+  m_changed.notifyAll();
+  return true;
+}
+
+void CCDDARipBuffer::SetEOF()
+{
+  CSingleLock lock(m_section);
+  m_eof = true;
+  m_changed.notifyAll();
+}
+
+bool CCDDARipBuffer::Read(std::vector<uint8_t>& chunk)
+{
+  CSingleLock lock(m_section);
+  while (!m_aborted && !m_eof && m_chunks.empty())
+    m_changed.wait(lock);
+
+  if (m_aborted || m_chunks.empty())
+    return false;
+
+  chunk.swap(m_chunks.front());
+  m_chunks.pop_front();
+  m_buffered -= chunk.size();
+  m_changed.notifyAll();
+  return true;
+}
+
+void CCDDARipBuffer::Abort()
+{
+  CSingleLock lock(m_section);
+  m_aborted = true;
+  Clear();
+  m_changed.notifyAll();
+}
+
+bool CCDDARipBuffer::IsAborted() const
+{
+  CSingleLock lock(m_section);
+  return m_aborted;
+}
+
+void CCDDARipBuffer::Clear()
+{
+  while (!m_chunks.empty())
+  {
+    m_buffered -= m_chunks.front().size();
+    m_chunks.pop_front();
+  }
+}
@@ -0,0 +1,75 @@
+#pragma once
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <deque>
+#include <vector>
+#include <stdint.h>
+
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+
+//! PCM held by all rip buffers together, about six minutes of CD audio
+#define CDDARIP_BUFFER_BUDGET (64 * 1024 * 1024)
+
+/*! \brief Bounded PCM buffer between the CD reader and the encoder of a track
+
+ The reader appends chunks while the encoder of the track consumes them on
+ another thread. All buffers draw from one shared byte budget, so the drive
+ can run ahead of several slow encoders without the buffered audio growing
+ beyond CDDARIP_BUFFER_BUDGET.
+ */
+class CCDDARipBuffer
+{
+public:
+  CCDDARipBuffer();
+  ~CCDDARipBuffer();
+
+  //! \brief Append a chunk, waits while the shared budget is exhausted
+  //! \return false if the buffer has been aborted
+  bool Write(const uint8_t* data, unsigned int size);
+
+  //! \brief Signal the encoder that the whole track has been written
+  void SetEOF();
+
+  //! \brief Take the next chunk, waits until one is available
+  //! \param chunk receives the data
+  //! \return false at the end of the track or if the buffer has been aborted
+  bool Read(std::vector<uint8_t>& chunk);
+
+  //! \brief Drop all buffered data and wake up both sides
+  void Abort();
+  bool IsAborted() const;
+
+private:
+  CCDDARipBuffer(const CCDDARipBuffer&);
+  CCDDARipBuffer& operator=(const CCDDARipBuffer&);
+
+  void Clear();
+
+  std::deque<std::vector<uint8_t> > m_chunks;
+  bool m_eof;
+  bool m_aborted;
+
+  // the budget is shared, so is the lock guarding it
+  static CCriticalSection m_section;
+  static XbmcThreads::ConditionVariable m_changed;
+  static unsigned int m_buffered;
+};
@@ -19,6 +19,9 @@
  */
 
 #include "CDDARipJob.h"
+#include "CDDAEncodeJob.h"
+#include "CDDARipBuffer.h"
+#include "CDDARipper.h"
 #include "system.h"
 #ifdef HAVE_LIBMP3LAME
 #include "EncoderLame.h"
@@ -44,6 +47,9 @@
 using namespace MUSIC_INFO;
 using namespace XFILE;
 
+// bytes read from the drive at once, a whole number of raw CD sectors
+#define CDDARIP_CHUNK_SIZE (28 * 2352)
+
 CCDDARipJob::CCDDARipJob(const CStdString& input,
                          const CStdString& output,
                          const CMusicInfoTag& tag, 
@@ -67,6 +73,7 @@ bool CCDDARipJob::DoWork()
                                                      m_output.c_str());
 
   // if we are ripping to a samba share, rip it to hd first and then copy it it the share
+  CStdString destination = m_output;
   CFileItem file(m_output, false);
   if (file.IsRemote())
     m_output = SetupTempFile();
@@ -97,79 +104,71 @@ bool CCDDARipJob::DoWork()
                                             m_tag.GetTitle().c_str());
   handle->SetText(strLine0);
 
+  // reading has a bar of its own, as the encoder may lag behind it
+  CGUIDialogProgressBarHandle* readHandle = pDlgProgress->GetHandle(g_localizeStrings.Get(163));
+  readHandle->SetText(strLine0);
+
+  // the encoder works through the buffer on its own core while we read
+  boost::shared_ptr<CCDDARipBuffer> buffer(new CCDDARipBuffer);
+  CCDDARipper::GetInstance().AddEncodeJob(new CCDDAEncodeJob(encoder, buffer, m_output, destination,
+                                                             reader.GetLength(), handle));
+
   // start ripping
   int percent=0;
   int oldpercent=0;
   bool cancelled(false);
   int result;
-  while (!cancelled && (result=RipChunk(reader, encoder, percent)) == 0)
+  while (!cancelled && (result=ReadChunk(reader, *buffer, percent)) == 0)
   {
     cancelled = ShouldCancel(percent,100);
     if (percent > oldpercent)
     {
       oldpercent = percent;
-      handle->SetPercentage(percent);
+      readHandle->SetPercentage(percent);
     }
   }
 
-  // close encoder ripper
-  encoder->Close();
-  delete encoder;
   reader.Close();
+  readHandle->MarkFinished();
 
-  if (file.IsRemote() && !cancelled && result == 2)
+  if (cancelled || result != 2)
   {
-    // copy the ripped track to the share
-    if (!CFile::Cache(m_output, file.GetPath()))
-    {
-      CLog::Log(LOGERROR, "CDDARipper: Error copying file from %s to %s", 
-                m_output.c_str(), file.GetPath().c_str());
-      CFile::Delete(m_output);
-      return false;
-    }
-    // delete cached file
-    CFile::Delete(m_output);
+    // stops the encoder, which cleans up after itself
+    buffer->Abort();
+    if (cancelled)
+      CLog::Log(LOGWARNING, "User Cancelled CDDA Rip");
+    else if (result == 1)
+      CLog::Log(LOGERROR, "CDDARipper: Error ripping %s", m_input.c_str());
+    return false;
   }
 
-  if (cancelled)
+  buffer->SetEOF();
+  CLog::Log(LOGINFO, "Finished reading %s", m_input.c_str());
+  if (m_eject)
   {
-    CLog::Log(LOGWARNING, "User Cancelled CDDA Rip");
-    CFile::Delete(m_output);
+    CLog::Log(LOGINFO, "Ejecting CD");
+    g_mediaManager.EjectTray();
   }
-  else if (result == 1)
-    CLog::Log(LOGERROR, "CDDARipper: Error ripping %s", m_input.c_str());
-  else if (result < 0)
-    CLog::Log(LOGERROR, "CDDARipper: Error encoding %s", m_input.c_str());
-  else
-  {
-    CLog::Log(LOGINFO, "Finished ripping %s", m_input.c_str());
-    if (m_eject)
-    {
-      CLog::Log(LOGINFO, "Ejecting CD");
-      g_mediaManager.EjectTray();
-    }
-  }
-
-  handle->MarkFinished();
 
-  return !cancelled && result == 2;
+  return true;
 }
 
-int CCDDARipJob::RipChunk(CFile& reader, CEncoder* encoder, int& percent)
+int CCDDARipJob::ReadChunk(CFile& reader, CCDDARipBuffer& buffer, int& percent)
 {
   percent = 0;
 
-  uint8_t stream[1024];
+  uint8_t stream[CDDARIP_CHUNK_SIZE];
 
   // get data
-  int result = reader.Read(stream, 1024);
+  int result = reader.Read(stream, sizeof(stream));
 
   // return if rip is done or on some kind of error
   if (!result)
     return 1;
 
-  // encode data
-  int encres=encoder->Encode(result, stream);
+  // hand it to the encoder, this waits while too much audio is buffered
+  if (!buffer.Write(stream, result))
+    return -1;
 
   // Get progress indication
   percent = reader.GetPosition()*100/reader.GetLength();
@@ -177,7 +176,7 @@ int CCDDARipJob::RipChunk(CFile& reader, CEncoder* encoder, int& percent)
   if (reader.GetPosition() == reader.GetLength())
     return 2;
 
-  return -(1-encres);
+  return 0;
 }
 
 CEncoder* CCDDARipJob::SetupEncoder(CFile& reader)
@@ -23,6 +23,7 @@
 #include "utils/StdString.h"
 #include "music/tags/MusicInfoTag.h"
 
+class CCDDARipBuffer;
 class CEncoder;
 
 namespace XFILE
@@ -30,6 +31,13 @@ namespace XFILE
 class CFile;
 }
 
+/*! \brief Read a track from the CD
+
+ The track is read into a CCDDARipBuffer and encoded by a CCDDAEncodeJob
+ that is queued with the ripper as soon as the encoder has been set up.
+ The job completes once the track has been read, leaving the drive free for
+ the next track while this one is still being encoded.
+ */
 class CCDDARipJob : public CJob
 {
 public:
@@ -52,7 +60,6 @@ public:
   virtual const char* GetType() const { return "cdrip"; };
   virtual bool operator==(const CJob *job) const;
   virtual bool DoWork();
-  CStdString GetOutput() const { return m_output; }
 protected:
   //! \brief Setup the audio encoder
   CEncoder* SetupEncoder(XFILE::CFile& reader);
@@ -60,15 +67,15 @@ protected:
   //! \brief Helper used if output is a remote url
   CStdString SetupTempFile();
 
-  //! \brief Rip a chunk of audio
+  //! \brief Read a chunk of audio into the buffer of the track
   //! \param reader The input reader
-  //! \param encoder The audio encoder
-  //! \param percent The percentage completed on return
-  //! \return 0 (CDDARIP_OK) if everything went okay, or
-  //!         a positive error code from the reader, or
-  //!         -1 if the encoder failed
-  //! \sa CCDDARipper::GetData, CEncoder::Encode
-  int RipChunk(XFILE::CFile& reader, CEncoder* encoder, int& percent);
+  //! \param buffer The buffer the encoder reads from
+  //! \param percent The percentage read on return
+  //! \return 0 if everything went okay, 1 if the reader failed,
+  //!         2 once the track has been read completely, or
+  //!         -1 if the encoder stopped taking data
+  //! \sa CCDDARipBuffer::Write
+  int ReadChunk(XFILE::CFile& reader, CCDDARipBuffer& buffer, int& percent);
 
   unsigned int m_rate; //< The sample rate of the input file 
   unsigned int m_channels; //< The number of channels in input file
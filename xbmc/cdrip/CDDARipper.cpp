@@ -25,10 +25,12 @@
 
 #include "CDDARipper.h"
 #include "CDDARipJob.h"
+#include "CDDAEncodeJob.h"
 #include "utils/StringUtils.h"
 #include "Util.h"
 #include "filesystem/CDDADirectory.h"
 #include "music/tags/MusicInfoTagLoaderFactory.h"
+#include "utils/CPUInfo.h"
 #include "utils/LabelFormatter.h"
 #include "music/tags/MusicInfoTag.h"
 #include "guilib/GUIWindowManager.h"
@@ -47,6 +49,9 @@
 #include "settings/MediaSourceSettings.h"
 #include "Application.h"
 #include "music/MusicDatabase.h"
+#include "threads/SingleLock.h"
+
+#include <algorithm>
 
 using namespace std;
 using namespace XFILE;
@@ -59,7 +64,10 @@ CCDDARipper& CCDDARipper::GetInstance()
 }
 
 CCDDARipper::CCDDARipper()
-  : CJobQueue(false, 1) //enforce fifo and non-parallel processing
+  // enforce fifo and non-parallel reading. Reading runs above the encoders, which
+  // use up to all the normal priority workers, so the drive never waits for them.
+  : CJobQueue(false, 1, CJob::PRIORITY_HIGH)
+  , m_encoders(*this, std::max(g_cpuInfo.getCPUCount(), 1))
 {
 }
 
@@ -304,26 +312,89 @@ CStdString CCDDARipper::GetTrackName(CFileItem *item)
   return track;
 }
 
+void CCDDARipper::AddEncodeJob(CCDDAEncodeJob* job)
+{
+  {
+    CSingleLock lock(m_section);
+    m_lastOutput = job->GetOutput();
+  }
+  m_encoders.AddJob(job);
+}
+
 void CCDDARipper::OnJobComplete(unsigned int jobID, bool success, CJob* job)
 {
   if (success)
   {
-    if(CJobQueue::QueueEmpty())
+    CStdString dir;
+    bool finished;
     {
-      CStdString dir = URIUtils::GetDirectory(((CCDDARipJob*)job)->GetOutput());
-      bool unimportant;
-      int source = CUtil::GetMatchingSource(dir, *CMediaSourceSettings::Get().CMediaSourceSettings::GetSources("music"), unimportant);
-
-      CMusicDatabase database;
-      database.Open();
-      if (source>=0 && database.InsideScannedPath(dir))
-        g_application.StartMusicScan(dir);
-      database.Close();
+      CSingleLock lock(m_section);
+      CJobQueue::OnJobComplete(jobID, success, job);
+      finished = IsFinished(dir);
     }
-    return CJobQueue::OnJobComplete(jobID, success, job);
+    if (finished)
+      ScanRipped(dir);
+    return;
   }
 
+  CancelAll();
+}
+
+void CCDDARipper::OnEncodeComplete(unsigned int jobID, bool success, CJob* job)
+{
+  if (success)
+  {
+    CStdString dir;
+    bool finished;
+    {
+      CSingleLock lock(m_section);
+      m_encoders.CJobQueue::OnJobComplete(jobID, success, job);
+      finished = IsFinished(dir);
+    }
+    if (finished)
+      ScanRipped(dir);
+    return;
+  }
+
+  CancelAll();
+}
+
+bool CCDDARipper::IsFinished(CStdString &dir)
+{
+  // the last track may finish either reading or encoding last
+  if (!QueueEmpty() || IsProcessing() || !m_encoders.IsIdle())
+    return false;
+
+  dir = URIUtils::GetDirectory(m_lastOutput);
+  return true;
+}
+
+void CCDDARipper::ScanRipped(const CStdString &dir)
+{
+  bool unimportant;
+  int source = CUtil::GetMatchingSource(dir, *CMediaSourceSettings::Get().CMediaSourceSettings::GetSources("music"), unimportant);
+
+  CMusicDatabase database;
+  database.Open();
+  if (source>=0 && database.InsideScannedPath(dir))
+    g_application.StartMusicScan(dir);
+  database.Close();
+}
+
+void CCDDARipper::CancelAll()
+{
   CancelJobs();
+  m_encoders.CancelJobs();
+}
+
+CCDDARipper::CEncoderQueue::CEncoderQueue(CCDDARipper& ripper, unsigned int encoders)
+  : CJobQueue(false, encoders, CJob::PRIORITY_NORMAL), m_ripper(ripper)
+{
+}
+
+void CCDDARipper::CEncoderQueue::OnJobComplete(unsigned int jobID, bool success, CJob* job)
+{
+  m_ripper.OnEncodeComplete(jobID, success, job);
 }
 
 #endif
@@ -22,8 +22,10 @@
  */
 
 #include "Encoder.h"
+#include "threads/CriticalSection.h"
 #include "utils/JobManager.h"
 
+class CCDDAEncodeJob;
 class CFileItem;
 
 namespace MUSIC_INFO
@@ -40,6 +42,8 @@ namespace MUSIC_INFO
  for the track file name.
  Format used to encode ripped tracks is defined by the audiocds.encoder user setting, and 
  there are several choices: wav, ogg vorbis and mp3.
+ Tracks are read one at a time, while the encoders of tracks that have already
+ been read run in parallel, one per core.
  */
 class CCDDARipper : public CJobQueue
 {
@@ -61,9 +65,28 @@ public:
    */
   bool RipCD();
 
+  /*! \brief Queue the encoder of a track that is being read
+   \param job the encoder job, owned by the ripper from now on
+   \sa CCDDARipJob
+   */
+  void AddEncodeJob(CCDDAEncodeJob* job);
+
   virtual void OnJobComplete(unsigned int jobID, bool success, CJob* job);
 
 private:
+  /*! \brief Queue running the encoders of read tracks in parallel
+   */
+  class CEncoderQueue : public CJobQueue
+  {
+  public:
+    CEncoderQueue(CCDDARipper& ripper, unsigned int encoders);
+    virtual void OnJobComplete(unsigned int jobID, bool success, CJob* job);
+    bool IsIdle() const { return QueueEmpty() && !IsProcessing(); }
+  private:
+    CCDDARipper& m_ripper;
+  };
+
+
   // private construction and no assignments
   CCDDARipper();
   CCDDARipper(const CCDDARipper&);
@@ -95,6 +118,30 @@ private:
    \return track file name
    */
   CStdString GetTrackName(CFileItem *item);
+
+  /*! \brief Handle the completion of a track's encoder
+   \sa CEncoderQueue
+   */
+  void OnEncodeComplete(unsigned int jobID, bool success, CJob* job);
+
+  /*! \brief Whether all tracks are read and encoded, called with m_section held
+   \param dir [out] the folder of the ripped tracks
+   \return true if the ripped tracks should be scanned now
+   */
+  bool IsFinished(CStdString &dir);
+
+  /*! \brief Start a music scan of the ripped tracks, if their folder is in the library
+   \param dir the folder of the ripped tracks
+   */
+  void ScanRipped(const CStdString &dir);
+
+  /*! \brief Cancel reading and encoding of all tracks
+   */
+  void CancelAll();
+
+  CEncoderQueue m_encoders;
+  CCriticalSection m_section;
+  CStdString m_lastOutput; //< the most recently queued track, its folder gets scanned
 };
 
 #endif // _CCDDARIPPERMP3_H
@@ -830,7 +830,7 @@ unsigned int CActiveAESink::OutputSamples(CSampleBuffer* samples)
   while(frames > 0)
   {
     maxFrames = std::min(frames, m_sinkFormat.m_frames);
-    written = m_sink->AddPackets(buffer, maxFrames, true, true);
+    written = m_sink->AddPackets(buffer, maxFrames, samples != &m_sampleOfSilence, true);
     if (written == 0)
     {
       Sleep(500*m_sinkFormat.m_frames/m_sinkFormat.m_sampleRate);
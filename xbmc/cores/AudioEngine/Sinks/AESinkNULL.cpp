@@ -22,10 +22,17 @@
 
 #include <stdint.h>
 #include <limits.h>
+#include <math.h>
+#include <algorithm>
 
 #include "AESinkNULL.h"
 #include "cores/AudioEngine/Utils/AEUtil.h"
+#include "threads/SingleLock.h"
 #include "utils/log.h"
+#include "utils/TimeUtils.h"
+
+CCriticalSection CAESinkNULL::m_statsLock;
+AESinkNULLStats  CAESinkNULL::m_stats = { 0, 0, 0, 0.0, 0.0, 0.0f, 0, 0, AE_FMT_INVALID };
 
 CAESinkNULL::CAESinkNULL()
   : CThread("AESinkNull"),
@@ -33,7 +40,9 @@ CAESinkNULL::CAESinkNULL()
     m_sink_frameSize(0),
     m_sinkbuffer_size(0),
     m_sinkbuffer_level(0),
-    m_sinkbuffer_sec_per_byte(0)
+    m_sinkbuffer_sec_per_byte(0),
+    m_benchmark(false),
+    m_lastPeriod(0)
 {
 }
 
@@ -55,6 +64,18 @@ bool CAESinkNULL::Initialize(AEAudioFormat &format, std::string &device)
   m_sinkbuffer_size = m_sink_frameSize * format.m_sampleRate / 2;
   m_sinkbuffer_sec_per_byte = 1.0 / (double)(m_sink_frameSize * format.m_sampleRate);
 
+  // in benchmark mode packets are swallowed as they arrive, so the engine
+  // runs as fast as it can produce them
+  m_benchmark = (device == "benchmark");
+  m_lastPeriod = 0;
+  if (m_benchmark)
+  {
+    CSingleLock lock(m_statsLock);
+    m_stats.sampleRate = format.m_sampleRate;
+    m_stats.channels   = format.m_channelLayout.Count();
+    m_stats.dataFormat = format.m_dataFormat;
+  }
+
   m_draining = false;
   m_wake.Reset();
   m_inited.Reset();
@@ -88,11 +109,43 @@ double CAESinkNULL::GetCacheTotal()
 
 unsigned int CAESinkNULL::AddPackets(uint8_t *data, unsigned int frames, bool hasAudio, bool blocking)
 {
+  if (m_benchmark)
+  {
+    int64_t now = CurrentHostCounter();
+    CSingleLock lock(m_statsLock);
+    if (!hasAudio)
+    {
+      // the engine ran dry and the sink got silence, don't let
+      // the gap count as period time
+      m_stats.silenceFrames += frames;
+      m_lastPeriod = 0;
+      return frames;
+    }
+    if (m_lastPeriod && m_stats.periods)
+    {
+      double period = (double)(now - m_lastPeriod) / CurrentHostFrequency();
+      m_stats.totalTime += period;
+      if (period > m_stats.maxPeriodTime)
+        m_stats.maxPeriodTime = period;
+    }
+    if (m_format.m_dataFormat == AE_FMT_FLOAT)
+    {
+      const float *samples = (const float*)data;
+      for (unsigned int i = 0; i < frames * m_format.m_frameSamples; i++)
+        m_stats.peak = std::max(m_stats.peak, (float)fabs(samples[i]));
+    }
+    m_stats.frames += frames;
+    m_stats.periods++;
+    m_lastPeriod = CurrentHostCounter();
+    return frames;
+  }
+
   unsigned int max_frames = (m_sinkbuffer_size - m_sinkbuffer_level) / m_sink_frameSize;
   if (frames > max_frames)
     frames = max_frames;
 
-  if (hasAudio && frames)
+  // silence has to be paced like audio
+  if (frames)
   {
     m_sinkbuffer_level += frames * m_sink_frameSize;
     m_wake.Set();
@@ -112,6 +165,23 @@ void CAESinkNULL::EnumerateDevices (AEDeviceList &devices, bool passthrough)
   // we never return any devices
 }
 
+void CAESinkNULL::GetBenchmarkStats(AESinkNULLStats &stats)
+{
+  CSingleLock lock(m_statsLock);
+  stats = m_stats;
+}
+
+void CAESinkNULL::ResetBenchmarkStats()
+{
+  CSingleLock lock(m_statsLock);
+  m_stats.frames = 0;
+  m_stats.silenceFrames = 0;
+  m_stats.periods = 0;
+  m_stats.totalTime = 0.0;
+  m_stats.maxPeriodTime = 0.0;
+  m_stats.peak = 0.0f;
+}
+
 void CAESinkNULL::Process()
 {
   CLog::Log(LOGDEBUG, "CAESinkNULL::Process");
@@ -20,9 +20,28 @@
  */
 
 #include "system.h"
+#include "threads/CriticalSection.h"
 #include "threads/Thread.h"
 #include "cores/AudioEngine/Interfaces/AESink.h"
 
+/**
+ * Statistics collected by the NULL sink when it is opened in benchmark mode
+ * (device "NULL:benchmark"). A period is one AddPackets call, the period time
+ * is the time the engine needed to deliver it after the previous one returned.
+ */
+struct AESinkNULLStats
+{
+  uint64_t     frames;        ///< frames consumed since the last reset
+  uint64_t     silenceFrames; ///< frames of silence the engine filled in
+  uint64_t     periods;       ///< number of AddPackets calls with audio
+  double       totalTime;     ///< seconds between first and last period
+  double       maxPeriodTime; ///< worst-case period time in seconds
+  float        peak;          ///< largest absolute sample, for float data
+  unsigned int sampleRate;    ///< sample rate the sink was opened with
+  unsigned int channels;      ///< channels the sink was opened with
+  AEDataFormat dataFormat;    ///< data format the sink was opened with
+};
+
 class CAESinkNULL : public CThread, public IAESink
 {
 public:
@@ -40,6 +59,13 @@ public:
   virtual void         Drain           ();
 
   static void          EnumerateDevices(AEDeviceList &devices, bool passthrough);
+
+  /**
+   * Statistics of the last sink opened in benchmark mode. In this mode the
+   * sink does not pace the engine, every packet is consumed immediately.
+   */
+  static void          GetBenchmarkStats(AESinkNULLStats &stats);
+  static void          ResetBenchmarkStats();
 private:
   virtual void         Process();
 
@@ -51,4 +77,9 @@ private:
   unsigned int         m_sinkbuffer_size;  ///< total size of the buffer
   unsigned int         m_sinkbuffer_level; ///< current level in the buffer
   double               m_sinkbuffer_sec_per_byte;
+  bool                 m_benchmark;
+  int64_t              m_lastPeriod;
+
+  static CCriticalSection m_statsLock;
+  static AESinkNULLStats  m_stats;
 };
@@ -0,0 +1,193 @@
+/*
+ *      Copyright (C) 2010-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "AELoudnessMeter.h"
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+#define ABSOLUTE_GATE  -70.0
+#define RELATIVE_GATE  -10.0
+
+CAELoudnessMeter::CAELoudnessMeter()
+{
+  memset(&m_shelf, 0, sizeof(m_shelf));
+  memset(&m_highpass, 0, sizeof(m_highpass));
+  m_subBlockFrames = 0;
+  Reset();
+}
+
+bool CAELoudnessMeter::Initialize(unsigned int sampleRate, const CAEChannelInfo &layout)
+{
+  m_channels.clear();
+  m_subBlockFrames = sampleRate / 10;
+  if (m_subBlockFrames == 0 || layout.Count() == 0)
+    return false;
+
+  /* K-weighting, the BS.1770 coefficients are given for 48kHz only so derive
+     both stages from their analog prototypes for any other rate */
+  double f0 = 1681.974450955533;
+  double G  = 3.999843853973347;
+  double Q  = 0.7071752369554196;
+  double K  = tan(M_PI * f0 / sampleRate);
+  double Vh = pow(10.0, G / 20.0);
+  double Vb = pow(Vh, 0.4996667741545416);
+  double a0 = 1.0 + K / Q + K * K;
+  m_shelf.b0 = (Vh + Vb * K / Q + K * K) / a0;
+  m_shelf.b1 = 2.0 * (K * K - Vh) / a0;
+  m_shelf.b2 = (Vh - Vb * K / Q + K * K) / a0;
+  m_shelf.a1 = 2.0 * (K * K - 1.0) / a0;
+  m_shelf.a2 = (1.0 - K / Q + K * K) / a0;
+
+  f0 = 38.13547087602444;
+  Q  = 0.5003270373238773;
+  K  = tan(M_PI * f0 / sampleRate);
+  a0 = 1.0 + K / Q + K * K;
+  m_highpass.b0 =  1.0;
+  m_highpass.b1 = -2.0;
+  m_highpass.b2 =  1.0;
+  m_highpass.a1 = 2.0 * (K * K - 1.0) / a0;
+  m_highpass.a2 = (1.0 - K / Q + K * K) / a0;
+
+  m_channels.resize(layout.Count());
+  for (unsigned int ch = 0; ch < layout.Count(); ++ch)
+  {
+    switch (layout[ch])
+    {
+      case AE_CH_LFE:
+        m_channels[ch].weight = 0.0;
+        break;
+      case AE_CH_SL:
+      case AE_CH_SR:
+      case AE_CH_BL:
+      case AE_CH_BR:
+        m_channels[ch].weight = 1.41;
+        break;
+      default:
+        m_channels[ch].weight = 1.0;
+        break;
+    }
+  }
+
+  Reset();
+  return true;
+}
+
+void CAELoudnessMeter::Reset()
+{
+  for (std::vector<ChannelState>::iterator it = m_channels.begin(); it != m_channels.end(); ++it)
+    memset(it->z, 0, sizeof(it->z));
+
+  m_subBlockPos   = 0;
+  m_subBlockSum   = 0.0;
+  m_subBlockCount = 0;
+  memset(m_subBlocks, 0, sizeof(m_subBlocks));
+  m_blocks.clear();
+  m_peak = 0.0f;
+}
+
+void CAELoudnessMeter::AddFrames(const float *data, unsigned int frames)
+{
+  const unsigned int channels = m_channels.size();
+  if (!channels)
+    return;
+
+  for (unsigned int i = 0; i < frames; ++i, data += channels)
+  {
+    for (unsigned int ch = 0; ch < channels; ++ch)
+    {
+      ChannelState &state = m_channels[ch];
+      double x = data[ch];
+      m_peak = std::max(m_peak, (float)fabs(x));
+
+      double y  = m_shelf.b0 * x + state.z[0];
+      state.z[0] = m_shelf.b1 * x - m_shelf.a1 * y + state.z[1];
+      state.z[1] = m_shelf.b2 * x - m_shelf.a2 * y;
+
+      double z  = m_highpass.b0 * y + state.z[2];
+      state.z[2] = m_highpass.b1 * y - m_highpass.a1 * z + state.z[3];
+      state.z[3] = m_highpass.b2 * y - m_highpass.a2 * z;
+
+      m_subBlockSum += state.weight * z * z;
+    }
+
+    if (++m_subBlockPos < m_subBlockFrames)
+      continue;
+
+    /* every 100ms close a sub block, a gating block is the last four of them */
+    m_subBlocks[m_subBlockCount++ % 4] = m_subBlockSum / m_subBlockFrames;
+    m_subBlockPos = 0;
+    m_subBlockSum = 0.0;
+
+    if (m_subBlockCount >= 4)
+      m_blocks.push_back((m_subBlocks[0] + m_subBlocks[1] + m_subBlocks[2] + m_subBlocks[3]) / 4.0);
+  }
+}
+
+double CAELoudnessMeter::GetIntegratedLoudness() const
+{
+  const double absoluteGate = LoudnessToEnergy(ABSOLUTE_GATE);
+
+  double sum = 0.0;
+  unsigned int count = 0;
+  for (std::vector<double>::const_iterator it = m_blocks.begin(); it != m_blocks.end(); ++it)
+  {
+    if (*it > absoluteGate)
+    {
+      sum += *it;
+      count++;
+    }
+  }
+  if (!count)
+    return AE_LOUDNESS_SILENCE;
+
+  const double relativeGate = std::max(absoluteGate, LoudnessToEnergy(EnergyToLoudness(sum / count) + RELATIVE_GATE));
+
+  sum   = 0.0;
+  count = 0;
+  for (std::vector<double>::const_iterator it = m_blocks.begin(); it != m_blocks.end(); ++it)
+  {
+    if (*it > relativeGate)
+    {
+      sum += *it;
+      count++;
+    }
+  }
+  if (!count)
+    return AE_LOUDNESS_SILENCE;
+
+  return std::max(AE_LOUDNESS_SILENCE, EnergyToLoudness(sum / count));
+}
+
+double CAELoudnessMeter::EnergyToLoudness(double energy)
+{
+  if (energy <= 0.0)
+    return AE_LOUDNESS_SILENCE;
+  return -0.691 + 10.0 * log10(energy);
+}
+
+double CAELoudnessMeter::LoudnessToEnergy(double loudness)
+{
+  return pow(10.0, (loudness + 0.691) / 10.0);
+}
@@ -0,0 +1,94 @@
+#pragma once
+/*
+ *      Copyright (C) 2010-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+#include "AEAudioFormat.h"
+
+/* loudness reported for input where no block passes the absolute gate */
+#define AE_LOUDNESS_SILENCE -70.0
+
+/*!
+ \brief Integrated loudness meter after ITU-R BS.1770 / EBU R128
+
+ Feeds interleaved float frames through the K-weighting filter, collects the
+ mean square of 400ms blocks with 75% overlap and applies the absolute
+ (-70 LUFS) and relative (-10 LU) gates when the integrated loudness is
+ requested. The sample peak is tracked alongside.
+ */
+class CAELoudnessMeter
+{
+public:
+  CAELoudnessMeter();
+
+  /*!
+   \brief Prepare the meter for a stream, discarding all previous measurements
+   \param sampleRate sample rate of the frames passed to AddFrames
+   \param layout channel layout, used to weight surround and ignore LFE channels
+   \return false if the format can not be measured
+   */
+  bool Initialize(unsigned int sampleRate, const CAEChannelInfo &layout);
+  void Reset();
+
+  /*!
+   \brief Measure interleaved float frames
+   \param data frames with as many channels as the layout given to Initialize
+   \param frames number of frames in data
+   */
+  void AddFrames(const float *data, unsigned int frames);
+
+  /*!
+   \brief Integrated, gated loudness of everything measured so far
+   \return loudness in LUFS, AE_LOUDNESS_SILENCE if nothing passed the gates
+   */
+  double GetIntegratedLoudness() const;
+
+  /*! \brief Highest absolute sample value measured so far */
+  float GetSamplePeak() const { return m_peak; }
+
+  /*! \brief Number of 400ms blocks measured so far */
+  unsigned int GetBlockCount() const { return m_blocks.size(); }
+
+  static double EnergyToLoudness(double energy);
+  static double LoudnessToEnergy(double loudness);
+
+private:
+  struct Biquad
+  {
+    double b0, b1, b2, a1, a2;
+  };
+
+  struct ChannelState
+  {
+    double weight;
+    double z[4];  ///< transposed direct form state of both stages
+  };
+
+  Biquad                    m_shelf;
+  Biquad                    m_highpass;
+  std::vector<ChannelState> m_channels;
+  unsigned int              m_subBlockFrames;
+  unsigned int              m_subBlockPos;
+  double                    m_subBlockSum;
+  double                    m_subBlocks[4];
+  unsigned int              m_subBlockCount;
+  std::vector<double>       m_blocks;
+  float                     m_peak;
+};
@@ -0,0 +1,111 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/Utils/AELoudnessMeter.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <math.h>
+#include <vector>
+
+/* 1kHz sine of the given level in dBFS on every channel, the reference
+ * signal of EBU Tech 3341 */
+static void AddSine(CAELoudnessMeter &meter, unsigned int sampleRate,
+                    unsigned int channels, double level, double seconds)
+{
+  const double amplitude = pow(10.0, level / 20.0);
+  const unsigned int frames = (unsigned int)(seconds * sampleRate);
+  std::vector<float> buffer(sampleRate * channels);
+
+  for (unsigned int done = 0; done < frames; done += sampleRate)
+  {
+    unsigned int count = std::min(frames - done, sampleRate);
+    for (unsigned int i = 0; i < count; ++i)
+    {
+      float sample = (float)(amplitude * sin(2.0 * M_PI * 1000.0 * (done + i) / sampleRate));
+      for (unsigned int ch = 0; ch < channels; ++ch)
+        buffer[i * channels + ch] = sample;
+    }
+    meter.AddFrames(&buffer[0], count);
+  }
+}
+
+TEST(TestAELoudnessMeter, StereoSine)
+{
+  CAELoudnessMeter meter;
+  ASSERT_TRUE(meter.Initialize(48000, CAEChannelInfo(AE_CH_LAYOUT_2_0)));
+
+  AddSine(meter, 48000, 2, -23.0, 20.0);
+  EXPECT_NEAR(-23.0, meter.GetIntegratedLoudness(), 0.1);
+  EXPECT_NEAR(pow(10.0, -23.0 / 20.0), meter.GetSamplePeak(), 0.001);
+  EXPECT_EQ(197U, meter.GetBlockCount());
+}
+
+TEST(TestAELoudnessMeter, SampleRates)
+{
+  const unsigned int rates[] = { 22050, 44100, 96000 };
+  for (unsigned int i = 0; i < sizeof(rates) / sizeof(rates[0]); ++i)
+  {
+    CAELoudnessMeter meter;
+    ASSERT_TRUE(meter.Initialize(rates[i], CAEChannelInfo(AE_CH_LAYOUT_2_0)));
+    AddSine(meter, rates[i], 2, -20.0, 10.0);
+    EXPECT_NEAR(-20.0, meter.GetIntegratedLoudness(), 0.1) << "at " << rates[i] << "Hz";
+  }
+}
+
+TEST(TestAELoudnessMeter, LFEIsIgnored)
+{
+  CAELoudnessMeter stereo;
+  ASSERT_TRUE(stereo.Initialize(48000, CAEChannelInfo(AE_CH_LAYOUT_2_0)));
+  AddSine(stereo, 48000, 2, -23.0, 5.0);
+
+  CAELoudnessMeter lfe;
+  ASSERT_TRUE(lfe.Initialize(48000, CAEChannelInfo(AE_CH_LAYOUT_2_1)));
+  AddSine(lfe, 48000, 3, -23.0, 5.0);
+
+  EXPECT_NEAR(stereo.GetIntegratedLoudness(), lfe.GetIntegratedLoudness(), 0.01);
+}
+
+TEST(TestAELoudnessMeter, RelativeGate)
+{
+  /* EBU Tech 3341 case 3, the quiet passages fall below the relative gate */
+  CAELoudnessMeter meter;
+  ASSERT_TRUE(meter.Initialize(48000, CAEChannelInfo(AE_CH_LAYOUT_2_0)));
+
+  AddSine(meter, 48000, 2, -36.0, 10.0);
+  AddSine(meter, 48000, 2, -23.0, 60.0);
+  AddSine(meter, 48000, 2, -36.0, 10.0);
+  EXPECT_NEAR(-23.0, meter.GetIntegratedLoudness(), 0.1);
+}
+
+TEST(TestAELoudnessMeter, Silence)
+{
+  CAELoudnessMeter meter;
+  ASSERT_TRUE(meter.Initialize(44100, CAEChannelInfo(AE_CH_LAYOUT_2_0)));
+
+  std::vector<float> silence(44100 * 2, 0.0f);
+  meter.AddFrames(&silence[0], 44100);
+  EXPECT_EQ(AE_LOUDNESS_SILENCE, meter.GetIntegratedLoudness());
+  EXPECT_EQ(0.0f, meter.GetSamplePeak());
+
+  meter.Reset();
+  EXPECT_EQ(0U, meter.GetBlockCount());
+}
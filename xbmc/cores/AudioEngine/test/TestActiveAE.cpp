@@ -0,0 +1,276 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "cores/AudioEngine/AEFactory.h"
+#include "cores/AudioEngine/Interfaces/AEStream.h"
+#include "cores/AudioEngine/Interfaces/AESound.h"
+#include "cores/AudioEngine/Sinks/AESinkNULL.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "cores/AudioEngine/Utils/AEWAVLoader.h"
+#include "settings/Settings.h"
+#include "test/TestUtils.h"
+#include "threads/SystemClock.h"
+#include "threads/Thread.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+#include <utility>
+#include <vector>
+
+/* The engine is driven against the NULL sink in benchmark mode. The sink
+ * swallows every period as soon as it arrives, so the numbers below are
+ * limited by the engine and not by a sound device.
+ */
+#define BENCH_DEVICE  "NULL:benchmark"
+#define BENCH_STREAMS 4
+#define BENCH_SECONDS 20
+#define BENCH_SOUND   "addons/skin.confluence/sounds/click.wav"
+
+namespace
+{
+struct BenchStream
+{
+  IAEStream     *stream;
+  CAEWAVLoader   source;
+  unsigned int   position;  // in samples of the source
+  unsigned int   remaining; // in frames
+};
+
+class TestActiveAE : public testing::Test
+{
+protected:
+  TestActiveAE()
+  {
+    SetString("audiooutput.audiodevice", BENCH_DEVICE);
+    SetString("audiooutput.passthroughdevice", BENCH_DEVICE);
+    SetInt("audiooutput.config", AE_CONFIG_AUTO);
+    SetInt("audiooutput.processquality", AE_QUALITY_MID);
+    SetInt("audiooutput.guisoundmode", 2 /* always */);
+    SetBool("audiooutput.normalizelevels", true);
+  }
+
+  ~TestActiveAE()
+  {
+    CAEFactory::UnLoadEngine();
+
+    // put back what the other tests run with, last change first
+    for (std::vector< std::pair<std::string, std::string> >::const_reverse_iterator it = m_strings.rbegin(); it != m_strings.rend(); ++it)
+      CSettings::Get().SetString(it->first, it->second);
+    for (std::vector< std::pair<std::string, int> >::const_reverse_iterator it = m_ints.rbegin(); it != m_ints.rend(); ++it)
+      CSettings::Get().SetInt(it->first, it->second);
+    for (std::vector< std::pair<std::string, bool> >::const_reverse_iterator it = m_bools.rbegin(); it != m_bools.rend(); ++it)
+      CSettings::Get().SetBool(it->first, it->second);
+  }
+
+  void SetString(const std::string &id, const std::string &value)
+  {
+    m_strings.push_back(std::make_pair(id, CSettings::Get().GetString(id)));
+    CSettings::Get().SetString(id, value);
+  }
+
+  void SetInt(const std::string &id, int value)
+  {
+    m_ints.push_back(std::make_pair(id, CSettings::Get().GetInt(id)));
+    CSettings::Get().SetInt(id, value);
+  }
+
+  void SetBool(const std::string &id, bool value)
+  {
+    m_bools.push_back(std::make_pair(id, CSettings::Get().GetBool(id)));
+    CSettings::Get().SetBool(id, value);
+  }
+
+  bool StartEngine()
+  {
+    if (!CAEFactory::LoadEngine() || !CAEFactory::StartEngine())
+      return false;
+    CAEFactory::SetVolume(1.0f);
+    CAEFactory::SetMute(false);
+    return true;
+  }
+
+  bool AddStream(unsigned int sampleRate, enum AEStdChLayout layout, float amplify = 1.0f)
+  {
+    BenchStream *s = new BenchStream();
+    CAEChannelInfo channels(layout);
+    if (!s->source.Load(XBMC_REF_FILE_PATH(BENCH_SOUND)) ||
+        !s->source.Initialize(sampleRate, channels, layout))
+    {
+      delete s;
+      return false;
+    }
+    s->stream = CAEFactory::MakeStream(AE_FMT_FLOAT, sampleRate, sampleRate, channels, AESTREAM_FORCE_RESAMPLE);
+    if (!s->stream)
+    {
+      delete s;
+      return false;
+    }
+    s->stream->SetAmplification(amplify);
+    s->position = 0;
+    s->remaining = sampleRate * BENCH_SECONDS;
+    m_streams.push_back(s);
+    return true;
+  }
+
+  /* feed all streams until every one of them has delivered BENCH_SECONDS of
+   * audio, while triggering a gui sound every 100ms of wall clock time.
+   * Returns the wall clock time spent in seconds.
+   */
+  double Run()
+  {
+    IAESound *sound = CAEFactory::MakeSound(XBMC_REF_FILE_PATH(BENCH_SOUND));
+    unsigned int nextSound = 0;
+
+    CAESinkNULL::ResetBenchmarkStats();
+    int64_t start = CurrentHostCounter();
+
+    bool done = false;
+    while (!done)
+    {
+      done = true;
+      bool added = false;
+      for (std::vector<BenchStream*>::iterator it = m_streams.begin(); it != m_streams.end(); ++it)
+      {
+        BenchStream *s = *it;
+        if (!s->remaining)
+          continue;
+        done = false;
+
+        unsigned int channels = s->stream->GetChannelCount();
+        unsigned int frameSize = s->stream->GetFrameSize();
+        unsigned int frames = std::min(s->stream->GetSpace() / frameSize, s->remaining);
+        frames = std::min(frames, (s->source.GetSampleCount() - s->position) / channels);
+        if (!frames)
+          continue;
+
+        unsigned int taken = s->stream->AddData(s->source.GetSamples() + s->position, frames * frameSize) / frameSize;
+        s->remaining -= taken;
+        s->position += taken * channels;
+        if (s->position >= s->source.GetSampleCount())
+          s->position = 0;
+        added |= taken > 0;
+      }
+
+      // the streams are full, give the engine time to take from them
+      if (!done && !added)
+        XbmcThreads::ThreadSleep(1);
+
+      if (sound && XbmcThreads::SystemClockMillis() >= nextSound)
+      {
+        sound->Play();
+        nextSound = XbmcThreads::SystemClockMillis() + 100;
+      }
+    }
+
+    for (std::vector<BenchStream*>::iterator it = m_streams.begin(); it != m_streams.end(); ++it)
+      (*it)->stream->Drain(true);
+
+    double elapsed = (double)(CurrentHostCounter() - start) / CurrentHostFrequency();
+
+    for (std::vector<BenchStream*>::iterator it = m_streams.begin(); it != m_streams.end(); ++it)
+    {
+      CAEFactory::FreeStream((*it)->stream);
+      delete *it;
+    }
+    m_streams.clear();
+
+    if (sound)
+      CAEFactory::FreeSound(sound);
+
+    return elapsed;
+  }
+
+  void Report(const char *name, double elapsed, const AESinkNULLStats &stats)
+  {
+    double audio = stats.sampleRate ? (double)stats.frames / stats.sampleRate : 0.0;
+    fprintf(stdout, "[ BENCH    ] %s: %s %uHz, %.1fs audio in %.3fs (%.1fx realtime), "
+                    "%.0f frames/s, %llu periods, worst period %.3fms, %llu silence frames\n",
+            name, CAEUtil::DataFormatToStr(stats.dataFormat), stats.sampleRate,
+            audio, elapsed, elapsed > 0.0 ? audio / elapsed : 0.0,
+            elapsed > 0.0 ? stats.frames / elapsed : 0.0,
+            (unsigned long long)stats.periods, stats.maxPeriodTime * 1000.0,
+            (unsigned long long)stats.silenceFrames);
+  }
+
+  std::vector<BenchStream*> m_streams;
+  std::vector< std::pair<std::string, std::string> > m_strings;
+  std::vector< std::pair<std::string, int> >         m_ints;
+  std::vector< std::pair<std::string, bool> >        m_bools;
+};
+}
+
+TEST_F(TestActiveAE, PCMResampleRemapLimiter)
+{
+  // stereo streams upmixed to 5.1, at rates that need resampling and
+  // amplified so the limiter has to work on every sample
+  SetInt("audiooutput.channels", 8 /* 5.1 */);
+  SetBool("audiooutput.stereoupmix", true);
+  SetBool("audiooutput.passthrough", false);
+  ASSERT_TRUE(StartEngine());
+
+  static const unsigned int rates[] = { 44100, 48000, 96000, 22050 };
+  for (int i = 0; i < BENCH_STREAMS; i++)
+    ASSERT_TRUE(AddStream(rates[i % 4], AE_CH_LAYOUT_2_0, 2.0f));
+
+  double elapsed = Run();
+
+  AESinkNULLStats stats;
+  CAESinkNULL::GetBenchmarkStats(stats);
+  Report("PCMResampleRemapLimiter", elapsed, stats);
+
+  EXPECT_EQ(AE_FMT_FLOAT, stats.dataFormat);
+  // the stereo streams are upmixed to the 5.1 output
+  EXPECT_EQ(6U, stats.channels);
+  // allow for the tail that is still in flight when the streams are freed
+  EXPECT_LE((uint64_t)stats.sampleRate * BENCH_SECONDS * 9 / 10, stats.frames);
+  // the streams are amplified past full scale, the limiter keeps the mix in range
+  EXPECT_LT(0.0f, stats.peak);
+  EXPECT_GE(1.0f, stats.peak);
+}
+
+TEST_F(TestActiveAE, AC3Transcode)
+{
+  // multichannel pcm to a stereo passthrough device is transcoded
+  // to ac3 by AEEncoderFFmpeg
+  SetInt("audiooutput.channels", 1 /* 2.0 */);
+  SetBool("audiooutput.stereoupmix", false);
+  SetBool("audiooutput.passthrough", true);
+  SetBool("audiooutput.ac3passthrough", true);
+  SetBool("audiooutput.ac3transcode", true);
+  ASSERT_TRUE(StartEngine());
+
+  for (int i = 0; i < BENCH_STREAMS; i++)
+    ASSERT_TRUE(AddStream(48000, AE_CH_LAYOUT_5_1));
+
+  double elapsed = Run();
+
+  AESinkNULLStats stats;
+  CAESinkNULL::GetBenchmarkStats(stats);
+  Report("AC3Transcode", elapsed, stats);
+
+  // the NULL sink takes raw streams as S16NE, ac3 is carried in stereo frames
+  EXPECT_EQ(AE_FMT_S16NE, stats.dataFormat);
+  EXPECT_EQ(2U, stats.channels);
+  EXPECT_LE((uint64_t)stats.sampleRate * BENCH_SECONDS * 9 / 10, stats.frames);
+}
@@ -49,6 +49,7 @@
 #include "RenderFormats.h"
 #include "cores/IPlayer.h"
 #include "cores/dvdplayer/DVDCodecs/DVDCodecUtils.h"
+#include "cores/dvdplayer/DVDCodecs/Video/DVDVideoCodecInfo.h"
 
 #ifdef HAVE_LIBVDPAU
 #include "cores/dvdplayer/DVDCodecs/Video/VDPAU.h"
@@ -133,6 +134,7 @@ CLinuxRendererGL::YUVBUFFER::YUVBUFFER()
   memset(&image , 0, sizeof(image));
   memset(&pbo   , 0, sizeof(pbo));
   flipindex = 0;
+  codecinfo = NULL;
 #ifdef HAVE_LIBVDPAU
   vdpau = NULL;
 #endif
@@ -366,6 +368,10 @@ int CLinuxRendererGL::GetImage(YV12Image *image, int source, bool readonly)
   else
     im.flags |= IMAGE_FLAG_WRITING;
 
+  // the picture is written to the image, not to a frame referenced before
+  if( !readonly )
+    SAFE_RELEASE(m_buffers[source].codecinfo);
+
   // copy the image - should be operator of YV12Image
   for (int p=0;p<MAX_PLANES;p++)
   {
@@ -567,9 +573,8 @@ void CLinuxRendererGL::Flush()
 
 void CLinuxRendererGL::ReleaseBuffer(int idx)
 {
-#if defined(HAVE_LIBVDPAU) || defined(HAVE_LIBVA) || defined(TARGET_DARWIN)
   YUVBUFFER &buf = m_buffers[idx];
-#endif
+  SAFE_RELEASE(buf.codecinfo);
 #ifdef HAVE_LIBVDPAU
   SAFE_RELEASE(buf.vdpau);
 #endif
@@ -1813,6 +1818,22 @@ bool CLinuxRendererGL::RenderCapture(CRenderCapture* capture)
 //********************************************************************************************************
 // YV12 Texture creation, deletion, copying + clearing
 //********************************************************************************************************
+// the planes of a frame referenced through AddProcessor take the place of
+// the ones of the image
+static YV12Image* GetUploadImage(YV12Image* im, CDVDVideoCodecBuffer* codecinfo, YV12Image& referenced)
+{
+  if (!codecinfo)
+    return im;
+
+  referenced = *im;
+  for (int i = 0; i < 3; i++)
+  {
+    referenced.plane[i]  = codecinfo->data[i];
+    referenced.stride[i] = codecinfo->iLineSize[i];
+  }
+  return &referenced;
+}
+
 bool CLinuxRendererGL::UploadYV12Texture(int source)
 {
   YUVBUFFER& buf    =  m_buffers[source];
@@ -1821,6 +1842,13 @@ bool CLinuxRendererGL::UploadYV12Texture(int source)
 
   if (!(im->flags&IMAGE_FLAG_READY))
     return false;
+
+  // a referenced frame isn't in the mapped pbos, upload it from client memory
+  YV12Image referenced;
+  GLuint    nopbo = 0;
+  GLuint*   pbo   = buf.codecinfo ? &nopbo : NULL;
+  im = GetUploadImage(im, buf.codecinfo, referenced);
+
   bool deinterlacing;
   if (m_currentField == FIELD_FULL)
     deinterlacing = false;
@@ -1837,47 +1865,47 @@ bool CLinuxRendererGL::UploadYV12Texture(int source)
     // Load Even Y Field
     LoadPlane( fields[FIELD_TOP][0] , GL_LUMINANCE, buf.flipindex
              , im->width, im->height >> 1
-             , im->stride[0]*2, im->bpp, im->plane[0] );
+             , im->stride[0]*2, im->bpp, im->plane[0], pbo );
 
     //load Odd Y Field
     LoadPlane( fields[FIELD_BOT][0], GL_LUMINANCE, buf.flipindex
              , im->width, im->height >> 1
-             , im->stride[0]*2, im->bpp, im->plane[0] + im->stride[0]) ;
+             , im->stride[0]*2, im->bpp, im->plane[0] + im->stride[0], pbo );
 
     // Load Even U & V Fields
     LoadPlane( fields[FIELD_TOP][1], GL_LUMINANCE, buf.flipindex
              , im->width >> im->cshift_x, im->height >> (im->cshift_y + 1)
-             , im->stride[1]*2, im->bpp, im->plane[1] );
+             , im->stride[1]*2, im->bpp, im->plane[1], pbo );
 
     LoadPlane( fields[FIELD_TOP][2], GL_ALPHA, buf.flipindex
              , im->width >> im->cshift_x, im->height >> (im->cshift_y + 1)
-             , im->stride[2]*2, im->bpp, im->plane[2] );
+             , im->stride[2]*2, im->bpp, im->plane[2], pbo );
 
     // Load Odd U & V Fields
     LoadPlane( fields[FIELD_BOT][1], GL_LUMINANCE, buf.flipindex
              , im->width >> im->cshift_x, im->height >> (im->cshift_y + 1)
-             , im->stride[1]*2, im->bpp, im->plane[1] + im->stride[1] );
+             , im->stride[1]*2, im->bpp, im->plane[1] + im->stride[1], pbo );
 
     LoadPlane( fields[FIELD_BOT][2], GL_ALPHA, buf.flipindex
              , im->width >> im->cshift_x, im->height >> (im->cshift_y + 1)
-             , im->stride[2]*2, im->bpp, im->plane[2] + im->stride[2] );
+             , im->stride[2]*2, im->bpp, im->plane[2] + im->stride[2], pbo );
   }
   else
   {
     //Load Y plane
     LoadPlane( fields[FIELD_FULL][0], GL_LUMINANCE, buf.flipindex
              , im->width, im->height
-             , im->stride[0], im->bpp, im->plane[0] );
+             , im->stride[0], im->bpp, im->plane[0], pbo );
 
     //load U plane
     LoadPlane( fields[FIELD_FULL][1], GL_LUMINANCE, buf.flipindex
              , im->width >> im->cshift_x, im->height >> im->cshift_y
-             , im->stride[1], im->bpp, im->plane[1] );
+             , im->stride[1], im->bpp, im->plane[1], pbo );
 
     //load V plane
     LoadPlane( fields[FIELD_FULL][2], GL_ALPHA, buf.flipindex
              , im->width >> im->cshift_x, im->height >> im->cshift_y
-             , im->stride[2], im->bpp, im->plane[2] );
+             , im->stride[2], im->bpp, im->plane[2], pbo );
   }
 
   VerifyGLState();
@@ -1890,6 +1918,8 @@ bool CLinuxRendererGL::UploadYV12Texture(int source)
 
 void CLinuxRendererGL::DeleteYV12Texture(int index)
 {
+  SAFE_RELEASE(m_buffers[index].codecinfo);
+
   YV12Image &im     = m_buffers[index].image;
   YUVFIELDS &fields = m_buffers[index].fields;
   GLuint    *pbo    = m_buffers[index].pbo;
@@ -3308,6 +3338,9 @@ bool CLinuxRendererGL::UploadRGBTexture(int source)
   if (!(im->flags&IMAGE_FLAG_READY))
     return false;
 
+  YV12Image referenced;
+  im = GetUploadImage(im, buf.codecinfo, referenced);
+
   bool deinterlacing;
   if (m_currentField == FIELD_FULL)
     deinterlacing = false;
@@ -3674,6 +3707,14 @@ unsigned int CLinuxRendererGL::GetProcessorSize()
     return 0;
 }
 
+void CLinuxRendererGL::AddProcessor(CDVDVideoCodecBuffer *codecinfo, int index)
+{
+  YUVBUFFER &buf = m_buffers[index];
+  SAFE_RELEASE(buf.codecinfo);
+  buf.codecinfo = codecinfo;
+  buf.codecinfo->Lock();
+}
+
 #ifdef HAVE_LIBVDPAU
 void CLinuxRendererGL::AddProcessor(VDPAU::CVdpauRenderPicture *vdpau, int index)
 {
@@ -39,6 +39,7 @@
 class CRenderCapture;
 
 class CBaseTexture;
+class CDVDVideoCodecBuffer;
 namespace Shaders { class BaseYUV2RGBShader; }
 namespace Shaders { class BaseVideoFilterShader; }
 namespace VAAPI   { struct CHolder; }
@@ -123,7 +124,7 @@ public:
   virtual void Update();
   virtual void SetupScreenshot() {};
 
-  bool RenderCapture(CRenderCapture* capture);
+  virtual bool RenderCapture(CRenderCapture* capture);
 
   // Player functions
   virtual bool Configure(unsigned int width, unsigned int height, unsigned int d_width, unsigned int d_height, float fps, unsigned flags, ERenderFormat format, unsigned extended_formatl, unsigned int orientation);
@@ -140,6 +141,7 @@ public:
   virtual unsigned int GetMaxBufferSize() { return NUM_BUFFERS; }
   virtual unsigned int GetProcessorSize();
 
+  virtual void         AddProcessor(CDVDVideoCodecBuffer *codecinfo, int index);
 #ifdef HAVE_LIBVDPAU
   virtual void         AddProcessor(VDPAU::CVdpauRenderPicture* vdpau, int index);
 #endif
@@ -280,6 +282,9 @@ protected:
     unsigned  flipindex; /* used to decide if this has been uploaded */
     GLuint    pbo[MAX_PLANES];
 
+    // decoded frame uploaded in place of image, see AddProcessor
+    CDVDVideoCodecBuffer *codecinfo;
+
 #ifdef HAVE_LIBVDPAU
     VDPAU::CVdpauRenderPicture *vdpau;
 #endif
@@ -322,6 +322,10 @@ int CLinuxRendererGLES::GetImage(YV12Image *image, int source, bool readonly)
   else
     im.flags |= IMAGE_FLAG_WRITING;
 
+  // the picture is written to the image, not to a frame referenced before
+  if( !readonly && m_format == RENDER_FMT_YUV420P )
+    SAFE_RELEASE(m_buffers[source].codecinfo);
+
   // copy the image - should be operator of YV12Image
   for (int p=0;p<MAX_PLANES;p++)
   {
@@ -925,6 +929,8 @@ inline void CLinuxRendererGLES::ReorderDrawPoints()
 void CLinuxRendererGLES::ReleaseBuffer(int idx)
 {
   YUVBUFFER &buf = m_buffers[idx];
+  if (m_format == RENDER_FMT_YUV420P)
+    SAFE_RELEASE(buf.codecinfo);
 #ifdef HAVE_VIDEOTOOLBOXDECODER
   if (m_renderMethod & RENDER_CVREF )
   {
@@ -1792,6 +1798,19 @@ void CLinuxRendererGLES::UploadYV12Texture(int source)
     return;
   }
 
+  // planes of a frame referenced through AddProcessor take the place of the image
+  YV12Image referenced;
+  if (buf.codecinfo)
+  {
+    referenced = *im;
+    for (int i = 0; i < 3; i++)
+    {
+      referenced.plane[i]  = buf.codecinfo->data[i];
+      referenced.stride[i] = buf.codecinfo->iLineSize[i];
+    }
+    im = &referenced;
+  }
+
   // if we don't have a shader, fallback to SW YUV2RGB for now
   if (m_renderMethod & RENDER_SW)
   {
@@ -1915,6 +1934,8 @@ void CLinuxRendererGLES::UploadYV12Texture(int source)
 
 void CLinuxRendererGLES::DeleteYV12Texture(int index)
 {
+  SAFE_RELEASE(m_buffers[index].codecinfo);
+
   YV12Image &im     = m_buffers[index].image;
   YUVFIELDS &fields = m_buffers[index].fields;
 
@@ -0,0 +1,282 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+#include "OverlayGlyphCache.h"
+#include "OverlayRenderer.h"
+#include "RenderManager.h"
+#include "cores/dvdplayer/DVDClock.h"
+#include "cores/dvdplayer/DVDSubtitles/DVDSubtitlesLibass.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#include <algorithm>
+
+#if defined(HAS_GL) || defined(HAS_GLES)
+#include "OverlayRendererGL.h"
+#elif defined(HAS_DX)
+#include "OverlayRendererDX.h"
+#endif
+#if defined(HAS_GL)
+#include "OverlayRendererSW.h"
+#endif
+
+// frames rendered ahead, more than the render queue ever holds
+#define CACHE_FRAMES 32
+// memory for glyphs of frames not displayed yet
+#define CACHE_SIZE   (32 * 1024 * 1024)
+
+using namespace OVERLAY;
+
+CGlyphCache::SGlyphs::~SGlyphs()
+{
+  if (overlay)
+    overlay->Release();
+}
+
+bool CGlyphCache::SKey::operator==(const SKey& rhs) const
+{
+  return libass == rhs.libass
+      && ms     == rhs.ms
+      && width  == rhs.width
+      && height == rhs.height;
+}
+
+CGlyphCache::CGlyphCache()
+  : CThread("GlyphCache")
+{
+  m_size       = 0;
+  m_generation = 0;
+  m_lastKey    = MakeKey(NULL, 0.0, 0, 0);
+  m_lastRender = 0;
+}
+
+CGlyphCache::~CGlyphCache()
+{
+  StopThread();
+  Flush();
+}
+
+CGlyphCache::SKey CGlyphCache::MakeKey(CDVDSubtitlesLibass* libass, double pts, int width, int height)
+{
+  SKey key;
+  key.libass = libass;
+  key.pts    = pts;
+  key.ms     = DVD_TIME_TO_MSEC(pts);
+  key.width  = width;
+  key.height = height;
+  return key;
+}
+
+CGlyphCache::SGlyphsPtr CGlyphCache::Find(const SKey& key)
+{
+  for (std::list<SEntry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+  {
+    if (it->key == key)
+      return it->glyphs;
+  }
+  return SGlyphsPtr();
+}
+
+void CGlyphCache::Prepare(CDVDSubtitlesLibass* libass, double pts, int width, int height)
+{
+  if (width <= 0 || height <= 0)
+    return;
+
+  SKey key = MakeKey(libass, pts, width, height);
+
+  CSingleLock lock(m_section);
+  if (m_size > CACHE_SIZE
+  ||  m_entries.size() + m_pending.size() >= CACHE_FRAMES)
+    return;
+
+  if (Find(key) || std::find(m_pending.begin(), m_pending.end(), key) != m_pending.end())
+    return;
+
+  libass->Acquire();
+  m_pending.push_back(key);
+
+  if (!IsRunning())
+    Create();
+  m_event.Set();
+}
+
+COverlay* CGlyphCache::Get(CDVDSubtitlesLibass* libass, double pts, int width, int height)
+{
+  SKey key = MakeKey(libass, pts, width, height);
+  SGlyphsPtr glyphs;
+  std::list<SEntry> shown;
+
+  { CSingleLock lock(m_section);
+
+    // frames before this one won't be displayed anymore
+    for (std::list<SEntry>::iterator it = m_entries.begin(); it != m_entries.end();)
+    {
+      if (it->key.libass == libass && it->key.ms < key.ms)
+      {
+        m_size -= it->size;
+        shown.splice(shown.end(), m_entries, it++);
+      }
+      else
+        ++it;
+    }
+    for (std::deque<SKey>::iterator it = m_pending.begin(); it != m_pending.end();)
+    {
+      if (it->libass == libass && it->ms < key.ms)
+      {
+        it->libass->Release();
+        it = m_pending.erase(it);
+      }
+      else
+        ++it;
+    }
+
+    glyphs = Find(key);
+  }
+
+  for (std::list<SEntry>::iterator it = shown.begin(); it != shown.end(); ++it)
+    it->key.libass->Release();
+  shown.clear();
+
+  // not rendered ahead, the worker didn't keep up or the video size changed
+  if (!glyphs)
+    glyphs = Render(key);
+  if (!glyphs)
+    return NULL;
+
+  if (!glyphs->overlay)
+  {
+#if defined(HAS_GL)
+    if (g_renderManager.m_pSoftwareRenderer)
+      glyphs->overlay = new COverlayGlyphSW(glyphs->quads, width, height);
+    else
+#endif
+#if defined(HAS_GL) || defined(HAS_GLES)
+    glyphs->overlay = new COverlayGlyphGL(glyphs->quads, width, height);
+#elif defined(HAS_DX)
+    glyphs->overlay = new COverlayQuadsDX(glyphs->quads, width, height);
+#endif
+  }
+  return glyphs->overlay->Acquire();
+}
+
+CGlyphCache::SGlyphsPtr CGlyphCache::Render(const SKey& key)
+{
+  // released after the lock, an overlay may need the render manager for cleanup
+  SGlyphsPtr previous;
+  SGlyphsPtr glyphs;
+
+  CSingleLock lock(m_render);
+
+  unsigned int generation;
+  { CSingleLock lock2(m_section);
+    glyphs = Find(key);
+    if (glyphs)
+      return glyphs;
+    generation = m_generation;
+  }
+
+  size_t size = 0;
+  { // libass may also be rendered by the player, for subtitles blended into
+    // the picture. The images and changes are only ours until it renders again
+    CSingleLock lock3(key.libass->GetSection());
+    bool consecutive = m_lastKey.libass == key.libass
+                    && m_lastRender     == key.libass->GetRenderCount();
+
+    int changes = 0;
+    ASS_Image* images = key.libass->RenderImage(key.width, key.height, key.pts, &changes);
+    m_lastRender = key.libass->GetRenderCount();
+
+    if (changes == 0 && m_last && consecutive
+    &&  m_lastKey.width  == key.width
+    &&  m_lastKey.height == key.height)
+      glyphs = m_last;
+    else
+    {
+      glyphs.reset(new SGlyphs());
+      convert_quad(images, glyphs->quads);
+      size = glyphs->quads.size_x * glyphs->quads.size_y + glyphs->quads.count * sizeof(SQuad);
+    }
+  }
+
+  previous  = m_last;
+  m_last    = glyphs;
+  m_lastKey = key;
+
+  CSingleLock lock2(m_section);
+  if (generation == m_generation)
+  {
+    SEntry entry;
+    entry.key    = key;
+    entry.glyphs = glyphs;
+    entry.size   = size;
+    entry.key.libass->Acquire();
+    m_entries.push_back(entry);
+    m_size += size;
+  }
+  return glyphs;
+}
+
+void CGlyphCache::Process()
+{
+  while (!m_bStop)
+  {
+    if (!m_event.WaitMSec(100))
+      continue;
+
+    while (!m_bStop)
+    {
+      SKey key;
+      { CSingleLock lock(m_section);
+        if (m_pending.empty())
+          break;
+        key = m_pending.front();
+        m_pending.pop_front();
+      }
+
+      Render(key);
+      key.libass->Release();
+    }
+  }
+}
+
+void CGlyphCache::Flush()
+{
+  std::list<SEntry> entries;
+  std::deque<SKey>  pending;
+  SGlyphsPtr        last;
+
+  { CSingleLock lock(m_section);
+    entries.swap(m_entries);
+    pending.swap(m_pending);
+    m_size = 0;
+    m_generation++;
+  }
+
+  { CSingleLock lock(m_render);
+    last.swap(m_last);
+    m_lastKey = MakeKey(NULL, 0.0, 0, 0);
+  }
+
+  for (std::list<SEntry>::iterator it = entries.begin(); it != entries.end(); ++it)
+    it->key.libass->Release();
+  for (std::deque<SKey>::iterator it = pending.begin(); it != pending.end(); ++it)
+    it->libass->Release();
+}
@@ -0,0 +1,113 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <deque>
+#include <list>
+#include <boost/shared_ptr.hpp>
+
+#include "OverlayRendererUtil.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+
+class CDVDSubtitlesLibass;
+
+namespace OVERLAY {
+
+  class COverlay;
+
+  /*
+   * Subtitle frames rendered by libass ahead of display.
+   *
+   * Typesetting heavy ASS subtitles can take longer to render than a frame
+   * is shown, so frames are rendered on a worker thread as soon as the
+   * overlay is queued together with its video picture, and packed the way
+   * the overlay renderers upload them. The render thread then only has to
+   * create the texture, or for frames libass reports unchanged from the
+   * previous one not even that, as those share one set of glyphs.
+   *
+   * Frames are kept until a later one was displayed, within a memory budget.
+   */
+  class CGlyphCache
+    : private CThread
+  {
+  public:
+    CGlyphCache();
+    virtual ~CGlyphCache();
+
+    // render the frame at pts in the background, it will be displayed soon
+    void      Prepare(CDVDSubtitlesLibass* libass, double pts, int width, int height);
+
+    // overlay of the frame at pts, rendered now if it wasn't already
+    COverlay* Get(CDVDSubtitlesLibass* libass, double pts, int width, int height);
+
+    void      Flush();
+
+  protected:
+    virtual void Process();
+
+  private:
+    struct SGlyphs
+    {
+      SGlyphs() : overlay(NULL) {}
+      ~SGlyphs();
+      SQuads    quads;
+      COverlay* overlay; // created from quads on the render thread, quads are freed then
+    };
+    typedef boost::shared_ptr<SGlyphs> SGlyphsPtr;
+
+    struct SKey
+    {
+      CDVDSubtitlesLibass* libass;
+      double               pts;
+      int                  ms;
+      int                  width;
+      int                  height;
+      bool operator==(const SKey& rhs) const;
+    };
+
+    struct SEntry
+    {
+      SKey       key;
+      SGlyphsPtr glyphs;
+      size_t     size; // 0 for glyphs shared with the frame before
+    };
+
+    static SKey MakeKey(CDVDSubtitlesLibass* libass, double pts, int width, int height);
+
+    SGlyphsPtr Find(const SKey& key);
+    SGlyphsPtr Render(const SKey& key);
+
+    CCriticalSection  m_section;
+    std::deque<SKey>  m_pending;
+    std::list<SEntry> m_entries;
+    size_t            m_size;
+    unsigned int      m_generation; // increased on flush, frames rendered before are dropped
+    CEvent            m_event;
+
+    CCriticalSection  m_render;  // libass renders into memory of its own, one frame at a time
+    SKey              m_lastKey;
+    unsigned int      m_lastRender; // render count of its libass after m_last
+    SGlyphsPtr        m_last;
+  };
+
+}
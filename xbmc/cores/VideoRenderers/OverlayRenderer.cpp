@@ -42,6 +42,9 @@
 #elif defined(HAS_DX)
 #include "OverlayRendererDX.h"
 #endif
+#if defined(HAS_GL)
+#include "OverlayRendererSW.h"
+#endif
 
 using namespace OVERLAY;
 
@@ -109,6 +112,16 @@ void CRenderer::AddOverlay(CDVDOverlay* o, double pts, int index)
   e.pts = pts;
   e.overlay_dvd = o->Acquire();
   m_buffers[index].push_back(e);
+
+  /* typeset subtitles while the picture waits in the render queue */
+  if(o->IsOverlayType(DVDOVERLAY_TYPE_SSA))
+  {
+    CRect src, dst;
+    g_renderManager.GetVideoRect(src, dst);
+    m_glyphs.Prepare(((CDVDOverlaySSA*)o)->m_libass, pts
+                   , MathUtils::round_int(dst.Width())
+                   , MathUtils::round_int(dst.Height()));
+  }
 }
 
 void CRenderer::AddOverlay(COverlay* o, double pts, int index)
@@ -157,6 +170,7 @@ void CRenderer::Flush()
   for(int i = 0; i < NUM_BUFFERS; i++)
     Release(m_buffers[i]);
 
+  m_glyphs.Flush();
   Release(m_cleanup);
 }
 
@@ -288,21 +302,7 @@ COverlay* CRenderer::Convert(CDVDOverlaySSA* o, double pts)
   int width  = MathUtils::round_int(dst.Width());
   int height = MathUtils::round_int(dst.Height());
 
-  int changes = 0;
-  ASS_Image* images = o->m_libass->RenderImage(width, height, pts, &changes);
-
-  if(o->m_overlay)
-  {
-    if(changes == 0)
-      return o->m_overlay->Acquire();
-  }
-
-#if defined(HAS_GL) || defined(HAS_GLES)
-  return new COverlayGlyphGL(images, width, height);
-#elif defined(HAS_DX)
-  return new COverlayQuadsDX(images, width, height);
-#endif
-  return NULL;
+  return m_glyphs.Get(o->m_libass, pts, width, height);
 }
 
 
@@ -323,6 +323,17 @@ COverlay* CRenderer::Convert(CDVDOverlay* o, double pts)
     return r;
   }
 
+#if defined(HAS_GL)
+  // the software renderer blends overlays into the picture it shows
+  if (g_renderManager.m_pSoftwareRenderer)
+  {
+    if     (o->IsOverlayType(DVDOVERLAY_TYPE_IMAGE))
+      r = new COverlayImageSW((CDVDOverlayImage*)o);
+    else if(o->IsOverlayType(DVDOVERLAY_TYPE_SPU))
+      r = new COverlayImageSW((CDVDOverlaySpu*)o);
+  }
+  else
+#endif
 #if defined(HAS_GL) || defined(HAS_GLES)
   if     (o->IsOverlayType(DVDOVERLAY_TYPE_IMAGE))
     r = new COverlayTextureGL((CDVDOverlayImage*)o);
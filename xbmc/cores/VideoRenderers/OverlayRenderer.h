@@ -23,6 +23,7 @@
 
 #include "threads/CriticalSection.h"
 #include "BaseRenderer.h"
+#include "OverlayGlyphCache.h"
 
 #include <vector>
 
@@ -129,5 +130,6 @@ namespace OVERLAY {
     SElementV        m_buffers[NUM_BUFFERS];
 
     COverlayV        m_cleanup;
+    CGlyphCache      m_glyphs;
   };
 }
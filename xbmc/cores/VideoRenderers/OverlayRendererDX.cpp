@@ -159,7 +159,7 @@ static bool LoadTexture(int width, int height, int stride
   return true;
 }
 
-COverlayQuadsDX::COverlayQuadsDX(ASS_Image* images, int width, int height)
+COverlayQuadsDX::COverlayQuadsDX(const SQuads& quads, int width, int height)
 {
   m_width  = 1.0;
   m_height = 1.0;
@@ -170,8 +170,7 @@ COverlayQuadsDX::COverlayQuadsDX(ASS_Image* images, int width, int height)
   m_count  = 0;
   m_fvf    = D3DFVF_XYZ | D3DFVF_DIFFUSE | D3DFVF_TEX1;
 
-  SQuads quads;
-  if(!convert_quad(images, quads))
+  if(quads.count == 0)
     return;
   
   float u, v;
@@ -38,7 +38,7 @@ namespace OVERLAY {
     : public COverlayMainThread
   {
   public:
-    COverlayQuadsDX(ASS_Image* images, int width, int height);
+    COverlayQuadsDX(const SQuads& quads, int width, int height);
     virtual ~COverlayQuadsDX();
 
     void Render(SRenderState& state);
@@ -22,6 +22,7 @@
 #pragma once
 #include "system_gl.h"
 #include "OverlayRenderer.h"
+#include "OverlayRendererUtil.h"
 
 class CDVDOverlay;
 class CDVDOverlayImage;
@@ -53,7 +54,7 @@ namespace OVERLAY {
      : public COverlayMainThread
   {
   public:
-   COverlayGlyphGL(ASS_Image* images, int width, int height);
+   COverlayGlyphGL(const SQuads& quads, int width, int height);
 
    virtual ~COverlayGlyphGL();
 
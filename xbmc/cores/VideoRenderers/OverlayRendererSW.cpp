@@ -0,0 +1,277 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+#include <algorithm>
+
+#include "OverlayRenderer.h"
+#include "OverlayRendererUtil.h"
+#include "OverlayRendererSW.h"
+#include "RenderManager.h"
+#include "cores/dvdplayer/DVDCodecs/Overlay/DVDOverlayImage.h"
+#include "cores/dvdplayer/DVDCodecs/Overlay/DVDOverlaySpu.h"
+#include "cores/dvdplayer/DVDCodecs/Overlay/DVDOverlaySSA.h"
+#include "utils/MathUtils.h"
+#include "utils/YUVScaler.h"
+#include "utils/log.h"
+
+#if defined(HAS_GL)
+
+#include "SoftwareRenderer.h"
+
+using namespace OVERLAY;
+
+static uint32_t Premultiply(uint32_t c)
+{
+  uint32_t a = c >> 24;
+  uint32_t r = ((c >> 16) & 0xff) * a / 255;
+  uint32_t g = ((c >>  8) & 0xff) * a / 255;
+  uint32_t b = ( c        & 0xff) * a / 255;
+  return (a << 24) | (r << 16) | (g << 8) | b;
+}
+
+COverlaySW::COverlaySW()
+{
+  m_pixelWidth  = 0;
+  m_pixelHeight = 0;
+}
+
+void COverlaySW::Blend(const CRect &dest)
+{
+  if (m_pixels.empty())
+    return;
+
+  CSoftwareRenderer *renderer = g_renderManager.m_pSoftwareRenderer;
+  if (!renderer)
+    return;
+
+  int width, height, stride;
+  uint8_t *surface = renderer->GetSurface(width, height, stride);
+  if (!surface)
+    return;
+
+  int dx0 = MathUtils::round_int(dest.x1);
+  int dy0 = MathUtils::round_int(dest.y1);
+  int dw  = MathUtils::round_int(dest.Width());
+  int dh  = MathUtils::round_int(dest.Height());
+  if (dw <= 0 || dh <= 0)
+    return;
+
+  int x0 = std::max(0, dx0);
+  int y0 = std::max(0, dy0);
+  int x1 = std::min(width,  dx0 + dw);
+  int y1 = std::min(height, dy0 + dh);
+  if (x0 >= x1 || y0 >= y1)
+    return;
+
+  // subtitles are only scaled by small amounts, nearest is good enough
+  std::vector<int> cols(x1 - x0);
+  for (int x = x0; x < x1; x++)
+    cols[x - x0] = (int)((int64_t)(x - dx0) * m_pixelWidth / dw);
+
+  std::vector<uint32_t> row(x1 - x0);
+  for (int y = y0; y < y1; y++)
+  {
+    const uint32_t *src = &m_pixels[(int64_t)(y - dy0) * m_pixelHeight / dh * m_pixelWidth];
+    for (int x = 0; x < x1 - x0; x++)
+      row[x] = src[cols[x]];
+    CYUVScaler::BlendPremultiplied(surface + y * stride + x0 * 4, (const uint8_t*)&row[0], x1 - x0);
+  }
+
+  renderer->PresentSurface(CRect((float)x0, (float)y0, (float)x1, (float)y1));
+}
+
+COverlayImageSW::COverlayImageSW(CDVDOverlayImage* o)
+{
+  uint32_t* rgba;
+  int stride;
+  if(o->palette)
+  {
+    rgba   = convert_rgba(o, true);
+    stride = o->width * 4;
+  }
+  else
+  {
+    rgba   = (uint32_t*)o->data;
+    stride = o->linesize;
+  }
+
+  if(!rgba)
+  {
+    CLog::Log(LOGERROR, "COverlayImageSW::COverlayImageSW - failed to convert overlay to rgb");
+    return;
+  }
+
+  m_pixelWidth  = o->width;
+  m_pixelHeight = o->height;
+  m_pixels.resize(m_pixelWidth * m_pixelHeight);
+  for (int y = 0; y < m_pixelHeight; y++)
+  {
+    const uint32_t *src = (const uint32_t*)((const uint8_t*)rgba + y * stride);
+    uint32_t       *dst = &m_pixels[y * m_pixelWidth];
+    for (int x = 0; x < m_pixelWidth; x++)
+      dst[x] = o->palette ? src[x] : Premultiply(src[x]);
+  }
+
+  if((BYTE*)rgba != o->data)
+    free(rgba);
+
+  if(o->source_width && o->source_height)
+  {
+    /* render aligned to screen to avoid cropping problems */
+    m_width  = (float)o->width  / o->source_width;
+    m_height = (float)o->height / o->source_height;
+    m_pos    = POSITION_RELATIVE;
+    m_align  = ALIGN_SCREEN;
+    m_x      = (float)(0.5f * o->width  + o->x) / o->source_width;
+    m_y      = (float)(0.5f * o->height + o->y) / o->source_height;
+  }
+  else
+  {
+    m_align  = ALIGN_VIDEO;
+    m_pos    = POSITION_ABSOLUTE;
+    m_x      = (float)o->x;
+    m_y      = (float)o->y;
+    m_width  = (float)o->width;
+    m_height = (float)o->height;
+  }
+}
+
+COverlayImageSW::COverlayImageSW(CDVDOverlaySpu* o)
+{
+  int min_x, max_x, min_y, max_y;
+  uint32_t* rgba = convert_rgba(o, true
+                              , min_x, max_x, min_y, max_y);
+
+  if(!rgba)
+  {
+    CLog::Log(LOGERROR, "COverlayImageSW::COverlayImageSW - failed to convert overlay to rgb");
+    return;
+  }
+
+  m_pixelWidth  = max_x - min_x;
+  m_pixelHeight = max_y - min_y;
+  m_pixels.resize(m_pixelWidth * m_pixelHeight);
+  for (int y = 0; y < m_pixelHeight; y++)
+    memcpy(&m_pixels[y * m_pixelWidth], rgba + min_x + (min_y + y) * o->width, m_pixelWidth * 4);
+
+  free(rgba);
+
+  m_align  = ALIGN_VIDEO;
+  m_pos    = POSITION_ABSOLUTE;
+  m_x      = (float)(min_x + o->x);
+  m_y      = (float)(min_y + o->y);
+  m_width  = (float)(max_x - min_x);
+  m_height = (float)(max_y - min_y);
+}
+
+void COverlayImageSW::Render(SRenderState& state)
+{
+  CRect rd;
+  if(m_pos == POSITION_RELATIVE)
+    rd.SetRect(state.x - state.width  * 0.5f, state.y - state.height * 0.5f,
+               state.x + state.width  * 0.5f, state.y + state.height * 0.5f);
+  else
+    rd.SetRect(state.x, state.y, state.x + state.width, state.y + state.height);
+
+  Blend(rd);
+}
+
+COverlayGlyphSW::COverlayGlyphSW(const SQuads& quads, int width, int height)
+{
+  m_width  = 1.0;
+  m_height = 1.0;
+  m_align  = ALIGN_VIDEO;
+  m_pos    = POSITION_RELATIVE;
+  m_x      = 0.0f;
+  m_y      = 0.0f;
+
+  m_frameWidth  = width;
+  m_frameHeight = height;
+  m_left = m_top = 0;
+
+  // only the part of the frame with glyphs is kept
+  int x0 = width, y0 = height, x1 = 0, y1 = 0;
+  for (int i = 0; i < quads.count; i++)
+  {
+    const SQuad& q = quads.quad[i];
+    x0 = std::min(x0, q.x);
+    y0 = std::min(y0, q.y);
+    x1 = std::max(x1, q.x + q.w);
+    y1 = std::max(y1, q.y + q.h);
+  }
+  x0 = std::max(x0, 0);
+  y0 = std::max(y0, 0);
+  x1 = std::min(x1, width);
+  y1 = std::min(y1, height);
+  if (x0 >= x1 || y0 >= y1)
+    return;
+
+  m_left        = x0;
+  m_top         = y0;
+  m_pixelWidth  = x1 - x0;
+  m_pixelHeight = y1 - y0;
+  m_pixels.assign(m_pixelWidth * m_pixelHeight, 0);
+
+  // glyphs are coverage masks in a single colour, later ones on top
+  for (int i = 0; i < quads.count; i++)
+  {
+    const SQuad& q = quads.quad[i];
+    uint32_t alpha = q.a;
+
+    for (int y = std::max(q.y, y0); y < std::min(q.y + q.h, y1); y++)
+    {
+      const uint8_t *mask = quads.data + (q.v + y - q.y) * quads.size_x + q.u - q.x;
+      uint32_t      *dst  = &m_pixels[(y - y0) * m_pixelWidth] - x0;
+      for (int x = std::max(q.x, x0); x < std::min(q.x + q.w, x1); x++)
+      {
+        uint32_t k = mask[x] * alpha / 255;
+        if (k == 0)
+          continue;
+
+        uint32_t d  = dst[x];
+        uint32_t ik = 255 - k;
+        uint32_t da = (d >> 24)         * ik / 255 + k;
+        uint32_t dr = ((d >> 16) & 0xff) * ik / 255 + q.r * k / 255;
+        uint32_t dg = ((d >>  8) & 0xff) * ik / 255 + q.g * k / 255;
+        uint32_t db = ( d        & 0xff) * ik / 255 + q.b * k / 255;
+        dst[x] = (da << 24) | (dr << 16) | (dg << 8) | db;
+      }
+    }
+  }
+}
+
+void COverlayGlyphSW::Render(SRenderState& state)
+{
+  if (m_frameWidth <= 0 || m_frameHeight <= 0)
+    return;
+
+  // state covers the whole libass frame
+  float scale_x = state.width  / m_frameWidth;
+  float scale_y = state.height / m_frameHeight;
+
+  CRect rd(state.x + m_left * scale_x,
+           state.y + m_top  * scale_y,
+           state.x + (m_left + m_pixelWidth)  * scale_x,
+           state.y + (m_top  + m_pixelHeight) * scale_y);
+  Blend(rd);
+}
+
+#endif
@@ -0,0 +1,80 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+#include "OverlayRenderer.h"
+#include "OverlayRendererUtil.h"
+#include "guilib/Geometry.h"
+
+class CDVDOverlay;
+class CDVDOverlayImage;
+class CDVDOverlaySpu;
+class CDVDOverlaySSA;
+
+#if defined(HAS_GL)
+
+namespace OVERLAY {
+
+  /* premultiplied BGRA picture, blended into the surface of the software renderer
+     and shown again with it */
+  class COverlaySW
+      : public COverlayMainThread
+  {
+  public:
+    COverlaySW();
+
+  protected:
+    // scales the picture to dest, in surface pixels, and blends it
+    void Blend(const CRect &dest);
+
+    std::vector<uint32_t> m_pixels;
+    int m_pixelWidth;
+    int m_pixelHeight;
+  };
+
+  class COverlayImageSW
+      : public COverlaySW
+  {
+  public:
+     COverlayImageSW(CDVDOverlayImage* o);
+     COverlayImageSW(CDVDOverlaySpu* o);
+
+    void Render(SRenderState& state);
+  };
+
+  class COverlayGlyphSW
+      : public COverlaySW
+  {
+  public:
+    COverlayGlyphSW(const SQuads& quads, int width, int height);
+
+    void Render(SRenderState& state);
+
+  protected:
+    // part of the video covered by the glyphs, in pixels of the libass frame
+    int m_left;
+    int m_top;
+    int m_frameWidth;
+    int m_frameHeight;
+  };
+
+}
+
+#endif
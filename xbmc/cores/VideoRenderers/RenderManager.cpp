@@ -41,6 +41,7 @@
 
 #if defined(HAS_GL)
   #include "LinuxRendererGL.h"
+  #include "SoftwareRenderer.h"
 #elif HAS_GLES == 2
   #include "LinuxRendererGLES.h"
 #elif defined(HAS_DX)
@@ -98,6 +99,9 @@ static void requeue(std::deque<int> &trg, std::deque<int> &src)
 CXBMCRenderManager::CXBMCRenderManager()
 {
   m_pRenderer = NULL;
+#if defined(HAS_GL)
+  m_pSoftwareRenderer = NULL;
+#endif
   m_bIsStarted = false;
 
   m_presentstep = PRESENT_IDLE;
@@ -119,6 +123,9 @@ CXBMCRenderManager::~CXBMCRenderManager()
 {
   delete m_pRenderer;
   m_pRenderer = NULL;
+#if defined(HAS_GL)
+  m_pSoftwareRenderer = NULL;
+#endif
 }
 
 void CXBMCRenderManager::GetVideoRect(CRect &source, CRect &dest)
@@ -288,6 +295,8 @@ bool CXBMCRenderManager::Configure(unsigned int width, unsigned int height, unsi
 
     m_firstFlipPage = false;  // tempfix
 
+    m_timeline.Reset(g_advancedSettings.m_videoRenderTrace ? "special://temp/rendertrace.csv" : "");
+
     CLog::Log(LOGDEBUG, "CXBMCRenderManager::Configure - %d", m_QueueSize);
   }
 
@@ -376,6 +385,9 @@ void CXBMCRenderManager::FrameFinish()
   if(g_graphicsContext.IsFullScreenVideo())
     WaitPresentTime(m.timestamp);
 
+  if(!g_application.m_pPlayer->IsPausedPlayback())
+    m_timeline.Displayed(GetPresentTime());
+
   { CSingleLock lock(m_presentlock);
 
     if(m_presentstep == PRESENT_FRAME)
@@ -413,7 +425,13 @@ unsigned int CXBMCRenderManager::PreInit()
   if (!m_pRenderer)
   {
 #if defined(HAS_GL)
-    m_pRenderer = new CLinuxRendererGL();
+    if (g_advancedSettings.m_videoSoftwareRenderer)
+    { // cpu scaling and blending, the surface is still shown through GL
+      CLog::Log(LOGNOTICE, "CXBMCRenderManager::PreInit - rendering video on the cpu");
+      m_pRenderer = m_pSoftwareRenderer = new CSoftwareRenderer();
+    }
+    else
+      m_pRenderer = new CLinuxRendererGL();
 #elif HAS_GLES == 2
     m_pRenderer = new CLinuxRendererGLES();
 #elif defined(HAS_DX)
@@ -438,6 +456,7 @@ void CXBMCRenderManager::UnInit()
   m_bIsStarted = false;
 
   m_overlays.Flush();
+  m_timeline.Reset();
   g_fontManager.Unload("__subtitle__");
   g_fontManager.Unload("__subtitleborder__");
 
@@ -695,6 +714,7 @@ void CXBMCRenderManager::FlipPage(volatile bool& bStop, double timestamp /* = 0L
     m.timestamp     = timestamp;
     m.presentfield  = sync;
     m.presentmethod = presentmethod;
+    m_timeline.Queued(source, GetPresentTime(), timestamp, m_queued.size());
     requeue(m_queued, m_free);
 
     /* signal to any waiters to check state */
@@ -878,7 +898,10 @@ int CXBMCRenderManager::AddVideoPicture(DVDVideoPicture& pic)
   }
 
   if(m_pRenderer->AddVideoPicture(&pic, index))
+  {
+    m_timeline.Added(index, GetPresentTime());
     return 1;
+  }
 
   YV12Image image;
   if (m_pRenderer->GetImage(&image, index) < 0)
@@ -888,7 +911,13 @@ int CXBMCRenderManager::AddVideoPicture(DVDVideoPicture& pic)
   || pic.format == RENDER_FMT_YUV420P10
   || pic.format == RENDER_FMT_YUV420P16)
   {
-    CDVDCodecUtils::CopyPicture(&image, &pic);
+#if defined(HAS_GL) || HAS_GLES == 2
+    // pooled frames are referenced by the renderer instead of copied
+    if(pic.format == RENDER_FMT_YUV420P && pic.codecinfo)
+      m_pRenderer->AddProcessor(pic.codecinfo, index);
+    else
+#endif
+      CDVDCodecUtils::CopyPicture(&image, &pic);
   }
   else if(pic.format == RENDER_FMT_NV12)
   {
@@ -934,6 +963,7 @@ int CXBMCRenderManager::AddVideoPicture(DVDVideoPicture& pic)
 #endif
 
   m_pRenderer->ReleaseImage(index, false);
+  m_timeline.Added(index, GetPresentTime());
 
   return index;
 }
@@ -996,6 +1026,8 @@ EINTERLACEMETHOD CXBMCRenderManager::AutoInterlaceMethodInternal(EINTERLACEMETHO
 
 int CXBMCRenderManager::WaitForBuffer(volatile bool& bStop, int timeout)
 {
+  m_timeline.Decoded(GetPresentTime());
+
   CSingleLock lock2(m_presentlock);
 
   XbmcThreads::EndTime endtime(timeout);
@@ -1061,7 +1093,9 @@ void CXBMCRenderManager::PrepareNextRender()
     {
       requeue(m_discard, m_queued);
       m_QueueSkip++;
+      m_timeline.Dropped(RENDER_DROP_LATE, clocktime);
     }
+    m_timeline.Presented(idx, clocktime);
 
     m_presentstep   = PRESENT_FLIP;
     m_discard.push_back(m_presentsource);
@@ -1077,7 +1111,10 @@ void CXBMCRenderManager::DiscardBuffer()
   CSingleLock lock2(m_presentlock);
 
   while(!m_queued.empty())
+  {
     requeue(m_discard, m_queued);
+    m_timeline.Dropped(RENDER_DROP_FLUSH, GetPresentTime());
+  }
 
   if(m_presentstep == PRESENT_READY)
     m_presentstep   = PRESENT_IDLE;
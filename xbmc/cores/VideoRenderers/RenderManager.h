@@ -29,6 +29,7 @@
 #include "threads/Thread.h"
 #include "settings/VideoSettings.h"
 #include "OverlayRenderer.h"
+#include "RenderTimeline.h"
 #include <deque>
 #include "PlatformDefs.h"
 
@@ -43,6 +44,7 @@ struct DVDVideoPicture;
 
 class CWinRenderer;
 class CLinuxRenderer;
+class CSoftwareRenderer;
 class CLinuxRendererGL;
 class CLinuxRendererGLES;
 
@@ -127,6 +129,17 @@ public:
   double GetDisplayLatency() { return m_displayLatency; }
   int    GetSkippedFrames()  { return m_QueueSkip; }
 
+  /**
+   * Called by video player for every frame it drops before it reaches the renderer
+   */
+  void AddDroppedFrame() { m_timeline.Dropped(RENDER_DROP_DECODER, GetPresentTime()); }
+
+  /**
+   * Statistics of the frame timeline, see CRenderTimeline
+   * @param reset start collecting anew after these
+   */
+  void GetRenderStatistics(SRenderStatistics &stats, bool reset = false) { m_timeline.GetStatistics(stats, reset); }
+
   bool Supports(ERENDERFEATURE feature);
   bool Supports(EDEINTERLACEMODE method);
   bool Supports(EINTERLACEMETHOD method);
@@ -145,6 +158,7 @@ public:
 
 #ifdef HAS_GL
   CLinuxRendererGL    *m_pRenderer;
+  CSoftwareRenderer   *m_pSoftwareRenderer; // same as m_pRenderer when rendering on the cpu
 #elif HAS_GLES == 2
   CLinuxRendererGLES  *m_pRenderer;
 #elif defined(HAS_DX)
@@ -245,6 +259,7 @@ protected:
 
 
   OVERLAY::CRenderer m_overlays;
+  CRenderTimeline    m_timeline;
 
   void RenderCapture(CRenderCapture* capture);
   void RemoveCapture(CRenderCapture* capture);
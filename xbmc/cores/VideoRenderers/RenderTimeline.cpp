@@ -0,0 +1,254 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RenderTimeline.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+// frames kept for the statistics, about a minute at 30fps
+#define HISTORY_SIZE     2048
+// trace lines buffered before they are written
+#define TRACE_BATCH      64
+
+static const char* const DropNames[RENDER_DROP_MAX] = { "late", "flush", "decoder" };
+
+static void Distribution(std::vector<double> &values, SRenderDistribution &dist)
+{
+  memset(&dist, 0, sizeof(dist));
+  if (values.empty())
+    return;
+
+  double sum = 0.0;
+  for (std::vector<double>::const_iterator it = values.begin(); it != values.end(); ++it)
+    sum += *it;
+  dist.mean = sum / values.size();
+
+  // nth_element leaves everything above the nth in the back, so go up
+  size_t last = values.size() - 1;
+  size_t idx[3] = { last / 2, last * 95 / 100, last * 99 / 100 };
+  double* out[3] = { &dist.median, &dist.p95, &dist.p99 };
+  std::vector<double>::iterator begin = values.begin();
+  for (int i = 0; i < 3; i++)
+  {
+    std::nth_element(begin, values.begin() + idx[i], values.end());
+    *out[i] = values[idx[i]];
+    begin = values.begin() + idx[i];
+  }
+  dist.max = *std::max_element(begin, values.end());
+}
+
+CRenderTimeline::CRenderTimeline()
+{
+  m_tracing = false;
+  m_traceLines = 0;
+  Reset();
+}
+
+CRenderTimeline::~CRenderTimeline()
+{
+  CloseTrace();
+}
+
+void CRenderTimeline::Reset(const std::string &traceFile)
+{
+  CSingleLock lock(m_section);
+
+  LogStatistics();
+  CloseTrace();
+
+  memset(m_frames, 0, sizeof(m_frames));
+  memset(m_dropped, 0, sizeof(m_dropped));
+  m_current = -1;
+  m_decoded = 0.0;
+  m_history.clear();
+  m_next = 0;
+
+  if (!traceFile.empty())
+  {
+    m_tracing = m_trace.OpenForWrite(traceFile, true);
+    if (m_tracing)
+      WriteTrace("event,decoded,added,queued,target,presented,displayed,vsyncs,queue\n");
+    else
+      CLog::Log(LOGERROR, "CRenderTimeline::Reset - unable to open trace file %s", traceFile.c_str());
+  }
+}
+
+void CRenderTimeline::Decoded(double time)
+{
+  CSingleLock lock(m_section);
+  m_decoded = time;
+}
+
+void CRenderTimeline::Added(int index, double time)
+{
+  CSingleLock lock(m_section);
+  SFrame &f = m_frames[index];
+  memset(&f, 0, sizeof(f));
+  f.decoded = m_decoded > 0.0 ? m_decoded : time;
+  f.added   = time;
+  m_decoded = 0.0;
+}
+
+void CRenderTimeline::Queued(int index, double time, double target, int queueDepth)
+{
+  CSingleLock lock(m_section);
+  SFrame &f = m_frames[index];
+  f.queued     = time;
+  f.target     = target;
+  f.queueDepth = queueDepth;
+}
+
+void CRenderTimeline::Presented(int index, double time)
+{
+  CSingleLock lock(m_section);
+
+  // the frame on screen until now is done
+  if (m_current >= 0 && m_frames[m_current].vsyncs > 0)
+    Complete(m_frames[m_current]);
+
+  m_current = index;
+  m_frames[index].presented = time;
+  m_frames[index].vsyncs    = 0;
+}
+
+void CRenderTimeline::Displayed(double time)
+{
+  CSingleLock lock(m_section);
+  if (m_current < 0)
+    return;
+
+  SFrame &f = m_frames[m_current];
+  if (f.vsyncs == 0)
+    f.displayed = time;
+  f.vsyncs++;
+}
+
+void CRenderTimeline::Dropped(ERENDERDROP cause, double time)
+{
+  CSingleLock lock(m_section);
+  m_dropped[cause]++;
+
+  if (m_tracing)
+    WriteTrace(StringUtils::Format("drop-%s,,,,,,%.6f,,\n", DropNames[cause], time));
+}
+
+void CRenderTimeline::Complete(const SFrame &frame)
+{
+  if (m_history.size() < HISTORY_SIZE)
+    m_history.push_back(frame);
+  else
+    m_history[m_next] = frame;
+  m_next = (m_next + 1) % HISTORY_SIZE;
+
+  if (m_tracing)
+    WriteTrace(StringUtils::Format("frame,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%d,%d\n",
+                                   frame.decoded, frame.added, frame.queued, frame.target,
+                                   frame.presented, frame.displayed, frame.vsyncs, frame.queueDepth));
+}
+
+void CRenderTimeline::GetStatistics(SRenderStatistics &stats, bool reset)
+{
+  CSingleLock lock(m_section);
+
+  memset(&stats, 0, sizeof(stats));
+  memcpy(stats.dropped, m_dropped, sizeof(stats.dropped));
+
+  std::vector<double> presentError, jitter, bufferWait, queueWait, latency;
+  size_t count = m_history.size();
+  size_t first = count < HISTORY_SIZE ? 0 : m_next;
+  double queueDepth = 0.0;
+  double lastError  = 0.0;
+
+  for (size_t i = 0; i < count; i++)
+  {
+    const SFrame &f = m_history[(first + i) % count];
+    double error = (f.displayed - f.target) * 1000.0;
+
+    presentError.push_back(error);
+    if (i > 0)
+      jitter.push_back(fabs(error - lastError));
+    bufferWait.push_back((f.added     - f.decoded) * 1000.0);
+    queueWait.push_back ((f.presented - f.queued ) * 1000.0);
+    latency.push_back   ((f.displayed - f.decoded) * 1000.0);
+
+    stats.repeated += f.vsyncs - 1;
+    queueDepth     += f.queueDepth;
+    lastError       = error;
+  }
+
+  stats.frames     = count;
+  stats.queueDepth = count ? queueDepth / count : 0.0;
+  Distribution(presentError, stats.presentError);
+  Distribution(jitter,       stats.jitter);
+  Distribution(bufferWait,   stats.bufferWait);
+  Distribution(queueWait,    stats.queueWait);
+  Distribution(latency,      stats.latency);
+
+  if (reset)
+  {
+    m_history.clear();
+    m_next = 0;
+    memset(m_dropped, 0, sizeof(m_dropped));
+  }
+}
+
+void CRenderTimeline::LogStatistics()
+{
+  if (m_history.empty())
+    return;
+
+  SRenderStatistics stats;
+  GetStatistics(stats);
+  CLog::Log(LOGDEBUG, "CRenderTimeline - %u frames, %u repeated vsyncs, dropped %u late %u flushed %u by decoder"
+                      ", present error median %.2fms, jitter p95 %.2fms max %.2fms",
+            stats.frames, stats.repeated,
+            stats.dropped[RENDER_DROP_LATE], stats.dropped[RENDER_DROP_FLUSH], stats.dropped[RENDER_DROP_DECODER],
+            stats.presentError.median, stats.jitter.p95, stats.jitter.max);
+}
+
+void CRenderTimeline::WriteTrace(const std::string &line)
+{
+  // written in batches, the render thread shouldn't wait on the disk every frame
+  m_traceBuffer += line;
+  if (++m_traceLines < TRACE_BATCH)
+    return;
+
+  m_trace.Write(m_traceBuffer.c_str(), m_traceBuffer.size());
+  m_traceBuffer.clear();
+  m_traceLines = 0;
+}
+
+void CRenderTimeline::CloseTrace()
+{
+  if (!m_tracing)
+    return;
+
+  if (!m_traceBuffer.empty())
+    m_trace.Write(m_traceBuffer.c_str(), m_traceBuffer.size());
+  m_trace.Close();
+  m_traceBuffer.clear();
+  m_traceLines = 0;
+  m_tracing = false;
+}
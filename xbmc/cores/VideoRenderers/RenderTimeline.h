@@ -0,0 +1,121 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string>
+#include <vector>
+
+#include "BaseRenderer.h"
+#include "filesystem/File.h"
+#include "threads/CriticalSection.h"
+
+enum ERENDERDROP
+{
+  RENDER_DROP_LATE = 0, // skipped in the render queue, a later frame was due already
+  RENDER_DROP_FLUSH,    // discarded from the render queue on flush
+  RENDER_DROP_DECODER,  // dropped by the player before it reached the renderer
+  RENDER_DROP_MAX
+};
+
+struct SRenderDistribution
+{
+  double mean;
+  double median;
+  double p95;
+  double p99;
+  double max;
+};
+
+/* statistics of the frames displayed recently, times are in milliseconds */
+struct SRenderStatistics
+{
+  unsigned int frames;                   // frames displayed
+  unsigned int repeated;                 // vsyncs frames were displayed for beyond their first
+  unsigned int dropped[RENDER_DROP_MAX]; // frames dropped since the last reset, by cause
+  double       queueDepth;               // average frames queued ahead when a frame was queued
+  SRenderDistribution presentError;      // first vsync of a frame minus its target time
+  SRenderDistribution jitter;            // change of the present error from one frame to the next
+  SRenderDistribution bufferWait;        // decoded until a render buffer was free
+  SRenderDistribution queueWait;         // queued until picked for display
+  SRenderDistribution latency;           // decoded until displayed
+};
+
+/*
+ * Timeline of the frames passing through the render manager, the times a
+ * frame was decoded, added to a buffer, queued, picked for display and
+ * first displayed, and the number of vsyncs it stayed on screen.
+ *
+ * The last frames are kept to calculate statistics on demand. If a trace
+ * file is given every frame and drop is written to it as well, for offline
+ * analysis of judder.
+ *
+ * Times are in seconds of CXBMCRenderManager::GetPresentTime().
+ */
+class CRenderTimeline
+{
+public:
+  CRenderTimeline();
+  ~CRenderTimeline();
+
+  /* start a new timeline, logs the statistics of the previous one */
+  void Reset(const std::string &traceFile = "");
+
+  void Decoded(double time);
+  void Added(int index, double time);
+  void Queued(int index, double time, double target, int queueDepth);
+  void Presented(int index, double time);
+  void Displayed(double time);
+  void Dropped(ERENDERDROP cause, double time);
+
+  void GetStatistics(SRenderStatistics &stats, bool reset = false);
+
+private:
+  struct SFrame
+  {
+    double decoded;
+    double added;
+    double queued;
+    double target;
+    double presented;
+    double displayed;
+    int    vsyncs;
+    int    queueDepth;
+  };
+
+  void Complete(const SFrame &frame);
+  void LogStatistics();
+  void WriteTrace(const std::string &line);
+  void CloseTrace();
+
+  CCriticalSection    m_section;
+  SFrame              m_frames[NUM_BUFFERS];
+  int                 m_current;  // buffer of the frame on screen
+  double              m_decoded;  // decode time of the frame about to be added
+
+  std::vector<SFrame> m_history;  // ring of completed frames
+  unsigned int        m_next;
+  unsigned int        m_dropped[RENDER_DROP_MAX];
+
+  XFILE::CFile        m_trace;
+  bool                m_tracing;
+  std::string         m_traceBuffer;
+  unsigned int        m_traceLines;
+};
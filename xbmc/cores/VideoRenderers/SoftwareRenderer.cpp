@@ -0,0 +1,778 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+#include <algorithm>
+#include <new>
+
+#if defined(HAS_GL)
+
+#include "SoftwareRenderer.h"
+#include "RenderCapture.h"
+#include "guilib/GraphicContext.h"
+#include "settings/AdvancedSettings.h"
+#include "settings/DisplaySettings.h"
+#include "settings/MediaSettings.h"
+#include "threads/Event.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/CPUInfo.h"
+#include "utils/GLUtils.h"
+#include "utils/log.h"
+#include "utils/MathUtils.h"
+#include "utils/TimeUtils.h"
+#include "windowing/WindowingFactory.h"
+#include "cores/dvdplayer/DVDCodecs/Video/DVDVideoCodecInfo.h"
+
+// at most this many threads render slices of a picture
+#define MAX_SLICES     8
+// a picture is only split if every slice gets at least this many rows
+#define MIN_SLICE_ROWS 64
+// render times are logged every that many pictures
+#define STATS_INTERVAL 1000
+
+struct SSliceJob
+{
+  const CYUVScaler *scaler;
+  uint8_t          *src[3];
+  int               srcStride[3];
+  uint8_t          *dst;
+  int               dstStride;
+  int               x0, y0, x1, y1;
+
+  void Run() const
+  {
+    scaler->Scale(src, srcStride, dst, dstStride, x0, y0, x1, y1);
+  }
+};
+
+// renders one slice of rows each time it is started
+class CSoftwareRenderSlice : public CThread
+{
+public:
+  CSoftwareRenderSlice() : CThread("SoftwareRenderSlice") {}
+
+  void Start(const SSliceJob &job)
+  {
+    m_job = job;
+    m_start.Set();
+  }
+
+  void WaitDone()
+  {
+    m_done.Wait();
+  }
+
+protected:
+  virtual void Process()
+  {
+    while (!m_bStop)
+    {
+      if (AbortableWait(m_start) != WAIT_SIGNALED)
+        break;
+      m_job.Run();
+      m_done.Set();
+    }
+  }
+
+  SSliceJob m_job;
+  CEvent    m_start;
+  CEvent    m_done;
+};
+
+CSoftwareRenderer::PICTURE::PICTURE()
+{
+  memset(&image, 0, sizeof(image));
+  data      = NULL;
+  codecinfo = NULL;
+}
+
+CSoftwareRenderer::CSoftwareRenderer()
+{
+  m_surface           = NULL;
+  m_surfaceWidth      = 0;
+  m_surfaceHeight     = 0;
+  m_surfaceStride     = 0;
+  m_clearPixel        = 0xff000000;
+  m_texture           = 0;
+  m_textureWidth      = 0;
+  m_textureHeight     = 0;
+  m_presentAlpha      = 255;
+  m_renderTicks       = 0;
+  m_renderCount       = 0;
+}
+
+CSoftwareRenderer::~CSoftwareRenderer()
+{
+  UnInit();
+}
+
+unsigned int CSoftwareRenderer::PreInit()
+{
+  CSingleLock lock(g_graphicsContext);
+  m_bConfigured = false;
+  UnInit();
+  m_resolution = CDisplaySettings::Get().GetCurrentResolution();
+  if ( m_resolution == RES_WINDOW )
+    m_resolution = RES_DESKTOP;
+
+  m_iYV12RenderBuffer = 0;
+
+  m_formats.clear();
+  m_formats.push_back(RENDER_FMT_YUV420P);
+  m_formats.push_back(RENDER_FMT_NV12);
+
+  // setup the background colour
+  uint32_t grey = g_advancedSettings.m_videoBlackBarColour & 0xff;
+  m_clearPixel  = 0xff000000 | (grey << 16) | (grey << 8) | grey;
+  m_clearColour = (float)grey / 0xff;
+
+  return true;
+}
+
+void CSoftwareRenderer::UnInit()
+{
+  CLog::Log(LOGDEBUG, "CSoftwareRenderer::UnInit - cleaning up");
+  CSingleLock lock(g_graphicsContext);
+
+  StopSlices();
+
+  for (int i = 0; i < NUM_BUFFERS; ++i)
+    DeletePicture(i);
+
+  delete [] m_surface;
+  m_surface       = NULL;
+  m_surfaceWidth  = 0;
+  m_surfaceHeight = 0;
+  m_surfaceStride = 0;
+
+  if (m_texture)
+  {
+    glDeleteTextures(1, &m_texture);
+    m_texture = 0;
+  }
+  m_textureWidth  = 0;
+  m_textureHeight = 0;
+
+  m_bImageReady = false;
+  m_bConfigured = false;
+}
+
+bool CSoftwareRenderer::Configure(unsigned int width, unsigned int height, unsigned int d_width, unsigned int d_height, float fps, unsigned flags, ERenderFormat format, unsigned extended_format, unsigned int orientation)
+{
+  if (format != RENDER_FMT_YUV420P && format != RENDER_FMT_NV12)
+  {
+    CLog::Log(LOGERROR, "CSoftwareRenderer::Configure - unsupported format %d", format);
+    return false;
+  }
+
+  m_sourceWidth = width;
+  m_sourceHeight = height;
+  m_renderOrientation = orientation;
+  m_fps = fps;
+
+  // Save the flags.
+  m_iFlags = flags;
+  m_format = format;
+
+  // Calculate the input frame aspect ratio.
+  CalculateFrameAspectRatio(d_width, d_height);
+  ChooseBestResolution(fps);
+  SetViewMode(CMediaSettings::Get().GetCurrentVideoSettings().m_ViewMode);
+  ManageDisplay();
+
+  UpdateColorMatrix();
+
+  // buffers have the size and layout of the new format
+  for (int i = 0; i < NUM_BUFFERS; i++)
+  {
+    DeletePicture(i);
+    if (!CreatePicture(i))
+      return false;
+  }
+  m_iYV12RenderBuffer = 0;
+
+  if (m_slices.empty())
+    StartSlices();
+
+  m_bConfigured = true;
+  m_bImageReady = false;
+
+  return true;
+}
+
+void CSoftwareRenderer::UpdateColorMatrix()
+{
+  // contribution of V to red, U and V to green and U to blue, as in the shaders
+  float vr, ug, vg, ub;
+  switch (CONF_FLAGS_YUVCOEF_MASK(m_iFlags))
+  {
+    case CONF_FLAGS_YUVCOEF_240M:
+      vr = 1.5756f; ug = -0.2253f; vg = -0.5000f; ub = 1.8270f; break;
+    case CONF_FLAGS_YUVCOEF_BT709:
+      vr = 1.5701f; ug = -0.1870f; vg = -0.4664f; ub = 1.8556f; break;
+    case CONF_FLAGS_YUVCOEF_EBU:
+      vr = 1.140f;  ug = -0.396f;  vg = -0.581f;  ub = 2.029f;  break;
+    case CONF_FLAGS_YUVCOEF_BT601:
+    default:
+      vr = 1.403f;  ug = -0.344f;  vg = -0.714f;  ub = 1.773f;  break;
+  }
+  m_scaler.SetColorMatrix(vr, ug, vg, ub, (m_iFlags & CONF_FLAGS_YUV_FULLRANGE) != 0);
+}
+
+bool CSoftwareRenderer::CreatePicture(int index)
+{
+  YV12Image &im = m_pictures[index].image;
+
+  im.width    = m_sourceWidth;
+  im.height   = m_sourceHeight;
+  im.cshift_x = 1;
+  im.cshift_y = 1;
+  im.bpp      = 1;
+
+  // chroma of odd sizes covers the last luma column and row as well
+  unsigned chromaWidth  = (im.width  + 1) >> 1;
+  unsigned chromaHeight = (im.height + 1) >> 1;
+
+  im.stride[0]    = im.width;
+  im.planesize[0] = im.stride[0] * im.height;
+  if (m_format == RENDER_FMT_NV12)
+  {
+    im.stride[1]    = chromaWidth * 2;
+    im.stride[2]    = 0;
+    im.planesize[1] = im.stride[1] * chromaHeight;
+    im.planesize[2] = 0;
+  }
+  else
+  {
+    im.stride[1]    = chromaWidth;
+    im.stride[2]    = chromaWidth;
+    im.planesize[1] = im.stride[1] * chromaHeight;
+    im.planesize[2] = im.stride[2] * chromaHeight;
+  }
+
+  uint8_t *data = new (std::nothrow) uint8_t[im.planesize[0] + im.planesize[1] + im.planesize[2]];
+  if (!data)
+  {
+    CLog::Log(LOGERROR, "CSoftwareRenderer::CreatePicture - unable to allocate %ux%u picture", im.width, im.height);
+    return false;
+  }
+
+  // black until the first picture is written
+  memset(data, 16, im.planesize[0]);
+  memset(data + im.planesize[0], 128, im.planesize[1] + im.planesize[2]);
+
+  im.plane[0] = data;
+  im.plane[1] = data + im.planesize[0];
+  im.plane[2] = im.planesize[2] ? im.plane[1] + im.planesize[1] : NULL;
+  im.flags    = 0;
+
+  m_pictures[index].data = data;
+  return true;
+}
+
+void CSoftwareRenderer::DeletePicture(int index)
+{
+  PICTURE &buf = m_pictures[index];
+  SAFE_RELEASE(buf.codecinfo);
+  delete [] buf.data;
+  buf.data = NULL;
+  for (int p = 0; p < MAX_PLANES; p++)
+    buf.image.plane[p] = NULL;
+  buf.image.flags = 0;
+}
+
+int CSoftwareRenderer::NextYV12Image()
+{
+  return (m_iYV12RenderBuffer + 1) % m_NumYV12Buffers;
+}
+
+int CSoftwareRenderer::GetImage(YV12Image *image, int source, bool readonly)
+{
+  if (!image) return -1;
+  if (!m_bConfigured) return -1;
+
+  /* take next available buffer */
+  if( source == AUTOSOURCE )
+    source = NextYV12Image();
+
+  YV12Image &im = m_pictures[source].image;
+
+  if ((im.flags&(~IMAGE_FLAG_READY)) != 0)
+  {
+     CLog::Log(LOGDEBUG, "CSoftwareRenderer::GetImage - request image but none to give");
+     return -1;
+  }
+
+  if( readonly )
+    im.flags |= IMAGE_FLAG_READING;
+  else
+    im.flags |= IMAGE_FLAG_WRITING;
+
+  // the picture is written to the image, not to a frame referenced before
+  if( !readonly )
+    SAFE_RELEASE(m_pictures[source].codecinfo);
+
+  *image = im;
+  return source;
+}
+
+void CSoftwareRenderer::ReleaseImage(int source, bool preserve)
+{
+  YV12Image &im = m_pictures[source].image;
+
+  im.flags &= ~IMAGE_FLAG_INUSE;
+  im.flags |= IMAGE_FLAG_READY;
+  /* if image should be preserved reserve it so it's not auto seleceted */
+
+  if( preserve )
+    im.flags |= IMAGE_FLAG_RESERVED;
+
+  m_bImageReady = true;
+}
+
+void CSoftwareRenderer::FlipPage(int source)
+{
+  if( source >= 0 && source < m_NumYV12Buffers )
+    m_iYV12RenderBuffer = source;
+  else
+    m_iYV12RenderBuffer = NextYV12Image();
+}
+
+void CSoftwareRenderer::Reset()
+{
+  for(int i=0; i<m_NumYV12Buffers; i++)
+  {
+    /* reset all image flags, this will cleanup textures later */
+    m_pictures[i].image.flags = 0;
+  }
+}
+
+void CSoftwareRenderer::Flush()
+{
+  for (int i = 0; i < NUM_BUFFERS; i++)
+  {
+    ReleaseBuffer(i);
+    m_pictures[i].image.flags = 0;
+  }
+  m_iYV12RenderBuffer = 0;
+  m_bImageReady = false;
+}
+
+void CSoftwareRenderer::ReleaseBuffer(int idx)
+{
+  SAFE_RELEASE(m_pictures[idx].codecinfo);
+}
+
+void CSoftwareRenderer::AddProcessor(CDVDVideoCodecBuffer *codecinfo, int index)
+{
+  PICTURE &buf = m_pictures[index];
+  SAFE_RELEASE(buf.codecinfo);
+  buf.codecinfo = codecinfo;
+  buf.codecinfo->Lock();
+}
+
+void CSoftwareRenderer::Update()
+{
+  if (!m_bConfigured) return;
+  ManageDisplay();
+}
+
+bool CSoftwareRenderer::ValidateSurface()
+{
+  int width  = g_graphicsContext.GetWidth();
+  int height = g_graphicsContext.GetHeight();
+  if (width <= 0 || height <= 0)
+    return false;
+
+  if (m_surface && width == m_surfaceWidth && height == m_surfaceHeight)
+    return true;
+
+  delete [] m_surface;
+  m_surface = new (std::nothrow) uint8_t[width * height * 4];
+  if (!m_surface)
+  {
+    CLog::Log(LOGERROR, "CSoftwareRenderer::ValidateSurface - unable to allocate %dx%d surface", width, height);
+    m_surfaceWidth  = 0;
+    m_surfaceHeight = 0;
+    m_surfaceStride = 0;
+    return false;
+  }
+
+  m_surfaceWidth  = width;
+  m_surfaceHeight = height;
+  m_surfaceStride = width * 4;
+  ClearSurface(CRect());
+  return true;
+}
+
+uint8_t* CSoftwareRenderer::GetSurface(int &width, int &height, int &stride)
+{
+  width  = m_surfaceWidth;
+  height = m_surfaceHeight;
+  stride = m_surfaceStride;
+  return m_surface;
+}
+
+// sets all pixels of the surface outside of keep to the background colour
+void CSoftwareRenderer::ClearSurface(const CRect &keep)
+{
+  int x0 = std::max(0, std::min(m_surfaceWidth,  MathUtils::round_int(keep.x1)));
+  int x1 = std::max(x0, std::min(m_surfaceWidth,  MathUtils::round_int(keep.x2)));
+  int y0 = std::max(0, std::min(m_surfaceHeight, MathUtils::round_int(keep.y1)));
+  int y1 = std::max(y0, std::min(m_surfaceHeight, MathUtils::round_int(keep.y2)));
+  if (x0 == x1 || y0 == y1)
+    x0 = x1 = y0 = y1 = 0;
+
+  for (int y = 0; y < m_surfaceHeight; y++)
+  {
+    uint32_t *row = (uint32_t*)(m_surface + y * m_surfaceStride);
+    if (y < y0 || y >= y1)
+      std::fill(row, row + m_surfaceWidth, m_clearPixel);
+    else
+    {
+      std::fill(row, row + x0, m_clearPixel);
+      std::fill(row + x1, row + m_surfaceWidth, m_clearPixel);
+    }
+  }
+}
+
+void CSoftwareRenderer::RenderUpdate(bool clear, DWORD flags, DWORD alpha)
+{
+  if (!m_bConfigured || !m_bImageReady || !ValidateSurface())
+  {
+    //if clear is set, we're expected to overwrite all backbuffer pixels, even if we have nothing to render
+    if (clear)
+      ClearBackBuffer();
+    return;
+  }
+
+  ManageDisplay();
+
+  // with clear set the black bars are part of the surface, else only the
+  // video is shown over what is already on screen
+  if (clear)
+  {
+    ClearSurface(m_destRect);
+    m_presentRect.SetRect(0, 0, (float)m_surfaceWidth, (float)m_surfaceHeight);
+  }
+  else
+  {
+    m_presentRect = m_destRect;
+    m_presentRect.Intersect(CRect(0, 0, (float)m_surfaceWidth, (float)m_surfaceHeight));
+  }
+  m_presentAlpha = alpha;
+
+  int64_t start = CurrentHostCounter();
+
+  Render(flags, m_iYV12RenderBuffer, m_surface, m_surfaceWidth, m_surfaceHeight, m_surfaceStride, m_destRect);
+
+  m_renderTicks += CurrentHostCounter() - start;
+  if (++m_renderCount == STATS_INTERVAL)
+  {
+    CLog::Log(LOGDEBUG, "CSoftwareRenderer::RenderUpdate - %.2f ms per picture, %dx%d to %dx%d on %d threads",
+              (double)m_renderTicks * 1000.0 / CurrentHostFrequency() / m_renderCount,
+              (int)m_sourceRect.Width(), (int)m_sourceRect.Height(),
+              (int)m_destRect.Width(), (int)m_destRect.Height(), (int)m_slices.size() + 1);
+    m_renderTicks = 0;
+    m_renderCount = 0;
+  }
+
+  PresentSurface(m_presentRect);
+}
+
+void CSoftwareRenderer::PresentSurface(const CRect &rect)
+{
+  if (!m_surface)
+    return;
+
+  CRect shown(rect);
+  shown.Intersect(m_presentRect);
+  int x0 = MathUtils::round_int(shown.x1);
+  int y0 = MathUtils::round_int(shown.y1);
+  int x1 = MathUtils::round_int(shown.x2);
+  int y1 = MathUtils::round_int(shown.y2);
+  if (x0 >= x1 || y0 >= y1)
+    return;
+
+  g_graphicsContext.BeginPaint();
+
+  glDisable(GL_DEPTH_TEST);
+  glEnable(GL_TEXTURE_2D);
+
+  if (!m_texture)
+    glGenTextures(1, &m_texture);
+  glBindTexture(GL_TEXTURE_2D, m_texture);
+
+  // the surface is shown pixel for pixel, the texture only has to be big enough
+  int textureWidth  = m_surfaceWidth;
+  int textureHeight = m_surfaceHeight;
+  if (!g_Windowing.IsExtSupported("GL_ARB_texture_non_power_of_two"))
+  {
+    textureWidth  = NP2(textureWidth);
+    textureHeight = NP2(textureHeight);
+  }
+  if (textureWidth != m_textureWidth || textureHeight != m_textureHeight)
+  {
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, textureWidth, textureHeight, 0, GL_BGRA, GL_UNSIGNED_BYTE, NULL);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    m_textureWidth  = textureWidth;
+    m_textureHeight = textureHeight;
+  }
+
+  // only the rows and columns of rect are uploaded
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, m_surfaceWidth);
+  glTexSubImage2D(GL_TEXTURE_2D, 0, x0, y0, x1 - x0, y1 - y0, GL_BGRA, GL_UNSIGNED_BYTE,
+                  m_surface + y0 * m_surfaceStride + x0 * 4);
+  glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+
+  if (m_presentAlpha < 255)
+  {
+    glEnable(GL_BLEND);
+    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    glColor4f(1.0f, 1.0f, 1.0f, m_presentAlpha / 255.0f);
+  }
+  else
+  {
+    glDisable(GL_BLEND);
+    glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
+  }
+  glTexEnvi(GL_TEXTURE_ENV, GL_TEXTURE_ENV_MODE, GL_MODULATE);
+
+  float u0 = (float)x0 / m_textureWidth;
+  float v0 = (float)y0 / m_textureHeight;
+  float u1 = (float)x1 / m_textureWidth;
+  float v1 = (float)y1 / m_textureHeight;
+
+  glBegin(GL_QUADS);
+  glTexCoord2f(u0, v0);
+  glVertex4f((float)x0, (float)y0, 0, 1.0f);
+  glTexCoord2f(u1, v0);
+  glVertex4f((float)x1, (float)y0, 0, 1.0f);
+  glTexCoord2f(u1, v1);
+  glVertex4f((float)x1, (float)y1, 0, 1.0f);
+  glTexCoord2f(u0, v1);
+  glVertex4f((float)x0, (float)y1, 0, 1.0f);
+  glEnd();
+
+  glDisable(GL_TEXTURE_2D);
+  glEnable(GL_BLEND);
+  VerifyGLState();
+
+  g_graphicsContext.EndPaint();
+}
+
+void CSoftwareRenderer::Render(DWORD flags, int index, uint8_t *target, int width, int height, int stride, const CRect &dest)
+{
+  PICTURE &buf = m_pictures[index];
+  YV12Image &im  = buf.image;
+  if (!(im.flags & IMAGE_FLAG_READY) || !im.plane[0])
+    return;
+
+  // the planes of a frame referenced through AddProcessor take the place of
+  // the ones of the image
+  SSliceJob job;
+  for (int p = 0; p < 3; p++)
+  {
+    job.src[p]       = buf.codecinfo ? buf.codecinfo->data[p]      : im.plane[p];
+    job.srcStride[p] = buf.codecinfo ? buf.codecinfo->iLineSize[p] : (int)im.stride[p];
+  }
+
+  // crop to the source rect, at even positions to keep luma and chroma aligned
+  int cropX = std::max(0, MathUtils::round_int(m_sourceRect.x1)) & ~1;
+  int cropY = std::max(0, MathUtils::round_int(m_sourceRect.y1)) & ~1;
+  int srcWidth  = std::min((int)im.width  - cropX, MathUtils::round_int(m_sourceRect.Width()));
+  int srcHeight = std::min((int)im.height - cropY, MathUtils::round_int(m_sourceRect.Height()));
+  if (srcWidth <= 0 || srcHeight <= 0)
+    return;
+
+  int chromaStep = m_format == RENDER_FMT_NV12 ? 2 : 1;
+  job.src[0] += cropY * job.srcStride[0] + cropX;
+  for (int p = 1; p < 3; p++)
+  {
+    if (job.src[p])
+      job.src[p] += (cropY >> 1) * job.srcStride[p] + (cropX >> 1) * chromaStep;
+  }
+
+  // a single field is every other row, starting at the first or second one
+  if (flags & (RENDER_FLAG_TOP | RENDER_FLAG_BOT))
+  {
+    for (int p = 0; p < 3; p++)
+    {
+      if (flags & RENDER_FLAG_BOT)
+        job.src[p] += job.srcStride[p];
+      job.srcStride[p] *= 2;
+    }
+    srcHeight >>= 1;
+  }
+
+  int dstX      = MathUtils::round_int(dest.x1);
+  int dstY      = MathUtils::round_int(dest.y1);
+  int dstWidth  = MathUtils::round_int(dest.Width());
+  int dstHeight = MathUtils::round_int(dest.Height());
+  if (dstWidth <= 0 || dstHeight <= 0)
+    return;
+
+  // only the part of the scaled picture that is on the target is rendered
+  job.x0 = std::max(0, -dstX);
+  job.y0 = std::max(0, -dstY);
+  job.x1 = std::min(dstWidth,  width  - dstX);
+  job.y1 = std::min(dstHeight, height - dstY);
+  if (job.x0 >= job.x1 || job.y0 >= job.y1)
+    return;
+
+  m_scaler.Configure(m_format == RENDER_FMT_NV12 ? CYUVScaler::FORMAT_NV12 : CYUVScaler::FORMAT_YUV420P,
+                     srcWidth, srcHeight, dstWidth, dstHeight);
+
+  job.scaler    = &m_scaler;
+  job.dstStride = stride;
+
+  int rows   = job.y1 - job.y0;
+  int slices = std::min((int)m_slices.size() + 1, rows / MIN_SLICE_ROWS);
+  if (slices < 1)
+    slices = 1;
+
+  // the other threads take the first slices, this one does the last
+  int y = job.y0;
+  int end = job.y1;
+  for (int i = 0; i < slices; i++)
+  {
+    job.y0  = y;
+    job.y1  = i == slices - 1 ? end : y + rows / slices;
+    job.dst = target + (dstY + job.y0) * stride + (dstX + job.x0) * 4;
+    y = job.y1;
+
+    if (i < slices - 1)
+      m_slices[i]->Start(job);
+    else
+      job.Run();
+  }
+
+  for (int i = 0; i < slices - 1; i++)
+    m_slices[i]->WaitDone();
+}
+
+void CSoftwareRenderer::StartSlices()
+{
+  int count = std::min(g_cpuInfo.getCPUCount(), MAX_SLICES) - 1;
+  for (int i = 0; i < count; i++)
+  {
+    CSoftwareRenderSlice *slice = new CSoftwareRenderSlice();
+    slice->Create();
+    m_slices.push_back(slice);
+  }
+  CLog::Log(LOGDEBUG, "CSoftwareRenderer::StartSlices - rendering on %d threads", count + 1);
+}
+
+void CSoftwareRenderer::StopSlices()
+{
+  for (std::vector<CSoftwareRenderSlice*>::iterator it = m_slices.begin(); it != m_slices.end(); ++it)
+  {
+    (*it)->StopThread();
+    delete *it;
+  }
+  m_slices.clear();
+}
+
+bool CSoftwareRenderer::RenderCapture(CRenderCapture* capture)
+{
+  if (!m_bConfigured || !m_bImageReady)
+    return false;
+
+  CRect dest(0, 0, (float)capture->GetWidth(), (float)capture->GetHeight());
+  int stride = capture->GetWidth() * 4;
+
+  capture->BeginRender();
+
+  // the capture reads back into a pixel buffer object when it can, which is
+  // bound when rendering begins and is filled from memory here
+  uint8_t *pixels = (uint8_t*)capture->GetRenderBuffer();
+  if (pixels)
+    Render(RENDER_FLAG_NOOSD, m_iYV12RenderBuffer, pixels, capture->GetWidth(), capture->GetHeight(), stride, dest);
+  else
+  {
+    std::vector<uint8_t> buffer(stride * capture->GetHeight());
+    Render(RENDER_FLAG_NOOSD, m_iYV12RenderBuffer, &buffer[0], capture->GetWidth(), capture->GetHeight(), stride, dest);
+    glBufferSubDataARB(GL_PIXEL_PACK_BUFFER_ARB, 0, buffer.size(), &buffer[0]);
+  }
+
+  capture->EndRender();
+
+  return true;
+}
+
+bool CSoftwareRenderer::Supports(ERENDERFEATURE feature)
+{
+  if (feature == RENDERFEATURE_STRETCH         ||
+      feature == RENDERFEATURE_CROP            ||
+      feature == RENDERFEATURE_ZOOM            ||
+      feature == RENDERFEATURE_VERTICAL_SHIFT  ||
+      feature == RENDERFEATURE_PIXEL_RATIO     ||
+      feature == RENDERFEATURE_POSTPROCESS)
+    return true;
+
+  return false;
+}
+
+bool CSoftwareRenderer::Supports(EDEINTERLACEMODE mode)
+{
+  if(mode == VS_DEINTERLACEMODE_OFF
+  || mode == VS_DEINTERLACEMODE_AUTO
+  || mode == VS_DEINTERLACEMODE_FORCE)
+    return true;
+
+  return false;
+}
+
+bool CSoftwareRenderer::Supports(EINTERLACEMETHOD method)
+{
+  if(method == VS_INTERLACEMETHOD_AUTO
+  || method == VS_INTERLACEMETHOD_RENDER_BOB
+  || method == VS_INTERLACEMETHOD_RENDER_BOB_INVERTED)
+    return true;
+
+  // done by the decoder, before the picture gets here
+  if(method == VS_INTERLACEMETHOD_DEINTERLACE
+  || method == VS_INTERLACEMETHOD_DEINTERLACE_HALF
+  || method == VS_INTERLACEMETHOD_SW_BLEND)
+    return true;
+
+  return false;
+}
+
+bool CSoftwareRenderer::Supports(ESCALINGMETHOD method)
+{
+  if(method == VS_SCALINGMETHOD_LINEAR
+  || method == VS_SCALINGMETHOD_AUTO)
+    return true;
+
+  return false;
+}
+
+EINTERLACEMETHOD CSoftwareRenderer::AutoInterlaceMethod()
+{
+  return VS_INTERLACEMETHOD_RENDER_BOB;
+}
+
+#endif
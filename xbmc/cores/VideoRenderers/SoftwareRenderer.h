@@ -0,0 +1,147 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+
+#if defined(HAS_GL)
+
+#include <vector>
+
+#include "LinuxRendererGL.h"
+#include "utils/YUVScaler.h"
+
+class CRenderCapture;
+class CDVDVideoCodecBuffer;
+class CSoftwareRenderSlice;
+
+/*
+ * Renders video on the cpu into a BGRA surface, selected instead of the
+ * GL renderer with <softwarerenderer> in the <video> section of
+ * advancedsettings.xml. Meant for machines whose gpu can't do the video
+ * shaders, such as servers and build machines running on a software GL.
+ *
+ * Scaling and colour conversion are done by CYUVScaler, split into slices
+ * of rows that are rendered on one thread per core. Overlays are blended
+ * into the same surface by OVERLAY::COverlaySW. The surface has the size of
+ * the current resolution and is shown with a single texture upload, and can
+ * be read back with a render capture, so the whole way from the player to
+ * the screen can be run, timed and compared without gpu video processing.
+ *
+ * A GL context is still needed to show the surface, as it is for the rest
+ * of the GUI. Builds and machines without any GL, with the surface only
+ * kept offscreen, are not supported.
+ */
+class CSoftwareRenderer : public CLinuxRendererGL
+{
+public:
+  CSoftwareRenderer();
+  virtual ~CSoftwareRenderer();
+
+  virtual void Update();
+  virtual void SetupScreenshot() {};
+
+  virtual bool RenderCapture(CRenderCapture* capture);
+
+  // Player functions
+  virtual bool Configure(unsigned int width, unsigned int height, unsigned int d_width, unsigned int d_height, float fps, unsigned flags, ERenderFormat format, unsigned extended_format, unsigned int orientation);
+  virtual int          GetImage(YV12Image *image, int source = AUTOSOURCE, bool readonly = false);
+  virtual void         ReleaseImage(int source, bool preserve = false);
+  virtual void         FlipPage(int source);
+  virtual unsigned int PreInit();
+  virtual void         UnInit();
+  virtual void         Reset(); /* resets renderer after seek for example */
+  virtual void         Flush();
+  virtual void         ReleaseBuffer(int idx);
+  virtual unsigned int GetProcessorSize() { return 0; }
+
+  virtual void         AddProcessor(CDVDVideoCodecBuffer *codecinfo, int index);
+
+  virtual void RenderUpdate(bool clear, DWORD flags = 0, DWORD alpha = 255);
+
+  // Feature support
+  virtual bool SupportsMultiPassRendering() { return false; }
+  virtual bool Supports(ERENDERFEATURE feature);
+  virtual bool Supports(EDEINTERLACEMODE mode);
+  virtual bool Supports(EINTERLACEMETHOD method);
+  virtual bool Supports(ESCALINGMETHOD method);
+
+  virtual EINTERLACEMETHOD AutoInterlaceMethod();
+
+  /*
+   * The surface, BGRA with the size of the current resolution.
+   * Only valid on the render thread between two calls to RenderUpdate.
+   */
+  uint8_t* GetSurface(int &width, int &height, int &stride);
+
+  /*
+   * Shows rect of the surface again, after an overlay was blended into it.
+   * Only the part of the screen covered by the last RenderUpdate is drawn.
+   */
+  void PresentSurface(const CRect &rect);
+
+protected:
+  struct PICTURE
+  {
+    PICTURE();
+
+    YV12Image image;
+    uint8_t  *data;
+    CDVDVideoCodecBuffer *codecinfo; // decoded frame referenced instead of copied to image
+  };
+
+  bool CreatePicture(int index);
+  void DeletePicture(int index);
+  int  NextYV12Image();
+  bool ValidateSurface();
+  void ClearSurface(const CRect &keep);
+  void UpdateColorMatrix();
+
+  // draws the picture of buffer index to target, dest is in target pixels
+  void Render(DWORD flags, int index, uint8_t *target, int width, int height, int stride, const CRect &dest);
+
+  void StartSlices();
+  void StopSlices();
+
+  PICTURE m_pictures[NUM_BUFFERS];
+
+  CYUVScaler m_scaler;
+  std::vector<CSoftwareRenderSlice*> m_slices;
+
+  uint8_t  *m_surface;
+  int       m_surfaceWidth;
+  int       m_surfaceHeight;
+  int       m_surfaceStride;
+  uint32_t  m_clearPixel;
+
+  // texture the surface is shown with
+  GLuint    m_texture;
+  int       m_textureWidth;
+  int       m_textureHeight;
+  CRect     m_presentRect;
+  DWORD     m_presentAlpha;
+
+  // render times, logged once in a while
+  int64_t   m_renderTicks;
+  int       m_renderCount;
+};
+
+#endif
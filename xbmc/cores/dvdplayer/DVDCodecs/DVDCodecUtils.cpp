@@ -20,142 +20,99 @@
 
 #include "DVDCodecUtils.h"
 #include "DVDClock.h"
+#include "Video/DVDVideoFramePool.h"
 #include "cores/VideoRenderers/RenderManager.h"
 #include "utils/log.h"
-#include "utils/fastmemcpy.h"
+#include "utils/PlaneCopy.h"
 #include "DllSwScale.h"
 
+// pictures allocated or converted here share one pool, so their planes are
+// recycled rather than allocated for every frame. The pool goes away at exit,
+// once the last of its frames is released.
+class CFramePoolRef
+{
+public:
+  CFramePoolRef() : m_pool(new CDVDVideoFramePool()) {}
+  ~CFramePoolRef() { m_pool->Release(); }
+  CDVDVideoFramePool* m_pool;
+};
+
+static CDVDVideoFramePool* GetFramePool()
+{
+  static CFramePoolRef ref;
+  return ref.m_pool;
+}
+
+void CDVDCodecUtils::FlushFramePool()
+{
+  GetFramePool()->Flush();
+}
+
+// point the planes of a picture at a pooled frame, the picture owns the reference
+static bool AttachFrame(DVDVideoPicture* pPicture, ERenderFormat format)
+{
+  CDVDVideoFrameBuffer* frame = GetFramePool()->Get(format, pPicture->iWidth, pPicture->iHeight);
+  if (!frame)
+    return false;
+
+  for (int i = 0; i < 4; i++)
+  {
+    pPicture->data[i]      = frame->data[i];
+    pPicture->iLineSize[i] = frame->iLineSize[i];
+  }
+  pPicture->codecinfo = frame;
+  pPicture->format    = format;
+  return true;
+}
+
 // allocate a new picture (PIX_FMT_YUV420P)
 DVDVideoPicture* CDVDCodecUtils::AllocatePicture(int iWidth, int iHeight)
 {
   DVDVideoPicture* pPicture = new DVDVideoPicture;
-  if (pPicture)
+  memset(pPicture, 0, sizeof(DVDVideoPicture));
+  pPicture->iWidth = iWidth;
+  pPicture->iHeight = iHeight;
+
+  if (!AttachFrame(pPicture, RENDER_FMT_YUV420P))
   {
-    pPicture->iWidth = iWidth;
-    pPicture->iHeight = iHeight;
-
-    int w = iWidth / 2;
-    int h = iHeight / 2;
-    int size = w * h;
-    int totalsize = (iWidth * iHeight) + size * 2;
-    uint8_t* data = new uint8_t[totalsize];
-    if (data)
-    {
-      pPicture->data[0] = data;
-      pPicture->data[1] = pPicture->data[0] + (iWidth * iHeight);
-      pPicture->data[2] = pPicture->data[1] + size;
-      pPicture->data[3] = NULL;
-      pPicture->iLineSize[0] = iWidth;
-      pPicture->iLineSize[1] = w;
-      pPicture->iLineSize[2] = w;
-      pPicture->iLineSize[3] = 0;
-    }
-    else
-    {
-      CLog::Log(LOGFATAL, "CDVDCodecUtils::AllocatePicture, unable to allocate new video picture, out of memory.");
-      delete pPicture;
-      pPicture = NULL;
-    }
+    CLog::Log(LOGFATAL, "CDVDCodecUtils::AllocatePicture, unable to allocate new video picture, out of memory.");
+    delete pPicture;
+    pPicture = NULL;
   }
   return pPicture;
 }
 
 void CDVDCodecUtils::FreePicture(DVDVideoPicture* pPicture)
 {
-  delete[] pPicture->data[0];
+  SAFE_RELEASE(pPicture->codecinfo);
   delete pPicture;
 }
 
 bool CDVDCodecUtils::CopyPicture(DVDVideoPicture* pDst, DVDVideoPicture* pSrc)
 {
-  uint8_t *s, *d;
   int w = pSrc->iWidth;
   int h = pSrc->iHeight;
 
-  s = pSrc->data[0];
-  d = pDst->data[0];
-
-  for (int y = 0; y < h; y++)
-  {
-    fast_memcpy(d, s, w);
-    s += pSrc->iLineSize[0];
-    d += pDst->iLineSize[0];
-  }
+  CPlaneCopy::Copy(pDst->data[0], pDst->iLineSize[0], pSrc->data[0], pSrc->iLineSize[0], w, h);
 
   w >>= 1;
   h >>= 1;
 
-  s = pSrc->data[1];
-  d = pDst->data[1];
-  for (int y = 0; y < h; y++)
-  {
-    fast_memcpy(d, s, w);
-    s += pSrc->iLineSize[1];
-    d += pDst->iLineSize[1];
-  }
-
-  s = pSrc->data[2];
-  d = pDst->data[2];
-  for (int y = 0; y < h; y++)
-  {
-    fast_memcpy(d, s, w);
-    s += pSrc->iLineSize[2];
-    d += pDst->iLineSize[2];
-  }
+  CPlaneCopy::Copy(pDst->data[1], pDst->iLineSize[1], pSrc->data[1], pSrc->iLineSize[1], w, h);
+  CPlaneCopy::Copy(pDst->data[2], pDst->iLineSize[2], pSrc->data[2], pSrc->iLineSize[2], w, h);
   return true;
 }
 
 bool CDVDCodecUtils::CopyPicture(YV12Image* pImage, DVDVideoPicture *pSrc)
 {
-  uint8_t *s = pSrc->data[0];
-  uint8_t *d = pImage->plane[0];
   int w = pImage->width * pImage->bpp;
   int h = pImage->height;
-  if ((w == pSrc->iLineSize[0]) && ((unsigned int) pSrc->iLineSize[0] == pImage->stride[0]))
-  {
-    fast_memcpy(d, s, w*h);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      fast_memcpy(d, s, w);
-      s += pSrc->iLineSize[0];
-      d += pImage->stride[0];
-    }
-  }
-  s = pSrc->data[1];
-  d = pImage->plane[1];
-  w =(pImage->width  >> pImage->cshift_x) * pImage->bpp;
-  h =(pImage->height >> pImage->cshift_y);
-  if ((w==pSrc->iLineSize[1]) && ((unsigned int) pSrc->iLineSize[1]==pImage->stride[1]))
-  {
-    fast_memcpy(d, s, w*h);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      fast_memcpy(d, s, w);
-      s += pSrc->iLineSize[1];
-      d += pImage->stride[1];
-    }
-  }
-  s = pSrc->data[2];
-  d = pImage->plane[2];
-  if ((w==pSrc->iLineSize[2]) && ((unsigned int) pSrc->iLineSize[2]==pImage->stride[2]))
-  {
-    fast_memcpy(d, s, w*h);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      fast_memcpy(d, s, w);
-      s += pSrc->iLineSize[2];
-      d += pImage->stride[2];
-    }
-  }
+  CPlaneCopy::Copy(pImage->plane[0], pImage->stride[0], pSrc->data[0], pSrc->iLineSize[0], w, h);
+
+  w = (pImage->width  >> pImage->cshift_x) * pImage->bpp;
+  h = (pImage->height >> pImage->cshift_y);
+  CPlaneCopy::Copy(pImage->plane[1], pImage->stride[1], pSrc->data[1], pSrc->iLineSize[1], w, h);
+  CPlaneCopy::Copy(pImage->plane[2], pImage->stride[2], pSrc->data[2], pSrc->iLineSize[2], w, h);
   return true;
 }
 
@@ -167,44 +124,18 @@ DVDVideoPicture* CDVDCodecUtils::ConvertToNV12Picture(DVDVideoPicture *pSrc)
   {
     *pPicture = *pSrc;
 
-    int w = pPicture->iWidth / 2;
-    int h = pPicture->iHeight / 2;
-    int size = w * h;
-    int totalsize = (pPicture->iWidth * pPicture->iHeight) + size * 2;
-    uint8_t* data = new uint8_t[totalsize];
-    if (data)
+    if (AttachFrame(pPicture, RENDER_FMT_NV12))
     {
-      pPicture->data[0] = data;
-      pPicture->data[1] = pPicture->data[0] + (pPicture->iWidth * pPicture->iHeight);
-      pPicture->data[2] = NULL;
-      pPicture->data[3] = NULL;
-      pPicture->iLineSize[0] = pPicture->iWidth;
-      pPicture->iLineSize[1] = pPicture->iWidth;
-      pPicture->iLineSize[2] = 0;
-      pPicture->iLineSize[3] = 0;
-      pPicture->format = RENDER_FMT_NV12;
-      
       // copy luma
-      uint8_t *s = pSrc->data[0];
-      uint8_t *d = pPicture->data[0];
-      for (int y = 0; y < (int)pSrc->iHeight; y++)
-      {
-        fast_memcpy(d, s, pSrc->iWidth);
-        s += pSrc->iLineSize[0];
-        d += pPicture->iLineSize[0];
-      }
+      CPlaneCopy::Copy(pPicture->data[0], pPicture->iLineSize[0],
+                       pSrc->data[0], pSrc->iLineSize[0],
+                       pSrc->iWidth, pSrc->iHeight);
 
       //copy chroma
-      for (int y = 0; y < (int)pSrc->iHeight/2; y++) {
-        uint8_t *s_u = pSrc->data[1] + (y * pSrc->iLineSize[1]);
-        uint8_t *s_v = pSrc->data[2] + (y * pSrc->iLineSize[2]);
-        uint8_t *d_uv = pPicture->data[1] + (y * pPicture->iLineSize[1]);
-        for (int x = 0; x < (int)pSrc->iWidth/2; x++) {
-          *d_uv++ = *s_u++;
-          *d_uv++ = *s_v++;
-        }
-      }
-      
+      CPlaneCopy::InterleaveUV(pPicture->data[1], pPicture->iLineSize[1],
+                               pSrc->data[1], pSrc->iLineSize[1],
+                               pSrc->data[2], pSrc->iLineSize[2],
+                               pSrc->iWidth/2, pSrc->iHeight/2);
     }
     else
     {
@@ -224,48 +155,15 @@ DVDVideoPicture* CDVDCodecUtils::ConvertToYUV422PackedPicture(DVDVideoPicture *p
   {
     *pPicture = *pSrc;
 
-    int totalsize = pPicture->iWidth * pPicture->iHeight * 2;
-    uint8_t* data = new uint8_t[totalsize];
-
-    if (data)
+    if (AttachFrame(pPicture, format))
     {
-      pPicture->data[0] = data;
-      pPicture->data[1] = NULL;
-      pPicture->data[2] = NULL;
-      pPicture->data[3] = NULL;
-      pPicture->iLineSize[0] = pPicture->iWidth * 2;
-      pPicture->iLineSize[1] = 0;
-      pPicture->iLineSize[2] = 0;
-      pPicture->iLineSize[3] = 0;
-      pPicture->format = format;
-
-      //if this is going to be used for anything else than testing the renderer
-      //the library should not be loaded on every function call
-      DllSwScale  dllSwScale;
-      if (!dllSwScale.Load())
-      {
-        CLog::Log(LOGERROR,"CDVDCodecUtils::ConvertToYUY2Picture - failed to load rescale libraries!");
-      }
-      else
-      {
-        // Perform the scaling.
-        uint8_t* src[] =       { pSrc->data[0],          pSrc->data[1],      pSrc->data[2],      NULL };
-        int      srcStride[] = { pSrc->iLineSize[0],     pSrc->iLineSize[1], pSrc->iLineSize[2], 0    };
-        uint8_t* dst[] =       { pPicture->data[0],      NULL,               NULL,               NULL };
-        int      dstStride[] = { pPicture->iLineSize[0], 0,                  0,                  0    };
-
-        int dstformat;
-        if (format == RENDER_FMT_UYVY422)
-          dstformat = PIX_FMT_UYVY422;
-        else
-          dstformat = PIX_FMT_YUYV422;
-
-        struct SwsContext *ctx = dllSwScale.sws_getContext(pSrc->iWidth, pSrc->iHeight, PIX_FMT_YUV420P,
-                                                           pPicture->iWidth, pPicture->iHeight, dstformat,
-                                                           SWS_FAST_BILINEAR | SwScaleCPUFlags(), NULL, NULL, NULL);
-        dllSwScale.sws_scale(ctx, src, srcStride, 0, pSrc->iHeight, dst, dstStride);
-        dllSwScale.sws_freeContext(ctx);
-      }
+      // chroma rows are repeated, as the renderers do for 4:2:0 input
+      CPlaneCopy::PackYUV422(pPicture->data[0], pPicture->iLineSize[0],
+                             pSrc->data[0], pSrc->iLineSize[0],
+                             pSrc->data[1], pSrc->iLineSize[1],
+                             pSrc->data[2], pSrc->iLineSize[2],
+                             pSrc->iWidth, pSrc->iHeight,
+                             format == RENDER_FMT_UYVY422);
     }
     else
     {
@@ -279,69 +177,23 @@ DVDVideoPicture* CDVDCodecUtils::ConvertToYUV422PackedPicture(DVDVideoPicture *p
 
 bool CDVDCodecUtils::CopyNV12Picture(YV12Image* pImage, DVDVideoPicture *pSrc)
 {
-  uint8_t *s = pSrc->data[0];
-  uint8_t *d = pImage->plane[0];
-  int w = pSrc->iWidth;
-  int h = pSrc->iHeight;
   // Copy Y
-  if ((w == pSrc->iLineSize[0]) && ((unsigned int) pSrc->iLineSize[0] == pImage->stride[0]))
-  {
-    fast_memcpy(d, s, w*h);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      fast_memcpy(d, s, w);
-      s += pSrc->iLineSize[0];
-      d += pImage->stride[0];
-    }
-  }
-  
-  s = pSrc->data[1];
-  d = pImage->plane[1];
-  w = pSrc->iWidth;
-  h = pSrc->iHeight >> 1;
+  CPlaneCopy::Copy(pImage->plane[0], pImage->stride[0], pSrc->data[0], pSrc->iLineSize[0],
+                   pSrc->iWidth, pSrc->iHeight);
+
   // Copy packed UV (width is same as for Y as it's both U and V components)
-  if ((w==pSrc->iLineSize[1]) && ((unsigned int) pSrc->iLineSize[1]==pImage->stride[1]))
-  {
-    fast_memcpy(d, s, w*h);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      fast_memcpy(d, s, w);
-      s += pSrc->iLineSize[1];
-      d += pImage->stride[1];
-    }
-  }
+  CPlaneCopy::Copy(pImage->plane[1], pImage->stride[1], pSrc->data[1], pSrc->iLineSize[1],
+                   pSrc->iWidth, pSrc->iHeight >> 1);
 
   return true;
 }
 
 bool CDVDCodecUtils::CopyYUV422PackedPicture(YV12Image* pImage, DVDVideoPicture *pSrc)
 {
-  uint8_t *s = pSrc->data[0];
-  uint8_t *d = pImage->plane[0];
-  int w = pSrc->iWidth;
-  int h = pSrc->iHeight;
-
   // Copy YUYV
-  if ((w * 2 == pSrc->iLineSize[0]) && ((unsigned int) pSrc->iLineSize[0] == pImage->stride[0]))
-  {
-    fast_memcpy(d, s, w*h*2);
-  }
-  else
-  {
-    for (int y = 0; y < h; y++)
-    {
-      fast_memcpy(d, s, w*2);
-      s += pSrc->iLineSize[0];
-      d += pImage->stride[0];
-    }
-  }
-  
+  CPlaneCopy::Copy(pImage->plane[0], pImage->stride[0], pSrc->data[0], pSrc->iLineSize[0],
+                   pSrc->iWidth * 2, pSrc->iHeight);
+
   return true;
 }
 
@@ -359,15 +211,10 @@ bool CDVDCodecUtils::CopyDXVA2Picture(YV12Image* pImage, DVDVideoPicture *pSrc)
         if (FAILED(surface->LockRect(&rectangle, NULL, 0)))
           return false;
 
-        // Copy Y
+        // Copy Y, the surface is uncached memory
         uint8_t* bits = (uint8_t*)(rectangle.pBits);
-        uint8_t* d = pImage->plane[0];
-        for (unsigned y = 0; y < pSrc->iHeight; y++)
-        {
-          memcpy(d, bits, pSrc->iWidth);
-          bits += rectangle.Pitch;
-          d += pImage->stride[0];
-        }
+        CPlaneCopy::CopyUncached(pImage->plane[0], pImage->stride[0], bits, rectangle.Pitch,
+                                 pSrc->iWidth, pSrc->iHeight);
 
         D3DSURFACE_DESC desc;
         if (FAILED(surface->GetDesc(&desc)))
@@ -375,13 +222,8 @@ bool CDVDCodecUtils::CopyDXVA2Picture(YV12Image* pImage, DVDVideoPicture *pSrc)
         
         // Copy packed UV
         uint8_t *s_uv = ((uint8_t*)(rectangle.pBits)) + desc.Height * rectangle.Pitch;
-        uint8_t *d_uv = pImage->plane[1];
-        for (unsigned y = 0; y < pSrc->iHeight >> 1; y++)
-        {
-          memcpy(d_uv, s_uv, pSrc->iWidth);
-          s_uv += rectangle.Pitch;
-          d_uv += pImage->stride[1];
-        }
+        CPlaneCopy::CopyUncached(pImage->plane[1], pImage->stride[1], s_uv, rectangle.Pitch,
+                                 pSrc->iWidth, pSrc->iHeight >> 1);
 
         if (FAILED(surface->UnlockRect()))
           return false;
@@ -30,6 +30,8 @@ class CDVDCodecUtils
 public:
   static DVDVideoPicture* AllocatePicture(int iWidth, int iHeight);
   static void FreePicture(DVDVideoPicture* pPicture);
+  // free the frames kept for reuse by AllocatePicture and the conversions
+  static void FlushFramePool();
   static bool CopyPicture(DVDVideoPicture* pDst, DVDVideoPicture* pSrc);
   static bool CopyPicture(YV12Image* pDst, DVDVideoPicture *pSrc);
   
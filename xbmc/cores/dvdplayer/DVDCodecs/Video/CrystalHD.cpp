@@ -36,6 +36,7 @@
 #include "threads/Thread.h"
 #include "utils/log.h"
 #include "utils/fastmemcpy.h"
+#include "utils/PlaneCopy.h"
 #include "DllSwScale.h"
 #include "utils/TimeUtils.h"
 #include "windowing/WindowingFactory.h"
@@ -672,17 +673,8 @@ void CMPCOutputThread::CopyOutAsYV12(CPictureBuffer *pBuffer, BCM::BC_DTS_PROC_O
   }
   //copy chroma
   //copy uv packed to u,v planes (1/2 the width and 1/2 the height of y)
-  uint8_t *d_u = pBuffer->m_u_buffer_ptr;
-  uint8_t *d_v = pBuffer->m_v_buffer_ptr;
-  for (int y = 0; y < h/2; y++)
-  {
-    uint8_t *s_uv = procOut->UVbuff + (y * stride);
-    for (int x = 0; x < w/2; x++)
-    {
-      *d_u++ = *s_uv++;
-      *d_v++ = *s_uv++;
-    }
-  }
+  CPlaneCopy::DeinterleaveUV(pBuffer->m_u_buffer_ptr, w/2, pBuffer->m_v_buffer_ptr, w/2,
+                             procOut->UVbuff, stride, w/2, h/2);
 }
 
 void CMPCOutputThread::CopyOutAsYV12DeInterlace(CPictureBuffer *pBuffer, BCM::BC_DTS_PROC_OUT *procOut, int w, int h, int stride)
@@ -92,13 +92,12 @@ struct DVDVideoPicture
     struct {
       CDVDMediaCodecInfo *mediacodec;
     };
-  
-    struct {
-      CDVDVideoCodecBuffer *codecinfo;
-    };
-
   };
 
+  // refcounted buffer holding the picture, for software formats it backs data[]
+  // and a consumer that keeps the planes beyond the next decode takes a reference
+  CDVDVideoCodecBuffer *codecinfo;
+
   unsigned int iFlags;
 
   double       iRepeatPicture;
@@ -130,6 +129,15 @@ struct DVDVideoUserData
   int size;
 };
 
+// how a codec adapted to the decoding load, see CDVDVideoCodec::GetDecodeLoad
+struct DVDVideoDecodeLoad
+{
+  int  load;         // decode time per picture in percent of the frame duration
+  int  threads;      // decoder threads
+  bool frameThreads; // threads decode whole frames rather than slices
+  int  skipLevel;    // 0 for full quality, higher levels skip more work
+};
+
 #define DVP_FLAG_TOP_FIELD_FIRST    0x00000001
 #define DVP_FLAG_REPEAT_TOP_FIELD   0x00000002 //Set to indicate that the top field should be repeated
 #define DVP_FLAG_ALLOCATED          0x00000004 //Set to indicate that this has allocated data
@@ -225,6 +233,19 @@ public:
    */
   virtual void SetSpeed(int iSpeed) {};
 
+  /*
+   * will be called by video player before each packet to tell how it keeps up,
+   * so the codec can lighten its work before frames have to be dropped
+   * queueLevel : fill level of the players packet queue in percent
+   * lateFrames : number of pictures in a row that were presented late
+   */
+  virtual void SetPlayerLoad(int queueLevel, int lateFrames) {};
+
+  /*
+   * returns how the codec adapted to the decoding load, false if it doesn't
+   */
+  virtual bool GetDecodeLoad(DVDVideoDecodeLoad &load) { return false; }
+
   /*
    * returns the number of demuxer bytes in any internal buffers
    */
@@ -29,6 +29,7 @@
 #include "DVDCodecs/DVDCodecs.h"
 #include "DVDCodecs/DVDCodecUtils.h"
 #include "DVDVideoPPFFmpeg.h"
+#include "DVDVideoFramePool.h"
 #if defined(TARGET_POSIX) || defined(TARGET_WINDOWS)
 #include "utils/CPUInfo.h"
 #endif
@@ -36,6 +37,7 @@
 #include "settings/Settings.h"
 #include "settings/VideoSettings.h"
 #include "utils/log.h"
+#include "utils/TimeUtils.h"
 #include "boost/shared_ptr.hpp"
 #include "threads/Atomics.h"
 
@@ -63,6 +65,10 @@
 #endif
 #include "utils/StringUtils.h"
 
+// pixels per second above which slice threads tend not to keep up, streams
+// beyond 720p50 are decoded with frame threads when possible
+#define FRAME_THREADS_PIXEL_RATE (1280.0 * 720.0 * 50.0)
+
 using namespace boost;
 
 enum PixelFormat CDVDVideoCodecFFmpeg::GetFormat( struct AVCodecContext * avctx
@@ -137,6 +143,114 @@ enum PixelFormat CDVDVideoCodecFFmpeg::GetFormat( struct AVCodecContext * avctx
   return ctx->m_dllAvCodec.avcodec_default_get_format(avctx, fmt);
 }
 
+int CDVDVideoCodecFFmpeg::GetBuffer(AVCodecContext *avctx, AVFrame *pic)
+{
+  CDVDVideoCodecFFmpeg* ctx  = (CDVDVideoCodecFFmpeg*)avctx->opaque;
+
+  pic->opaque = NULL;
+  // only codecs with direct rendering support may be given buffers of our own
+  if(!(avctx->codec->capabilities & CODEC_CAP_DR1)
+  || (avctx->pix_fmt != PIX_FMT_YUV420P
+   && avctx->pix_fmt != PIX_FMT_YUVJ420P))
+    return ctx->m_dllAvCodec.avcodec_default_get_buffer(avctx, pic);
+
+  int width  = avctx->width;
+  int height = avctx->height;
+  int linesize_align[AV_NUM_DATA_POINTERS];
+  ctx->m_dllAvCodec.avcodec_align_dimensions2(avctx, &width, &height, linesize_align);
+
+  // codecs without emulated edges draw motion vectors past the picture
+  int edge = 0;
+  if(!(avctx->flags & CODEC_FLAG_EMU_EDGE))
+    edge = ctx->m_dllAvCodec.avcodec_get_edge_width();
+
+  CDVDVideoFrameBuffer* buffer = ctx->m_pFramePool->Get(RENDER_FMT_YUV420P, width, height, edge);
+  if(!buffer)
+    return -1;
+
+  for(int i = 0; i < AV_NUM_DATA_POINTERS; i++)
+  {
+    pic->base[i]     = i < 4 ? buffer->data[i]      : NULL;
+    pic->data[i]     = i < 4 ? buffer->data[i]      : NULL;
+    pic->linesize[i] = i < 4 ? buffer->iLineSize[i] : 0;
+  }
+  pic->extended_data = pic->data;
+  pic->type          = FF_BUFFER_TYPE_USER;
+  pic->opaque        = buffer;
+  return 0;
+}
+
+void CDVDVideoCodecFFmpeg::ReleaseBuffer(AVCodecContext *avctx, AVFrame *pic)
+{
+  CDVDVideoCodecFFmpeg* ctx  = (CDVDVideoCodecFFmpeg*)avctx->opaque;
+
+  if(pic->type != FF_BUFFER_TYPE_USER)
+  {
+    ctx->m_dllAvCodec.avcodec_default_release_buffer(avctx, pic);
+    return;
+  }
+
+  CDVDVideoFrameBuffer* buffer = (CDVDVideoFrameBuffer*)pic->opaque;
+  SAFE_RELEASE(buffer);
+  for(int i = 0; i < AV_NUM_DATA_POINTERS; i++)
+    pic->data[i] = NULL;
+  pic->opaque = NULL;
+}
+
+int CDVDVideoCodecFFmpeg::RegetBuffer(AVCodecContext *avctx, AVFrame *pic)
+{
+  CDVDVideoCodecFFmpeg* ctx  = (CDVDVideoCodecFFmpeg*)avctx->opaque;
+
+  // the repainted picture belongs to the current packet, as the default
+  // reget_buffer would set through ff_init_buffer_info
+  pic->reordered_opaque = avctx->reordered_opaque;
+  pic->pkt_pts          = avctx->pkt ? avctx->pkt->pts : AV_NOPTS_VALUE;
+
+  if(!pic->data[0])
+  { // nothing to repaint, any buffer will do
+    pic->buffer_hints |= FF_BUFFER_HINTS_READABLE;
+    return GetBuffer(avctx, pic);
+  }
+
+  if(pic->type != FF_BUFFER_TYPE_USER)
+    return ctx->m_dllAvCodec.avcodec_default_reget_buffer(avctx, pic);
+
+  // the codec repaints the previous picture in place, which must not happen
+  // to a frame the renderer may still be showing: repaint a copy of it instead
+  CDVDVideoFrameBuffer* old = (CDVDVideoFrameBuffer*)pic->opaque;
+  if(!old->IsShared())
+    return 0;
+
+  uint8_t* data[4];
+  int      linesize[4];
+  for(int i = 0; i < 4; i++)
+  {
+    data[i]     = pic->data[i];
+    linesize[i] = pic->linesize[i];
+  }
+
+  if(GetBuffer(avctx, pic) < 0)
+  {
+    for(int i = 0; i < 4; i++)
+    {
+      pic->data[i]     = data[i];
+      pic->linesize[i] = linesize[i];
+    }
+    pic->opaque = old;
+    return -1;
+  }
+
+  for(int plane = 0; plane < 3; plane++)
+  {
+    int width  = plane ? (avctx->width  + 1) >> 1 : avctx->width;
+    int height = plane ? (avctx->height + 1) >> 1 : avctx->height;
+    for(int y = 0; y < height; y++)
+      memcpy(pic->data[plane] + y * pic->linesize[plane], data[plane] + y * linesize[plane], width);
+  }
+  old->Release();
+  return 0;
+}
+
 CDVDVideoCodecFFmpeg::CDVDVideoCodecFFmpeg() : CDVDVideoCodec()
 {
   m_pCodecContext = NULL;
@@ -161,6 +275,10 @@ CDVDVideoCodecFFmpeg::CDVDVideoCodecFFmpeg() : CDVDVideoCodec()
   m_bSoftware = false;
   m_isHi10p = false;
   m_pHardware = NULL;
+  m_pFramePool = NULL;
+  m_decodeTime = 0.0;
+  m_skipLoopFilter = AVDISCARD_DEFAULT;
+  m_bDropState = false;
   m_iLastKeyframe = 0;
   m_dts = DVD_NOPTS_VALUE;
   m_started = false;
@@ -238,6 +356,20 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
   m_pCodecContext->workaround_bugs = FF_BUG_AUTODETECT;
   m_pCodecContext->get_format = GetFormat;
   m_pCodecContext->codec_tag = hints.codec_tag;
+
+  /* Decode into pooled frames the renderer can reference instead of copy,
+   * unless a hardware decoder may take over the context in GetFormat, or
+   * the codec can't decode into buffers it didn't allocate (no DR1). */
+  if((pCodec->capabilities & CODEC_CAP_DR1)
+  && (!IsHardwareAllowed()
+   || (EDECODEMETHOD) CSettings::Get().GetInt("videoplayer.decodingmethod") != VS_DECODEMETHOD_HARDWARE))
+  {
+    m_pFramePool = new CDVDVideoFramePool();
+    m_pCodecContext->get_buffer     = GetBuffer;
+    m_pCodecContext->release_buffer = ReleaseBuffer;
+    m_pCodecContext->reget_buffer   = RegetBuffer;
+    m_pCodecContext->thread_safe_callbacks = 1;
+  }
   /* Only allow slice threading, since frame threading is more
    * sensitive to changes in frame sizes, and it causes crashes
    * during HW accell - so we unset it in this case.
@@ -296,18 +428,41 @@ bool CDVDVideoCodecFFmpeg::Open(CDVDStreamInfo &hints, CDVDCodecOptions &options
       m_dllAvUtil.av_opt_set(m_pCodecContext, it->m_name.c_str(), it->m_value.c_str(), 0);
   }
 
+  // what the skip levels of the decode control build upon
+  m_skipLoopFilter = m_pCodecContext->skip_loop_filter;
+
   int num_threads = std::min(8 /*MAX_THREADS*/, g_cpuInfo.getCPUCount());
   if( num_threads > 1 && !hints.software && m_pHardware == NULL // thumbnail extraction fails when run threaded
-  && ( pCodec->id == AV_CODEC_ID_H264
-    || pCodec->id == AV_CODEC_ID_MPEG4 ))
+  && (pCodec->capabilities & (CODEC_CAP_FRAME_THREADS | CODEC_CAP_SLICE_THREADS)))
     m_pCodecContext->thread_count = num_threads;
 
+  double frameDuration = 0.0;
+  if (hints.fpsrate > 0 && hints.fpsscale > 0)
+    frameDuration = DVD_TIME_BASE * (double)hints.fpsscale / hints.fpsrate;
+
+  /* The thread type is fixed once the codec is open, so streams too heavy
+   * for slice threads get frame threads from the start. Only on the pooled
+   * buffer path, where no hardware decoder can take over the context. */
+  double pixelRate = (double)hints.width * hints.height
+                   * (frameDuration > 0.0 ? DVD_TIME_BASE / frameDuration : 25.0);
+  if (m_pFramePool && m_pCodecContext->thread_count > 1
+  && m_pCodecContext->thread_type == FF_THREAD_SLICE
+  && (pCodec->capabilities & CODEC_CAP_FRAME_THREADS)
+  && pixelRate > FRAME_THREADS_PIXEL_RATE)
+  {
+    CLog::Log(LOGDEBUG,"CDVDVideoCodecFFmpeg::Open() Using frame threading for %dx%d",
+                        hints.width, hints.height);
+    m_pCodecContext->thread_type = FF_THREAD_FRAME | FF_THREAD_SLICE;
+  }
+
   if (m_dllAvCodec.avcodec_open2(m_pCodecContext, pCodec, NULL) < 0)
   {
     CLog::Log(LOGDEBUG,"CDVDVideoCodecFFmpeg::Open() Unable to open codec");
     return false;
   }
 
+  m_control.Reset(frameDuration);
+
   m_pFrame = m_dllAvCodec.avcodec_alloc_frame();
   if (!m_pFrame) return false;
 
@@ -342,6 +497,8 @@ void CDVDVideoCodecFFmpeg::Dispose()
     m_pCodecContext = NULL;
   }
   SAFE_RELEASE(m_pHardware);
+  // frames still shown by the renderer keep the pool alive
+  SAFE_RELEASE(m_pFramePool);
 
   FilterClose();
 
@@ -360,21 +517,50 @@ void CDVDVideoCodecFFmpeg::SetDropState(bool bDrop)
     // from codec to codec on what it does
 
     //  2 seem to be to high.. it causes video to be ruined on following images
+    m_bDropState = bDrop;
     if( bDrop )
     {
       m_pCodecContext->skip_frame = AVDISCARD_NONREF;
       m_pCodecContext->skip_idct = AVDISCARD_NONREF;
-      m_pCodecContext->skip_loop_filter = AVDISCARD_NONREF;
     }
     else
     {
       m_pCodecContext->skip_frame = AVDISCARD_DEFAULT;
       m_pCodecContext->skip_idct = AVDISCARD_DEFAULT;
-      m_pCodecContext->skip_loop_filter = AVDISCARD_DEFAULT;
     }
+    UpdateSkip();
   }
 }
 
+void CDVDVideoCodecFFmpeg::SetPlayerLoad(int queueLevel, int lateFrames)
+{
+  m_control.SetPlayerLoad(queueLevel, lateFrames);
+}
+
+bool CDVDVideoCodecFFmpeg::GetDecodeLoad(DVDVideoDecodeLoad &load)
+{
+  if (!m_pCodecContext || m_pHardware)
+    return false;
+
+  load.load         = m_control.GetLoad();
+  load.threads      = std::max(1, m_pCodecContext->thread_count);
+  load.frameThreads = (m_pCodecContext->active_thread_type & FF_THREAD_FRAME) != 0;
+  load.skipLevel    = m_control.GetSkipLevel();
+  return true;
+}
+
+void CDVDVideoCodecFFmpeg::UpdateSkip()
+{
+  // loop filter is skipped for less and less important frames
+  static const AVDiscard levels[DECODECONTROL_MAX_SKIP + 1] =
+    { AVDISCARD_DEFAULT, AVDISCARD_NONREF, AVDISCARD_BIDIR, AVDISCARD_ALL };
+
+  AVDiscard skip = std::max(m_skipLoopFilter, levels[m_control.GetSkipLevel()]);
+  if (m_bDropState)
+    skip = std::max(skip, AVDISCARD_NONREF);
+  m_pCodecContext->skip_loop_filter = skip;
+}
+
 unsigned int CDVDVideoCodecFFmpeg::SetFilters(unsigned int flags)
 {
   m_filters_next.clear();
@@ -482,7 +668,9 @@ int CDVDVideoCodecFFmpeg::Decode(uint8_t* pData, int iSize, double dts, double p
   /* We lie, but this flag is only used by pngdec.c.
    * Setting it correctly would allow CorePNG decoding. */
   avpkt.flags = AV_PKT_FLAG_KEY;
+  int64_t start = CurrentHostCounter();
   len = m_dllAvCodec.avcodec_decode_video2(m_pCodecContext, m_pFrame, &iGotPicture, &avpkt);
+  m_decodeTime += (double)(CurrentHostCounter() - start) * DVD_TIME_BASE / CurrentHostFrequency();
 
   if(m_iLastKeyframe < m_pCodecContext->has_b_frames + 2)
     m_iLastKeyframe = m_pCodecContext->has_b_frames + 2;
@@ -496,6 +684,13 @@ int CDVDVideoCodecFFmpeg::Decode(uint8_t* pData, int iSize, double dts, double p
   if (!iGotPicture)
     return VC_BUFFER;
 
+  if (m_pHardware == NULL)
+  {
+    m_control.AddPicture(m_decodeTime);
+    UpdateSkip();
+  }
+  m_decodeTime = 0.0;
+
   if(m_pFrame->key_frame)
   {
     m_started = true;
@@ -689,6 +884,17 @@ bool CDVDVideoCodecFFmpeg::GetPicture(DVDVideoPicture* pDvdVideoPicture)
   pDvdVideoPicture->iFlags |= pDvdVideoPicture->data[0] ? 0 : DVP_FLAG_DROPPED;
   pDvdVideoPicture->extended_format = 0;
 
+  // hand out the pooled frame unless filters produced a new picture
+  CDVDVideoFrameBuffer* buffer = (CDVDVideoFrameBuffer*)m_pFrame->opaque;
+  if(m_pFramePool && !m_pFilterGraph
+  && m_pFrame->type == FF_BUFFER_TYPE_USER && buffer
+  && buffer->data[0] == m_pFrame->data[0]
+  && buffer->data[1] == m_pFrame->data[1]
+  && buffer->data[2] == m_pFrame->data[2])
+    pDvdVideoPicture->codecinfo = buffer;
+  else
+    pDvdVideoPicture->codecinfo = NULL;
+
   PixelFormat pix_fmt;
 #if !defined(LIBAVFILTER_AVFRAME_BASED)
   if(m_pBufferRef)
@@ -21,6 +21,7 @@
  */
 
 #include "DVDVideoCodec.h"
+#include "DVDVideoDecodeControl.h"
 #include "DVDResource.h"
 #include "DllAvCodec.h"
 #include "DllAvFormat.h"
@@ -30,6 +31,7 @@
 #include "DllPostProc.h"
 
 class CCriticalSection;
+class CDVDVideoFramePool;
 
 class CDVDVideoCodecFFmpeg : public CDVDVideoCodec
 {
@@ -58,6 +60,8 @@ public:
   bool GetPictureCommon(DVDVideoPicture* pDvdVideoPicture);
   virtual bool GetPicture(DVDVideoPicture* pDvdVideoPicture);
   virtual void SetDropState(bool bDrop);
+  virtual void SetPlayerLoad(int queueLevel, int lateFrames);
+  virtual bool GetDecodeLoad(DVDVideoDecodeLoad &load);
   virtual unsigned int SetFilters(unsigned int filters);
   virtual const char* GetName() { return m_name.c_str(); }; // m_name is never changed after open
   virtual unsigned GetConvergeCount();
@@ -74,6 +78,11 @@ public:
 
 protected:
   static enum PixelFormat GetFormat(struct AVCodecContext * avctx, const PixelFormat * fmt);
+  static int  GetBuffer(AVCodecContext *avctx, AVFrame *pic);
+  static void ReleaseBuffer(AVCodecContext *avctx, AVFrame *pic);
+  static int  RegetBuffer(AVCodecContext *avctx, AVFrame *pic);
+
+  void UpdateSkip();
 
   int  FilterOpen(const CStdString& filters, bool scale);
   void FilterClose();
@@ -123,6 +132,11 @@ protected:
   bool              m_bSoftware;
   bool  m_isHi10p;
   IHardwareDecoder *m_pHardware;
+  CDVDVideoFramePool *m_pFramePool;
+  CDVDVideoDecodeControl m_control;
+  double m_decodeTime;     // spent decoding since the last picture
+  AVDiscard m_skipLoopFilter; // as configured for the stream
+  bool   m_bDropState;
   int m_iLastKeyframe;
   double m_dts;
   bool   m_started;
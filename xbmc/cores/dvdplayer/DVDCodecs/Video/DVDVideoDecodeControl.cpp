@@ -0,0 +1,100 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDVideoDecodeControl.h"
+#include "DVDClock.h"
+#include "utils/log.h"
+
+// load above which a picture counts as decoded too slow, the rest of the
+// frame duration is needed for conversion, rendering and jitter
+#define LOAD_HIGH       0.85
+// load below which a picture counts as decoded with time to spare
+#define LOAD_LOW        0.55
+// pictures too slow in a row before stepping up, ~half a second at 50fps
+#define STEP_UP_COUNT   25
+// pictures with time to spare in a row before stepping down, ~10 seconds
+#define STEP_DOWN_COUNT 500
+// late pictures only count if the queue isn't starved, then the input is the
+// problem, and if decoding takes a fair share of the time
+#define QUEUE_STARVED   10
+
+CDVDVideoDecodeControl::CDVDVideoDecodeControl()
+{
+  Reset(0.0);
+}
+
+void CDVDVideoDecodeControl::Reset(double frameDuration)
+{
+  if (frameDuration <= 0.0 || frameDuration > DVD_TIME_BASE)
+    frameDuration = DVD_TIME_BASE / 25;
+
+  m_frameDuration    = frameDuration;
+  m_load             = 0.0;
+  m_skipLevel        = 0;
+  m_queueLevel       = 100;
+  m_lateFrames       = 0;
+  m_overloaded       = 0;
+  m_underloaded      = 0;
+}
+
+void CDVDVideoDecodeControl::SetPlayerLoad(int queueLevel, int lateFrames)
+{
+  m_queueLevel = queueLevel;
+  m_lateFrames = lateFrames;
+}
+
+void CDVDVideoDecodeControl::AddPicture(double decodeTime)
+{
+  // smooth over the cost difference of frame types
+  double load = decodeTime / m_frameDuration;
+  m_load = m_load * 0.9 + load * 0.1;
+
+  bool late = m_lateFrames > 2 && m_queueLevel > QUEUE_STARVED && m_load > LOAD_LOW;
+
+  if (m_load > LOAD_HIGH || late)
+  {
+    m_underloaded = 0;
+    if (++m_overloaded < STEP_UP_COUNT)
+      return;
+    m_overloaded = 0;
+
+    if (m_skipLevel < DECODECONTROL_MAX_SKIP)
+    {
+      m_skipLevel++;
+      CLog::Log(LOGDEBUG, "CDVDVideoDecodeControl - decoder at %d%% load%s, skip level %d",
+                GetLoad(), late ? " and late" : "", m_skipLevel);
+    }
+  }
+  else if (m_load < LOAD_LOW && m_lateFrames == 0)
+  {
+    m_overloaded = 0;
+    if (m_skipLevel == 0 || ++m_underloaded < STEP_DOWN_COUNT)
+      return;
+    m_underloaded = 0;
+
+    m_skipLevel--;
+    CLog::Log(LOGDEBUG, "CDVDVideoDecodeControl - decoder at %d%% load, skip level %d", GetLoad(), m_skipLevel);
+  }
+  else
+  {
+    m_overloaded  = 0;
+    m_underloaded = 0;
+  }
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+// highest level of CDVDVideoDecodeControl::GetSkipLevel
+#define DECODECONTROL_MAX_SKIP 3
+
+/*
+ * Tunes a software decoder to the load it's under, before the player has
+ * to drop frames.
+ *
+ * The decoder reports the time it spent on each picture, the player how
+ * full its packet queue is and how many pictures in a row were late. When
+ * decoding takes most of a frame duration, or pictures are late while
+ * packets are waiting, the controller raises the skip level one step at
+ * a time. Once decoding has been comfortably fast for a while the skip level
+ * is lowered again.
+ *
+ * All times are in DVD_TIME_BASE units.
+ */
+class CDVDVideoDecodeControl
+{
+public:
+  CDVDVideoDecodeControl();
+
+  /*
+   * Start over for a stream
+   * frameDuration : duration of a frame, 0 if unknown
+   */
+  void Reset(double frameDuration);
+
+  // time spent decoding since the last picture
+  void AddPicture(double decodeTime);
+
+  /*
+   * State of the player
+   * queueLevel : fill level of the packet queue in percent
+   * lateFrames : pictures in a row that were presented late
+   */
+  void SetPlayerLoad(int queueLevel, int lateFrames);
+
+  // 0 for full quality, up to DECODECONTROL_MAX_SKIP
+  int  GetSkipLevel() const    { return m_skipLevel; }
+  // average decode time in percent of the frame duration
+  int  GetLoad() const         { return (int)(m_load * 100.0 + 0.5); }
+
+private:
+  double m_frameDuration;
+  double m_load;
+  int    m_skipLevel;
+  int    m_queueLevel;
+  int    m_lateFrames;
+  int    m_overloaded;  // pictures in a row decoded too slow
+  int    m_underloaded; // pictures in a row decoded with time to spare
+};
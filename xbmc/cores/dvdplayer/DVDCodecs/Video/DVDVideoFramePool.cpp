@@ -0,0 +1,213 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "system.h"
+#include "DVDVideoFramePool.h"
+#include "threads/Atomics.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+#define ALIGN(value, alignment) (((value)+((alignment)-1))&~((alignment)-1))
+
+struct FramePlane
+{
+  int shift_x; // chroma subsampling
+  int shift_y;
+  int bpp;     // bytes per sample
+};
+
+static const FramePlane planes_yuv420p[] = { {0, 0, 1}, {1, 1, 1}, {1, 1, 1} };
+static const FramePlane planes_nv12[]    = { {0, 0, 1}, {1, 1, 2} };
+static const FramePlane planes_yuv422[]  = { {0, 0, 2} };
+
+static int GetPlanes(ERenderFormat format, const FramePlane **planes)
+{
+  switch(format)
+  {
+    case RENDER_FMT_YUV420P:
+      *planes = planes_yuv420p;
+      return 3;
+    case RENDER_FMT_NV12:
+      *planes = planes_nv12;
+      return 2;
+    case RENDER_FMT_YUYV422:
+    case RENDER_FMT_UYVY422:
+      *planes = planes_yuv422;
+      return 1;
+    default:
+      *planes = NULL;
+      return 0;
+  }
+}
+
+CDVDVideoFrameBuffer::CDVDVideoFrameBuffer(CDVDVideoFramePool *pool, ERenderFormat format, int width, int height, int edge)
+  : m_refs(0)
+  , m_pool(pool)
+  , m_format(format)
+  , m_edge(edge)
+  , m_memory(NULL)
+{
+  iWidth  = width;
+  iHeight = height;
+  memset(data     , 0, sizeof(data));
+  memset(iLineSize, 0, sizeof(iLineSize));
+
+  const FramePlane *planes;
+  int count = GetPlanes(format, &planes);
+  if (count == 0)
+    return;
+
+  // the chroma planes are laid out from the luma one, so chroma strides are
+  // an exact fraction of the luma stride like decoders tend to expect
+  int left   = ALIGN(edge * planes[0].bpp, FRAMEPOOL_ALIGN * 2);
+  int stride = ALIGN(left + (width + edge) * planes[0].bpp, FRAMEPOOL_ALIGN * 2);
+
+  int offset[4];
+  int size = 0;
+  for (int i = 0; i < count; i++)
+  {
+    const FramePlane &plane = planes[i];
+    int rows = ((height + (1 << plane.shift_y) - 1) >> plane.shift_y) + 2 * (edge >> plane.shift_y);
+
+    iLineSize[i] = (stride >> plane.shift_x) * plane.bpp / planes[0].bpp;
+    offset[i]    = size + (edge >> plane.shift_y) * iLineSize[i]
+                        + (left >> plane.shift_x) * plane.bpp / planes[0].bpp;
+    size        += iLineSize[i] * rows;
+  }
+
+  // some simd code reads a little past the last row
+  m_memory = (uint8_t*)_aligned_malloc(size + FRAMEPOOL_ALIGN, FRAMEPOOL_ALIGN);
+  if (!m_memory)
+    return;
+
+  for (int i = 0; i < count; i++)
+    data[i] = m_memory + offset[i];
+}
+
+CDVDVideoFrameBuffer::~CDVDVideoFrameBuffer()
+{
+  if (m_memory)
+    _aligned_free(m_memory);
+}
+
+void CDVDVideoFrameBuffer::Lock()
+{
+  AtomicIncrement(&m_refs);
+}
+
+long CDVDVideoFrameBuffer::Release()
+{
+  long count = AtomicDecrement(&m_refs);
+  if (count == 0)
+    m_pool->Recycle(this);
+  return count;
+}
+
+bool CDVDVideoFrameBuffer::Matches(ERenderFormat format, int width, int height, int edge) const
+{
+  return m_format == format
+      && (int)iWidth == width
+      && (int)iHeight == height
+      && m_edge == edge;
+}
+
+CDVDVideoFramePool::CDVDVideoFramePool(unsigned int maxFree)
+  : m_refs(1)
+  , m_maxFree(maxFree)
+{
+}
+
+CDVDVideoFramePool::~CDVDVideoFramePool()
+{
+  Flush();
+}
+
+void CDVDVideoFramePool::Lock()
+{
+  AtomicIncrement(&m_refs);
+}
+
+long CDVDVideoFramePool::Release()
+{
+  long count = AtomicDecrement(&m_refs);
+  if (count == 0)
+    delete this;
+  return count;
+}
+
+CDVDVideoFrameBuffer* CDVDVideoFramePool::Get(ERenderFormat format, int width, int height, int edge)
+{
+  CDVDVideoFrameBuffer *frame = NULL;
+  {
+    CSingleLock lock(m_section);
+    for (std::list<CDVDVideoFrameBuffer*>::iterator it = m_free.begin(); it != m_free.end(); ++it)
+    {
+      if ((*it)->Matches(format, width, height, edge))
+      {
+        frame = *it;
+        m_free.erase(it);
+        break;
+      }
+    }
+  }
+
+  if (!frame)
+  {
+    frame = new CDVDVideoFrameBuffer(this, format, width, height, edge);
+    if (!frame->m_memory)
+    {
+      CLog::Log(LOGERROR, "CDVDVideoFramePool::Get - unable to allocate %dx%d frame of format %d", width, height, format);
+      delete frame;
+      return NULL;
+    }
+  }
+
+  // each frame out of the pool keeps it alive
+  Lock();
+  frame->m_refs = 1;
+  return frame;
+}
+
+void CDVDVideoFramePool::Recycle(CDVDVideoFrameBuffer *frame)
+{
+  {
+    CSingleLock lock(m_section);
+    m_free.push_front(frame);
+    if (m_free.size() > m_maxFree)
+    {
+      frame = m_free.back();
+      m_free.pop_back();
+    }
+    else
+      frame = NULL;
+  }
+  delete frame;
+
+  // may delete the pool, so not under the lock
+  Release();
+}
+
+void CDVDVideoFramePool::Flush()
+{
+  CSingleLock lock(m_section);
+  for (std::list<CDVDVideoFrameBuffer*>::iterator it = m_free.begin(); it != m_free.end(); ++it)
+    delete *it;
+  m_free.clear();
+}
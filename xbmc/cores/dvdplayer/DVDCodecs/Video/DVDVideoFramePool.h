@@ -0,0 +1,116 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <list>
+#include <stdint.h>
+
+#include "DVDVideoCodecInfo.h"
+#include "cores/VideoRenderers/RenderFormats.h"
+#include "threads/CriticalSection.h"
+
+class CDVDVideoFramePool;
+
+// alignment of the start of each plane and of its rows
+#define FRAMEPOOL_ALIGN 32
+
+/*
+ * Refcounted frame allocated by a CDVDVideoFramePool. data[] and iLineSize[]
+ * describe the visible picture, rows and planes are FRAMEPOOL_ALIGN aligned
+ * and may be surrounded by an edge a decoder can draw into.
+ * The frame goes back to its pool when the last reference is released.
+ */
+class CDVDVideoFrameBuffer : public CDVDVideoCodecBuffer
+{
+public:
+  // reference counting
+  virtual void          Lock();
+  virtual long          Release();
+  virtual bool          IsValid() { return true; }
+
+  ERenderFormat         GetFormat() const { return m_format; }
+  // someone besides the caller holds a reference, e.g. the renderer
+  bool                  IsShared() const { return m_refs > 1; }
+
+private:
+  friend class CDVDVideoFramePool;
+
+  CDVDVideoFrameBuffer(CDVDVideoFramePool *pool, ERenderFormat format, int width, int height, int edge);
+  // private because we are reference counted
+  virtual              ~CDVDVideoFrameBuffer();
+
+  bool                  Matches(ERenderFormat format, int width, int height, int edge) const;
+
+  long                  m_refs;
+  CDVDVideoFramePool   *m_pool;
+  ERenderFormat         m_format;
+  int                   m_edge;
+  uint8_t              *m_memory;
+};
+
+/*
+ * Pool of frame buffers for software decoded or converted pictures.
+ *
+ * Frames are handed out with a single reference. Whoever keeps the planes
+ * around, the decoder, a post processing stage or the renderer, holds a
+ * reference, so a picture can travel from the decoder to the renderer
+ * without being copied. Released frames are kept for reuse, so in steady
+ * state no memory is allocated per frame.
+ *
+ * The pool itself is refcounted too, every frame handed out holds a
+ * reference to it: an owner can release the pool while the renderer still
+ * shows its last frames.
+ *
+ * Supported formats are RENDER_FMT_YUV420P, RENDER_FMT_NV12,
+ * RENDER_FMT_YUYV422 and RENDER_FMT_UYVY422.
+ */
+class CDVDVideoFramePool
+{
+public:
+  CDVDVideoFramePool(unsigned int maxFree = 8);
+
+  void                  Lock();
+  long                  Release();
+
+  /*
+   * Get a frame with a reference owned by the caller
+   * width, height : size of the picture in pixels
+   * edge          : pixels of margin around the picture, luma samples
+   * returns NULL if the format isn't supported or out of memory
+   */
+  CDVDVideoFrameBuffer* Get(ERenderFormat format, int width, int height, int edge = 0);
+
+  // drop all frames kept for reuse
+  void                  Flush();
+
+private:
+  friend class CDVDVideoFrameBuffer;
+
+  // private because we are reference counted
+  ~CDVDVideoFramePool();
+
+  void                  Recycle(CDVDVideoFrameBuffer *frame);
+
+  long                  m_refs;
+  unsigned int          m_maxFree;
+  CCriticalSection      m_section;
+  std::list<CDVDVideoFrameBuffer*> m_free; ///< most recently released first
+};
@@ -19,6 +19,7 @@
  */
 
 #include "DVDVideoPPFFmpeg.h"
+#include "DVDVideoFramePool.h"
 #include "utils/log.h"
 
 CDVDVideoPPFFmpeg::CDVDVideoPPFFmpeg(const CStdString& mType)
@@ -29,10 +30,13 @@ CDVDVideoPPFFmpeg::CDVDVideoPPFFmpeg(const CStdString& mType)
   m_iInitWidth = m_iInitHeight = 0;
   m_deinterlace = false;
   memset(&m_FrameBuffer, 0, sizeof(DVDVideoPicture));
+  m_pFramePool = NULL;
+  m_pFrame = NULL;
 }
 CDVDVideoPPFFmpeg::~CDVDVideoPPFFmpeg()
 {
   Dispose();
+  SAFE_RELEASE(m_pFramePool);
 }
 void CDVDVideoPPFFmpeg::Dispose()
 {
@@ -47,19 +51,8 @@ void CDVDVideoPPFFmpeg::Dispose()
     m_pContext = NULL;
   }
 
-  if( m_FrameBuffer.iFlags & DVP_FLAG_ALLOCATED )
-  {
-    for( int i = 0; i<4; i++ )
-    {
-      if( m_FrameBuffer.data[i] )
-      {
-        _aligned_free(m_FrameBuffer.data[i]);
-        m_FrameBuffer.data[i] = NULL;
-        m_FrameBuffer.iLineSize[i] = 0;
-      }
-    }
-    m_FrameBuffer.iFlags &= ~DVP_FLAG_ALLOCATED;
-  }
+  SAFE_RELEASE(m_pFrame);
+  memset(&m_FrameBuffer, 0, sizeof(DVDVideoPicture));
 
   m_iInitWidth = 0;
   m_iInitHeight = 0;
@@ -162,41 +155,30 @@ bool CDVDVideoPPFFmpeg::Process(DVDVideoPicture* pPicture)
 
 bool CDVDVideoPPFFmpeg::CheckFrameBuffer(const DVDVideoPicture* pSource)
 {
-  if( m_FrameBuffer.iFlags & DVP_FLAG_ALLOCATED && (m_FrameBuffer.iWidth != pSource->iWidth || m_FrameBuffer.iHeight != pSource->iHeight))
+  // the previous output may still be shown by the renderer, which references
+  // it rather than copying, so every picture is processed into a fresh frame
+  SAFE_RELEASE(m_pFrame);
+  memset(&m_FrameBuffer, 0, sizeof(DVDVideoPicture));
+
+  if(!m_pFramePool)
+    m_pFramePool = new CDVDVideoFramePool();
+
+  m_pFrame = m_pFramePool->Get(RENDER_FMT_YUV420P, pSource->iWidth, pSource->iHeight);
+  if(!m_pFrame)
   {
-    m_FrameBuffer.iFlags &= ~DVP_FLAG_ALLOCATED;
-    for(int i = 0;i<3;i++)
-      if(m_FrameBuffer.data[i])
-      {
-        delete[] m_FrameBuffer.data[i];
-        m_FrameBuffer.data[i] = NULL;
-      }
+    CLog::Log(LOGERROR, "CDVDVideoDeinterlace::AllocBufferOfType - Unable to allocate framebuffer, bailing");
+    return false;
   }
 
-  if(!(m_FrameBuffer.iFlags & DVP_FLAG_ALLOCATED))
+  for(int i = 0; i < 4; i++)
   {
-    memset(&m_FrameBuffer, 0, sizeof(DVDVideoPicture));
-
-    m_FrameBuffer.iLineSize[0] = pSource->iLineSize[0];   //Y
-    m_FrameBuffer.iLineSize[1] = pSource->iLineSize[1]; //U
-    m_FrameBuffer.iLineSize[2] = pSource->iLineSize[2]; //V
-    m_FrameBuffer.iLineSize[3] = 0;
-
-    m_FrameBuffer.iWidth = pSource->iWidth;
-    m_FrameBuffer.iHeight = pSource->iHeight;
-
-    m_FrameBuffer.data[0] = (uint8_t*)_aligned_malloc(m_FrameBuffer.iLineSize[0] * m_FrameBuffer.iHeight  , 16);
-    m_FrameBuffer.data[1] = (uint8_t*)_aligned_malloc(m_FrameBuffer.iLineSize[1] * m_FrameBuffer.iHeight/2, 16);
-    m_FrameBuffer.data[2] = (uint8_t*)_aligned_malloc(m_FrameBuffer.iLineSize[2] * m_FrameBuffer.iHeight/2, 16);
-
-    if( !m_FrameBuffer.data[0] || !m_FrameBuffer.data[1] || !m_FrameBuffer.data[2])
-    {
-      CLog::Log(LOGERROR, "CDVDVideoDeinterlace::AllocBufferOfType - Unable to allocate framebuffer, bailing");
-      return false;
-    }
-
-    m_FrameBuffer.iFlags |= DVP_FLAG_ALLOCATED;
+    m_FrameBuffer.data[i]      = m_pFrame->data[i];
+    m_FrameBuffer.iLineSize[i] = m_pFrame->iLineSize[i];
   }
+  m_FrameBuffer.iWidth    = pSource->iWidth;
+  m_FrameBuffer.iHeight   = pSource->iHeight;
+  m_FrameBuffer.iFlags    = DVP_FLAG_ALLOCATED;
+  m_FrameBuffer.codecinfo = m_pFrame;
 
   return true;
 }
@@ -23,6 +23,9 @@
 #include "DVDVideoCodec.h"
 #include "DllPostProc.h"
 
+class CDVDVideoFramePool;
+class CDVDVideoFrameBuffer;
+
 class CDVDVideoPPFFmpeg
 {
 public:
@@ -44,6 +47,8 @@ protected:
   bool m_deinterlace;
 
   DVDVideoPicture m_FrameBuffer;
+  CDVDVideoFramePool   *m_pFramePool;
+  CDVDVideoFrameBuffer *m_pFrame; // backs m_FrameBuffer
   DVDVideoPicture *m_pSource;
   DVDVideoPicture *m_pTarget;
 
@@ -273,6 +273,11 @@ public:
    */
   virtual void GetChapterName(std::string& strChapterName) {}
 
+  /*
+   * Get the start of a chapter in msec from stream start, -1 if unknown
+   */
+  virtual int GetChapterPos(int chapter) { return -1; }
+
   /*
    * Set the playspeed, if demuxer can handle different
    * speeds of playback
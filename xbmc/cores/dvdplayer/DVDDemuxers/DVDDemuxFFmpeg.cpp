@@ -1387,6 +1387,20 @@ void CDVDDemuxFFmpeg::GetChapterName(std::string& strChapterName)
   }
 }
 
+int CDVDDemuxFFmpeg::GetChapterPos(int chapter)
+{
+  // chapters of the input stream are only known once seeked to
+  if(dynamic_cast<CDVDInputStream::IChapter*>(m_pInput))
+    return -1;
+
+  if(m_pFormatContext == NULL
+  || chapter < 1 || chapter > (int)m_pFormatContext->nb_chapters)
+    return -1;
+
+  AVChapter *ch = m_pFormatContext->chapters[chapter-1];
+  return DVD_TIME_TO_MSEC(ConvertTimestamp(ch->start, ch->time_base.den, ch->time_base.num));
+}
+
 bool CDVDDemuxFFmpeg::SeekChapter(int chapter, double* startpts)
 {
   if(chapter < 1)
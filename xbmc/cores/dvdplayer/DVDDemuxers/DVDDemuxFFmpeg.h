@@ -109,6 +109,7 @@ public:
   int GetChapterCount();
   int GetChapter();
   void GetChapterName(std::string& strChapterName);
+  int GetChapterPos(int chapter);
   virtual void GetStreamCodecName(int iStreamId, CStdString &strName);
 
   bool Aborted();
@@ -24,6 +24,7 @@
 #include "settings/AdvancedSettings.h"
 #include "pictures/Picture.h"
 #include "video/VideoInfoTag.h"
+#include "video/VideoThumbStrip.h"
 #include "filesystem/StackDirectory.h"
 #include "utils/log.h"
 #include "utils/TimeUtils.h"
@@ -31,6 +32,7 @@
 
 #include "DVDClock.h"
 #include "DVDStreamInfo.h"
+#include "DVDThumbCodecCache.h"
 #include "DVDInputStreams/DVDInputStream.h"
 #ifdef HAVE_LIBBLURAY
 #include "DVDInputStreams/DVDInputStreamBluray.h"
@@ -92,7 +94,7 @@ int DegreeToOrientation(int degrees)
   }
 }
 
-bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &details, CStreamDetails *pStreamDetails)
+bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &details, CStreamDetails *pStreamDetails, CDVDThumbCodecCache *pCodecCache)
 {
   std::string redactPath = CURL::GetRedacted(strPath);
   unsigned int nTime = XbmcThreads::SystemClockMillis();
@@ -190,21 +192,15 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &deta
 
   if (nVideoStream != -1)
   {
-    CDVDVideoCodec *pVideoCodec;
-
     CDVDStreamInfo hint(*pDemuxer->GetStream(nVideoStream), true);
     hint.software = true;
 
-    if (hint.codec == AV_CODEC_ID_MPEG2VIDEO || hint.codec == AV_CODEC_ID_MPEG1VIDEO)
-    {
-      // libmpeg2 is not thread safe so use ffmepg for mpeg2/mpeg1 thumb extraction
-      CDVDCodecOptions dvdOptions;
-      pVideoCodec = CDVDFactoryCodec::OpenCodec(new CDVDVideoCodecFFmpeg(), hint, dvdOptions);
-    }
-    else
-    {
-      pVideoCodec = CDVDFactoryCodec::CreateVideoCodec( hint );
-    }
+    // without a cache of the caller, use one for this file only
+    CDVDThumbCodecCache localCache;
+    if (!pCodecCache)
+      pCodecCache = &localCache;
+    CDVDVideoCodec *pVideoCodec = pCodecCache->Acquire(hint);
+    bool bCodecOk = true;
 
     if (pVideoCodec)
     {
@@ -239,7 +235,10 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &deta
           CDVDDemuxUtils::FreeDemuxPacket(pPacket);
 
           if (iDecoderState & VC_ERROR)
+          {
+            bCodecOk = false;
             break;
+          }
 
           if (iDecoderState & VC_PICTURE)
           {
@@ -257,7 +256,9 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &deta
         {
           {
             unsigned int nWidth = g_advancedSettings.GetThumbSize();
-            double aspect = (double)picture.iDisplayWidth / (double)picture.iDisplayHeight;
+            double aspect = (double)picture.iWidth / (double)picture.iHeight;
+            if (picture.iDisplayWidth > 0 && picture.iDisplayHeight > 0)
+              aspect = (double)picture.iDisplayWidth / (double)picture.iDisplayHeight;
             if(hint.forced_aspect && hint.aspect != 0)
               aspect = hint.aspect;
             unsigned int nHeight = (unsigned int)((double)g_advancedSettings.GetThumbSize() / aspect);
@@ -294,7 +295,7 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &deta
           CLog::Log(LOGDEBUG,"%s - decode failed in %s after %d packets.", __FUNCTION__, redactPath.c_str(), packetsTried);
         }
       }
-      delete pVideoCodec;
+      pCodecCache->Release(pVideoCodec, hint, bCodecOk);
     }
   }
 
@@ -315,6 +316,172 @@ bool CDVDFileInfo::ExtractThumb(const CStdString &strPath, CTextureDetails &deta
   return bOk;
 }
 
+bool CDVDFileInfo::ExtractThumbStrip(const CStdString &strPath, CTextureDetails &details, CDVDThumbCodecCache *pCodecCache, const CJob *pJob)
+{
+  std::string redactPath = CURL::GetRedacted(strPath);
+  unsigned int nTime = XbmcThreads::SystemClockMillis();
+
+  std::auto_ptr<CDVDInputStream> input(CDVDFactoryInputStream::CreateInputStream(NULL, strPath, ""));
+  if (!input.get() || input->IsStreamType(DVDSTREAM_TYPE_DVD) || !input->Open(strPath.c_str(), ""))
+  {
+    CLog::Log(LOGERROR, "%s - Error opening %s", __FUNCTION__, redactPath.c_str());
+    return false;
+  }
+
+  std::auto_ptr<CDVDDemux> demux;
+  try
+  {
+    demux.reset(CDVDFactoryDemuxer::CreateDemuxer(input.get()));
+  }
+  catch(...)
+  {
+    CLog::Log(LOGERROR, "%s - Exception thrown when opening demuxer", __FUNCTION__);
+  }
+  if (!demux.get())
+    return false;
+
+  int nVideoStream = -1;
+  for (int i = 0; i < demux->GetNrOfStreams(); i++)
+  {
+    CDemuxStream* pStream = demux->GetStream(i);
+    if (pStream)
+    {
+      if (pStream->type == STREAM_VIDEO && nVideoStream < 0)
+        nVideoStream = i;
+      else
+        pStream->SetDiscard(AVDISCARD_ALL);
+    }
+  }
+
+  int duration = demux->GetStreamLength();
+  if (nVideoStream < 0 || duration <= 0)
+    return false;
+
+  std::vector<int> chapters;
+  for (int i = 1; i <= demux->GetChapterCount() && i <= CVideoThumbStrip::CHAPTER_TILES; i++)
+    chapters.push_back(demux->GetChapterPos(i));
+  std::vector<int> times = CVideoThumbStrip::GetTileTimes(duration, chapters);
+
+  CDVDStreamInfo hint(*demux->GetStream(nVideoStream), true);
+  hint.software = true;
+
+  CDVDThumbCodecCache localCache;
+  if (!pCodecCache)
+    pCodecCache = &localCache;
+  CDVDVideoCodec *pVideoCodec = pCodecCache->Acquire(hint);
+  if (!pVideoCodec)
+    return false;
+
+  const int tileWidth   = CVideoThumbStrip::TILE_WIDTH;
+  const int tileHeight  = CVideoThumbStrip::TILE_HEIGHT;
+  const int stripWidth  = tileWidth  * CVideoThumbStrip::COLUMNS;
+  const int stripHeight = tileHeight * CVideoThumbStrip::ROWS;
+  std::vector<uint32_t> strip(stripWidth * stripHeight, 0xff000000);
+
+  DllSwScale dllSwScale;
+  dllSwScale.Load();
+  struct SwsContext *context = NULL;
+
+  bool bCodecOk = true;
+  bool bCancelled = false;
+  int tiles = 0;
+  for (size_t i = 0; i < times.size() && bCodecOk; i++)
+  {
+    if (pJob && pJob->ShouldCancel(i, times.size()))
+    {
+      bCancelled = true;
+      break;
+    }
+
+    if (times[i] < 0 || !demux->SeekTime(times[i], true))
+      continue;
+
+    // the thumb decoders only output key frames, the first after the seek
+    pVideoCodec->Reset();
+    DVDVideoPicture picture;
+    memset(&picture, 0, sizeof(picture));
+    bool bPicture = false;
+    for (int packets = 0; packets < demux->GetNrOfStreams() * 80 && !bPicture; packets++)
+    {
+      DemuxPacket* pPacket = demux->Read();
+      if (!pPacket)
+        break;
+
+      if (pPacket->iStreamId != nVideoStream)
+      {
+        CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+        continue;
+      }
+
+      int iDecoderState = pVideoCodec->Decode(pPacket->pData, pPacket->iSize, pPacket->dts, pPacket->pts);
+      CDVDDemuxUtils::FreeDemuxPacket(pPacket);
+
+      if (iDecoderState & VC_ERROR)
+      {
+        bCodecOk = false;
+        break;
+      }
+
+      if (iDecoderState & VC_PICTURE)
+      {
+        memset(&picture, 0, sizeof(picture));
+        bPicture = pVideoCodec->GetPicture(&picture) && !(picture.iFlags & DVP_FLAG_DROPPED);
+      }
+    }
+
+    if (!bPicture || picture.iWidth <= 0 || picture.iHeight <= 0)
+      continue;
+
+    // fit the picture in the tile, keeping its aspect
+    double aspect = (double)picture.iWidth / (double)picture.iHeight;
+    if (picture.iDisplayWidth > 0 && picture.iDisplayHeight > 0)
+      aspect = (double)picture.iDisplayWidth / (double)picture.iDisplayHeight;
+    if (hint.forced_aspect && hint.aspect != 0)
+      aspect = hint.aspect;
+    int width  = tileWidth;
+    int height = (int)(tileWidth / aspect + 0.5);
+    if (height > tileHeight || height <= 0)
+    {
+      height = tileHeight;
+      width  = std::min(tileWidth, (int)(tileHeight * aspect + 0.5));
+    }
+
+    context = dllSwScale.sws_getCachedContext(context, picture.iWidth, picture.iHeight, PIX_FMT_YUV420P,
+                                              width, height, PIX_FMT_BGRA, SWS_FAST_BILINEAR | SwScaleCPUFlags(),
+                                              NULL, NULL, NULL);
+    if (!context)
+      continue;
+
+    int x = (i % CVideoThumbStrip::COLUMNS) * tileWidth  + (tileWidth  - width)  / 2;
+    int y = (i / CVideoThumbStrip::COLUMNS) * tileHeight + (tileHeight - height) / 2;
+    uint8_t *src[] = { picture.data[0], picture.data[1], picture.data[2], 0 };
+    int     srcStride[] = { picture.iLineSize[0], picture.iLineSize[1], picture.iLineSize[2], 0 };
+    uint8_t *dst[] = { (uint8_t*)&strip[y * stripWidth + x], 0, 0, 0 };
+    int     dstStride[] = { stripWidth * 4, 0, 0, 0 };
+    dllSwScale.sws_scale(context, src, srcStride, 0, picture.iHeight, dst, dstStride);
+    tiles++;
+  }
+
+  if (context)
+    dllSwScale.sws_freeContext(context);
+  dllSwScale.Unload();
+  pCodecCache->Release(pVideoCodec, hint, bCodecOk);
+
+  bool bOk = false;
+  if (tiles > 0 && !bCancelled)
+  {
+    details.width  = stripWidth;
+    details.height = stripHeight;
+    bOk = CPicture::CreateThumbnailFromSurface((const unsigned char*)&strip[0], stripWidth, stripHeight,
+                                               stripWidth * 4, CTextureCache::GetCachedPath(details.file));
+  }
+
+  unsigned int nTotalTime = XbmcThreads::SystemClockMillis() - nTime;
+  CLog::Log(LOGDEBUG, "%s - measured %u ms to extract %d of %u tiles from file <%s>", __FUNCTION__,
+            nTotalTime, tiles, (unsigned int)times.size(), redactPath.c_str());
+  return bOk;
+}
+
 /**
  * \brief Open the item pointed to by pItem and extact streamdetails
  * \return true if the stream details have changed
@@ -27,13 +27,19 @@ class CDVDDemux;
 class CStreamDetails;
 class CStreamDetailSubtitle;
 class CDVDInputStream;
+class CDVDThumbCodecCache;
 class CTextureDetails;
+class CJob;
 
 class CDVDFileInfo
 {
 public:
   // Extract a thumbnail immage from the media at strPath, optionally populating a streamdetails class with the data
-  static bool ExtractThumb(const CStdString &strPath, CTextureDetails &details, CStreamDetails *pStreamDetails);
+  // decoders are taken from and returned to pCodecCache, if given, to reuse them across files
+  static bool ExtractThumb(const CStdString &strPath, CTextureDetails &details, CStreamDetails *pStreamDetails, CDVDThumbCodecCache *pCodecCache = NULL);
+
+  // Extract the key frames of the tiles of a CVideoThumbStrip into a single image, pJob is checked for cancellation
+  static bool ExtractThumbStrip(const CStdString &strPath, CTextureDetails &details, CDVDThumbCodecCache *pCodecCache = NULL, const CJob *pJob = NULL);
 
   // Probe the files streams and store the info in the VideoInfoTag
   static bool GetFileStreamDetails(CFileItem *pItem);
@@ -25,6 +25,7 @@
 #include "DVDCodecs/Overlay/DVDOverlayImage.h"
 #include "DVDCodecs/Overlay/DVDOverlaySSA.h"
 #include "cores/VideoRenderers/OverlayRendererUtil.h"
+#include "threads/SingleLock.h"
 
 #define CLAMP(a, min, max) ((a) > (max) ? (max) : ( (a) < (min) ? (min) : a ))
 
@@ -71,6 +72,8 @@ void CDVDOverlayRenderer::Render(DVDPictureRenderer* pPicture, CDVDOverlaySSA* p
   height = pPicture->height;
   width = pPicture->width;
 
+  // the renderer is shared with the overlay glyph cache
+  CSingleLock lock(pOverlay->m_libass->GetSection());
   ASS_Image* img = pOverlay->m_libass->RenderImage(width, height, pts);
 
   int depth = OVERLAY::GetStereoscopicDepth();
@@ -149,6 +149,7 @@ CDVDPlayerVideo::CDVDPlayerVideo( CDVDClock* pClock
 
   m_iCurrentPts = DVD_NOPTS_VALUE;
   m_iDroppedFrames = 0;
+  memset(&m_decodeLoad, 0, sizeof(m_decodeLoad));
   m_fFrameRate = 25;
   m_bCalcFrameRate = false;
   m_fStableFrameRate = 0.0;
@@ -256,6 +257,7 @@ void CDVDPlayerVideo::OpenStream(CDVDStreamInfo &hint, CDVDVideoCodec* codec)
   m_stalled = m_messageQueue.GetPacketCount(CDVDMsg::DEMUXER_PACKET) == 0;
   m_started = false;
   m_codecname = m_pVideoCodec->GetName();
+  memset(&m_decodeLoad, 0, sizeof(m_decodeLoad));
   m_packets.clear();
 }
 
@@ -286,6 +288,7 @@ void CDVDPlayerVideo::CloseStream(bool bWaitForBuffers)
     CDVDCodecUtils::FreePicture(m_pTempOverlayPicture);
     m_pTempOverlayPicture = NULL;
   }
+  CDVDCodecUtils::FlushFramePool();
 
   //tell the clock we stopped playing video
   m_pClock->UpdateFramerate(0.0);
@@ -524,6 +527,7 @@ void CDVDPlayerVideo::Process()
       // both frames will be dropped in that case instead of just the first
       // decoder still needs to provide an empty image structure, with correct flags
       m_pVideoCodec->SetDropState(bRequestDrop);
+      m_pVideoCodec->SetPlayerLoad(GetLevel(), m_iLateFrames);
 
       // ask codec to do deinterlacing if possible
       EDEINTERLACEMODE mDeintMode = CMediaSettings::Get().GetCurrentVideoSettings().m_DeinterlaceMode;
@@ -549,6 +553,10 @@ void CDVDPlayerVideo::Process()
 
       int iDecoderState = m_pVideoCodec->Decode(pPacket->pData, pPacket->iSize, pPacket->dts, pPacket->pts);
 
+      DVDVideoDecodeLoad load;
+      if (m_pVideoCodec->GetDecodeLoad(load))
+        m_decodeLoad = load;
+
       // buffer packets so we can recover should decoder flush for some reason
       if(m_pVideoCodec->GetConvergeCount() > 0)
       {
@@ -567,6 +575,7 @@ void CDVDPlayerVideo::Process()
       {
         m_iDroppedFrames++;
         iDropped++;
+        g_renderManager.AddDroppedFrame();
       }
       // reset the request, the following while loop may break before
       // setting the flag to a new value
@@ -712,6 +721,7 @@ void CDVDPlayerVideo::Process()
             {
               m_iDroppedFrames++;
               iDropped++;
+              g_renderManager.AddDroppedFrame();
             }
             else
               iDropped = 0;
@@ -925,6 +935,8 @@ void CDVDPlayerVideo::ProcessOverlays(DVDVideoPicture* pSource, double pts)
       CDVDCodecUtils::CopyPicture(m_pTempOverlayPicture, pSource);
       memcpy(pSource->data     , m_pTempOverlayPicture->data     , sizeof(pSource->data));
       memcpy(pSource->iLineSize, m_pTempOverlayPicture->iLineSize, sizeof(pSource->iLineSize));
+      // the temp picture is drawn over again for the next frame, so the renderer must copy it
+      pSource->codecinfo = NULL;
     }
   }
 
@@ -1428,6 +1440,13 @@ std::string CDVDPlayerVideo::GetPlayerInfo()
   s << "fr:"     << fixed << setprecision(3) << m_fFrameRate;
   s << ", vq:"   << setw(2) << min(99,GetLevel()) << "%";
   s << ", dc:"   << m_codecname;
+  if (m_decodeLoad.threads > 0)
+  {
+    // decode load, threading and skip level
+    s << ", dl:" << m_decodeLoad.load << "%/"
+      << (m_decodeLoad.frameThreads ? "ft" : "st") << m_decodeLoad.threads
+      << "/sk" << m_decodeLoad.skipLevel;
+  }
   s << ", Mb/s:" << fixed << setprecision(2) << (double)GetVideoBitrate() / (1024.0*1024.0);
   s << ", drop:" << m_iDroppedFrames;
   s << ", skip:" << g_renderManager.GetSkippedFrames();
@@ -169,6 +169,7 @@ protected:
   bool m_stalled;
   bool m_started;
   std::string m_codecname;
+  DVDVideoDecodeLoad m_decodeLoad; // threads is 0 if the codec doesn't adapt
 
   BitstreamStats m_videoStats;
 
@@ -0,0 +1,123 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDSubtitleCache.h"
+#include "filesystem/File.h"
+#include "settings/Settings.h"
+#include "threads/SingleLock.h"
+#include "utils/StringUtils.h"
+
+// files kept, enough for the subtitles of a movie in a few languages
+#define CACHE_FILES 4
+
+CDVDSubtitleCache& CDVDSubtitleCache::Get()
+{
+  static CDVDSubtitleCache cache;
+  return cache;
+}
+
+bool CDVDSubtitleCache::GetVersion(const std::string& file, std::string& version)
+{
+  struct __stat64 st;
+  if (XFILE::CFile::Stat(file, &st) != 0)
+    return false;
+
+  version = StringUtils::Format("%" PRId64 ":%" PRId64 ":%s", (int64_t)st.st_size, (int64_t)st.st_mtime,
+                                CSettings::Get().GetString("subtitles.charset").c_str());
+  return true;
+}
+
+std::list<CDVDSubtitleCache::Entry>::iterator CDVDSubtitleCache::Find(const std::string& file)
+{
+  std::list<Entry>::iterator it;
+  for (it = m_entries.begin(); it != m_entries.end(); ++it)
+  {
+    if (it->file == file)
+      break;
+  }
+  if (it == m_entries.end())
+    return it;
+
+  std::string version;
+  if (!GetVersion(file, version) || version != it->version)
+  {
+    m_entries.erase(it);
+    return m_entries.end();
+  }
+
+  m_entries.splice(m_entries.begin(), m_entries, it);
+  return m_entries.begin();
+}
+
+CDVDSubtitleCache::TextPtr CDVDSubtitleCache::GetText(const std::string& file)
+{
+  CSingleLock lock(m_section);
+  std::list<Entry>::iterator it = Find(file);
+  if (it == m_entries.end())
+    return TextPtr();
+  return it->text;
+}
+
+void CDVDSubtitleCache::SetText(const std::string& file, const TextPtr& text)
+{
+  Entry entry;
+  entry.file = file;
+  entry.text = text;
+  if (!GetVersion(file, entry.version))
+    return;
+
+  CSingleLock lock(m_section);
+  std::list<Entry>::iterator it = Find(file);
+  if (it != m_entries.end())
+    m_entries.erase(it);
+
+  m_entries.push_front(entry);
+  if (m_entries.size() > CACHE_FILES)
+    m_entries.pop_back();
+}
+
+bool CDVDSubtitleCache::GetIndex(const std::string& file, const std::string& parser, SubtitleLines& lines)
+{
+  CSingleLock lock(m_section);
+  std::list<Entry>::iterator it = Find(file);
+  if (it == m_entries.end())
+    return false;
+
+  std::map<std::string, SubtitleLines>::const_iterator index = it->indexes.find(parser);
+  if (index == it->indexes.end())
+    return false;
+
+  lines = index->second;
+  return true;
+}
+
+void CDVDSubtitleCache::SetIndex(const std::string& file, const std::string& parser, const SubtitleLines& lines)
+{
+  CSingleLock lock(m_section);
+  std::list<Entry>::iterator it = Find(file);
+  if (it != m_entries.end())
+    it->indexes[parser] = lines;
+}
+
+void CDVDSubtitleCache::Clear()
+{
+  CSingleLock lock(m_section);
+  m_entries.clear();
+}
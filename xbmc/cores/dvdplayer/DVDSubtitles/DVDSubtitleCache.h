@@ -0,0 +1,81 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <list>
+#include <map>
+#include <string>
+#include <boost/shared_ptr.hpp>
+
+#include "DVDSubtitleLineCollection.h"
+#include "threads/CriticalSection.h"
+
+/*!
+ \brief Subtitle files read recently, with the index of their subtitles
+
+ Switching between the external subtitles of a movie, or playing it again,
+ opens the same files over and over. The converted text of the last few
+ files is kept together with the positions of the subtitles found in it by
+ each parser, so a file is read, converted and scanned only once as long as
+ it is unchanged on disk.
+ */
+class CDVDSubtitleCache
+{
+public:
+  typedef boost::shared_ptr<const std::string> TextPtr;
+
+  static CDVDSubtitleCache& Get();
+
+  /*!
+   \brief Get the utf-8 text of a file
+   \return the text, empty if the file isn't cached or changed since
+   */
+  TextPtr GetText(const std::string& file);
+  void    SetText(const std::string& file, const TextPtr& text);
+
+  /*!
+   \brief Get the subtitles a parser found in the cached text of a file
+   \param parser name of the parser and anything else the positions depend on
+   */
+  bool GetIndex(const std::string& file, const std::string& parser, SubtitleLines& lines);
+  void SetIndex(const std::string& file, const std::string& parser, const SubtitleLines& lines);
+
+  void Clear();
+
+private:
+  CDVDSubtitleCache() {}
+  CDVDSubtitleCache(const CDVDSubtitleCache&);
+  CDVDSubtitleCache& operator=(const CDVDSubtitleCache&);
+
+  struct Entry
+  {
+    std::string file;
+    std::string version; // size and time of the file and the charset it was converted with
+    TextPtr     text;
+    std::map<std::string, SubtitleLines> indexes;
+  };
+
+  static bool GetVersion(const std::string& file, std::string& version);
+  std::list<Entry>::iterator Find(const std::string& file);
+
+  CCriticalSection m_section;
+  std::list<Entry> m_entries; // most recently used first
+};
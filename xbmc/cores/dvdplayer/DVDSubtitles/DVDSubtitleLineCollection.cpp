@@ -21,14 +21,16 @@
 #include "DVDSubtitleLineCollection.h"
 #include "DVDClock.h"
 
+#include <algorithm>
+
+// subtitles parsed by the loader kept around, enough for any overlap and to step back a bit
+#define MAX_LOADED 32
 
 CDVDSubtitleLineCollection::CDVDSubtitleLineCollection()
 {
-  m_pHead = NULL;
-  m_pCurrent = NULL;
-  m_pTail = NULL;
-
-  m_iSize = 0;
+  m_loader  = NULL;
+  m_current = -1;
+  m_indexed = true;
 }
 
 CDVDSubtitleLineCollection::~CDVDSubtitleLineCollection()
@@ -38,85 +40,136 @@ CDVDSubtitleLineCollection::~CDVDSubtitleLineCollection()
 
 void CDVDSubtitleLineCollection::Add(CDVDOverlay* pOverlay)
 {
-  ListElement* pElement = new ListElement;
-  pElement->pOverlay = pOverlay;
-  pElement->pNext = NULL;
+  Entry entry;
+  entry.line.start  = pOverlay->iPTSStartTime;
+  entry.line.stop   = pOverlay->iPTSStopTime;
+  entry.line.offset = 0;
+  entry.overlay     = pOverlay;
+  entry.lazy        = false;
+  m_entries.push_back(entry);
+  m_indexed = false;
+}
 
-  if (!m_pHead)
-  {
-    m_pHead = m_pTail = pElement;
-    m_pCurrent = m_pHead;
-  }
-  else
-  {
-    m_pTail->pNext = pElement;
-    m_pTail = pElement;
-  }
+void CDVDSubtitleLineCollection::Add(const SubtitleLine& line)
+{
+  Entry entry;
+  entry.line    = line;
+  entry.overlay = NULL;
+  entry.lazy    = true;
+  m_entries.push_back(entry);
+  m_indexed = false;
+}
 
-  m_iSize++;
+bool CDVDSubtitleLineCollection::CompareStart(const Entry& lhs, const Entry& rhs)
+{
+  return lhs.line.start < rhs.line.start;
 }
 
 void CDVDSubtitleLineCollection::Sort()
 {
-  if (!m_pHead || !m_pHead->pNext)
+  m_indexed = false;
+  Index();
+}
+
+void CDVDSubtitleLineCollection::Index()
+{
+  if (m_indexed)
     return;
-  
-  for (ListElement* p1 = m_pHead; p1->pNext->pNext != NULL; p1 = p1->pNext)
+
+  // positions of loaded overlays change with the sort
+  Unload(0);
+
+  // overlays may have been changed after they were added
+  for (std::vector<Entry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
   {
-    for (ListElement* p2 = p1->pNext; p2->pNext != NULL; p2 = p2->pNext)
+    if (!it->lazy)
     {
-      if (p1->pOverlay->iPTSStartTime > p2->pOverlay->iPTSStartTime)
-      {
-        CDVDOverlay* temp = p1->pOverlay;
-        p1->pOverlay = p2->pOverlay;
-        p2->pOverlay = temp;
-      }
+      it->line.start = it->overlay->iPTSStartTime;
+      it->line.stop  = it->overlay->iPTSStopTime;
     }
   }
+  std::stable_sort(m_entries.begin(), m_entries.end(), CompareStart);
+
+  m_stop.resize(m_entries.size());
+  for (size_t i = 0; i < m_entries.size(); i++)
+    m_stop[i] = i > 0 ? std::max(m_stop[i - 1], m_entries[i].line.stop) : m_entries[i].line.stop;
+
+  m_current = -1;
+  m_indexed = true;
 }
 
 CDVDOverlay* CDVDSubtitleLineCollection::Get(double iPts)
 {
-  CDVDOverlay* pOverlay = NULL;
+  Index();
+
+  // after a reset find the first subtitle not yet stopped at iPts
+  if (m_current < 0)
+    m_current = std::lower_bound(m_stop.begin(), m_stop.end(), iPts) - m_stop.begin();
 
-  if (m_pCurrent)
+  while (m_current < (int)m_entries.size())
   {
-    while (m_pCurrent && m_pCurrent->pOverlay->iPTSStopTime < iPts)
+    Entry& entry = m_entries[m_current++];
+    if (entry.line.stop < iPts)
+      continue;
+
+    if (!entry.overlay && m_loader)
     {
-      m_pCurrent = m_pCurrent->pNext;
+      entry.overlay = m_loader->LoadLine(entry.line);
+      if (entry.overlay)
+      {
+        m_loaded.push_back(m_current - 1);
+        Unload(MAX_LOADED);
+      }
     }
 
-    if (m_pCurrent)
-    {
-      pOverlay = m_pCurrent->pOverlay;
+    if (entry.overlay)
+      return entry.overlay;
+  }
+  return NULL;
+}
 
-      // advance to the next overlay
-      m_pCurrent = m_pCurrent->pNext;
+void CDVDSubtitleLineCollection::Unload(size_t keep)
+{
+  while (m_loaded.size() > keep)
+  {
+    Entry& entry = m_entries[m_loaded.front()];
+    m_loaded.pop_front();
+    if (entry.overlay)
+    {
+      entry.overlay->Release();
+      entry.overlay = NULL;
     }
   }
-  return pOverlay;
 }
 
 void CDVDSubtitleLineCollection::Reset()
 {
-  m_pCurrent = m_pHead;
+  m_current = -1;
 }
 
-void CDVDSubtitleLineCollection::Clear()
+void CDVDSubtitleLineCollection::GetLines(SubtitleLines& lines)
 {
-  ListElement* pElement = NULL;
+  Index();
 
-  while (m_pHead)
+  lines.clear();
+  for (std::vector<Entry>::const_iterator it = m_entries.begin(); it != m_entries.end(); ++it)
   {
-    pElement = m_pHead;
-    m_pHead = pElement->pNext;
+    if (it->lazy)
+      lines.push_back(it->line);
+  }
+}
 
-    pElement->pOverlay->Release();
-    delete pElement;
+void CDVDSubtitleLineCollection::Clear()
+{
+  for (std::vector<Entry>::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+  {
+    if (it->overlay)
+      it->overlay->Release();
   }
 
-  m_pTail    = NULL;
-  m_pHead    = NULL;
-  m_pCurrent = NULL;
-  m_iSize    = 0;
+  m_entries.clear();
+  m_stop.clear();
+  m_loaded.clear();
+  m_current = -1;
+  m_indexed = true;
 }
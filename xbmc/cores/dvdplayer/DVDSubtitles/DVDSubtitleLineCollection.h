@@ -22,39 +22,72 @@
 
 #include "../DVDCodecs/Overlay/DVDOverlay.h"
 
-typedef struct stListElement
+#include <deque>
+#include <vector>
+
+// position of a subtitle in the subtitle text, for subtitles parsed on demand
+typedef struct stSubtitleLine
 {
-  CDVDOverlay* pOverlay;
-  struct stListElement* pNext;
+  double start;
+  double stop;
+  size_t offset;
+} SubtitleLine;
+
+typedef std::vector<SubtitleLine> SubtitleLines;
 
-} ListElement;
+class IDVDSubtitleLineLoader
+{
+public:
+  virtual ~IDVDSubtitleLineLoader() {}
+  // parse the subtitle at line.offset, NULL if it doesn't yield an overlay
+  virtual CDVDOverlay* LoadLine(const SubtitleLine& line) = 0;
+};
 
+/*
+ * Subtitles of a file, sorted by start time. Overlays are either added
+ * directly or, with a loader set, added as a position in the subtitle text
+ * and only parsed once playback gets near them. Parsed overlays of the latter
+ * are released again when playback moves on, so a long file only keeps a few
+ * of them in memory.
+ */
 class CDVDSubtitleLineCollection
 {
 public:
   CDVDSubtitleLineCollection();
   virtual ~CDVDSubtitleLineCollection();
 
-  //void Lock()   { EnterCriticalSection(&m_critSection); }
-  //void Unlock() { LeaveCriticalSection(&m_critSection); }
+  void SetLoader(IDVDSubtitleLineLoader* loader) { m_loader = loader; }
 
   void Add(CDVDOverlay* pSubtitle);
+  void Add(const SubtitleLine& line);
   void Sort();
 
   CDVDOverlay* Get(double iPts = 0LL); // get the first overlay in this fifo
 
   void Reset();
 
-  void Remove();
   void Clear();
-  int GetSize() { return m_iSize; }
+  int GetSize() { return m_entries.size(); }
+
+  // positions of the subtitles added with a loader, in order
+  void GetLines(SubtitleLines& lines);
 
 private:
-  ListElement* m_pHead;
-  ListElement* m_pCurrent;
-  ListElement* m_pTail;
+  struct Entry
+  {
+    SubtitleLine line;
+    CDVDOverlay* overlay;
+    bool         lazy;
+  };
 
-  int m_iSize;
-  //CRITICAL_SECTION m_critSection;
-};
+  static bool CompareStart(const Entry& lhs, const Entry& rhs);
+  void Index();
+  void Unload(size_t keep);
 
+  std::vector<Entry>      m_entries;
+  std::vector<double>     m_stop;    // latest stop time up to each entry, for the lookup on seek
+  std::deque<size_t>      m_loaded;  // entries parsed by the loader, oldest first
+  IDVDSubtitleLineLoader* m_loader;
+  int                     m_current; // next entry to return, -1 to look it up
+  bool                    m_indexed;
+};
@@ -23,6 +23,7 @@
 #include "../DVDCodecs/Overlay/DVDOverlay.h"
 #include "DVDSubtitleStream.h"
 #include "DVDSubtitleLineCollection.h"
+#include "DVDSubtitleCache.h"
 
 #include <string>
 
@@ -61,12 +62,14 @@ protected:
 
 class CDVDSubtitleParserText
      : public CDVDSubtitleParserCollection
+     , public IDVDSubtitleLineLoader
 {
 public:
   CDVDSubtitleParserText(CDVDSubtitleStream* stream, const std::string& filename)
     : CDVDSubtitleParserCollection(filename)
   {
     m_pStream  = stream;
+    m_collection.SetLoader(this);
   }
 
   virtual ~CDVDSubtitleParserText()
@@ -90,5 +93,27 @@ protected:
     return m_pStream->Open(m_filename);
   }
 
+  // parsers that only index the file in Open parse a subtitle here once it is needed
+  virtual CDVDOverlay* LoadLine(const SubtitleLine& line) { return NULL; }
+
+  // positions of the subtitles found in this file by a previous Open
+  bool LoadIndex(const std::string& parser)
+  {
+    SubtitleLines lines;
+    if (!CDVDSubtitleCache::Get().GetIndex(m_filename, parser, lines))
+      return false;
+
+    for (SubtitleLines::const_iterator it = lines.begin(); it != lines.end(); ++it)
+      m_collection.Add(*it);
+    return true;
+  }
+
+  void StoreIndex(const std::string& parser)
+  {
+    SubtitleLines lines;
+    m_collection.GetLines(lines);
+    CDVDSubtitleCache::Get().SetIndex(m_filename, parser, lines);
+  }
+
   CDVDSubtitleStream* m_pStream;
 };
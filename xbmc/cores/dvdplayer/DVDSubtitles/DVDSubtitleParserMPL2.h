@@ -30,6 +30,7 @@ public:
   virtual ~CDVDSubtitleParserMPL2();
 
   virtual bool Open(CDVDStreamInfo &hints);
+  virtual CDVDOverlay* LoadLine(const SubtitleLine& line);
 private:
   double m_framerate;
 };
@@ -25,6 +25,7 @@
 #include "DVDStreamInfo.h"
 #include "utils/StdString.h"
 #include "utils/log.h"
+#include "utils/StringUtils.h"
 #include "DVDSubtitleTagMicroDVD.h"
 
 using namespace std;
@@ -54,35 +55,53 @@ bool CDVDSubtitleParserMicroDVD::Open(CDVDStreamInfo &hints)
   else
     m_framerate = DVD_TIME_BASE / 25.0;
 
+  if (LoadIndex(StringUtils::Format("microdvd:%f", m_framerate)))
+    return true;
+
   char line[1024];
 
   CRegExp reg;
   if (!reg.RegComp("\\{([0-9]+)\\}\\{([0-9]+)\\}"))
     return false;
-  CDVDSubtitleTagMicroDVD TagConv;
 
+  // only the frames are read here, the text is parsed in LoadLine when it's due
+  long position = m_pStream->Seek(0, SEEK_CUR);
   while (m_pStream->ReadLine(line, sizeof(line)))
   {
-    if ((strlen(line) > 0) && (line[strlen(line) - 1] == '\r'))
-      line[strlen(line) - 1] = 0;
-
     int pos = reg.RegFind(line);
     if (pos > -1)
     {
-      const char* text = line + pos + reg.GetFindLen();
       std::string startFrame(reg.GetMatch(1));
       std::string endFrame  (reg.GetMatch(2));
-      CDVDOverlayText* pOverlay = new CDVDOverlayText();
-      pOverlay->Acquire(); // increase ref count with one so that we can hold a handle to this overlay
 
-      pOverlay->iPTSStartTime = m_framerate * atoi(startFrame.c_str());
-      pOverlay->iPTSStopTime  = m_framerate * atoi(endFrame.c_str());
-
-      TagConv.ConvertLine(pOverlay, text, strlen(text));
-      m_collection.Add(pOverlay);
+      SubtitleLine subtitle;
+      subtitle.start  = m_framerate * atoi(startFrame.c_str());
+      subtitle.stop   = m_framerate * atoi(endFrame.c_str());
+      subtitle.offset = position + pos + reg.GetFindLen();
+      m_collection.Add(subtitle);
     }
+    position = m_pStream->Seek(0, SEEK_CUR);
   }
 
+  StoreIndex(StringUtils::Format("microdvd:%f", m_framerate));
   return true;
 }
 
+CDVDOverlay* CDVDSubtitleParserMicroDVD::LoadLine(const SubtitleLine& subtitle)
+{
+  char line[1024];
+  if (m_pStream->Seek(subtitle.offset, SEEK_SET) != (long)subtitle.offset
+  || !m_pStream->ReadLine(line, sizeof(line)))
+    return NULL;
+
+  if ((strlen(line) > 0) && (line[strlen(line) - 1] == '\r'))
+    line[strlen(line) - 1] = 0;
+
+  CDVDOverlayText* pOverlay = new CDVDOverlayText();
+  pOverlay->iPTSStartTime = subtitle.start;
+  pOverlay->iPTSStopTime  = subtitle.stop;
+
+  CDVDSubtitleTagMicroDVD TagConv;
+  TagConv.ConvertLine(pOverlay, line, strlen(line));
+  return pOverlay;
+}
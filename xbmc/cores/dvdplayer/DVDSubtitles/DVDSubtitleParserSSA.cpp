@@ -42,7 +42,7 @@ bool CDVDSubtitleParserSSA::Open(CDVDStreamInfo &hints)
   if (!CDVDSubtitleParserText::Open())
     return false;
 
-  std::string buffer = m_pStream->m_stringstream.str();
+  std::string buffer = m_pStream->GetText();
   if(!m_libass->CreateTrack((char*) buffer.c_str(), buffer.length()))
     return false;
 
@@ -42,10 +42,13 @@ bool CDVDSubtitleParserSubrip::Open(CDVDStreamInfo &hints)
   if (!CDVDSubtitleParserText::Open())
     return false;
 
-  CDVDSubtitleTagSami TagConv;
-  if (!TagConv.Init())
+  if (!m_tagConv.Init())
     return false;
 
+  if (LoadIndex("subrip"))
+    return true;
+
+  // only the times are read here, the text is parsed in LoadLine when it's due
   char line[1024];
   CStdString strLine;
 
@@ -68,11 +71,10 @@ bool CDVDSubtitleParserSubrip::Open(CDVDStreamInfo &hints)
       }
       else if (c == 14) // time info
       {
-        CDVDOverlayText* pOverlay = new CDVDOverlayText();
-        pOverlay->Acquire(); // increase ref count with one so that we can hold a handle to this overlay
-
-        pOverlay->iPTSStartTime = ((double)(((hh1 * 60 + mm1) * 60) + ss1) * 1000 + ms1) * (DVD_TIME_BASE / 1000);
-        pOverlay->iPTSStopTime  = ((double)(((hh2 * 60 + mm2) * 60) + ss2) * 1000 + ms2) * (DVD_TIME_BASE / 1000);
+        SubtitleLine subtitle;
+        subtitle.start  = ((double)(((hh1 * 60 + mm1) * 60) + ss1) * 1000 + ms1) * (DVD_TIME_BASE / 1000);
+        subtitle.stop   = ((double)(((hh2 * 60 + mm2) * 60) + ss2) * 1000 + ms2) * (DVD_TIME_BASE / 1000);
+        subtitle.offset = m_pStream->Seek(0, SEEK_CUR);
 
         while (m_pStream->ReadLine(line, sizeof(line)))
         {
@@ -81,15 +83,38 @@ bool CDVDSubtitleParserSubrip::Open(CDVDStreamInfo &hints)
 
           // empty line, next subtitle is about to start
           if (strLine.length() <= 0) break;
-
-          TagConv.ConvertLine(pOverlay, strLine.c_str(), strLine.length());
         }
-        TagConv.CloseTag(pOverlay);
-        m_collection.Add(pOverlay);
+        m_collection.Add(subtitle);
       }
     }
   }
   m_collection.Sort();
+  StoreIndex("subrip");
   return true;
 }
 
+CDVDOverlay* CDVDSubtitleParserSubrip::LoadLine(const SubtitleLine& subtitle)
+{
+  if (m_pStream->Seek(subtitle.offset, SEEK_SET) != (long)subtitle.offset)
+    return NULL;
+
+  CDVDOverlayText* pOverlay = new CDVDOverlayText();
+  pOverlay->iPTSStartTime = subtitle.start;
+  pOverlay->iPTSStopTime  = subtitle.stop;
+
+  char line[1024];
+  CStdString strLine;
+
+  while (m_pStream->ReadLine(line, sizeof(line)))
+  {
+    strLine = line;
+    StringUtils::Trim(strLine);
+
+    // empty line, next subtitle is about to start
+    if (strLine.length() <= 0) break;
+
+    m_tagConv.ConvertLine(pOverlay, strLine.c_str(), strLine.length());
+  }
+  m_tagConv.CloseTag(pOverlay);
+  return pOverlay;
+}
@@ -22,6 +22,7 @@
 
 #include "DVDSubtitleParser.h"
 #include "DVDSubtitleLineCollection.h"
+#include "DVDSubtitleTagSami.h"
 
 class CDVDSubtitleParserSubrip : public CDVDSubtitleParserText
 {
@@ -30,5 +31,7 @@ public:
   virtual ~CDVDSubtitleParserSubrip();
 
   virtual bool Open(CDVDStreamInfo &hints);
+  virtual CDVDOverlay* LoadLine(const SubtitleLine& line);
 private:
+  CDVDSubtitleTagSami m_tagConv;
 };
@@ -49,51 +49,74 @@ bool CDVDSubtitleParserVplayer::Open(CDVDStreamInfo &hints)
   // for 4 seconds, to not have text hanging around in silent scenes...
   int iDefaultDuration = 4 * (int)m_framerate;
 
-  char line[1024];
-
-  CRegExp reg;
-  if (!reg.RegComp("([0-9]+):([0-9]+):([0-9]+):([^|]*?)(\\|([^|]*?))?$"))
+  if (!m_reg.RegComp("([0-9]+):([0-9]+):([0-9]+):([^|]*?)(\\|([^|]*?))?$"))
     return false;
 
-  CDVDOverlayText* pPrevOverlay = NULL;
+  if (LoadIndex("vplayer"))
+    return true;
+
+  // only the times are read here, the text is parsed in LoadLine when it's due
+  char line[1024];
+  SubtitleLine subtitle;
+  bool previous = false;
 
+  long position = m_pStream->Seek(0, SEEK_CUR);
   while (m_pStream->ReadLine(line, sizeof(line)))
   {
-    if (reg.RegFind(line) > -1)
+    if (m_reg.RegFind(line) > -1)
     {
-      std::string hour(reg.GetMatch(1));
-      std::string min (reg.GetMatch(2));
-      std::string sec (reg.GetMatch(3));
-      std::string lines[3];
-      lines[0] = reg.GetMatch(4);
-      lines[1] = reg.GetMatch(6);
-      lines[2] = reg.GetMatch(8);
-
-      CDVDOverlayText* pOverlay = new CDVDOverlayText();
-      pOverlay->Acquire(); // increase ref count with one so that we can hold a handle to this overlay
-
-      pOverlay->iPTSStartTime = m_framerate * (3600*atoi(hour.c_str()) + 60*atoi(min.c_str()) + atoi(sec.c_str()));
+      std::string hour(m_reg.GetMatch(1));
+      std::string min (m_reg.GetMatch(2));
+      std::string sec (m_reg.GetMatch(3));
+      double start = m_framerate * (3600*atoi(hour.c_str()) + 60*atoi(min.c_str()) + atoi(sec.c_str()));
 
       // set StopTime for previous overlay
-      if (pPrevOverlay)
+      if (previous)
       {
-        if ( (pOverlay->iPTSStartTime - pPrevOverlay->iPTSStartTime) < iDefaultDuration)
-          pPrevOverlay->iPTSStopTime = pOverlay->iPTSStartTime;
+        if ( (start - subtitle.start) < iDefaultDuration)
+          subtitle.stop = start;
         else
-          pPrevOverlay->iPTSStopTime = pPrevOverlay->iPTSStartTime + iDefaultDuration;
+          subtitle.stop = subtitle.start + iDefaultDuration;
+        m_collection.Add(subtitle);
       }
-      pPrevOverlay = pOverlay;
-      for (int i = 0; i < 3 && !lines[i].empty(); i++)
-          pOverlay->AddElement(new CDVDOverlayText::CElementText(lines[i].c_str()));
 
-      m_collection.Add(pOverlay);
+      subtitle.start  = start;
+      subtitle.offset = position;
+      previous = true;
     }
+    position = m_pStream->Seek(0, SEEK_CUR);
+  }
 
-    // set StopTime for the last subtitle
-    if (pPrevOverlay)
-      pPrevOverlay->iPTSStopTime = pPrevOverlay->iPTSStartTime + iDefaultDuration;
+  // set StopTime for the last subtitle
+  if (previous)
+  {
+    subtitle.stop = subtitle.start + iDefaultDuration;
+    m_collection.Add(subtitle);
   }
 
+  StoreIndex("vplayer");
   return true;
 }
 
+CDVDOverlay* CDVDSubtitleParserVplayer::LoadLine(const SubtitleLine& subtitle)
+{
+  char line[1024];
+  if (m_pStream->Seek(subtitle.offset, SEEK_SET) != (long)subtitle.offset
+  || !m_pStream->ReadLine(line, sizeof(line))
+  || m_reg.RegFind(line) < 0)
+    return NULL;
+
+  std::string lines[3];
+  lines[0] = m_reg.GetMatch(4);
+  lines[1] = m_reg.GetMatch(6);
+  lines[2] = m_reg.GetMatch(8);
+
+  CDVDOverlayText* pOverlay = new CDVDOverlayText();
+  pOverlay->iPTSStartTime = subtitle.start;
+  pOverlay->iPTSStopTime  = subtitle.stop;
+
+  for (int i = 0; i < 3 && !lines[i].empty(); i++)
+      pOverlay->AddElement(new CDVDOverlayText::CElementText(lines[i].c_str()));
+
+  return pOverlay;
+}
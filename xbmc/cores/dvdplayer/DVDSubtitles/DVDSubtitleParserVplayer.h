@@ -22,6 +22,7 @@
 
 #include "DVDSubtitleParser.h"
 #include "DVDSubtitleLineCollection.h"
+#include "utils/RegExp.h"
 
 class CDVDSubtitleParserVplayer : public CDVDSubtitleParserText
 {
@@ -30,6 +31,8 @@ public:
   virtual ~CDVDSubtitleParserVplayer();
 
   virtual bool Open(CDVDStreamInfo &hints);
+  virtual CDVDOverlay* LoadLine(const SubtitleLine& line);
 private:
   double m_framerate;
+  CRegExp m_reg;
 };
@@ -26,11 +26,16 @@
 #include "utils/CharsetDetection.h"
 #include "filesystem/File.h"
 
+#include <algorithm>
+#include <string.h>
+
 using namespace std;
 using XFILE::auto_buffer;
 
 CDVDSubtitleStream::CDVDSubtitleStream()
 {
+  m_text.reset(new std::string());
+  m_position = 0;
 }
 
 CDVDSubtitleStream::~CDVDSubtitleStream()
@@ -39,6 +44,16 @@ CDVDSubtitleStream::~CDVDSubtitleStream()
 
 bool CDVDSubtitleStream::Open(const string& strFile)
 {
+  m_position = 0;
+
+  // the same files are opened again on every subtitle switch
+  CDVDSubtitleCache::TextPtr cached = CDVDSubtitleCache::Get().GetText(strFile);
+  if (cached)
+  {
+    m_text = cached;
+    return true;
+  }
+
   CDVDInputStream* pInputStream;
   pInputStream = CDVDFactoryInputStream::CreateInputStream(NULL, strFile, "");
   if (pInputStream && pInputStream->Open(strFile.c_str(), ""))
@@ -66,28 +81,22 @@ bool CDVDSubtitleStream::Open(const string& strFile)
     std::string tmpStr(buf.get(), totalread);
     buf.clear();
 
+    std::string* text = new std::string();
+    CDVDSubtitleCache::TextPtr textPtr(text);
+
     std::string enc(CCharsetDetection::GetBomEncoding(tmpStr));
     if (enc == "UTF-8" || (enc.empty() && CUtf8Utils::isValidUtf8(tmpStr)))
-      m_stringstream << tmpStr;
+      text->swap(tmpStr);
     else if (!enc.empty())
-    {
-      std::string converted;
-      g_charsetConverter.ToUtf8(enc, tmpStr, converted);
-      if (converted.empty())
-        return false;
-
-      m_stringstream << converted;
-    }
+      g_charsetConverter.ToUtf8(enc, tmpStr, *text);
     else
-    {
-      std::string converted;
-      g_charsetConverter.subtitleCharsetToUtf8(tmpStr, converted);
-      if (converted.empty())
-        return false;
+      g_charsetConverter.subtitleCharsetToUtf8(tmpStr, *text);
 
-      m_stringstream << converted;
-    }
+    if (text->empty())
+      return false;
 
+    m_text = textPtr;
+    CDVDSubtitleCache::Get().SetText(strFile, m_text);
     return true;
   }
 
@@ -97,37 +106,54 @@ bool CDVDSubtitleStream::Open(const string& strFile)
 
 int CDVDSubtitleStream::Read(char* buf, int buf_size)
 {
-  return (int)m_stringstream.readsome(buf, buf_size);
+  size_t size = std::min((size_t)std::max(buf_size, 0), m_text->size() - m_position);
+  memcpy(buf, m_text->c_str() + m_position, size);
+  m_position += size;
+  return (int)size;
 }
 
 long CDVDSubtitleStream::Seek(long offset, int whence)
 {
+  long position = (long)m_position;
   switch (whence)
   {
     case SEEK_CUR:
     {
-      m_stringstream.seekg(offset, ios::cur);
+      position += offset;
       break;
     }
     case SEEK_END:
     {
-      m_stringstream.seekg(offset, ios::end);
+      position = (long)m_text->size() + offset;
       break;
     }
     case SEEK_SET:
     {
-      m_stringstream.seekg(offset, ios::beg);
+      position = offset;
       break;
     }
   }
-  return (int)m_stringstream.tellg();
+  if (position < 0 || position > (long)m_text->size())
+    return -1;
+
+  m_position = position;
+  return position;
 }
 
 char* CDVDSubtitleStream::ReadLine(char* buf, int iLen)
 {
-  if (m_stringstream.getline(buf, iLen))
-    return buf;
-  else
+  if (m_position >= m_text->size() || iLen <= 0)
     return NULL;
-}
 
+  const char* start = m_text->c_str() + m_position;
+  const char* end   = (const char*)memchr(start, '\n', m_text->size() - m_position);
+  size_t      len   = end ? end - start : m_text->size() - m_position;
+
+  // the rest of a line too long for the buffer is skipped
+  size_t copy = std::min(len, (size_t)iLen - 1);
+  memcpy(buf, start, copy);
+  buf[copy] = 0;
+
+  m_position += end ? len + 1 : len;
+  return buf;
+}
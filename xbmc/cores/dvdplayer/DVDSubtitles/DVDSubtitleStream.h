@@ -21,9 +21,9 @@
  */
 
 #include "system.h"
+#include "DVDSubtitleCache.h"
 
 #include <string>
-#include <sstream>
 
 class CDVDInputStream;
 
@@ -42,6 +42,11 @@ public:
   char* ReadLine(char* pBuffer, int iLen);
   //wchar* ReadLineW(wchar* pBuffer, int iLen) { return NULL; };
 
-  std::stringstream m_stringstream;
+  // the utf-8 text of the file
+  const std::string& GetText() const { return *m_text; }
+
+private:
+  CDVDSubtitleCache::TextPtr m_text;
+  size_t                     m_position;
 };
 
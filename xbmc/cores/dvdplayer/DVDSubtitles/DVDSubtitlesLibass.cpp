@@ -46,6 +46,7 @@ CDVDSubtitlesLibass::CDVDSubtitlesLibass()
   m_track = NULL;
   m_library = NULL;
   m_renderer = NULL;
+  m_renderCount = 0;
   m_references = 1;
 
   if(!m_dll.Load())
@@ -163,6 +164,7 @@ ASS_Image* CDVDSubtitlesLibass::RenderImage(int imageWidth, int imageHeight, dou
     return NULL;
   }
 
+  m_renderCount++;
   double storage_aspact = (double)imageWidth / imageHeight;
   m_dll.ass_set_frame_size(m_renderer, imageWidth, imageHeight);
   m_dll.ass_set_aspect_ratio(m_renderer, storage_aspact / g_graphicsContext.GetResInfo().fPixelRatio, storage_aspact);
@@ -32,7 +32,12 @@ public:
   CDVDSubtitlesLibass();
   virtual ~CDVDSubtitlesLibass();
 
+  /* The images are only valid until the next call, by any thread, so hold
+   * GetSection() while they are used. changes is relative to the previous
+   * call, which GetRenderCount() tells apart. */
   ASS_Image* RenderImage(int imageWidth, int imageHeight, double pts, int* changes = NULL);
+  CCriticalSection& GetSection() { return m_section; }
+  unsigned int GetRenderCount() const { return m_renderCount; }
   ASS_Event* GetEvents();
 
   int GetNrOfEvents();
@@ -47,6 +52,7 @@ private:
   ASS_Library* m_library;
   ASS_Track* m_track;
   ASS_Renderer* m_renderer;
+  unsigned int m_renderCount;
   CCriticalSection m_section;
 };
 
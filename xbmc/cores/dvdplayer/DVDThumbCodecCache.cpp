@@ -0,0 +1,105 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "DVDThumbCodecCache.h"
+#include "DVDStreamInfo.h"
+#include "DVDCodecs/DVDCodecs.h"
+#include "DVDCodecs/DVDFactoryCodec.h"
+#include "DVDCodecs/Video/DVDVideoCodecFFmpeg.h"
+#include "threads/SingleLock.h"
+#include "utils/log.h"
+
+// idle decoders kept open, each holds on to its frame buffers
+#define THUMB_CODEC_CACHE_SIZE 4
+
+CDVDThumbCodecCache::CDVDThumbCodecCache()
+{
+}
+
+CDVDThumbCodecCache::~CDVDThumbCodecCache()
+{
+  Flush();
+}
+
+CDVDVideoCodec* CDVDThumbCodecCache::Acquire(CDVDStreamInfo &hint)
+{
+  {
+    CSingleLock lock(m_section);
+    for (std::list<Entry>::iterator it = m_idle.begin(); it != m_idle.end(); ++it)
+    {
+      if (it->hint->Equal(hint, true))
+      {
+        CDVDVideoCodec *codec = it->codec;
+        delete it->hint;
+        m_idle.erase(it);
+        return codec;
+      }
+    }
+  }
+
+  // ffmpeg is used for all codecs as libmpeg2 is not thread safe, and we want
+  // to decode the key frame we seeked to and nothing else
+  CDVDCodecOptions options;
+  options.m_keys.push_back(CDVDCodecOption("skip_frame", "nokey"));
+  // the picture is scaled down to a thumb, deblocking it is wasted effort
+  options.m_keys.push_back(CDVDCodecOption("skip_loop_filter", "all"));
+
+  hint.software = true;
+  return CDVDFactoryCodec::OpenCodec(new CDVDVideoCodecFFmpeg(), hint, options);
+}
+
+void CDVDThumbCodecCache::Release(CDVDVideoCodec *codec, const CDVDStreamInfo &hint, bool reusable)
+{
+  if (!codec)
+    return;
+
+  if (!reusable)
+  {
+    delete codec;
+    return;
+  }
+
+  codec->Reset();
+
+  Entry entry;
+  entry.hint = new CDVDStreamInfo();
+  entry.hint->Assign(hint, true);
+  entry.codec = codec;
+
+  CSingleLock lock(m_section);
+  m_idle.push_front(entry);
+  while (m_idle.size() > THUMB_CODEC_CACHE_SIZE)
+  {
+    delete m_idle.back().codec;
+    delete m_idle.back().hint;
+    m_idle.pop_back();
+  }
+}
+
+void CDVDThumbCodecCache::Flush()
+{
+  CSingleLock lock(m_section);
+  for (std::list<Entry>::iterator it = m_idle.begin(); it != m_idle.end(); ++it)
+  {
+    delete it->codec;
+    delete it->hint;
+  }
+  m_idle.clear();
+}
@@ -0,0 +1,82 @@
+#pragma once
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <list>
+
+#include "threads/CriticalSection.h"
+
+class CDVDStreamInfo;
+class CDVDVideoCodec;
+
+/*!
+ \brief Video decoders kept open between thumbnail extractions
+
+ Opening a decoder is a good part of the cost of extracting a thumb, and the
+ files of a library usually share a handful of stream configurations. Idle
+ decoders are kept after use and handed out again, after a reset, for a stream
+ that is identical including its extradata.
+
+ Decoders are opened for thumbnail use only: in software and with non key
+ frames skipped, as a thumb is always taken from the key frame the demuxer
+ seeked to.
+
+ The cache is thread safe, an acquired decoder is used exclusively by the
+ caller until it is released.
+ */
+class CDVDThumbCodecCache
+{
+public:
+  CDVDThumbCodecCache();
+  ~CDVDThumbCodecCache();
+
+  /*!
+   \brief Get a decoder for a stream
+   \param hint the stream to decode
+   \return an idle decoder opened for the same stream, a newly opened one or NULL
+   */
+  CDVDVideoCodec* Acquire(CDVDStreamInfo &hint);
+
+  /*!
+   \brief Hand back a decoder obtained from Acquire
+   \param codec the decoder
+   \param hint the stream it was acquired for
+   \param reusable false if the decoder failed and should be closed
+   */
+  void Release(CDVDVideoCodec *codec, const CDVDStreamInfo &hint, bool reusable);
+
+  /*!
+   \brief Close all idle decoders
+   */
+  void Flush();
+
+private:
+  CDVDThumbCodecCache(const CDVDThumbCodecCache&);
+  CDVDThumbCodecCache& operator=(const CDVDThumbCodecCache&);
+
+  struct Entry
+  {
+    CDVDStreamInfo *hint;
+    CDVDVideoCodec *codec;
+  };
+
+  CCriticalSection m_section;
+  std::list<Entry> m_idle; ///< most recently released first
+};
@@ -19,6 +19,7 @@
  */
 
 #include "Edl.h"
+#include "EdlDetectJob.h"
 #include "utils/StringUtils.h"
 #include "utils/URIUtils.h"
 #include "filesystem/File.h"
@@ -138,6 +139,9 @@ bool CEdl::ReadEditDecisionLists(const CStdString& strMovie, const float fFrameR
 
     if (!bFound)
       bFound = ReadBeyondTV(strMovie);
+
+    if (!bFound)
+      bFound = ReadDetected(strMovie, strMovie, fFramesPerSecond);
   }
   /*
    * Or if the movie points to MythTV and isn't live TV.
@@ -163,6 +167,20 @@ bool CEdl::ReadEditDecisionLists(const CStdString& strMovie, const float fFrameR
       __FUNCTION__, strMovie.c_str());
 
     bFound = ReadPvr(strMovie);
+
+    /*
+     * Recordings the backend didn't provide a list for can be analysed if they are files.
+     */
+    if (!bFound && PVR::g_PVRManager.IsStarted())
+    {
+      CFileItemPtr tag = PVR::g_PVRRecordings->GetByPath(strMovie);
+      if (tag && tag->HasPVRRecordingInfoTag())
+      {
+        CStdString strFile = tag->GetPVRRecordingInfoTag()->m_strStreamURL;
+        if (!strFile.empty() && !URIUtils::IsInternetStream(strFile))
+          bFound = ReadDetected(strMovie, strFile, fFramesPerSecond);
+      }
+    }
   }
 
   if (bFound)
@@ -174,10 +192,14 @@ bool CEdl::ReadEditDecisionLists(const CStdString& strMovie, const float fFrameR
 }
 
 bool CEdl::ReadEdl(const CStdString& strMovie, const float fFramesPerSecond)
+{
+  return ReadEdlFile(URIUtils::ReplaceExtension(strMovie, ".edl"), fFramesPerSecond);
+}
+
+bool CEdl::ReadEdlFile(const CStdString& edlFilename, const float fFramesPerSecond)
 {
   Clear();
 
-  CStdString edlFilename(URIUtils::ReplaceExtension(strMovie, ".edl"));
   if (!CFile::Exists(edlFilename))
     return false;
 
@@ -664,6 +686,28 @@ bool CEdl::ReadPvr(const CStdString &strMovie)
  return !edl.empty();
 }
 
+bool CEdl::ReadDetected(const CStdString& strMovie, const CStdString& strFile, const float fFramesPerSecond)
+{
+  if (!g_advancedSettings.m_bEdlDetectCommBreaks)
+    return false;
+
+  /*
+   * Detection runs in the background while nothing is played, the result is used the next time.
+   */
+  CStdString edlFilename = CEdlDetectJob::GetEdlFile(strMovie);
+  if (!CFile::Exists(edlFilename))
+  {
+    CLog::Log(LOGDEBUG, "%s - Queueing commercial break detection for: %s", __FUNCTION__,
+              strMovie.c_str());
+    CEdlDetectJob::Queue(strMovie, strFile);
+    return false;
+  }
+
+  CLog::Log(LOGDEBUG, "%s - Reading detected commercial breaks for: %s", __FUNCTION__,
+            strMovie.c_str());
+  return ReadEdlFile(edlFilename, fFramesPerSecond);
+}
+
 bool CEdl::AddCut(Cut& cut)
 {
   if (cut.action != CUT && cut.action != MUTE && cut.action != COMM_BREAK)
@@ -70,10 +70,12 @@ private:
   std::vector<int64_t> m_vecSceneMarkers;
 
   bool ReadEdl(const CStdString& strMovie, const float fFramesPerSecond);
+  bool ReadEdlFile(const CStdString& edlFilename, const float fFramesPerSecond);
   bool ReadComskip(const CStdString& strMovie, const float fFramesPerSecond);
   bool ReadVideoReDo(const CStdString& strMovie);
   bool ReadBeyondTV(const CStdString& strMovie);
   bool ReadPvr(const CStdString& strMovie);
+  bool ReadDetected(const CStdString& strMovie, const CStdString& strFile, const float fFramesPerSecond);
   bool ReadMythCommBreakList(const CStdString& strMovie, const float fFramesPerSecond);
   bool ReadMythCutList(const CStdString& strMovie, const float fFramesPerSecond);
 
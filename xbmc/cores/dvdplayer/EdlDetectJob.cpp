@@ -0,0 +1,837 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "EdlDetectJob.h"
+#include "DVDClock.h"
+#include "DVDFileInfo.h"
+#include "DVDStreamInfo.h"
+#include "DVDThumbCodecCache.h"
+#include "DVDInputStreams/DVDInputStream.h"
+#include "DVDInputStreams/DVDFactoryInputStream.h"
+#include "DVDDemuxers/DVDDemux.h"
+#include "DVDDemuxers/DVDDemuxUtils.h"
+#include "DVDDemuxers/DVDFactoryDemuxer.h"
+#include "DVDCodecs/DVDCodecs.h"
+#include "DVDCodecs/DVDFactoryCodec.h"
+#include "DVDCodecs/Audio/DVDAudioCodecFFmpeg.h"
+#include "DVDCodecs/Video/DVDVideoCodec.h"
+#include "filesystem/Directory.h"
+#include "filesystem/File.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/CPUInfo.h"
+#include "utils/Crc32.h"
+#include "utils/FrameStats.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "URL.h"
+
+#include <algorithm>
+#include <limits>
+#include <memory>
+#include <set>
+#include <string.h>
+#include <time.h>
+
+using namespace XFILE;
+
+#define EDLDETECT_FOLDER   "special://profile/commbreaks/"
+#define STATE_MAGIC        0x444c4445
+#define STATE_VERSION      1
+
+// recordings changed more recently than this are probably still recording
+#define MIN_AGE            (5 * 60)
+#define MAX_WORKERS        4
+
+// samples at or below this are black, a black frame has only a few above
+#define BLACK_LEVEL        48
+#define BLACK_LUMA         32
+#define BLACK_BRIGHT       20      // per mille
+// audio windows and the level of silence, about -45dB
+#define WINDOW_MS          250
+#define SILENCE_POWER      3.2e-5
+// difference of neighbouring samples of the low resolution copy for an edge
+#define EDGE_THRESHOLD     24
+// boundaries closer than this are one
+#define MERGE_MS           2000
+// logo cells are edges in at least this part of the frames, but not all of
+// them, a logo is gone during commercials while bars and borders are not
+#define LOGO_MIN_PRESENCE  0.5
+#define LOGO_MAX_PRESENCE  0.95
+#define LOGO_MIN_CELLS     12
+#define LOGO_MIN_FRAMES    100
+// parts showing the logo in less of their frames than this are commercials
+#define LOGO_COMMERCIAL    0.25
+// without a logo, commercials are runs of at least MIN_SPOTS short parts
+#define MAX_SPOT_MS        65000
+#define MIN_SPOTS          3
+
+typedef CEdlDetectJob::SFrame   SFrame;
+typedef CEdlDetectJob::SLevel   SLevel;
+typedef CEdlDetectJob::SSegment SSegment;
+
+//-----------------------------------------------------------------------------
+// queue of recordings being detected
+//-----------------------------------------------------------------------------
+
+namespace
+{
+class CEdlDetectQueue : public IJobCallback
+{
+public:
+  void Queue(const std::string &path, const std::string &file)
+  {
+    CSingleLock lock(m_section);
+    if (m_queued.insert(path).second)
+      CJobManager::GetInstance().AddJob(new CEdlDetectJob(path, file), this, CJob::PRIORITY_LOW_PAUSABLE);
+  }
+
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job)
+  {
+    CEdlDetectJob *detect = (CEdlDetectJob*)job;
+    CSingleLock lock(m_section);
+
+    // jobs stay queued while paused, it continues once playback ends
+    if (detect->WasPaused())
+    {
+      CJobManager::GetInstance().AddJob(new CEdlDetectJob(detect->GetPath(), detect->GetFile()), this, CJob::PRIORITY_LOW_PAUSABLE);
+      return;
+    }
+    m_queued.erase(detect->GetPath());
+  }
+
+private:
+  CCriticalSection      m_section;
+  std::set<std::string> m_queued;
+};
+
+CEdlDetectQueue& GetQueue()
+{
+  static CEdlDetectQueue queue;
+  return queue;
+}
+
+bool FrameBefore(const SFrame &a, const SFrame &b)
+{
+  return a.time < b.time;
+}
+
+bool IsBlack(const SFrame &frame)
+{
+  return frame.luma < BLACK_LUMA && frame.bright < BLACK_BRIGHT;
+}
+
+bool GetBit(const uint8_t *bits, int index)
+{
+  return (bits[index >> 3] & (1 << (index & 7))) != 0;
+}
+}
+
+//-----------------------------------------------------------------------------
+// worker, analyses one segment
+//-----------------------------------------------------------------------------
+
+namespace
+{
+class CEdlDetectWorker : public CThread
+{
+public:
+  CEdlDetectWorker(const std::string &file, SSegment &segment, CCriticalSection &section, CDVDThumbCodecCache &codecs)
+    : CThread("EdlDetectWorker")
+    , m_file(file)
+    , m_segment(segment)
+    , m_section(section)
+    , m_codecs(codecs)
+  {
+    m_failed = false;
+  }
+
+  bool Failed() const { return m_failed; }
+
+protected:
+  virtual void Process();
+
+private:
+  void AddPicture(const DVDVideoPicture &picture, int64_t time);
+  void AddAudio(CDVDAudioCodec *codec, int64_t time);
+  void FlushWindow();
+  void SetDone(int64_t done);
+
+  std::string          m_file;
+  SSegment            &m_segment;
+  CCriticalSection    &m_section;     // the job reads the progress while we run
+  CDVDThumbCodecCache &m_codecs;
+  bool                 m_failed;
+
+  int64_t              m_window;      // start of the audio window being summed
+  double               m_power;
+  unsigned int         m_samples;
+
+  uint8_t              m_grid[CEdlDetectJob::GRID_WIDTH * CEdlDetectJob::GRID_HEIGHT];
+  uint8_t              m_edges[CEdlDetectJob::GRID_WIDTH * CEdlDetectJob::GRID_HEIGHT];
+};
+
+void CEdlDetectWorker::Process()
+{
+  std::string redactPath = CURL::GetRedacted(m_file);
+  std::auto_ptr<CDVDInputStream> input(CDVDFactoryInputStream::CreateInputStream(NULL, m_file, ""));
+  if (!input.get() || !input->Open(m_file.c_str(), ""))
+  {
+    CLog::Log(LOGERROR, "CEdlDetectWorker::Process - unable to open %s", redactPath.c_str());
+    m_failed = true;
+    return;
+  }
+
+  std::auto_ptr<CDVDDemux> demux;
+  try
+  {
+    demux.reset(CDVDFactoryDemuxer::CreateDemuxer(input.get()));
+  }
+  catch(...)
+  {
+    CLog::Log(LOGERROR, "CEdlDetectWorker::Process - exception thrown when opening demuxer for %s", redactPath.c_str());
+  }
+  if (!demux.get())
+  {
+    m_failed = true;
+    return;
+  }
+
+  int videoStream = -1, audioStream = -1;
+  for (int i = 0; i < demux->GetNrOfStreams(); i++)
+  {
+    CDemuxStream *stream = demux->GetStream(i);
+    if (!stream)
+      continue;
+    if (stream->type == STREAM_VIDEO && videoStream < 0)
+      videoStream = i;
+    else if (stream->type == STREAM_AUDIO && audioStream < 0)
+      audioStream = i;
+    else
+      stream->SetDiscard(AVDISCARD_ALL);
+  }
+
+  if (videoStream < 0)
+  {
+    CLog::Log(LOGERROR, "CEdlDetectWorker::Process - no video in %s", redactPath.c_str());
+    m_failed = true;
+    return;
+  }
+
+  // key frames only, the thumb decoders skip the rest
+  CDVDStreamInfo videoHint(*demux->GetStream(videoStream), true);
+  videoHint.software = true;
+  CDVDVideoCodec *video = m_codecs.Acquire(videoHint);
+  if (!video)
+  {
+    CLog::Log(LOGERROR, "CEdlDetectWorker::Process - unable to open a video decoder for %s", redactPath.c_str());
+    m_failed = true;
+    return;
+  }
+
+  // the levels of the audio are only needed, without passthrough
+  CDVDAudioCodec *audio = NULL;
+  CDVDStreamInfo audioHint;
+  if (audioStream >= 0)
+  {
+    audioHint = *demux->GetStream(audioStream);
+    CDVDCodecOptions options;
+    audio = CDVDFactoryCodec::OpenCodec(new CDVDAudioCodecFFmpeg(), audioHint, options);
+  }
+
+  if (m_segment.done > 0)
+    demux->SeekTime((int)m_segment.done, true);
+
+  m_window  = -1;
+  m_power   = 0.0;
+  m_samples = 0;
+
+  bool videoOk = true;
+  while (!m_bStop)
+  {
+    DemuxPacket *packet = demux->Read();
+    if (!packet)
+    {
+      // end of the recording
+      m_segment.complete = true;
+      break;
+    }
+
+    double pts = packet->pts != DVD_NOPTS_VALUE ? packet->pts : packet->dts;
+    if (pts == DVD_NOPTS_VALUE || packet->iSize <= 0)
+    {
+      CDVDDemuxUtils::FreeDemuxPacket(packet);
+      continue;
+    }
+
+    int64_t time = (int64_t)(pts * 1000 / DVD_TIME_BASE);
+    if (time >= m_segment.end)
+    {
+      CDVDDemuxUtils::FreeDemuxPacket(packet);
+      m_segment.complete = true;
+      break;
+    }
+
+    // seeking goes to the key frame before
+    if (time >= m_segment.done)
+    {
+      if (packet->iStreamId == videoStream)
+      {
+        int state = video->Decode(packet->pData, packet->iSize, packet->dts, packet->pts);
+        if (state & VC_ERROR)
+        {
+          videoOk = false;
+          CDVDDemuxUtils::FreeDemuxPacket(packet);
+          m_failed = true;
+          break;
+        }
+
+        if (state & VC_PICTURE)
+        {
+          DVDVideoPicture picture;
+          memset(&picture, 0, sizeof(picture));
+          if (video->GetPicture(&picture) && !(picture.iFlags & DVP_FLAG_DROPPED))
+            AddPicture(picture, picture.pts != DVD_NOPTS_VALUE ? (int64_t)(picture.pts * 1000 / DVD_TIME_BASE) : time);
+        }
+
+        // with audio the progress is kept by its windows
+        if (!audio)
+          SetDone(time);
+      }
+      else if (packet->iStreamId == audioStream && audio)
+      {
+        uint8_t *data = packet->pData;
+        int size = packet->iSize;
+        while (size > 0)
+        {
+          int used = audio->Decode(data, size);
+          if (used <= 0)
+            break;
+          data += used;
+          size -= used;
+          AddAudio(audio, time);
+        }
+      }
+    }
+
+    CDVDDemuxUtils::FreeDemuxPacket(packet);
+  }
+
+  if (m_segment.complete)
+    FlushWindow();
+
+  m_codecs.Release(video, videoHint, videoOk);
+  delete audio;
+}
+
+void CEdlDetectWorker::AddPicture(const DVDVideoPicture &picture, int64_t time)
+{
+  if (picture.format != RENDER_FMT_YUV420P || picture.iWidth <= 0 || picture.iHeight <= 0)
+    return;
+
+  const int w = picture.iWidth, h = picture.iHeight;
+  const uint8_t *luma = picture.data[0];
+  int stride = picture.iLineSize[0];
+
+  SFrame frame;
+  memset(&frame, 0, sizeof(frame));
+  frame.time = time;
+
+  uint64_t sum;
+  uint32_t above;
+  CFrameStats::Luma(luma, stride, w, h, BLACK_LEVEL, sum, above);
+  frame.luma   = (uint8_t)(sum / ((uint64_t)w * h));
+  frame.bright = (uint16_t)((uint64_t)above * 1000 / ((uint64_t)w * h));
+
+  // the logo is looked for in a low resolution copy, point sampled
+  for (int y = 0; y < CEdlDetectJob::GRID_HEIGHT; y++)
+  {
+    const uint8_t *row = luma + (y * h + h / 2) / CEdlDetectJob::GRID_HEIGHT * stride;
+    uint8_t *dst = m_grid + y * CEdlDetectJob::GRID_WIDTH;
+    for (int x = 0; x < CEdlDetectJob::GRID_WIDTH; x++)
+      dst[x] = row[(x * w + w / 2) / CEdlDetectJob::GRID_WIDTH];
+  }
+  CFrameStats::Edges(m_edges, CEdlDetectJob::GRID_WIDTH, m_grid, CEdlDetectJob::GRID_WIDTH,
+                     CEdlDetectJob::GRID_WIDTH, CEdlDetectJob::GRID_HEIGHT, EDGE_THRESHOLD);
+
+  for (int c = 0; c < 4; c++)
+  {
+    int x0 = (c & 1) ? CEdlDetectJob::GRID_WIDTH  - CEdlDetectJob::CORNER_WIDTH  - 1 : 0;
+    int y0 = (c & 2) ? CEdlDetectJob::GRID_HEIGHT - CEdlDetectJob::CORNER_HEIGHT - 1 : 0;
+    int bit = 0;
+    for (int y = 0; y < CEdlDetectJob::CORNER_HEIGHT; y++)
+    {
+      const uint8_t *row = m_edges + (y0 + y) * CEdlDetectJob::GRID_WIDTH + x0;
+      for (int x = 0; x < CEdlDetectJob::CORNER_WIDTH; x++, bit++)
+      {
+        if (row[x])
+          frame.edges[c][bit >> 3] |= 1 << (bit & 7);
+      }
+    }
+  }
+
+  m_segment.frames.push_back(frame);
+}
+
+void CEdlDetectWorker::AddAudio(CDVDAudioCodec *codec, int64_t time)
+{
+  uint8_t *data;
+  int size = codec->GetData(&data);
+  if (size <= 0)
+    return;
+
+  double power;
+  unsigned int samples;
+  switch (codec->GetDataFormat())
+  {
+    case AE_FMT_S16NE:
+      samples = size / sizeof(int16_t);
+      power   = CFrameStats::MeanSquare((const int16_t*)data, samples);
+      break;
+    case AE_FMT_FLOAT:
+      samples = size / sizeof(float);
+      power   = CFrameStats::MeanSquare((const float*)data, samples);
+      break;
+    default:
+      return;
+  }
+
+  int64_t window = time - time % WINDOW_MS;
+  if (window != m_window)
+  {
+    FlushWindow();
+    m_window = window;
+  }
+  m_power   += power * samples;
+  m_samples += samples;
+}
+
+void CEdlDetectWorker::FlushWindow()
+{
+  if (m_window >= 0 && m_samples > 0)
+  {
+    SLevel level;
+    level.time  = m_window;
+    level.power = (float)(m_power / m_samples);
+    m_segment.levels.push_back(level);
+
+    // everything before the window is analysed, a resume starts over from it
+    SetDone(std::max(m_segment.done, m_window));
+  }
+  m_power   = 0.0;
+  m_samples = 0;
+}
+
+void CEdlDetectWorker::SetDone(int64_t done)
+{
+  CSingleLock lock(m_section);
+  m_segment.done = done;
+}
+}
+
+//-----------------------------------------------------------------------------
+// job
+//-----------------------------------------------------------------------------
+
+void CEdlDetectJob::Queue(const std::string &path, const std::string &file)
+{
+  GetQueue().Queue(path, file);
+}
+
+std::string CEdlDetectJob::GetEdlFile(const std::string &path)
+{
+  Crc32 crc;
+  crc.ComputeFromLowerCase(path);
+  return StringUtils::Format(EDLDETECT_FOLDER "%08x.edl", (unsigned int)crc);
+}
+
+CEdlDetectJob::CEdlDetectJob(const std::string &path, const std::string &file)
+  : m_path(path)
+  , m_file(file)
+{
+  m_size   = 0;
+  m_length = 0;
+  m_paused = false;
+}
+
+CEdlDetectJob::~CEdlDetectJob()
+{
+}
+
+bool CEdlDetectJob::operator==(const CJob *job) const
+{
+  if (strcmp(job->GetType(), GetType()) != 0)
+    return false;
+  return ((const CEdlDetectJob*)job)->m_path == m_path;
+}
+
+bool CEdlDetectJob::DoWork()
+{
+  std::string redactPath = CURL::GetRedacted(m_file);
+
+  struct __stat64 st;
+  if (CFile::Stat(m_file, &st) != 0)
+    return false;
+
+  if (time(NULL) - st.st_mtime < MIN_AGE)
+  {
+    CLog::Log(LOGDEBUG, "CEdlDetectJob::DoWork - %s is still being recorded", redactPath.c_str());
+    return false;
+  }
+
+  int length;
+  if (!CDVDFileInfo::GetFileDuration(m_file, length))
+  {
+    CLog::Log(LOGERROR, "CEdlDetectJob::DoWork - unable to get the length of %s", redactPath.c_str());
+    return false;
+  }
+
+  if (!LoadState(st.st_size, length))
+  {
+    int workers = std::max(1, std::min(g_cpuInfo.getCPUCount(), MAX_WORKERS));
+    m_size   = st.st_size;
+    m_length = length;
+    m_segments.resize(workers);
+    for (int i = 0; i < workers; i++)
+    {
+      m_segments[i].start    = m_length * i / workers;
+      m_segments[i].end      = i == workers - 1 ? std::numeric_limits<int64_t>::max() : m_length * (i + 1) / workers;
+      m_segments[i].done     = m_segments[i].start;
+      m_segments[i].complete = false;
+    }
+  }
+
+  CLog::Log(LOGDEBUG, "CEdlDetectJob::DoWork - detecting commercial breaks in %s", redactPath.c_str());
+
+  CDVDThumbCodecCache codecs;
+  std::vector<CEdlDetectWorker*> workers;
+  for (size_t i = 0; i < m_segments.size(); i++)
+  {
+    if (m_segments[i].complete)
+      continue;
+    CEdlDetectWorker *worker = new CEdlDetectWorker(m_file, m_segments[i], m_section, codecs);
+    worker->Create();
+    worker->SetPriority(worker->GetMinPriority());
+    workers.push_back(worker);
+  }
+
+  bool failed = false;
+  for (size_t i = 0; i < workers.size(); i++)
+  {
+    while (!workers[i]->WaitForThreadExit(200))
+    {
+      int64_t done = 0;
+      {
+        CSingleLock lock(m_section);
+        for (size_t j = 0; j < m_segments.size(); j++)
+          done += m_segments[j].done - m_segments[j].start;
+      }
+
+      if (CJobManager::GetInstance().IsPaused())
+        m_paused = true;
+      if (m_paused || ShouldCancel((unsigned int)(done / 1000), (unsigned int)(m_length / 1000)))
+      {
+        for (size_t j = 0; j < workers.size(); j++)
+          workers[j]->StopThread(false);
+      }
+    }
+    failed |= workers[i]->Failed();
+  }
+
+  for (size_t i = 0; i < workers.size(); i++)
+  {
+    workers[i]->StopThread();
+    delete workers[i];
+  }
+
+  bool complete = true;
+  for (size_t i = 0; i < m_segments.size(); i++)
+    complete &= m_segments[i].complete;
+
+  if (!complete || failed)
+  {
+    // kept for later unless it can't be read at all
+    if (!failed)
+      SaveState();
+    if (m_paused)
+      CLog::Log(LOGDEBUG, "CEdlDetectJob::DoWork - paused detection in %s", redactPath.c_str());
+    if (failed)
+      m_paused = false;
+    return false;
+  }
+
+  CFile::Delete(URIUtils::ReplaceExtension(GetEdlFile(m_path), ".state"));
+  return WriteEdl();
+}
+
+bool CEdlDetectJob::LoadState(int64_t size, int64_t length)
+{
+  std::string stateFile = URIUtils::ReplaceExtension(GetEdlFile(m_path), ".state");
+  CFile file;
+  if (!file.Open(stateFile))
+    return false;
+
+  uint32_t magic = 0, version = 0, count = 0;
+  bool ok = file.Read(&magic,    sizeof(magic))    == sizeof(magic)
+         && file.Read(&version,  sizeof(version))  == sizeof(version)
+         && file.Read(&m_size,   sizeof(m_size))   == sizeof(m_size)
+         && file.Read(&m_length, sizeof(m_length)) == sizeof(m_length)
+         && file.Read(&count,    sizeof(count))    == sizeof(count);
+
+  // a recording that changed is analysed again
+  if (!ok || magic != STATE_MAGIC || version != STATE_VERSION || m_size != size || m_length != length
+  ||  count == 0 || count > MAX_WORKERS)
+    return false;
+
+  m_segments.resize(count);
+  for (uint32_t i = 0; i < count && ok; i++)
+  {
+    SSegment &segment = m_segments[i];
+    uint8_t  complete = 0;
+    uint32_t frames = 0, levels = 0;
+    ok = file.Read(&segment.start, sizeof(segment.start)) == sizeof(segment.start)
+      && file.Read(&segment.end,   sizeof(segment.end))   == sizeof(segment.end)
+      && file.Read(&segment.done,  sizeof(segment.done))  == sizeof(segment.done)
+      && file.Read(&complete,      sizeof(complete))      == sizeof(complete)
+      && file.Read(&frames,        sizeof(frames))        == sizeof(frames);
+    if (!ok || frames > length)
+      break;
+
+    segment.complete = complete != 0;
+    segment.frames.resize(frames);
+    if (frames)
+      ok = file.Read(&segment.frames[0], frames * sizeof(SFrame)) == frames * sizeof(SFrame);
+
+    ok = ok && file.Read(&levels, sizeof(levels)) == sizeof(levels) && levels <= length;
+    if (!ok)
+      break;
+    segment.levels.resize(levels);
+    if (levels)
+      ok = file.Read(&segment.levels[0], levels * sizeof(SLevel)) == levels * sizeof(SLevel);
+
+    // whatever was found after the last complete audio window is found again
+    if (ok && !segment.complete)
+    {
+      while (!segment.frames.empty() && segment.frames.back().time >= segment.done)
+        segment.frames.pop_back();
+      while (!segment.levels.empty() && segment.levels.back().time >= segment.done)
+        segment.levels.pop_back();
+    }
+  }
+
+  if (!ok)
+  {
+    CLog::Log(LOGWARNING, "CEdlDetectJob::LoadState - ignoring damaged state %s", stateFile.c_str());
+    m_segments.clear();
+    return false;
+  }
+  return true;
+}
+
+bool CEdlDetectJob::SaveState()
+{
+  CDirectory::Create(EDLDETECT_FOLDER);
+
+  std::string stateFile = URIUtils::ReplaceExtension(GetEdlFile(m_path), ".state");
+  CFile file;
+  if (!file.OpenForWrite(stateFile, true))
+  {
+    CLog::Log(LOGERROR, "CEdlDetectJob::SaveState - unable to write %s", stateFile.c_str());
+    return false;
+  }
+
+  uint32_t magic = STATE_MAGIC, version = STATE_VERSION, count = m_segments.size();
+  file.Write(&magic,    sizeof(magic));
+  file.Write(&version,  sizeof(version));
+  file.Write(&m_size,   sizeof(m_size));
+  file.Write(&m_length, sizeof(m_length));
+  file.Write(&count,    sizeof(count));
+  for (size_t i = 0; i < m_segments.size(); i++)
+  {
+    const SSegment &segment = m_segments[i];
+    uint8_t  complete = segment.complete ? 1 : 0;
+    uint32_t frames = segment.frames.size(), levels = segment.levels.size();
+    file.Write(&segment.start, sizeof(segment.start));
+    file.Write(&segment.end,   sizeof(segment.end));
+    file.Write(&segment.done,  sizeof(segment.done));
+    file.Write(&complete,      sizeof(complete));
+    file.Write(&frames,        sizeof(frames));
+    if (frames)
+      file.Write(&segment.frames[0], frames * sizeof(SFrame));
+    file.Write(&levels,        sizeof(levels));
+    if (levels)
+      file.Write(&segment.levels[0], levels * sizeof(SLevel));
+  }
+  return true;
+}
+
+bool CEdlDetectJob::WriteEdl()
+{
+  std::vector<SFrame> frames;
+  std::vector<SLevel> levels;
+  for (size_t i = 0; i < m_segments.size(); i++)
+  {
+    frames.insert(frames.end(), m_segments[i].frames.begin(), m_segments[i].frames.end());
+    levels.insert(levels.end(), m_segments[i].levels.begin(), m_segments[i].levels.end());
+  }
+  std::sort(frames.begin(), frames.end(), FrameBefore);
+
+  // candidates for the start and end of a break, black frames and silence
+  std::vector<int64_t> candidates;
+  for (size_t i = 0; i < frames.size(); i++)
+  {
+    if (IsBlack(frames[i]))
+      candidates.push_back(frames[i].time);
+  }
+  for (size_t i = 0; i < levels.size(); i++)
+  {
+    if (levels[i].power < SILENCE_POWER)
+      candidates.push_back(levels[i].time + WINDOW_MS / 2);
+  }
+  std::sort(candidates.begin(), candidates.end());
+
+  // a fade to black with the sound going is one boundary, in its middle
+  std::vector<int64_t> bounds;
+  bounds.push_back(0);
+  for (size_t i = 0; i < candidates.size(); )
+  {
+    size_t j = i + 1;
+    while (j < candidates.size() && candidates[j] - candidates[j - 1] < MERGE_MS)
+      j++;
+    int64_t bound = (candidates[i] + candidates[j - 1]) / 2;
+    if (bound - bounds.back() >= MERGE_MS && m_length - bound >= MERGE_MS)
+      bounds.push_back(bound);
+    i = j;
+  }
+  bounds.push_back(m_length);
+
+  // the logo, cells of a corner with an edge in most frames
+  std::vector<int> presence(4 * CORNER_WIDTH * CORNER_HEIGHT, 0);
+  int shown = 0;
+  for (size_t i = 0; i < frames.size(); i++)
+  {
+    if (IsBlack(frames[i]))
+      continue;
+    shown++;
+    for (int c = 0; c < 4; c++)
+      for (int bit = 0; bit < CORNER_WIDTH * CORNER_HEIGHT; bit++)
+        presence[c * CORNER_WIDTH * CORNER_HEIGHT + bit] += GetBit(frames[i].edges[c], bit);
+  }
+
+  int logoCorner = -1;
+  std::vector<int> logoCells;
+  if (shown >= LOGO_MIN_FRAMES)
+  {
+    for (int c = 0; c < 4; c++)
+    {
+      std::vector<int> cells;
+      for (int bit = 0; bit < CORNER_WIDTH * CORNER_HEIGHT; bit++)
+      {
+        int count = presence[c * CORNER_WIDTH * CORNER_HEIGHT + bit];
+        if (count >= shown * LOGO_MIN_PRESENCE && count <= shown * LOGO_MAX_PRESENCE)
+          cells.push_back(bit);
+      }
+      if (cells.size() >= LOGO_MIN_CELLS && cells.size() > logoCells.size())
+      {
+        logoCorner = c;
+        logoCells.swap(cells);
+      }
+    }
+  }
+
+  // classify the parts between the bounds
+  size_t parts = bounds.size() - 1;
+  std::vector<bool> commercial(parts, false);
+  size_t frame = 0;
+  for (size_t i = 0; i < parts; i++)
+  {
+    int total = 0, logo = 0;
+    for (; frame < frames.size() && frames[frame].time < bounds[i + 1]; frame++)
+    {
+      if (IsBlack(frames[frame]) || logoCorner < 0)
+        continue;
+      size_t set = 0;
+      for (size_t k = 0; k < logoCells.size(); k++)
+        set += GetBit(frames[frame].edges[logoCorner], logoCells[k]);
+      total++;
+      if (set * 2 >= logoCells.size())
+        logo++;
+    }
+
+    if (logoCorner >= 0)
+      commercial[i] = total > 0 && logo < total * LOGO_COMMERCIAL;
+    else
+      commercial[i] = bounds[i + 1] - bounds[i] <= MAX_SPOT_MS;
+  }
+
+  if (logoCorner < 0)
+  {
+    // a single short part is a scene, not a break
+    for (size_t i = 0; i < parts; )
+    {
+      size_t j = i;
+      while (j < parts && commercial[j])
+        j++;
+      if (j - i < MIN_SPOTS)
+        std::fill(commercial.begin() + i, commercial.begin() + j, false);
+      i = j + 1;
+    }
+  }
+
+  std::string edl;
+  int breaks = 0;
+  for (size_t i = 0; i < parts; )
+  {
+    if (!commercial[i])
+    {
+      i++;
+      continue;
+    }
+    size_t j = i;
+    while (j < parts && commercial[j])
+      j++;
+    if (bounds[j] - bounds[i] >= g_advancedSettings.m_iEdlMinCommBreakLength * 1000)
+    {
+      edl += StringUtils::Format("%.3f\t%.3f\t3\n", bounds[i] / 1000.0, bounds[j] / 1000.0);
+      breaks++;
+    }
+    i = j;
+  }
+
+  CLog::Log(LOGDEBUG, "CEdlDetectJob::WriteEdl - %d commercial breaks in %s, %u key frames, %u boundaries, %s",
+            breaks, CURL::GetRedacted(m_file).c_str(), (unsigned int)frames.size(), (unsigned int)bounds.size() - 2,
+            logoCorner >= 0 ? "by the logo" : "no logo found");
+
+  // written even without breaks, so the recording isn't analysed again
+  CDirectory::Create(EDLDETECT_FOLDER);
+  std::string edlFile = GetEdlFile(m_path);
+  CFile file;
+  if (!file.OpenForWrite(edlFile, true))
+  {
+    CLog::Log(LOGERROR, "CEdlDetectJob::WriteEdl - unable to write %s", edlFile.c_str());
+    return false;
+  }
+  if (!edl.empty())
+    file.Write(edl.c_str(), edl.size());
+  return true;
+}
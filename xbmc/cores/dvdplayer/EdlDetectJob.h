@@ -0,0 +1,124 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+#include "utils/Job.h"
+
+/*!
+ \brief Background detection of commercial breaks in recordings
+
+ The recording is decoded cheaply, key frames only in software and the
+ audio, and split in segments analysed in parallel. For every key frame the
+ average luma, the amount of bright samples and the edges in the corners of
+ a low resolution copy are kept, for the audio the level of short windows.
+
+ Once all segments are done, breaks are placed between black frames or
+ silences, and the parts between them are classified by whether the station
+ logo, found as the edges present in a corner for most of the recording, is
+ shown. Without a logo, runs of short parts are taken for commercials.
+
+ The result is written as a MPlayer EDL with commercial break actions, which
+ CEdl reads for the recording when there is no other edit decision list.
+
+ The job runs at PRIORITY_LOW_PAUSABLE. When jobs are paused for playback it
+ stops, keeps what was analysed so far and is queued again, to continue where
+ it was once jobs are resumed.
+ */
+class CEdlDetectJob : public CJob
+{
+public:
+  /*!
+   \brief Queue a detection for a recording, unless one is queued already
+   \param path the path the recording is played from, the EDL is kept for it
+   \param file the file to analyse, the same as path unless played through PVR
+   */
+  static void Queue(const std::string &path, const std::string &file);
+
+  /*!
+   \brief EDL file of the detection for a recording, it exists once detection is done
+   */
+  static std::string GetEdlFile(const std::string &path);
+
+  CEdlDetectJob(const std::string &path, const std::string &file);
+  virtual ~CEdlDetectJob();
+
+  virtual const char *GetType() const { return "edldetect"; }
+  virtual bool operator==(const CJob *job) const;
+  virtual bool DoWork();
+
+  /*!
+   \brief Whether DoWork stopped because jobs were paused, rather than finished or failed
+   */
+  bool WasPaused() const { return m_paused; }
+
+  const std::string &GetPath() const { return m_path; }
+  const std::string &GetFile() const { return m_file; }
+
+  // size of the low resolution copy the edges are taken from
+  static const int GRID_WIDTH  = 128;
+  static const int GRID_HEIGHT = 72;
+  // corner of the grid a logo is looked for in
+  static const int CORNER_WIDTH  = 32;
+  static const int CORNER_HEIGHT = 18;
+  static const int CORNER_BYTES  = CORNER_WIDTH * CORNER_HEIGHT / 8;
+
+  struct SFrame
+  {
+    int64_t  time;                      // ms
+    uint8_t  luma;                      // average
+    uint16_t bright;                    // samples above black, per mille
+    uint8_t  edges[4][CORNER_BYTES];    // edge bits of each corner
+  };
+
+  struct SLevel
+  {
+    int64_t time;                       // ms, start of the window
+    float   power;                      // mean square, 1.0 is full scale
+  };
+
+  struct SSegment
+  {
+    int64_t start;                      // ms
+    int64_t end;                        // ms
+    int64_t done;                       // ms analysed up to
+    bool    complete;
+    std::vector<SFrame> frames;
+    std::vector<SLevel> levels;
+  };
+
+private:
+  bool LoadState(int64_t size, int64_t length);
+  bool SaveState();
+  bool WriteEdl();
+
+  std::string m_path;
+  std::string m_file;
+  int64_t     m_size;
+  int64_t     m_length;
+  bool        m_paused;
+  std::vector<SSegment> m_segments;
+  CCriticalSection      m_section;  // guards SSegment::done while the workers run
+};
@@ -63,7 +63,7 @@ void CAudioDecoder::Destroy()
   m_canPlay = false;
 }
 
-bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
+bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset, float bufferTime /* = 2.0f */, unsigned int maxBufferSize /* = 0 */)
 {
   Destroy();
 
@@ -99,13 +99,38 @@ bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
     return false;
   }
 
-  /* allocate the pcmBuffer for 2 seconds of audio */
-  m_pcmBuffer.Create(2 * blockSize * m_codec->m_SampleRate);
+  /* allocate the pcmBuffer for bufferTime seconds of audio, in whole frames */
+  unsigned int bufferSize = (unsigned int)(bufferTime * m_codec->m_SampleRate) * blockSize;
+  if (maxBufferSize && bufferSize > maxBufferSize)
+    bufferSize = maxBufferSize - maxBufferSize % blockSize;
+  if (bufferSize < PACKET_SIZE * (m_codec->m_BitsPerSample >> 3))
+  {
+    CLog::Log(LOGERROR, "CAudioDecoder: Buffer of %u bytes is too small for %s", bufferSize, file.GetPath().c_str());
+    Destroy();
+    return false;
+  }
+  m_pcmBuffer.Create(bufferSize);
 
   // set total time from the given tag
   if (file.HasMusicInfoTag() && file.GetMusicInfoTag()->GetDuration())
     m_codec->SetTotalTime(file.GetMusicInfoTag()->GetDuration());
 
+  // fall back to the gain measured by the library scan if the file has no replaygain tags
+  if (file.HasMusicInfoTag() && !m_codec->m_tag.HasReplayGainInfo())
+  {
+    const MUSIC_INFO::CMusicInfoTag &tag = *file.GetMusicInfoTag();
+    if (tag.HasReplayGainInfo() & REPLAY_GAIN_HAS_TRACK_INFO)
+    {
+      m_codec->m_tag.SetReplayGainTrackGain(tag.GetReplayGainTrackGain());
+      m_codec->m_tag.SetReplayGainTrackPeak(tag.GetReplayGainTrackPeak());
+    }
+    if (tag.HasReplayGainInfo() & REPLAY_GAIN_HAS_ALBUM_INFO)
+    {
+      m_codec->m_tag.SetReplayGainAlbumGain(tag.GetReplayGainAlbumGain());
+      m_codec->m_tag.SetReplayGainAlbumPeak(tag.GetReplayGainAlbumPeak());
+    }
+  }
+
   if (seekOffset)
     m_codec->Seek(seekOffset);
 
@@ -114,6 +139,27 @@ bool CAudioDecoder::Create(const CFileItem &file, int64_t seekOffset)
   return true;
 }
 
+void CAudioDecoder::Adopt(CAudioDecoder &other)
+{
+  Destroy();
+
+  CSingleLock lock(m_critSection);
+  CSingleLock otherLock(other.m_critSection);
+
+  m_codec = other.m_codec;
+  other.m_codec = NULL;
+
+  m_pcmBuffer.Create(other.m_pcmBuffer.getSize());
+  m_pcmBuffer.Copy(other.m_pcmBuffer);
+
+  m_eof     = other.m_eof;
+  m_status  = other.m_status;
+  m_canPlay = false;
+
+  otherLock.Leave();
+  other.Destroy();
+}
+
 void CAudioDecoder::GetDataFormat(CAEChannelInfo *channelInfo, unsigned int *samplerate, unsigned int *encodedSampleRate, enum AEDataFormat *dataFormat)
 {
   if (!m_codec)
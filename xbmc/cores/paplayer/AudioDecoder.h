@@ -56,9 +56,23 @@ public:
   CAudioDecoder();
   ~CAudioDecoder();
 
-  bool Create(const CFileItem &file, int64_t seekOffset);
+  /*!
+   \brief Open the codec for a file and allocate the pcm buffer
+   \param file the file to decode
+   \param seekOffset the position to start decoding at in ms
+   \param bufferTime the amount of decoded audio to buffer in seconds
+   \param maxBufferSize upper limit for the pcm buffer in bytes, 0 for no limit
+   */
+  bool Create(const CFileItem &file, int64_t seekOffset, float bufferTime = 2.0f, unsigned int maxBufferSize = 0);
   void Destroy();
 
+  /*!
+   \brief Take over the codec and the buffered audio of another decoder
+   \param other an opened decoder, it is left destroyed afterwards
+   */
+  void Adopt(CAudioDecoder &other);
+  unsigned int GetBufferSize() { return m_pcmBuffer.getSize(); }
+
   int ReadSamples(int numsamples);
 
   bool CanSeek() { if (m_codec) return m_codec->CanSeek(); else return false; };
@@ -0,0 +1,220 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include "AudioDecoderCache.h"
+#include "AudioDecoder.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "threads/Thread.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+#include "utils/URIUtils.h"
+
+class CAudioDecoderPrefetchJob : public CJob
+{
+public:
+  CAudioDecoderPrefetchJob(const CFileItem &item, unsigned int maxBufferSize)
+    : m_item(item), m_maxBufferSize(maxBufferSize), m_decoder(NULL) {}
+
+  virtual ~CAudioDecoderPrefetchJob()
+  {
+    delete m_decoder;
+  }
+
+  virtual const char *GetType() const { return "audiodecoderprefetch"; }
+
+  virtual bool DoWork()
+  {
+    m_decoder = new CAudioDecoder();
+    if (!m_decoder->Create(m_item, (m_item.m_lStartOffset * 1000) / 75,
+                           g_advancedSettings.m_audioPrefetchSeconds, m_maxBufferSize))
+      return false;
+
+    /* decode until the buffer is full, the codec decides when that is */
+    while (m_decoder->GetStatus() == STATUS_QUEUING)
+    {
+      if (ShouldCancel(0, 0))
+        return false;
+
+      int result = m_decoder->ReadSamples(PACKET_SIZE);
+      if (result == RET_ERROR)
+      {
+        CLog::Log(LOGINFO, "CAudioDecoderPrefetchJob - Error reading samples from %s", m_item.GetPath().c_str());
+        return false;
+      }
+      /* the codec has no data ready yet, e.g. waiting on the network */
+      if (result == RET_SLEEP)
+        XbmcThreads::ThreadSleep(10);
+    }
+
+    return m_decoder->GetStatus() != STATUS_NO_FILE;
+  }
+
+  CAudioDecoder *Release()
+  {
+    CAudioDecoder *decoder = m_decoder;
+    m_decoder = NULL;
+    return decoder;
+  }
+
+  const CFileItem &GetItem() const { return m_item; }
+
+private:
+  CFileItem      m_item;
+  unsigned int   m_maxBufferSize;
+  CAudioDecoder *m_decoder;
+};
+
+CAudioDecoderCache::CAudioDecoderCache()
+{
+}
+
+CAudioDecoderCache::~CAudioDecoderCache()
+{
+  Clear();
+}
+
+bool CAudioDecoderCache::CanPrefetch(const CFileItem &file)
+{
+  if (file.m_bIsFolder || file.IsCDDA() || file.IsOnDVD() || file.IsInternetStream())
+    return false;
+
+  /* these are resolved to the real file when they are queued */
+  if (file.IsPlugin() || URIUtils::IsUPnP(file.GetPath()))
+    return false;
+
+  return true;
+}
+
+bool CAudioDecoderCache::Matches(const CacheEntry &entry, const CFileItem &file)
+{
+  return entry.path == file.GetPath() &&
+         entry.startOffset == file.m_lStartOffset;
+}
+
+void CAudioDecoderCache::FreeEntry(CacheEntry &entry)
+{
+  if (entry.jobID)
+    CJobManager::GetInstance().CancelJob(entry.jobID);
+  delete entry.decoder;
+  entry.jobID = 0;
+  entry.decoder = NULL;
+}
+
+void CAudioDecoderCache::Prefetch(const CFileItemList &items)
+{
+  unsigned int tracks = g_advancedSettings.m_audioPrefetchTracks;
+  unsigned int budget = g_advancedSettings.m_audioPrefetchMemorySize;
+  if (!tracks || !budget)
+    return;
+
+  CSingleLock lock(m_section);
+
+  /* drop what is not wanted anymore */
+  for (CacheEntries::iterator it = m_entries.begin(); it != m_entries.end();)
+  {
+    bool wanted = false;
+    for (int i = 0; i < items.Size() && i < (int)tracks && !wanted; i++)
+      wanted = Matches(*it, *items[i]);
+
+    if (!wanted)
+    {
+      FreeEntry(*it);
+      it = m_entries.erase(it);
+    }
+    else
+      ++it;
+  }
+
+  /* every track gets an equal share of the budget, so the sum of all
+   * pcm buffers can never exceed it */
+  unsigned int share = budget / tracks;
+  for (int i = 0; i < items.Size() && i < (int)tracks; i++)
+  {
+    const CFileItem &item = *items[i];
+    if (!CanPrefetch(item))
+      continue;
+
+    bool cached = false;
+    for (CacheEntries::iterator it = m_entries.begin(); it != m_entries.end() && !cached; ++it)
+      cached = Matches(*it, item);
+    if (cached)
+      continue;
+
+    CacheEntry entry;
+    entry.path        = item.GetPath();
+    entry.startOffset = item.m_lStartOffset;
+    entry.decoder     = NULL;
+    entry.jobID       = CJobManager::GetInstance().AddJob(new CAudioDecoderPrefetchJob(item, share), this, CJob::PRIORITY_LOW);
+    m_entries.push_back(entry);
+
+    CLog::Log(LOGDEBUG, "CAudioDecoderCache::Prefetch - priming %s", entry.path.c_str());
+  }
+}
+
+CAudioDecoder *CAudioDecoderCache::Take(const CFileItem &file)
+{
+  CSingleLock lock(m_section);
+  for (CacheEntries::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+  {
+    if (!Matches(*it, file))
+      continue;
+
+    /* still priming, the caller is faster opening the file itself */
+    CAudioDecoder *decoder = it->decoder;
+    it->decoder = NULL;
+    FreeEntry(*it);
+    m_entries.erase(it);
+
+    if (decoder)
+      CLog::Log(LOGDEBUG, "CAudioDecoderCache::Take - using primed decoder for %s", file.GetPath().c_str());
+    return decoder;
+  }
+  return NULL;
+}
+
+void CAudioDecoderCache::Clear()
+{
+  CSingleLock lock(m_section);
+  for (CacheEntries::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+    FreeEntry(*it);
+  m_entries.clear();
+}
+
+void CAudioDecoderCache::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  CSingleLock lock(m_section);
+  for (CacheEntries::iterator it = m_entries.begin(); it != m_entries.end(); ++it)
+  {
+    if (it->jobID != jobID)
+      continue;
+
+    it->jobID = 0;
+    if (success)
+      it->decoder = ((CAudioDecoderPrefetchJob *)job)->Release();
+    else
+    {
+      CLog::Log(LOGDEBUG, "CAudioDecoderCache::OnJobComplete - failed to prime %s", it->path.c_str());
+      m_entries.erase(it);
+    }
+    return;
+  }
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+
+#include <list>
+
+#include "FileItem.h"
+#include "threads/CriticalSection.h"
+#include "utils/Job.h"
+
+class CAudioDecoder;
+
+/*!
+ \brief Keeps decoders for upcoming playlist entries opened and primed.
+
+ Opening a codec on a slow or high latency source can take longer than the
+ time PAPlayer has between queueing the next track and starting it. The cache
+ opens and pre-decodes the first seconds of the next entries in background
+ jobs, PAPlayer then takes over a ready decoder instead of opening the file
+ itself. The pcm buffers of all cached decoders share a fixed memory budget.
+ */
+class CAudioDecoderCache : public IJobCallback
+{
+public:
+  CAudioDecoderCache();
+  virtual ~CAudioDecoderCache();
+
+  /*!
+   \brief Set the entries that should be cached
+   Decoders for entries not in the list are dropped, missing ones are
+   opened in the background.
+   \param items the upcoming entries, most important first
+   */
+  void Prefetch(const CFileItemList &items);
+
+  /*!
+   \brief Hand out the cached decoder for a file
+   \param file the file that is about to be played
+   \return a decoder owned by the caller, or NULL if there is no ready decoder
+   */
+  CAudioDecoder *Take(const CFileItem &file);
+
+  /*!
+   \brief Drop all cached decoders and cancel pending jobs
+   */
+  void Clear();
+
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+
+  /*!
+   \brief Whether a file is worth prefetching
+   Streams, optical media and items that need to be resolved first are not.
+   */
+  static bool CanPrefetch(const CFileItem &file);
+
+private:
+  struct CacheEntry
+  {
+    std::string    path;
+    int64_t        startOffset;
+    unsigned int   jobID;        ///< job priming the decoder, 0 once it finished
+    CAudioDecoder *decoder;      ///< the primed decoder, NULL while the job runs
+  };
+  typedef std::list<CacheEntry> CacheEntries;
+
+  static bool Matches(const CacheEntry &entry, const CFileItem &file);
+  static void FreeEntry(CacheEntry &entry);
+
+  CCriticalSection m_section;
+  CacheEntries     m_entries;
+};
@@ -28,6 +28,8 @@
 #include "utils/log.h"
 #include "utils/MathUtils.h"
 #include "utils/JobManager.h"
+#include "PlayListPlayer.h"
+#include "playlists/PlayList.h"
 
 #include "threads/SingleLock.h"
 #include "cores/AudioEngine/AEFactory.h"
@@ -46,15 +48,18 @@ CAEChannelInfo ICodec::GetChannelInfo()
 class CQueueNextFileJob : public CJob
 {
   CFileItem m_item;
+  CFileItemList m_prefetch;
   PAPlayer &m_player;
 
 public:
-                CQueueNextFileJob(const CFileItem& item, PAPlayer &player)
-                  : m_item(item), m_player(player) {}
+                CQueueNextFileJob(const CFileItem& item, const CFileItemList& prefetch, PAPlayer &player)
+                  : m_item(item), m_player(player) { m_prefetch.Copy(prefetch); }
   virtual       ~CQueueNextFileJob() {}
   virtual bool  DoWork()
   {
-    return m_player.QueueNextFileEx(m_item, true, true);
+    bool ret = m_player.QueueNextFileEx(m_item, true, true);
+    m_player.m_decoderCache.Prefetch(m_prefetch);
+    return ret;
   }
 };
 
@@ -265,6 +270,10 @@ bool PAPlayer::OpenFile(const CFileItem& file, const CPlayerOptions &options)
   {
     if (!QueueNextFileEx(file, false))
       return false;
+
+    CFileItemList prefetch;
+    GetPrefetchItems(file, prefetch);
+    m_decoderCache.Prefetch(prefetch);
   }
 
   CSharedLock lock(m_streamsLock);
@@ -321,10 +330,34 @@ bool PAPlayer::QueueNextFile(const CFileItem &file)
     CExclusiveLock lock(m_streamsLock);
     m_jobCounter++;
   }
-  CJobManager::GetInstance().AddJob(new CQueueNextFileJob(file, *this), this, CJob::PRIORITY_NORMAL);
+  CFileItemList prefetch;
+  GetPrefetchItems(file, prefetch);
+  CJobManager::GetInstance().AddJob(new CQueueNextFileJob(file, prefetch, *this), this, CJob::PRIORITY_NORMAL);
   return true;
 }
 
+void PAPlayer::GetPrefetchItems(const CFileItem &file, CFileItemList &items)
+{
+  /* collect the playlist entries following the one being opened, this runs
+   * on the application thread which owns the playlist player */
+  int playlist = g_playlistPlayer.GetCurrentPlaylist();
+  if (playlist != PLAYLIST_MUSIC)
+    return;
+
+  const PLAYLIST::CPlayList &list = g_playlistPlayer.GetPlaylist(playlist);
+  for (int offset = 1; items.Size() < (int)g_advancedSettings.m_audioPrefetchTracks; offset++)
+  {
+    int index = g_playlistPlayer.GetNextSong(offset);
+    if (index < 0 || index >= list.size() || offset > list.size())
+      break;
+
+    const CFileItemPtr item = list[index];
+    if (item->GetPath() == file.GetPath() && item->m_lStartOffset == file.m_lStartOffset)
+      continue;
+    items.Add(CFileItemPtr(new CFileItem(*item)));
+  }
+}
+
 bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */, bool job /* = false */)
 {
   StreamInfo *si = new StreamInfo();
@@ -348,7 +381,14 @@ bool PAPlayer::QueueNextFileEx(const CFileItem &file, bool fadeIn/* = true */, b
     m_continueStream = false;
   }
 
-  if (!si->m_decoder.Create(file, (file.m_lStartOffset * 1000) / 75))
+  /* use a decoder that was opened and primed in the background if there is one */
+  CAudioDecoder *primed = m_decoderCache.Take(file);
+  if (primed)
+  {
+    si->m_decoder.Adopt(*primed);
+    delete primed;
+  }
+  else if (!si->m_decoder.Create(file, (file.m_lStartOffset * 1000) / 75))
   {
     CLog::Log(LOGWARNING, "PAPlayer::QueueNextFileEx - Failed to create the decoder");
 
@@ -532,6 +572,10 @@ bool PAPlayer::CloseFile(bool reopen)
     SoftStop(true, true);
   CloseAllStreams(false);
 
+  /* keep primed decoders when we are about to open the next file */
+  if (!reopen)
+    m_decoderCache.Clear();
+
   /* wait for the thread to terminate */
   StopThread(true);//true - wait for end of thread
 
@@ -25,6 +25,7 @@
 #include "cores/IPlayer.h"
 #include "threads/Thread.h"
 #include "AudioDecoder.h"
+#include "AudioDecoderCache.h"
 #include "threads/SharedSection.h"
 #include "utils/Job.h"
 
@@ -142,7 +143,9 @@ private:
   int                 m_jobCounter;
   CEvent              m_jobEvent;
   bool                m_continueStream;
+  CAudioDecoderCache  m_decoderCache;        /* primed decoders of the upcoming playlist entries */
 
+  void GetPrefetchItems(const CFileItem &file, CFileItemList &items);
   bool QueueNextFileEx(const CFileItem &file, bool fadeIn = true, bool job = false);
   void SoftStart(bool wait = false);
   void SoftStop(bool wait = false, bool close = true);
@@ -20,6 +20,7 @@
 
 #include "GUIBaseContainer.h"
 #include "GUIControlFactory.h"
+#include "GUILargeTextureManager.h"
 #include "GUIWindowManager.h"
 #include "utils/CharsetConverter.h"
 #include "GUIInfoManager.h"
@@ -39,6 +40,10 @@ using namespace std;
 #define HOLD_TIME_END   3000
 #define SCROLLING_GAP   200U
 #define SCROLLING_THRESHOLD 300U
+#define PREFETCH_ITEMS      1
+#define PREFETCH_TIME       1000   // ms of scrolling to have the art of loading ahead
+#define PREFETCH_VELOCITY   2.0f   // rows per second below which we are not scrolling
+#define PREFETCH_TRACKED    200
 
 CGUIBaseContainer::CGUIBaseContainer(int parentID, int controlID, float posX, float posY, float width, float height, ORIENTATION orientation, const CScroller& scroller, int preloadItems)
     : IGUIContainer(parentID, controlID, posX, posY, width, height)
@@ -62,6 +67,11 @@ CGUIBaseContainer::CGUIBaseContainer(int parentID, int controlID, float posX, fl
   m_autoScrollDelayTime = 0;
   m_autoScrollIsReversed = false;
   m_lastRenderTime = 0;
+  m_scrollVelocity = 0.0f;
+  m_prefetchPosition = 0.0f;
+  m_prefetchTime = 0;
+  m_prefetchDirection = 0;
+  m_prefetchRow = 0;
 }
 
 CGUIBaseContainer::~CGUIBaseContainer(void)
@@ -97,6 +107,7 @@ void CGUIBaseContainer::Process(unsigned int currentTime, CDirtyRegionList &dirt
   if (!m_layout || !m_focusedLayout) return;
 
   UpdateScrollOffset(currentTime);
+  PrefetchScrollArt(currentTime, 1);
 
   int offset = (int)floorf(m_scroller.GetValue() / m_layout->Size(m_orientation));
 
@@ -181,6 +192,8 @@ void CGUIBaseContainer::ProcessItem(float posX, float posY, CGUIListItemPtr& ite
       }
       item->GetFocusedLayout()->Process(item.get(), m_parentID, currentTime, dirtyregions);
     }
+    if (item != m_lastItem)
+      PrefetchArt();
     m_lastItem = item;
   }
   else
@@ -626,6 +639,85 @@ void CGUIBaseContainer::Scroll(int amount)
   ScrollToOffset(GetOffset() + amount);
 }
 
+void CGUIBaseContainer::PrefetchArt()
+{
+  // views show the fanart of the focused item, have that of its neighbours loaded by the time they get focus
+  int selected = GetSelectedItem();
+  for (int offset = -PREFETCH_ITEMS; offset <= PREFETCH_ITEMS; offset++)
+  {
+    int itemNo = selected + offset;
+    if (offset && itemNo >= 0 && itemNo < (int)m_items.size())
+      g_largeTextureManager.PrefetchImage(m_items[itemNo]->GetArt("fanart"));
+  }
+}
+
+void CGUIBaseContainer::PrefetchScrollArt(unsigned int currentTime, int itemsPerRow)
+{
+  float position = m_scroller.GetValue() / m_layout->Size(m_orientation);
+  if (m_prefetchTime && currentTime > m_prefetchTime)
+  { // smoothed, as holding a key moves the list in steps
+    float velocity = (position - m_prefetchPosition) * 1000.0f / (currentTime - m_prefetchTime);
+    m_scrollVelocity = 0.8f * m_scrollVelocity + 0.2f * velocity;
+  }
+  m_prefetchPosition = position;
+  m_prefetchTime = currentTime;
+
+  int direction = 0;
+  if (m_scrollVelocity > PREFETCH_VELOCITY)
+    direction = 1;
+  else if (m_scrollVelocity < -PREFETCH_VELOCITY)
+    direction = -1;
+  if (!direction)
+    return; // what is still loading is about to be shown
+
+  bool reversed = direction != m_prefetchDirection;
+  if (reversed)
+  { // what was loading ahead of the other direction won't be shown
+    CancelScrollPrefetch();
+    m_prefetchDirection = direction;
+  }
+
+  // the rows past those processed in the direction of scrolling, as many as scroll in within PREFETCH_TIME
+  int cacheBefore, cacheAfter;
+  GetCacheOffsets(cacheBefore, cacheAfter);
+  int offset = (int)floorf(position);
+  int first = direction > 0 ? offset + m_itemsPerPage + 1 + cacheAfter : offset - cacheBefore - 1;
+  int rows  = std::min(m_itemsPerPage, (int)ceilf(fabs(m_scrollVelocity) * PREFETCH_TIME / 1000.0f));
+  int last  = first + direction * rows;
+
+  // continue after the rows queued on earlier frames, unless we've jumped
+  if (reversed || direction * (m_prefetchRow - first) < 0 || direction * (m_prefetchRow - last) > 0)
+    m_prefetchRow = first;
+
+  std::vector<CStdString> images;
+  for (; direction * (last - m_prefetchRow) > 0; m_prefetchRow += direction)
+  {
+    for (int col = 0; col < itemsPerRow; col++)
+    {
+      int itemNo = CorrectOffset(m_prefetchRow, col);
+      if (itemNo >= 0 && itemNo < (int)m_items.size())
+        m_layout->GetLargeImages(m_items[itemNo].get(), images);
+    }
+  }
+
+  // ahead of background work, but behind the images on screen as those are queued first
+  for (std::vector<CStdString>::const_iterator i = images.begin(); i != images.end(); ++i)
+  {
+    g_largeTextureManager.PrefetchImage(*i, CJob::PRIORITY_NORMAL);
+    m_prefetched.push_back(*i);
+  }
+  // the oldest ones have been scrolled past by now
+  if (m_prefetched.size() > PREFETCH_TRACKED)
+    m_prefetched.erase(m_prefetched.begin(), m_prefetched.begin() + m_prefetched.size() - PREFETCH_TRACKED / 2);
+}
+
+void CGUIBaseContainer::CancelScrollPrefetch()
+{
+  for (std::vector<CStdString>::const_iterator i = m_prefetched.begin(); i != m_prefetched.end(); ++i)
+    g_largeTextureManager.CancelPrefetch(*i);
+  m_prefetched.clear();
+}
+
 int CGUIBaseContainer::GetSelectedItem() const
 {
   return CorrectOffset(GetOffset(), GetCursor());
@@ -1058,6 +1150,10 @@ void CGUIBaseContainer::Reset()
   m_items.clear();
   m_lastItem.reset();
   ResetAutoScrolling();
+  CancelScrollPrefetch();
+  m_scrollVelocity = 0.0f;
+  m_prefetchTime = 0;
+  m_prefetchDirection = 0;
 }
 
 void CGUIBaseContainer::LoadLayout(TiXmlElement *layout)
@@ -101,6 +101,9 @@ protected:
   bool OnClick(int actionID);
 
   virtual void ProcessItem(float posX, float posY, CGUIListItemPtr& item, bool focused, unsigned int currentTime, CDirtyRegionList &dirtyregions);
+  void PrefetchArt();
+  void PrefetchScrollArt(unsigned int currentTime, int itemsPerRow);
+  void CancelScrollPrefetch();
 
   virtual void Render();
   virtual void RenderItem(float posX, float posY, CGUIListItem *item, bool focused);
@@ -206,6 +209,14 @@ protected:
 
   unsigned int m_lastRenderTime;
 
+  // art prefetching ahead of scrolling
+  float        m_scrollVelocity;    ///< rows per second, smoothed over a few frames
+  float        m_prefetchPosition;  ///< scroll position in rows at m_prefetchTime
+  unsigned int m_prefetchTime;
+  int          m_prefetchDirection; ///< 1 when scrolling down, -1 when up, 0 before any scrolling
+  int          m_prefetchRow;       ///< next row to prefetch in m_prefetchDirection
+  std::vector<CStdString> m_prefetched;
+
 private:
   int m_cursor;
   int m_offset;
@@ -662,6 +662,17 @@ void CGUIControlGroup::GetContainers(vector<CGUIControl *> &containers) const
   }
 }
 
+void CGUIControlGroup::GetImages(vector<const CGUIControl *> &images) const
+{
+  for (ciControls it = m_children.begin();it != m_children.end(); ++it)
+  {
+    if ((*it)->GetControlType() == GUICONTROL_IMAGE || (*it)->GetControlType() == GUICONTROL_BORDEREDIMAGE)
+      images.push_back(*it);
+    else if ((*it)->IsGroup())
+      ((CGUIControlGroup *)(*it))->GetImages(images);
+  }
+}
+
 #ifdef _DEBUG
 void CGUIControlGroup::DumpTextureUse()
 {
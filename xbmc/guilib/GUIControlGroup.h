@@ -70,6 +70,7 @@ public:
   const CGUIControl *GetControl(int id) const;
   virtual CGUIControl *GetFirstFocusableControl(int id);
   void GetContainers(std::vector<CGUIControl *> &containers) const;
+  void GetImages(std::vector<const CGUIControl *> &images) const;
 
   virtual void AddControl(CGUIControl *control, int position = -1);
   bool InsertControl(CGUIControl *control, const CGUIControl *insertPoint);
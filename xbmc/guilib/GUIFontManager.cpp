@@ -25,6 +25,7 @@
 #include "GUIFontTTF.h"
 #include "GUIFont.h"
 #include "utils/XMLUtils.h"
+#include "threads/SingleLock.h"
 #include "GUIControlFactory.h"
 #include "filesystem/Directory.h"
 #include "filesystem/File.h"
@@ -33,17 +34,26 @@
 #include "utils/log.h"
 #include "utils/URIUtils.h"
 #include "utils/StringUtils.h"
+#include "utils/CharsetConverter.h"
 #include "windowing/WindowingFactory.h"
+#include "LocalizeStrings.h"
 #include "FileItem.h"
+#include "LangInfo.h"
 #include "URL.h"
 #include "Util.h"
 
+#include <algorithm>
+#include <set>
+
 using namespace std;
 
+#define MAX_WARMUP_CHARS 512 // characters rendered ahead of them being drawn, per font
+
 GUIFontManager::GUIFontManager(void)
 {
   m_fontsetUnicode=false;
   m_canReload = true;
+  m_glyphsRendered = false;
 }
 
 GUIFontManager::~GUIFontManager(void)
@@ -156,6 +166,7 @@ CGUIFont* GUIFontManager::LoadTTF(const CStdString& strFontName, const CStdStrin
   // font file is loaded, create our CGUIFont
   CGUIFont *pNewFont = new CGUIFont(strFontName, iStyle, textColor, shadowColor, lineSpacing, (float)iSize, pFontFile);
   m_vecFonts.push_back(pNewFont);
+  WarmUp(pFontFile, pNewFont->GetStyle());
 
   // Store the original TTF font info in case we need to reload it in a different resolution
   OrigFontInfo fontInfo;
@@ -237,6 +248,7 @@ void GUIFontManager::ReloadTTFFonts(void)
     }
 
     font->SetFont(pFontFile);
+    WarmUp(pFontFile, font->GetStyle());
   }
 }
 
@@ -337,6 +349,67 @@ void GUIFontManager::Clear()
   m_vecFontFiles.clear();
   m_vecFontInfo.clear();
   m_fontsetUnicode=false;
+  m_warmUpChars.clear();
+}
+
+namespace
+{
+bool MoreUsed(const std::pair<wchar_t, unsigned int> &a, const std::pair<wchar_t, unsigned int> &b)
+{
+  return a.second > b.second;
+}
+}
+
+void GUIFontManager::WarmUp(CGUIFontTTFBase *fontFile, uint32_t style)
+{
+  if (m_warmUpChars.empty())
+  {
+    set<wchar_t> chars;
+    // the printable ascii characters
+    for (wchar_t letter = 0x20; letter < 0x7f; letter++)
+      chars.insert(letter);
+
+    // the upper half of the code page of the language, which holds its alphabet
+    CStdString charset = g_langInfo.GetGuiCharSet();
+    for (int c = 0xa0; c <= 0xff; c++)
+    {
+      std::wstring letter;
+      if (g_charsetConverter.toW(std::string(1, (char)c), letter, charset) && letter.size() == 1)
+        chars.insert(letter[0]);
+    }
+    m_warmUpChars.assign(chars.begin(), chars.end());
+
+    // and the characters its strings use the most, for languages that need a double byte code page
+    map<wchar_t, unsigned int> counts;
+    g_localizeStrings.CountCharacters(counts);
+    vector< pair<wchar_t, unsigned int> > used(counts.begin(), counts.end());
+    sort(used.begin(), used.end(), MoreUsed);
+    for (vector< pair<wchar_t, unsigned int> >::const_iterator i = used.begin(); i != used.end() && m_warmUpChars.size() < MAX_WARMUP_CHARS; ++i)
+    {
+      if (chars.insert(i->first).second)
+        m_warmUpChars.push_back(i->first);
+    }
+  }
+
+  vecText text;
+  text.reserve(m_warmUpChars.size());
+  for (vector<wchar_t>::const_iterator i = m_warmUpChars.begin(); i != m_warmUpChars.end(); ++i)
+    text.push_back(((style & 3) << 24) | *i);
+  fontFile->WarmUp(text);
+}
+
+void GUIFontManager::MarkGlyphsRendered()
+{
+  CSingleLock lock(m_glyphsSection);
+  m_glyphsRendered = true;
+}
+
+bool GUIFontManager::TakeGlyphsRendered()
+{
+  CSingleLock lock(m_glyphsSection);
+  bool rendered = m_glyphsRendered;
+  m_glyphsRendered = false;
+  return rendered;
 }
 
 void GUIFontManager::LoadFonts(const CStdString& strFontSet)
@@ -30,6 +30,7 @@
 
 #include "GraphicContext.h"
 #include "IMsgTargetCallback.h"
+#include "threads/CriticalSection.h"
 #include "utils/GlobalsHandling.h"
 
 // Forward
@@ -80,6 +81,14 @@ public:
   bool IsFontSetUnicode(const CStdString& strFontSet);
   bool GetFirstFontSetUnicode(CStdString& strFontSet);
 
+  /*! \brief Note that glyphs were rendered in the background, called from the rasterizer jobs
+   Text drawn while they were pending has to be drawn again to show them.
+   */
+  void MarkGlyphsRendered();
+
+  /*! \brief Whether glyphs were rendered since the last call, called from the GUI thread */
+  bool TakeGlyphsRendered();
+
   static void SettingOptionsFontsFiller(const CSetting *setting, std::vector< std::pair<std::string, std::string> > &list, std::string &current);
 
 protected:
@@ -89,12 +98,21 @@ protected:
   CGUIFontTTFBase* GetFontFile(const CStdString& strFontFile);
   bool OpenFontFile(CXBMCTinyXML& xmlDoc);
 
+  /*! \brief Queue the characters of the current language to be rendered by a font file
+   \param fontFile the font file
+   \param style the style the font is drawn with
+   */
+  void WarmUp(CGUIFontTTFBase *fontFile, uint32_t style);
+
   std::vector<CGUIFont*> m_vecFonts;
   std::vector<CGUIFontTTFBase*> m_vecFontFiles;
   std::vector<OrigFontInfo> m_vecFontInfo;
   bool m_fontsetUnicode;
   RESOLUTION_INFO m_skinResolution;
   bool m_canReload;
+  std::vector<wchar_t> m_warmUpChars;  ///< characters of the current language, filled on first use
+  bool m_glyphsRendered;               ///< glyphs were rendered since the GUI last redrew
+  CCriticalSection m_glyphsSection;
 };
 
 /*!
@@ -23,12 +23,22 @@
 #include "GUIFontManager.h"
 #include "Texture.h"
 #include "GraphicContext.h"
+#include "filesystem/File.h"
 #include "filesystem/SpecialProtocol.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/Job.h"
+#include "utils/JobManager.h"
 #include "utils/MathUtils.h"
+#include "utils/StringUtils.h"
+#include "utils/TimeUtils.h"
+#include "utils/URIUtils.h"
 #include "utils/log.h"
 #include "windowing/WindowingFactory.h"
 
+#include <deque>
 #include <math.h>
+#include <boost/enable_shared_from_this.hpp>
 
 // stuff for freetype
 #include <ft2build.h>
@@ -48,6 +58,12 @@ using namespace std;
 
 #define CHARS_PER_TEXTURE_LINE 20 // number of characters to cache per texture line
 #define CHAR_CHUNK    64      // 64 chars allocated at a time (1024 bytes)
+#define LAYOUT_CACHE_SIZE 256 // number of laid out lines kept per font
+#define LAYOUT_CACHE_TIME 1000 // lines not drawn for this long (ms) are dropped when the cache is full
+#define GLYPH_CACHE_MAGIC   0x4c474258 // "XBGL"
+#define GLYPH_CACHE_VERSION 1
+#define GLYPH_CACHE_BYTES   (512 * 1024) // size of the pixels kept in the cache file of a font
+#define GLYPH_CACHE_WRITE_INTERVAL 300000 // ms between writes of the cache file while the font is used
 
 int CGUIFontTTFBase::justification_word_weight = 6;   // weight of word spacing over letter spacing when justifying.
                                                   // A larger number means more of the "dead space" is placed between
@@ -78,10 +94,19 @@ public:
       return NULL;
     }
 
+    return OpenFace(m_library, filename, size, aspect);
+  };
+
+  /*! \brief Load a font face on a library
+   A library and its faces must only be used by one thread at a time, the glyph
+   loader and rasterizer pools belong to the library.
+   */
+  static FT_Face OpenFace(FT_Library library, const CStdString &filename, float size, float aspect)
+  {
     FT_Face face;
 
     // ok, now load the font face
-    if (FT_New_Face( m_library, CSpecialProtocol::TranslatePath(filename).c_str(), 0, &face ))
+    if (FT_New_Face( library, CSpecialProtocol::TranslatePath(filename).c_str(), 0, &face ))
       return NULL;
 
     unsigned int ydpi = 72; // 72 points to the inch is the freetype default
@@ -131,6 +156,467 @@ private:
 XBMC_GLOBAL_REF(CFreeTypeLibrary, g_freeTypeLibrary); // our freetype library
 #define g_freeTypeLibrary XBMC_GLOBAL_USE(CFreeTypeLibrary)
 
+namespace
+{
+/* width of the border of bordered fonts, which also makes the cells higher */
+FT_Pos GetBorderStrength(FT_Face face)
+{
+  FT_Pos strength = FT_MulFix( face->units_per_EM, face->size->metrics.y_scale) / 12;
+  if (strength < 128)
+    strength = 128;
+  return strength;
+}
+
+bool Read(const char *&pos, const char *end, void *value, size_t size)
+{
+  if (size > (size_t)(end - pos))
+    return false;
+  memcpy(value, pos, size);
+  pos += size;
+  return true;
+}
+
+template<typename T>
+void Write(string &data, T value)
+{
+  data.append((const char *)&value, sizeof(value));
+}
+}
+
+/*!
+ \ingroup textures
+ \brief Renders the glyphs of a font on worker jobs
+
+ Has a FreeType library and face of its own, so rendering never waits on or
+ interferes with the font being drawn. Only one job works for a font at a
+ time, different fonts are rendered in parallel.
+
+ The glyphs it renders are kept, and stored in a cache file so that the next
+ run finds them ready. The file is written every few minutes while glyphs are
+ added and once more when the font is unloaded. It holds the glyphs that were
+ drawn before those that were only warmed up, up to GLYPH_CACHE_BYTES of
+ pixels.
+ */
+class CGUIFontRasterizer : public boost::enable_shared_from_this<CGUIFontRasterizer>
+{
+public:
+  typedef CGUIFontTTFBase::RenderedGlyph RenderedGlyph;
+
+  CGUIFontRasterizer(const CStdString &fontFile, float height, float aspect, bool border, const CStdString &cacheFile);
+  ~CGUIFontRasterizer();
+
+  /*! \brief Queue characters to be rendered, those that are rendered already are skipped
+   \param chars letters and styles, as stored in CGUIFontTTFBase::Character
+   */
+  void Queue(const vector<character_t> &chars);
+
+  /*! \brief Find a rendered character
+   \param ch letter and style of the character
+   \param glyph [out] the rendered character
+   \return true if the character is rendered
+   */
+  bool Find(character_t ch, RenderedGlyph &glyph);
+
+  /*! \brief Take the characters that are done out of a set of pending ones
+   Characters that couldn't be rendered are removed without a glyph.
+   \param pending [in/out] letters and styles of the pending characters
+   \param glyphs [out] the rendered characters
+   */
+  void TakeRendered(set<character_t> &pending, vector<RenderedGlyph> &glyphs);
+
+  /*! \brief Drop the queued characters when the font is unloaded
+   The cache file is written one last time if glyphs were added.
+   */
+  void Cancel();
+
+  /*! \brief Render the queued characters, called from the jobs */
+  void Process();
+
+private:
+  bool Open();
+  bool Render(character_t ch, RenderedGlyph &glyph);
+  void ReadCache();
+  void WriteCache();
+
+  CStdString m_fontFile;
+  float      m_height;
+  float      m_aspect;
+  bool       m_border;
+  CStdString m_cacheFile;
+
+  // only used by the job that is processing
+  FT_Library m_library;
+  FT_Face    m_face;
+  FT_Stroker m_stroker;
+  bool       m_opened;
+
+  map<character_t, RenderedGlyph> m_glyphs;  ///< rendered characters by letter and style
+  set<character_t>   m_used;                 ///< characters that were drawn, they go first in the cache file
+  set<character_t>   m_failed;               ///< characters that couldn't be rendered
+  deque<character_t> m_queue;
+  bool               m_processing;           ///< a job is queued or running
+  bool               m_cancelled;            ///< the font is unloaded
+  bool               m_changed;              ///< characters were rendered since the cache was written
+  unsigned int       m_lastWrite;            ///< time the cache file was last written
+  CCriticalSection   m_section;
+  CCriticalSection   m_cacheSection;
+};
+
+class CGUIFontRasterizeJob : public CJob
+{
+public:
+  CGUIFontRasterizeJob(const boost::shared_ptr<CGUIFontRasterizer> &rasterizer)
+    : m_rasterizer(rasterizer) {}
+
+  virtual const char *GetType() const { return "fontrasterize"; }
+  virtual bool DoWork()
+  {
+    m_rasterizer->Process();
+    return true;
+  }
+
+private:
+  boost::shared_ptr<CGUIFontRasterizer> m_rasterizer;
+};
+
+CGUIFontRasterizer::CGUIFontRasterizer(const CStdString &fontFile, float height, float aspect, bool border, const CStdString &cacheFile)
+  : m_fontFile(fontFile)
+  , m_height(height)
+  , m_aspect(aspect)
+  , m_border(border)
+  , m_cacheFile(cacheFile)
+  , m_library(NULL)
+  , m_face(NULL)
+  , m_stroker(NULL)
+  , m_opened(false)
+  , m_processing(false)
+  , m_cancelled(false)
+  , m_changed(false)
+  , m_lastWrite(XbmcThreads::SystemClockMillis())
+{
+}
+
+CGUIFontRasterizer::~CGUIFontRasterizer()
+{
+  if (m_face)
+    CFreeTypeLibrary::ReleaseFont(m_face);
+  if (m_stroker)
+    CFreeTypeLibrary::ReleaseStroker(m_stroker);
+  if (m_library)
+    FT_Done_FreeType(m_library);
+}
+
+void CGUIFontRasterizer::Queue(const vector<character_t> &chars)
+{
+  CSingleLock lock(m_section);
+  for (vector<character_t>::const_iterator i = chars.begin(); i != chars.end(); ++i)
+  {
+    if (m_glyphs.find(*i) == m_glyphs.end() && m_failed.find(*i) == m_failed.end())
+      m_queue.push_back(*i);
+  }
+  if (!m_queue.empty() && !m_processing)
+  { // text is waiting for these, so they go ahead of background work
+    m_processing = true;
+    CJobManager::GetInstance().AddJob(new CGUIFontRasterizeJob(shared_from_this()), NULL, CJob::PRIORITY_NORMAL);
+  }
+}
+
+bool CGUIFontRasterizer::Find(character_t ch, RenderedGlyph &glyph)
+{
+  CSingleLock lock(m_section);
+  map<character_t, RenderedGlyph>::const_iterator it = m_glyphs.find(ch);
+  if (it == m_glyphs.end())
+    return false;
+  glyph = it->second;
+  m_used.insert(ch);
+  return true;
+}
+
+void CGUIFontRasterizer::TakeRendered(set<character_t> &pending, vector<RenderedGlyph> &glyphs)
+{
+  CSingleLock lock(m_section);
+  for (set<character_t>::iterator i = pending.begin(); i != pending.end(); )
+  {
+    map<character_t, RenderedGlyph>::const_iterator it = m_glyphs.find(*i);
+    if (it != m_glyphs.end())
+    {
+      glyphs.push_back(it->second);
+      m_used.insert(*i);
+    }
+    else if (m_failed.find(*i) == m_failed.end())
+    {
+      ++i;
+      continue;
+    }
+    pending.erase(i++);
+  }
+}
+
+void CGUIFontRasterizer::Cancel()
+{
+  CSingleLock lock(m_section);
+  m_queue.clear();
+  m_cancelled = true;
+  if (m_changed && !m_processing)
+  { // a last job to write the cache file
+    m_processing = true;
+    CJobManager::GetInstance().AddJob(new CGUIFontRasterizeJob(shared_from_this()), NULL, CJob::PRIORITY_LOW);
+  }
+}
+
+void CGUIFontRasterizer::Process()
+{
+  if (!m_opened)
+  {
+    m_opened = true;
+    Open();
+    ReadCache();
+  }
+
+  bool renderedAny = false;
+  while (true)
+  {
+    character_t ch;
+    {
+      CSingleLock lock(m_section);
+      while (!m_queue.empty() &&
+             (m_glyphs.find(m_queue.front()) != m_glyphs.end() || m_failed.find(m_queue.front()) != m_failed.end()))
+        m_queue.pop_front();
+      if (m_queue.empty())
+      {
+        m_processing = false;
+        renderedAny &= !m_cancelled;
+        break;
+      }
+      ch = m_queue.front();
+      m_queue.pop_front();
+    }
+
+    RenderedGlyph glyph;
+    bool rendered = m_face && Render(ch, glyph);
+
+    CSingleLock lock(m_section);
+    if (rendered)
+    {
+      m_glyphs[ch] = glyph;
+      m_changed = true;
+      renderedAny = true;
+    }
+    else
+      m_failed.insert(ch);
+  }
+
+  // labels that don't change aren't drawn again by themselves, so have the GUI pick up the batch
+  if (renderedAny)
+    g_fontManager.MarkGlyphsRendered();
+
+  WriteCache();
+}
+
+bool CGUIFontRasterizer::Open()
+{
+  // FreeType 2.4 keeps the glyph loader and rasterizer state in the library, so the
+  // library of the fonts drawn on the render thread can't be shared
+  if (FT_Init_FreeType(&m_library))
+  {
+    m_library = NULL;
+    CLog::Log(LOGERROR, "%s - unable to initialize freetype library", __FUNCTION__);
+    return false;
+  }
+  m_face = CFreeTypeLibrary::OpenFace(m_library, m_fontFile, m_height, m_aspect);
+  if (!m_face)
+  {
+    CLog::Log(LOGERROR, "%s - unable to load %s", __FUNCTION__, m_fontFile.c_str());
+    return false;
+  }
+  if (m_border)
+  {
+    if (FT_Stroker_New(m_library, &m_stroker))
+      m_stroker = NULL;
+    if (m_stroker)
+      FT_Stroker_Set(m_stroker, GetBorderStrength(m_face), FT_STROKER_LINECAP_ROUND, FT_STROKER_LINEJOIN_ROUND, 0);
+  }
+  return true;
+}
+
+bool CGUIFontRasterizer::Render(character_t ch, RenderedGlyph &glyph)
+{
+  wchar_t letter = (wchar_t)(ch & 0xffff);
+  uint32_t style = ch >> 16;
+
+  int glyph_index = FT_Get_Char_Index( m_face, letter );
+  if (FT_Load_Glyph( m_face, glyph_index, FT_LOAD_TARGET_LIGHT ))
+  {
+    CLog::Log(LOGDEBUG, "%s Failed to load glyph %x", __FUNCTION__, letter);
+    return false;
+  }
+  // make bold if applicable
+  if (style & FONT_STYLE_BOLD)
+    CGUIFontTTFBase::EmboldenGlyph(m_face->glyph);
+  // and italics if applicable
+  if (style & FONT_STYLE_ITALICS)
+    CGUIFontTTFBase::ObliqueGlyph(m_face->glyph);
+  // grab the glyph
+  FT_Glyph ftGlyph = NULL;
+  if (FT_Get_Glyph(m_face->glyph, &ftGlyph))
+  {
+    CLog::Log(LOGDEBUG, "%s Failed to get glyph %x", __FUNCTION__, letter);
+    return false;
+  }
+  if (m_stroker)
+    FT_Glyph_StrokeBorder(&ftGlyph, m_stroker, 0, 1);
+  // render the glyph
+  if (FT_Glyph_To_Bitmap(&ftGlyph, FT_RENDER_MODE_NORMAL, NULL, 1))
+  {
+    CLog::Log(LOGDEBUG, "%s Failed to render glyph %x to a bitmap", __FUNCTION__, letter);
+    FT_Done_Glyph(ftGlyph);
+    return false;
+  }
+  FT_BitmapGlyph bitGlyph = (FT_BitmapGlyph)ftGlyph;
+  const FT_Bitmap &bitmap = bitGlyph->bitmap;
+
+  glyph.letterAndStyle = ch;
+  glyph.left    = bitGlyph->left;
+  glyph.top     = bitGlyph->top;
+  glyph.advance = (float)MathUtils::round_int( (float)m_face->glyph->advance.x / 64 );
+  glyph.width   = bitmap.width;
+  glyph.rows    = bitmap.rows;
+  glyph.pixels.resize(glyph.width * glyph.rows);
+  for (unsigned int y = 0; y < glyph.rows; y++)
+    memcpy(&glyph.pixels[y * glyph.width], bitmap.buffer + y * bitmap.pitch, glyph.width);
+
+  FT_Done_Glyph(ftGlyph);
+  return true;
+}
+
+void CGUIFontRasterizer::ReadCache()
+{
+  struct __stat64 st;
+  XFILE::CFile file;
+  XFILE::auto_buffer buffer;
+  if (m_cacheFile.empty() || XFILE::CFile::Stat(m_fontFile, &st) != 0 ||
+      !XFILE::CFile::Exists(m_cacheFile) || !file.LoadFile(m_cacheFile, buffer))
+    return;
+
+  const char *pos = buffer.get();
+  const char *end = pos + buffer.length();
+  uint32_t magic, version, count;
+  int64_t size, mtime;
+  if (!Read(pos, end, &magic, sizeof(magic)) || magic != GLYPH_CACHE_MAGIC ||
+      !Read(pos, end, &version, sizeof(version)) || version != GLYPH_CACHE_VERSION ||
+      !Read(pos, end, &size, sizeof(size)) || size != (int64_t)st.st_size ||
+      !Read(pos, end, &mtime, sizeof(mtime)) || mtime != (int64_t)st.st_mtime ||
+      !Read(pos, end, &count, sizeof(count)))
+  { // an older version or another font file, it is written again
+    CLog::Log(LOGDEBUG, "%s - ignoring outdated cache %s", __FUNCTION__, m_cacheFile.c_str());
+    return;
+  }
+
+  map<character_t, RenderedGlyph> glyphs;
+  for (uint32_t i = 0; i < count; i++)
+  {
+    RenderedGlyph glyph;
+    if (!Read(pos, end, &glyph.letterAndStyle, sizeof(glyph.letterAndStyle)) ||
+        !Read(pos, end, &glyph.left, sizeof(glyph.left)) ||
+        !Read(pos, end, &glyph.top, sizeof(glyph.top)) ||
+        !Read(pos, end, &glyph.advance, sizeof(glyph.advance)) ||
+        !Read(pos, end, &glyph.width, sizeof(glyph.width)) ||
+        !Read(pos, end, &glyph.rows, sizeof(glyph.rows)) ||
+        (glyph.width && glyph.rows > (size_t)(end - pos) / glyph.width))
+    {
+      CLog::Log(LOGDEBUG, "%s - ignoring truncated cache %s", __FUNCTION__, m_cacheFile.c_str());
+      return;
+    }
+    glyph.pixels.assign(pos, pos + glyph.width * glyph.rows);
+    pos += glyph.width * glyph.rows;
+    glyphs[glyph.letterAndStyle] = glyph;
+  }
+
+  CSingleLock lock(m_section);
+  glyphs.insert(m_glyphs.begin(), m_glyphs.end());
+  m_glyphs.swap(glyphs);
+  CLog::Log(LOGDEBUG, "%s - read %u glyphs from %s", __FUNCTION__, count, m_cacheFile.c_str());
+}
+
+void CGUIFontRasterizer::WriteCache()
+{
+  // jobs of the same font can finish at the same time
+  CSingleLock cacheLock(m_cacheSection);
+
+  struct __stat64 st;
+  if (m_cacheFile.empty() || XFILE::CFile::Stat(m_fontFile, &st) != 0)
+    return;
+
+  string data;
+  unsigned int count = 0;
+  {
+    CSingleLock lock(m_section);
+    // spare the storage, flash in particular, from a write for every new character
+    unsigned int now = XbmcThreads::SystemClockMillis();
+    if (!m_changed || (!m_cancelled && now - m_lastWrite < GLYPH_CACHE_WRITE_INTERVAL))
+      return;
+    m_changed = false;
+    m_lastWrite = now;
+
+    // the glyphs that were drawn, then those that were only warmed up
+    vector<const RenderedGlyph*> glyphs;
+    for (map<character_t, RenderedGlyph>::const_iterator i = m_glyphs.begin(); i != m_glyphs.end(); ++i)
+    {
+      if (m_used.find(i->first) != m_used.end())
+        glyphs.push_back(&i->second);
+    }
+    for (map<character_t, RenderedGlyph>::const_iterator i = m_glyphs.begin(); i != m_glyphs.end(); ++i)
+    {
+      if (m_used.find(i->first) == m_used.end())
+        glyphs.push_back(&i->second);
+    }
+
+    string entries;
+    size_t bytes = 0;
+    for (vector<const RenderedGlyph*>::const_iterator i = glyphs.begin(); i != glyphs.end(); ++i)
+    {
+      const RenderedGlyph &glyph = **i;
+      bytes += glyph.pixels.size();
+      if (bytes > GLYPH_CACHE_BYTES)
+        break;
+      Write<uint32_t>(entries, glyph.letterAndStyle);
+      Write<int32_t>(entries, glyph.left);
+      Write<int32_t>(entries, glyph.top);
+      Write<float>(entries, glyph.advance);
+      Write<uint32_t>(entries, glyph.width);
+      Write<uint32_t>(entries, glyph.rows);
+      if (!glyph.pixels.empty())
+        entries.append((const char *)&glyph.pixels[0], glyph.pixels.size());
+      count++;
+    }
+
+    Write<uint32_t>(data, GLYPH_CACHE_MAGIC);
+    Write<uint32_t>(data, GLYPH_CACHE_VERSION);
+    Write<int64_t>(data, st.st_size);
+    Write<int64_t>(data, st.st_mtime);
+    Write<uint32_t>(data, count);
+    data += entries;
+  }
+
+  // write next to it and swap, a font loading at the same time never sees half of it
+  CStdString tempFile = m_cacheFile + ".tmp";
+  XFILE::CFile file;
+  if (!file.OpenForWrite(tempFile, true) || file.Write(data.c_str(), data.size()) != (int)data.size())
+  {
+    CLog::Log(LOGERROR, "%s - unable to write %s", __FUNCTION__, tempFile.c_str());
+    file.Close();
+    XFILE::CFile::Delete(tempFile);
+    return;
+  }
+  file.Close();
+
+  XFILE::CFile::Delete(m_cacheFile);
+  if (!XFILE::CFile::Rename(tempFile, m_cacheFile))
+    CLog::Log(LOGERROR, "%s - unable to write %s", __FUNCTION__, m_cacheFile.c_str());
+  else
+    CLog::Log(LOGDEBUG, "%s - wrote %u glyphs to %s", __FUNCTION__, count, m_cacheFile.c_str());
+}
+
 CGUIFontTTFBase::CGUIFontTTFBase(const CStdString& strFileName)
 {
   m_texture = NULL;
@@ -157,6 +643,7 @@ CGUIFontTTFBase::CGUIFontTTFBase(const CStdString& strFileName)
   m_color = 0;
   m_vertex_count = 0;
   m_nTexture = 0;
+  m_charCacheGeneration = 0;
 }
 
 CGUIFontTTFBase::~CGUIFontTTFBase(void)
@@ -194,6 +681,16 @@ void CGUIFontTTFBase::ClearCharacterCache()
   m_posX = m_textureWidth;
   m_posY = -(int)GetTextureLineHeight();
   m_textureHeight = 0;
+  m_pendingChars.clear();
+
+  // the laid out lines have copies of the characters
+  m_charCacheGeneration++;
+  ClearLayoutCache();
+}
+
+void CGUIFontTTFBase::ClearLayoutCache()
+{
+  m_layouts.clear();
 }
 
 void CGUIFontTTFBase::Clear()
@@ -216,9 +713,18 @@ void CGUIFontTTFBase::Clear()
     g_freeTypeLibrary.ReleaseStroker(m_stroker);
   m_stroker = NULL;
 
+  // a job still rendering keeps the rasterizer until it is done
+  if (m_rasterizer)
+    m_rasterizer->Cancel();
+  m_rasterizer.reset();
+  m_pendingChars.clear();
+
   free(m_vertex);
   m_vertex = NULL;
   m_vertex_count = 0;
+
+  m_charCacheGeneration++;
+  ClearLayoutCache();
 }
 
 bool CGUIFontTTFBase::Load(const CStdString& strFilename, float height, float aspect, float lineSpacing, bool border)
@@ -257,9 +763,7 @@ bool CGUIFontTTFBase::Load(const CStdString& strFilename, float height, float as
      add on the strength of any border - the non-bordered font needs
      aligning with the bordered font by utilising GetTextBaseLine()
      */
-    FT_Pos strength = FT_MulFix( m_face->units_per_EM, m_face->size->metrics.y_scale) / 12;
-    if (strength < 128)
-      strength = 128;
+    FT_Pos strength = GetBorderStrength(m_face);
 
     cellDescender -= strength;
     cellAscender  += strength;
@@ -302,6 +806,12 @@ bool CGUIFontTTFBase::Load(const CStdString& strFilename, float height, float as
   m_posX = m_textureWidth;
   m_posY = -(int)GetTextureLineHeight();
 
+  // the glyphs are rendered on jobs, and kept per font file, size and border for the next run
+  CStdString cacheFile = StringUtils::Format("special://temp/glyphs-%s-%.2f-%.2f%s.bin",
+                                             URIUtils::GetFileName(strFilename).c_str(), height, aspect, border ? "-border" : "");
+  m_rasterizer.reset(new CGUIFontRasterizer(strFilename, height, aspect, border, cacheFile));
+  m_pendingChars.clear();
+
   // cache the ellipses width
   Character *ellipse = GetCharacter(L'.');
   if (ellipse) m_ellipsesWidth = ellipse->advance;
@@ -309,14 +819,152 @@ bool CGUIFontTTFBase::Load(const CStdString& strFilename, float height, float as
   return true;
 }
 
+CGUIFontTTFBase::VertexRun::VertexRun()
+  : clipped(false)
+  , originX(0), originY(0)
+  , maxPixelWidth(0)
+  , scaleX(0), scaleY(0)
+  , textureScaleX(0), textureScaleY(0)
+  , scrolling(false)
+  , limitedColor(false)
+{
+}
+
+CGUIFontTTFBase::RenderedGlyph::RenderedGlyph()
+  : letterAndStyle(0)
+  , left(0), top(0)
+  , advance(0)
+  , width(0), rows(0)
+{
+}
+
+CGUIFontTTFBase::Layout::Layout()
+  : alignment(0)
+  , maxPixelWidth(0)
+  , startX(0), startY(0)
+  , truncated(false)
+  , lastUsed(0)
+  , nextRun(0)
+{
+}
+
 void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors, const vecText &text, uint32_t alignment, float maxPixelWidth, bool scrolling)
 {
+  UpdatePendingCharacters();
+
   Begin();
 
   // save the origin, which is scaled separately
   m_originX = x;
   m_originY = y;
 
+  Layout &layout = GetLayout(text, alignment, maxPixelWidth);
+
+  // static text is drawn the same way each frame
+  for (unsigned int i = 0; i < sizeof(layout.runs) / sizeof(layout.runs[0]); i++)
+  {
+    const VertexRun &run = layout.runs[i];
+    if (IsSameRun(run, colors, maxPixelWidth, scrolling))
+    {
+      if (!run.vertices.empty())
+        AddVertices(&run.vertices[0], run.vertices.size());
+      End();
+      return;
+    }
+  }
+
+  int start = m_vertex_count;
+  for (vector<Glyph>::const_iterator glyph = layout.glyphs.begin(); glyph != layout.glyphs.end(); ++glyph)
+  {
+    if (!layout.truncated && maxPixelWidth > 0 && glyph->x > maxPixelWidth)
+      break;  // exceeded max allowed width - stop rendering
+
+    color_t color = 0;
+    if (glyph->color < colors.size())
+      color = colors[glyph->color];
+    else if (!colors.empty())
+      color = colors[0];
+    RenderCharacter(layout.startX + glyph->x, layout.startY, &glyph->ch, color, !scrolling);
+  }
+
+  if (m_vertex)
+  {
+    SaveRun(layout.runs[layout.nextRun], start, colors, maxPixelWidth, scrolling);
+    layout.nextRun = (layout.nextRun + 1) % (sizeof(layout.runs) / sizeof(layout.runs[0]));
+  }
+
+  End();
+}
+
+CGUIFontTTFBase::Layout &CGUIFontTTFBase::GetLayout(const vecText &text, uint32_t alignment, float maxPixelWidth)
+{
+  // the width changes the layout of truncated and justified text only, others are cut off when drawn
+  if (!(alignment & (XBFONT_TRUNCATED | XBFONT_JUSTIFIED)))
+    maxPixelWidth = 0;
+
+  // FNV-1a
+  uint32_t width;
+  memcpy(&width, &maxPixelWidth, sizeof(width));
+  uint32_t hash = 2166136261U;
+  hash = (hash ^ alignment) * 16777619U;
+  hash = (hash ^ width) * 16777619U;
+  for (vecText::const_iterator i = text.begin(); i != text.end(); ++i)
+    hash = (hash ^ *i) * 16777619U;
+
+  unsigned int frameTime = CTimeUtils::GetFrameTime();
+  map<uint32_t, Layout>::iterator it = m_layouts.find(hash);
+  if (it != m_layouts.end() && it->second.alignment == alignment &&
+      it->second.maxPixelWidth == maxPixelWidth && it->second.text == text)
+  {
+    it->second.lastUsed = frameTime;
+    return it->second;
+  }
+
+  Layout layout;
+  layout.text          = text;
+  layout.alignment     = alignment;
+  layout.maxPixelWidth = maxPixelWidth;
+  layout.lastUsed      = frameTime;
+
+  // characters that are new to the cache might have it cleared and filled again
+  unsigned int generation = m_charCacheGeneration;
+  LayoutText(layout);
+  if (generation != m_charCacheGeneration)
+  {
+    generation = m_charCacheGeneration;
+    layout.glyphs.clear();
+    LayoutText(layout);
+    if (generation != m_charCacheGeneration)
+    { // the cache is too small for this text, don't keep it
+      m_uncachedLayout = layout;
+      return m_uncachedLayout;
+    }
+  }
+
+  if (m_layouts.size() >= LAYOUT_CACHE_SIZE && m_layouts.find(hash) == m_layouts.end())
+  { // drop the lines that are no longer drawn, or everything if they all are
+    for (map<uint32_t, Layout>::iterator i = m_layouts.begin(); i != m_layouts.end(); )
+    {
+      if (frameTime - i->second.lastUsed > LAYOUT_CACHE_TIME)
+        m_layouts.erase(i++);
+      else
+        ++i;
+    }
+    if (m_layouts.size() >= LAYOUT_CACHE_SIZE)
+      ClearLayoutCache();
+  }
+
+  Layout &cached = m_layouts[hash];
+  cached = layout;
+  return cached;
+}
+
+void CGUIFontTTFBase::LayoutText(Layout &layout)
+{
+  const vecText &text = layout.text;
+  uint32_t alignment = layout.alignment;
+  float maxPixelWidth = layout.maxPixelWidth;
+
   // Check if we will really need to truncate or justify the text
   if ( alignment & XBFONT_TRUNCATED )
   {
@@ -328,10 +976,11 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors
     if ( maxPixelWidth <= 0.0f )
       alignment &= ~XBFONT_JUSTIFIED;
   }
+  layout.truncated = (alignment & XBFONT_TRUNCATED) != 0;
 
   // calculate sizing information
-  float startX = 0;
-  float startY = (alignment & XBFONT_CENTER_Y) ? -0.5f*m_cellHeight : 0;  // vertical centering
+  layout.startX = 0;
+  layout.startY = (alignment & XBFONT_CENTER_Y) ? -0.5f*m_cellHeight : 0;  // vertical centering
 
   if ( alignment & (XBFONT_RIGHT | XBFONT_CENTER_X) )
   {
@@ -344,7 +993,7 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors
     if ( alignment & XBFONT_CENTER_X)
       w *= 0.5f;
     // Offset this line's starting position
-    startX -= w;
+    layout.startX -= w;
   }
 
   float spacePerLetter = 0; // for justification effects
@@ -367,14 +1016,11 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors
   }
   float cursorX = 0; // current position along the line
 
+  layout.glyphs.reserve(text.size());
   for (vecText::const_iterator pos = text.begin(); pos != text.end(); ++pos)
   {
-    // If starting text on a new line, determine justification effects
-    // Get the current letter in the CStdString
-    color_t color = (*pos & 0xff0000) >> 16;
-    if (color >= colors.size())
-      color = 0;
-    color = colors[color];
+    Glyph glyph;
+    glyph.color = (*pos & 0xff0000) >> 16;
 
     // grab the next character
     Character *ch = GetCharacter(*pos);
@@ -391,18 +1037,20 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors
         if (!period)
           break;
 
+        glyph.ch = *period;
         for (int i = 0; i < 3; i++)
         {
-          RenderCharacter(startX + cursorX, startY, period, color, !scrolling);
+          glyph.x = cursorX;
+          layout.glyphs.push_back(glyph);
           cursorX += period->advance;
         }
         break;
       }
     }
-    else if (maxPixelWidth > 0 && cursorX > maxPixelWidth)
-      break;  // exceeded max allowed width - stop rendering
 
-    RenderCharacter(startX + cursorX, startY, ch, color, !scrolling);
+    glyph.ch = *ch;
+    glyph.x  = cursorX;
+    layout.glyphs.push_back(glyph);
     if ( alignment & XBFONT_JUSTIFIED )
     {
       if ((*pos & 0xffff) == L' ')
@@ -413,8 +1061,59 @@ void CGUIFontTTFBase::DrawTextInternal(float x, float y, const vecColors &colors
     else
       cursorX += ch->advance;
   }
+}
 
-  End();
+bool CGUIFontTTFBase::IsSameRun(const VertexRun &run, const vecColors &colors, float maxPixelWidth, bool scrolling) const
+{
+  if (run.originX != m_originX || run.originY != m_originY ||
+      run.maxPixelWidth != maxPixelWidth || run.scrolling != scrolling ||
+      run.textureScaleX != m_textureScaleX || run.textureScaleY != m_textureScaleY ||
+      run.scaleX != g_graphicsContext.GetGUIScaleX() || run.scaleY != g_graphicsContext.GetGUIScaleY() ||
+      run.limitedColor != g_Windowing.UseLimitedColor() ||
+      run.colors != colors || run.matrix != g_graphicsContext.GetFinalTransform())
+    return false;
+
+  CRect clipRegion;
+  bool clipped = g_graphicsContext.GetClipRegion(clipRegion);
+  return clipped == run.clipped && (!clipped || !(clipRegion != run.clipRegion));
+}
+
+void CGUIFontTTFBase::SaveRun(VertexRun &run, int start, const vecColors &colors, float maxPixelWidth, bool scrolling) const
+{
+  run.vertices.assign(m_vertex + start, m_vertex + m_vertex_count);
+  run.colors        = colors;
+  run.matrix        = g_graphicsContext.GetFinalTransform();
+  run.clipped       = g_graphicsContext.GetClipRegion(run.clipRegion);
+  run.originX       = m_originX;
+  run.originY       = m_originY;
+  run.maxPixelWidth = maxPixelWidth;
+  run.scaleX        = g_graphicsContext.GetGUIScaleX();
+  run.scaleY        = g_graphicsContext.GetGUIScaleY();
+  run.textureScaleX = m_textureScaleX;
+  run.textureScaleY = m_textureScaleY;
+  run.scrolling     = scrolling;
+  run.limitedColor  = g_Windowing.UseLimitedColor();
+}
+
+bool CGUIFontTTFBase::AddVertices(const SVertex *vertices, int count)
+{
+  // grow the vertex buffer if required
+  while (m_vertex_count + count > m_vertex_size)
+  {
+    m_vertex_size *= 2;
+    void* old      = m_vertex;
+    m_vertex       = (SVertex*)realloc(m_vertex, m_vertex_size * sizeof(SVertex));
+    if (!m_vertex)
+    {
+      free(old);
+      CLog::Log(LOGSEVERE, "%s: can't allocate %"PRIdS" bytes for texture", __FUNCTION__ , m_vertex_size * sizeof(SVertex));
+      return false;
+    }
+  }
+
+  memcpy(m_vertex + m_vertex_count, vertices, count * sizeof(SVertex));
+  m_vertex_count += count;
+  return true;
 }
 
 // this routine assumes a single line (i.e. it was called from GUITextLayout)
@@ -553,9 +1252,20 @@ CGUIFontTTFBase::Character* CGUIFontTTFBase::GetCharacter(character_t chr)
 
 bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *ch)
 {
-  int glyph_index = FT_Get_Char_Index( m_face, letter );
+  character_t letterAndStyle = (style << 16) | letter;
+
+  // warmed up or read from the cache
+  RenderedGlyph glyph;
+  if (m_rasterizer && m_rasterizer->Find(letterAndStyle, glyph))
+  {
+    if (!PlaceCharacter(glyph, ch))
+      return false;
+    m_numChars++;
+    return true;
+  }
 
-  FT_Glyph glyph = NULL;
+  // only the advance is needed to lay out the text, the glyph is drawn once it is rendered
+  int glyph_index = FT_Get_Char_Index( m_face, letter );
   if (FT_Load_Glyph( m_face, glyph_index, FT_LOAD_TARGET_LIGHT ))
   {
     CLog::Log(LOGDEBUG, "%s Failed to load glyph %x", __FUNCTION__, letter);
@@ -564,39 +1274,37 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
   // make bold if applicable
   if (style & FONT_STYLE_BOLD)
     EmboldenGlyph(m_face->glyph);
-  // and italics if applicable
-  if (style & FONT_STYLE_ITALICS)
-    ObliqueGlyph(m_face->glyph);
-  // grab the glyph
-  if (FT_Get_Glyph(m_face->glyph, &glyph))
-  {
-    CLog::Log(LOGDEBUG, "%s Failed to get glyph %x", __FUNCTION__, letter);
-    return false;
-  }
-  if (m_stroker)
-    FT_Glyph_StrokeBorder(&glyph, m_stroker, 0, 1);
-  // render the glyph
-  if (FT_Glyph_To_Bitmap(&glyph, FT_RENDER_MODE_NORMAL, NULL, 1))
+
+  ch->letterAndStyle = letterAndStyle;
+  ch->offsetX = ch->offsetY = 0;
+  ch->left = ch->top = ch->right = ch->bottom = 0;
+  ch->advance = (float)MathUtils::round_int( (float)m_face->glyph->advance.x / 64 );
+  m_numChars++;
+
+  if (m_rasterizer)
   {
-    CLog::Log(LOGDEBUG, "%s Failed to render glyph %x to a bitmap", __FUNCTION__, letter);
-    return false;
+    m_pendingChars.insert(letterAndStyle);
+    m_rasterizer->Queue(vector<character_t>(1, letterAndStyle));
   }
-  FT_BitmapGlyph bitGlyph = (FT_BitmapGlyph)glyph;
-  FT_Bitmap bitmap = bitGlyph->bitmap;
-  bool isEmptyGlyph = (bitmap.width == 0 || bitmap.rows == 0);
+  return true;
+}
+
+bool CGUIFontTTFBase::PlaceCharacter(const RenderedGlyph &glyph, Character *ch)
+{
+  bool isEmptyGlyph = (glyph.width == 0 || glyph.rows == 0);
 
   if (!isEmptyGlyph)
   {
-    if (bitGlyph->left < 0)
-      m_posX += -bitGlyph->left;
+    if (glyph.left < 0)
+      m_posX += -glyph.left;
 
     // check we have enough room for the character
-    if (m_posX + bitGlyph->left + bitmap.width > (int)m_textureWidth)
+    if (m_posX + glyph.left + glyph.width > (int)m_textureWidth)
     { // no space - gotta drop to the next line (which means creating a new texture and copying it across)
       m_posX = 0;
       m_posY += GetTextureLineHeight();
-      if (bitGlyph->left < 0)
-        m_posX += -bitGlyph->left;
+      if (glyph.left < 0)
+        m_posX += -glyph.left;
 
       if(m_posY + GetTextureLineHeight() >= m_textureHeight)
       {
@@ -606,7 +1314,6 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
         if (newHeight > g_Windowing.GetMaxTextureSize())
         {
           CLog::Log(LOGDEBUG, "%s: New cache texture is too large (%u > %u pixels long)", __FUNCTION__, newHeight, g_Windowing.GetMaxTextureSize());
-          FT_Done_Glyph(glyph);
           return false;
         }
 
@@ -614,7 +1321,6 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
         newTexture = ReallocTexture(newHeight);
         if(newTexture == NULL)
         {
-          FT_Done_Glyph(glyph);
           CLog::Log(LOGDEBUG, "%s: Failed to allocate new texture of height %u", __FUNCTION__, newHeight);
           return false;
         }
@@ -624,20 +1330,19 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
 
     if(m_texture == NULL)
     {
-      FT_Done_Glyph(glyph);
       CLog::Log(LOGDEBUG, "%s: no texture to cache character to", __FUNCTION__);
       return false;
     }
   }
   // set the character in our table
-  ch->letterAndStyle = (style << 16) | letter;
-  ch->offsetX = (short)bitGlyph->left;
-  ch->offsetY = (short)m_cellBaseLine - bitGlyph->top;
+  ch->letterAndStyle = glyph.letterAndStyle;
+  ch->offsetX = (short)glyph.left;
+  ch->offsetY = (short)m_cellBaseLine - glyph.top;
   ch->left = isEmptyGlyph ? 0 : ((float)m_posX + ch->offsetX);
   ch->top = isEmptyGlyph ? 0 : ((float)m_posY + ch->offsetY);
-  ch->right = ch->left + bitmap.width;
-  ch->bottom = ch->top + bitmap.rows;
-  ch->advance = (float)MathUtils::round_int( (float)m_face->glyph->advance.x / 64 );
+  ch->right = ch->left + glyph.width;
+  ch->bottom = ch->top + glyph.rows;
+  ch->advance = glyph.advance;
 
   // we need only render if we actually have some pixels
   if (!isEmptyGlyph)
@@ -645,20 +1350,76 @@ bool CGUIFontTTFBase::CacheCharacter(wchar_t letter, uint32_t style, Character *
     // ensure our rect will stay inside the texture (it *should* but we need to be certain)
     unsigned int x1 = max(m_posX + ch->offsetX, 0);
     unsigned int y1 = max(m_posY + ch->offsetY, 0);
-    unsigned int x2 = min(x1 + bitmap.width, m_textureWidth);
-    unsigned int y2 = min(y1 + bitmap.rows, m_textureHeight);
-    CopyCharToTexture(bitGlyph, x1, y1, x2, y2);
+    unsigned int x2 = min(x1 + glyph.width, m_textureWidth);
+    unsigned int y2 = min(y1 + glyph.rows, m_textureHeight);
+    CopyCharToTexture(&glyph.pixels[0], glyph.width, x1, y1, x2, y2);
   
     m_posX += spacing_between_characters_in_texture + (unsigned short)max(ch->right - ch->left + ch->offsetX, ch->advance);
   }
-  m_numChars++;
-
-  // free the glyph
-  FT_Done_Glyph(glyph);
 
   return true;
 }
 
+void CGUIFontTTFBase::UpdatePendingCharacters()
+{
+  if (m_pendingChars.empty() || !m_rasterizer)
+    return;
+
+  vector<RenderedGlyph> glyphs;
+  m_rasterizer->TakeRendered(m_pendingChars, glyphs);
+  if (glyphs.empty())
+    return;
+
+  // must End() as we can't render text to our texture during a Begin(), End() block
+  unsigned int nestedBeginCount = m_nestedBeginCount;
+  m_nestedBeginCount = 1;
+  if (nestedBeginCount) End();
+
+  for (vector<RenderedGlyph>::const_iterator glyph = glyphs.begin(); glyph != glyphs.end(); ++glyph)
+  {
+    Character *ch = NULL;
+    int low = 0;
+    int high = m_numChars - 1;
+    while (low <= high && !ch)
+    {
+      int mid = (low + high) >> 1;
+      if (glyph->letterAndStyle > m_char[mid].letterAndStyle)
+        low = mid + 1;
+      else if (glyph->letterAndStyle < m_char[mid].letterAndStyle)
+        high = mid - 1;
+      else
+        ch = &m_char[mid];
+    }
+    if (ch && !PlaceCharacter(*glyph, ch))
+    { // the texture is full - start over, the characters are placed again as they are drawn
+      CLog::Log(LOGDEBUG, "%s: Unable to cache character.  Clearing character cache of %i characters", __FUNCTION__, m_numChars);
+      ClearCharacterCache();
+      break;
+    }
+  }
+
+  if (nestedBeginCount) Begin();
+  m_nestedBeginCount = nestedBeginCount;
+
+  // the laid out lines have copies of the characters
+  ClearLayoutCache();
+}
+
+void CGUIFontTTFBase::WarmUp(const vecText &text)
+{
+  if (!m_rasterizer)
+    return;
+
+  vector<character_t> chars;
+  chars.reserve(text.size());
+  for (vecText::const_iterator i = text.begin(); i != text.end(); ++i)
+  {
+    character_t style = (*i & 0x3000000) >> 24;
+    chars.push_back((style << 16) | (*i & 0xffff));
+  }
+  m_rasterizer->Queue(chars);
+}
+
 void CGUIFontTTFBase::RenderCharacter(float posX, float posY, const Character *ch, color_t color, bool roundX)
 {
   // actual image width isn't same as the character width as that is
@@ -841,8 +1602,8 @@ void CGUIFontTTFBase::EmboldenGlyph(FT_GlyphSlot slot)
     return;
 
   /* some reasonable strength */
-  FT_Pos strength = FT_MulFix( m_face->units_per_EM,
-                    m_face->size->metrics.y_scale ) / 24;
+  FT_Pos strength = FT_MulFix( slot->face->units_per_EM,
+                    slot->face->size->metrics.y_scale ) / 24;
 
   FT_BBox bbox_before, bbox_after;
   FT_Outline_Get_CBox( &slot->outline, &bbox_before );
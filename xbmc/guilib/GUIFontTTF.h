@@ -27,8 +27,16 @@
  *
  */
 
+#include <map>
+#include <set>
+#include <boost/shared_ptr.hpp>
+
+#include "Geometry.h"
+#include "TransformMatrix.h"
+
 // forward definition
 class CBaseTexture;
+class CGUIFontRasterizer;
 
 struct FT_FaceRec_;
 struct FT_LibraryRec_;
@@ -67,6 +75,7 @@ struct SVertex
 class CGUIFontTTFBase
 {
   friend class CGUIFont;
+  friend class CGUIFontRasterizer;
 
 public:
 
@@ -77,6 +86,12 @@ public:
 
   bool Load(const CStdString& strFilename, float height = 20.0f, float aspect = 1.0f, float lineSpacing = 1.0f, bool border = false);
 
+  /*! \brief Render characters ahead of them being drawn
+   They are rendered in the background and kept until they are first drawn.
+   \param text the characters, styles included
+   */
+  void WarmUp(const vecText &text);
+
   virtual void Begin() = 0;
   virtual void End() = 0;
 
@@ -103,21 +118,87 @@ protected:
   void DrawTextInternal(float x, float y, const vecColors &colors, const vecText &text,
                             uint32_t alignment, float maxPixelWidth, bool scrolling);
 
+  /*! \brief A character placed on a line of text */
+  struct Glyph
+  {
+    Character    ch;     ///< copy of the character, the cache moves them around as it grows
+    float        x;      ///< position along the line
+    unsigned int color;  ///< index of the color of the character
+  };
+
+  /*! \brief Vertices of a line of text and the state they were made in
+   They can be drawn again as long as none of this has changed.
+   */
+  struct VertexRun
+  {
+    VertexRun();
+    std::vector<SVertex> vertices;
+    vecColors       colors;
+    TransformMatrix matrix;
+    CRect           clipRegion;
+    bool            clipped;
+    float           originX, originY;
+    float           maxPixelWidth;
+    float           scaleX, scaleY;
+    float           textureScaleX, textureScaleY;
+    bool            scrolling;
+    bool            limitedColor;
+  };
+
+  /*! \brief A line of text laid out for drawing
+   Laying out is the same each time a label is drawn, only the vertices depend on where
+   and how it is drawn. The last two vertex runs are kept, as most text is drawn twice
+   per frame, with and without its shadow.
+   */
+  struct Layout
+  {
+    Layout();
+    vecText            text;
+    uint32_t           alignment;
+    float              maxPixelWidth;  ///< only set for truncated and justified text
+    std::vector<Glyph> glyphs;
+    float              startX, startY;
+    bool               truncated;
+    unsigned int       lastUsed;       ///< frame time the layout was last drawn
+    VertexRun          runs[2];
+    unsigned int       nextRun;
+  };
+
+  /*! \brief A character rendered to 8 bit alpha, ready to be placed in the texture */
+  struct RenderedGlyph
+  {
+    RenderedGlyph();
+    character_t  letterAndStyle;
+    int          left, top;      ///< position of the bitmap relative to the pen, top upwards
+    float        advance;
+    unsigned int width, rows;
+    std::vector<unsigned char> pixels; ///< width bytes per row
+  };
+
+  Layout &GetLayout(const vecText &text, uint32_t alignment, float maxPixelWidth);
+  void LayoutText(Layout &layout);
+  bool IsSameRun(const VertexRun &run, const vecColors &colors, float maxPixelWidth, bool scrolling) const;
+  void SaveRun(VertexRun &run, int start, const vecColors &colors, float maxPixelWidth, bool scrolling) const;
+  bool AddVertices(const SVertex *vertices, int count);
+
   float m_height;
   CStdString m_strFilename;
 
   // Stuff for pre-rendering for speed
   inline Character *GetCharacter(character_t letter);
   bool CacheCharacter(wchar_t letter, uint32_t style, Character *ch);
+  bool PlaceCharacter(const RenderedGlyph &glyph, Character *ch);
+  void UpdatePendingCharacters();
   void RenderCharacter(float posX, float posY, const Character *ch, color_t color, bool roundX);
   void ClearCharacterCache();
+  void ClearLayoutCache();
 
   virtual CBaseTexture* ReallocTexture(unsigned int& newHeight) = 0;
-  virtual bool CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) = 0;
+  virtual bool CopyCharToTexture(const unsigned char *pixels, unsigned int pitch, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2) = 0;
   virtual void DeleteHardwareTexture() = 0;
 
   // modifying glyphs
-  void EmboldenGlyph(FT_GlyphSlot slot);
+  static void EmboldenGlyph(FT_GlyphSlot slot);
   static void ObliqueGlyph(FT_GlyphSlot slot);
 
   CBaseTexture* m_texture;        // texture that holds our rendered characters (8bit alpha only)
@@ -164,6 +245,13 @@ protected:
   float    m_textureScaleX;
   float    m_textureScaleY;
 
+  std::map<uint32_t, Layout> m_layouts;  ///< lines of text laid out, by a hash of their text, alignment and width
+  Layout       m_uncachedLayout;         ///< used for lines that change the character cache while being laid out
+  unsigned int m_charCacheGeneration;    ///< increased each time the character cache is cleared
+
+  boost::shared_ptr<CGUIFontRasterizer> m_rasterizer; ///< renders the characters on worker jobs
+  std::set<character_t> m_pendingChars;  ///< characters in the cache that are still being rendered
+
   static int justification_word_weight;
 
   CStdString m_strFileName;
@@ -283,10 +283,8 @@ CBaseTexture* CGUIFontTTFDX::ReallocTexture(unsigned int& newHeight)
   return pNewTexture;
 }
 
-bool CGUIFontTTFDX::CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
+bool CGUIFontTTFDX::CopyCharToTexture(const unsigned char *pixels, unsigned int pitch, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
 {
-  FT_Bitmap bitmap = bitGlyph->bitmap;
-
   LPDIRECT3DTEXTURE9 texture = ((CDXTexture *)m_texture)->GetTextureObject();
   LPDIRECT3DSURFACE9 target;
   if (m_speedupTexture)
@@ -294,11 +292,11 @@ bool CGUIFontTTFDX::CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1,
   else
     texture->GetSurfaceLevel(0, &target);
 
-  RECT sourcerect = { 0, 0, bitmap.width, bitmap.rows };
+  RECT sourcerect = { 0, 0, x2 - x1, y2 - y1 };
   RECT targetrect = { x1, y1, x2, y2 };
 
   HRESULT hr = D3DXLoadSurfaceFromMemory( target, NULL, &targetrect,
-                                          bitmap.buffer, D3DFMT_LIN_A8, bitmap.pitch, NULL, &sourcerect,
+                                          pixels, D3DFMT_LIN_A8, pitch, NULL, &sourcerect,
                                           D3DX_FILTER_NONE, 0x00000000);
 
   SAFE_RELEASE(target);
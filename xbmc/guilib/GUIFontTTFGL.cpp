@@ -230,17 +230,15 @@ CBaseTexture* CGUIFontTTFGL::ReallocTexture(unsigned int& newHeight)
   return newTexture;
 }
 
-bool CGUIFontTTFGL::CopyCharToTexture(FT_BitmapGlyph bitGlyph, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
+bool CGUIFontTTFGL::CopyCharToTexture(const unsigned char *pixels, unsigned int pitch, unsigned int x1, unsigned int y1, unsigned int x2, unsigned int y2)
 {
-  FT_Bitmap bitmap = bitGlyph->bitmap;
-
-  unsigned char* source = (unsigned char*) bitmap.buffer;
+  const unsigned char* source = pixels;
   unsigned char* target = (unsigned char*) m_texture->GetPixels() + y1 * m_texture->GetPitch() + x1;
 
   for (unsigned int y = y1; y < y2; y++)
   {
     memcpy(target, source, x2-x1);
-    source += bitmap.width;
+    source += pitch;
     target += m_texture->GetPitch();
   }
   // THE SOURCE VALUES ARE THE SAME IN BOTH SITUATIONS.
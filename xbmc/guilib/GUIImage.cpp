@@ -298,6 +298,16 @@ const CStdString &CGUIImage::GetFileName() const
   return m_texture.GetFileName();
 }
 
+CStdString CGUIImage::GetLargeFileName(const CGUIListItem *item) const
+{
+  if (m_info.IsConstant())
+    return "";
+  CStdString file = m_info.GetItemLabel(item, true);
+  if (file.empty() || (!m_texture.IsLazyLoaded() && g_TextureManager.CanLoad(file)))
+    return "";
+  return file;
+}
+
 void CGUIImage::SetAspectRatio(const CAspectRatio &aspect)
 {
   m_texture.SetAspectRatio(aspect);
@@ -93,6 +93,10 @@ public:
   void SetCrossFade(unsigned int time);
 
   const CStdString& GetFileName() const;
+  /*! \brief The file this image would show for an item, if it is loaded in the background
+   \return the file, or empty if the image is constant or loaded with the skin textures
+   */
+  CStdString GetLargeFileName(const CGUIListItem *item) const;
   float GetTextureWidth() const;
   float GetTextureHeight() const;
 
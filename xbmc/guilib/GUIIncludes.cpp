@@ -21,11 +21,14 @@
 #include "GUIIncludes.h"
 #include "addons/Skin.h"
 #include "GUIInfoManager.h"
+#include "GUIXMLPreloader.h"
 #include "utils/log.h"
 #include "utils/XBMCTinyXML.h"
 #include "utils/StringUtils.h"
 #include "interfaces/info/SkinVariable.h"
 
+#include <memory>
+
 using namespace std;
 
 CGUIIncludes::CGUIIncludes()
@@ -101,13 +104,19 @@ bool CGUIIncludes::LoadIncludes(const CStdString &includeFile)
     return true;
 
   CXBMCTinyXML doc;
-  if (!doc.LoadFile(includeFile))
+  std::auto_ptr<TiXmlElement> preloaded(CGUIXMLPreloader::Get().Take(includeFile));
+  TiXmlElement *root = preloaded.get();
+  if (!root)
   {
-    CLog::Log(LOGINFO, "Error loading includes.xml file (%s): %s (row=%i, col=%i)", includeFile.c_str(), doc.ErrorDesc(), doc.ErrorRow(), doc.ErrorCol());
-    return false;
+    if (!doc.LoadFile(includeFile))
+    {
+      CLog::Log(LOGINFO, "Error loading includes.xml file (%s): %s (row=%i, col=%i)", includeFile.c_str(), doc.ErrorDesc(), doc.ErrorRow(), doc.ErrorCol());
+      return false;
+    }
+    root = doc.RootElement();
   }
   // success, load the tags
-  if (LoadIncludesFromXML(doc.RootElement()))
+  if (LoadIncludesFromXML(root))
   {
     m_files.push_back(includeFile);
     return true;
@@ -27,6 +27,7 @@
 #include "GUIListItem.h"
 #include "utils/StringUtils.h"
 #include "addons/Skin.h"
+#include "Application.h"
 
 using namespace std;
 using ADDON::CAddonMgr;
@@ -121,11 +122,11 @@ void CGUIInfoColor::Parse(const CStdString &label, int context)
     m_color = g_colorManager.GetColor(label);
 }
 
-CGUIInfoLabel::CGUIInfoLabel()
+CGUIInfoLabel::CGUIInfoLabel() : m_dirty(false)
 {
 }
 
-CGUIInfoLabel::CGUIInfoLabel(const CStdString &label, const CStdString &fallback /*= ""*/, int context /*= 0*/)
+CGUIInfoLabel::CGUIInfoLabel(const CStdString &label, const CStdString &fallback /*= ""*/, int context /*= 0*/) : m_dirty(false)
 {
   SetLabel(label, fallback, context);
 }
@@ -138,55 +139,70 @@ void CGUIInfoLabel::SetLabel(const CStdString &label, const CStdString &fallback
 
 CStdString CGUIInfoLabel::GetLabel(int contextWindow, bool preferImage, CStdString *fallback /*= NULL*/) const
 {
+  // only the GUI thread caches the label, other threads (scripts, JSON-RPC) build their own copy
+  bool cache = g_application.IsCurrentThread();
+  bool needsUpdate = cache && m_dirty;
   CStdString label;
   for (unsigned int i = 0; i < m_info.size(); i++)
   {
     const CInfoPortion &portion = m_info[i];
+    CStdString infoLabel;
     if (portion.m_info)
     {
-      CStdString infoLabel;
       if (preferImage)
         infoLabel = g_infoManager.GetImage(portion.m_info, contextWindow, fallback);
       if (infoLabel.empty())
         infoLabel = g_infoManager.GetLabel(portion.m_info, contextWindow, fallback);
-      if (!infoLabel.empty())
-        label += portion.GetLabel(infoLabel);
     }
+    if (cache)
+      needsUpdate |= portion.m_info && portion.NeedsUpdate(infoLabel);
     else
-    { // no info, so just append the prefix
-      label += portion.m_prefix;
-    }
+      portion.AppendTo(label, infoLabel);
   }
-  if (label.empty())  // empty label, use the fallback
-    return m_fallback;
-  return label;
+  if (cache)
+    return CacheLabel(needsUpdate);
+  return label.empty() ? m_fallback : label;
 }
 
 CStdString CGUIInfoLabel::GetItemLabel(const CGUIListItem *item, bool preferImages, CStdString *fallback /*= NULL*/) const
 {
   if (!item->IsFileItem()) return "";
+  bool cache = g_application.IsCurrentThread();
+  bool needsUpdate = cache && m_dirty;
   CStdString label;
   for (unsigned int i = 0; i < m_info.size(); i++)
   {
     const CInfoPortion &portion = m_info[i];
+    CStdString infoLabel;
     if (portion.m_info)
     {
-      CStdString infoLabel;
       if (preferImages)
         infoLabel = g_infoManager.GetItemImage((const CFileItem *)item, portion.m_info, fallback);
       else
         infoLabel = g_infoManager.GetItemLabel((const CFileItem *)item, portion.m_info, fallback);
-      if (!infoLabel.empty())
-        label += portion.GetLabel(infoLabel);
     }
+    if (cache)
+      needsUpdate |= portion.m_info && portion.NeedsUpdate(infoLabel);
     else
-    { // no info, so just append the prefix
-      label += portion.m_prefix;
-    }
+      portion.AppendTo(label, infoLabel);
+  }
+  if (cache)
+    return CacheLabel(needsUpdate);
+  return label.empty() ? m_fallback : label;
+}
+
+const CStdString &CGUIInfoLabel::CacheLabel(bool rebuild) const
+{
+  if (rebuild)
+  {
+    m_label.clear();
+    for (unsigned int i = 0; i < m_info.size(); i++)
+      m_info[i].AppendTo(m_label);
+    m_dirty = false;
   }
-  if (label.empty())
+  if (m_label.empty())  // empty label, use the fallback
     return m_fallback;
-  return label;
+  return m_label;
 }
 
 bool CGUIInfoLabel::IsEmpty() const
@@ -277,6 +293,7 @@ const static infoformat infoformatmap[] = {{ "$INFO[",    FORMATINFO },
 void CGUIInfoLabel::Parse(const CStdString &label, int context)
 {
   m_info.clear();
+  m_dirty = true;
   // Step 1: Replace all $LOCALIZE[number] with the real string
   CStdString work = ReplaceLocalize(label);
   // Step 2: Replace all $ADDON[id number] with the real string
@@ -358,16 +375,36 @@ CGUIInfoLabel::CInfoPortion::CInfoPortion(int info, const CStdString &prefix, co
   StringUtils::Replace(m_postfix, "$LBRACKET", "["); StringUtils::Replace(m_postfix, "$RBRACKET", "]");
 }
 
-CStdString CGUIInfoLabel::CInfoPortion::GetLabel(const CStdString &info) const
+bool CGUIInfoLabel::CInfoPortion::NeedsUpdate(const CStdString &label) const
 {
-  CStdString label = m_prefix + info + m_postfix;
+  if (m_label != label)
+  {
+    m_label = label;
+    return true;
+  }
+  return false;
+}
+
+void CGUIInfoLabel::CInfoPortion::AppendTo(CStdString &label, const CStdString &info) const
+{
+  if (!m_info)
+  { // no info, so just append the prefix
+    label += m_prefix;
+    return;
+  }
+  if (info.empty())
+    return;
   if (m_escaped) // escape all quotes and backslashes, then quote
   {
-    StringUtils::Replace(label, "\\", "\\\\");
-    StringUtils::Replace(label, "\"", "\\\"");
-    return "\"" + label + "\"";
+    CStdString escaped = m_prefix + info + m_postfix;
+    StringUtils::Replace(escaped, "\\", "\\\\");
+    StringUtils::Replace(escaped, "\"", "\\\"");
+    label += "\"" + escaped + "\"";
+    return;
   }
-  return label;
+  label += m_prefix;
+  label += info;
+  label += m_postfix;
 }
 
 CStdString CGUIInfoLabel::GetLabel(const CStdString &label, int contextWindow /*= 0*/, bool preferImage /*= false */)
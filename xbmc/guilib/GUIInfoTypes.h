@@ -118,20 +118,34 @@ public:
 private:
   void Parse(const CStdString &label, int context);
 
+  /*! \brief Rebuild the cached label from its portions if needed
+   \param rebuild whether a portion changed since the label was last built
+   \return the cached label, or the fallback if it's empty
+   */
+  const CStdString &CacheLabel(bool rebuild) const;
+
   class CInfoPortion
   {
   public:
     CInfoPortion(int info, const CStdString &prefix, const CStdString &postfix, bool escaped = false);
-    CStdString GetLabel(const CStdString &info) const;
+    /*! \brief Store the current value of the info, returns true if it changed */
+    bool NeedsUpdate(const CStdString &label) const;
+    /*! \brief Append this portion to the label using the stored value of its info */
+    void AppendTo(CStdString &label) const { AppendTo(label, m_label); };
+    /*! \brief Append this portion to the label using the given value of its info */
+    void AppendTo(CStdString &label, const CStdString &info) const;
     int m_info;
     CStdString m_prefix;
     CStdString m_postfix;
   private:
     bool m_escaped;
+    mutable CStdString m_label;   ///< last value of the info, GUI thread only
   };
 
   CStdString m_fallback;
   std::vector<CInfoPortion> m_info;
+  mutable CStdString m_label;     ///< the label built from the last values of the portions, GUI thread only
+  mutable bool m_dirty;           ///< the portions changed since the label was built, GUI thread only
 };
 
 #endif
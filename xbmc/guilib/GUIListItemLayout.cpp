@@ -140,6 +140,18 @@ bool CGUIListItemLayout::MoveRight()
   return m_group.MoveRight();
 }
 
+void CGUIListItemLayout::GetLargeImages(const CGUIListItem *item, std::vector<CStdString> &images) const
+{
+  std::vector<const CGUIControl *> controls;
+  m_group.GetImages(controls);
+  for (std::vector<const CGUIControl *>::const_iterator i = controls.begin(); i != controls.end(); ++i)
+  {
+    CStdString file = ((const CGUIImage *)*i)->GetLargeFileName(item);
+    if (!file.empty())
+      images.push_back(file);
+  }
+}
+
 bool CGUIListItemLayout::CheckCondition()
 {
   return !m_condition || m_condition->Get();
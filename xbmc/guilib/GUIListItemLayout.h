@@ -45,6 +45,12 @@ public:
   void SetInvalid() { m_invalidated = true; };
   void FreeResources(bool immediately = false);
 
+  /*! \brief Get the files of the images this layout loads in the background for an item
+   \param item the item to get them for, the layout isn't changed
+   \param images [out] the files, appended to
+   */
+  void GetLargeImages(const CGUIListItem *item, std::vector<CStdString> &images) const;
+
 //#ifdef PRE_SKIN_VERSION_9_10_COMPATIBILITY
   void CreateListControlLayouts(float width, float height, bool focused, const CLabelInfo &labelInfo, const CLabelInfo &labelInfo2, const CTextureInfo &texture, const CTextureInfo &textureFocus, float texHeight, float iconWidth, float iconHeight, const CStdString &nofocusCondition, const CStdString &focusCondition);
 //#endif
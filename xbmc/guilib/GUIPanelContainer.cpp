@@ -47,6 +47,7 @@ void CGUIPanelContainer::Process(unsigned int currentTime, CDirtyRegionList &dir
   if (!m_layout || !m_focusedLayout) return;
 
   UpdateScrollOffset(currentTime);
+  PrefetchScrollArt(currentTime, m_itemsPerRow);
 
   int offset = (int)(m_scroller.GetValue() / m_layout->Size(m_orientation));
 
@@ -33,11 +33,13 @@
 #include "addons/Skin.h"
 #include "GUIInfoManager.h"
 #include "utils/log.h"
+#include "threads/Atomics.h"
 #include "threads/SingleLock.h"
 #include "utils/TimeUtils.h"
 #include "input/ButtonTranslator.h"
 #include "utils/XMLUtils.h"
 #include "GUIAudioManager.h"
+#include "GUIXMLPreloader.h"
 #include "Application.h"
 #include "ApplicationMessenger.h"
 #include "utils/Variant.h"
@@ -49,6 +51,8 @@
 
 using namespace std;
 
+volatile long CGUIWindow::m_propertiesChanged = 0;
+
 bool CGUIWindow::icompare::operator()(const CStdString &s1, const CStdString &s2) const
 {
   return StringUtils::CompareNoCase(s1, s2) < 0;
@@ -138,6 +142,8 @@ bool CGUIWindow::Load(const CStdString& strFileName, bool bContainsPath)
 bool CGUIWindow::LoadXML(const CStdString &strPath, const CStdString &strLowerPath)
 {
   // load window xml if we don't have it stored yet
+  if (!m_windowXMLRootElement)
+    m_windowXMLRootElement = CGUIXMLPreloader::Get().Take(strPath);
   if (!m_windowXMLRootElement)
   {
     CXBMCTinyXML xmlDoc;
@@ -1029,7 +1035,14 @@ void CGUIWindow::ChangeButtonToEdit(int id, bool singleLabel /* = false*/)
 void CGUIWindow::SetProperty(const CStdString &strKey, const CVariant &value)
 {
   CSingleLock lock(*this);
-  m_mapProperties[strKey] = value;
+  std::map<CStdString, CVariant, icompare>::iterator iter = m_mapProperties.find(strKey);
+  if (iter == m_mapProperties.end())
+    m_mapProperties.insert(std::make_pair(strKey, value));
+  else if (iter->second != value)
+    iter->second = value;
+  else
+    return;
+  AtomicIncrement(&m_propertiesChanged);
 }
 
 CVariant CGUIWindow::GetProperty(const CStdString &strKey) const
@@ -1045,7 +1058,10 @@ CVariant CGUIWindow::GetProperty(const CStdString &strKey) const
 void CGUIWindow::ClearProperties()
 {
   CSingleLock lock(*this);
+  if (m_mapProperties.empty())
+    return;
   m_mapProperties.clear();
+  AtomicIncrement(&m_propertiesChanged);
 }
 
 void CGUIWindow::SetRunActionsManually()
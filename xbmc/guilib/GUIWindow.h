@@ -188,6 +188,11 @@ public:
    */
   void ClearProperties();
 
+  /*! \brief Changes each time a property of any window is set to a new value or cleared
+   \sa SetProperty, ClearProperties
+   */
+  static long GetPropertiesChanged() { return m_propertiesChanged; }
+
   void DumpTextureUse();
 
   bool HasSaveLastControl() const { return !m_defaultAlways; };
@@ -280,6 +285,7 @@ protected:
 
 private:
   std::map<CStdString, CVariant, icompare> m_mapProperties;
+  static volatile long m_propertiesChanged;
   std::map<INFO::InfoPtr, bool> m_xmlIncludeConditions; ///< \brief used to store conditions used to resolve includes for this window
 };
 
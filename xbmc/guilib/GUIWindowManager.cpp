@@ -31,6 +31,7 @@
 #include "settings/Settings.h"
 #include "addons/Skin.h"
 #include "GUITexture.h"
+#include "GUIFontManager.h"
 #include "windowing/WindowingFactory.h"
 #include "utils/Variant.h"
 #include "Key.h"
@@ -515,6 +516,10 @@ void CGUIWindowManager::Process(unsigned int currentTime)
 
   for (CDirtyRegionList::iterator itr = dirtyregions.begin(); itr != dirtyregions.end(); ++itr)
     m_tracker.MarkDirtyRegion(*itr);
+
+  // text drawn while its glyphs were still being rendered is drawn again with them
+  if (g_fontManager.TakeGlyphsRendered())
+    MarkDirty();
 }
 
 void CGUIWindowManager::MarkDirty()
@@ -906,6 +911,20 @@ bool CGUIWindowManager::IsWindowActive(const CStdString &xmlFile, bool ignoreClo
   return false; // window isn't active
 }
 
+void CGUIWindowManager::GetActiveState(std::vector<int> &state) const
+{
+  CSingleLock lock(g_graphicsContext);
+  CGUIWindow *window = GetWindow(GetActiveWindow());
+  state.push_back(GetActiveWindow());
+  state.push_back(window ? window->GetFocusedControlID() : 0);
+  for (ciDialog it = m_activeDialogs.begin(); it != m_activeDialogs.end(); ++it)
+  {
+    state.push_back((*it)->GetID());
+    state.push_back((*it)->GetFocusedControlID());
+    state.push_back((*it)->IsAnimating(ANIM_TYPE_WINDOW_CLOSE));
+  }
+}
+
 bool CGUIWindowManager::IsWindowVisible(int id) const
 {
   return IsWindowActive(id, false);
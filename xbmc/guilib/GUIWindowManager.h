@@ -136,6 +136,10 @@ public:
   bool IsWindowActive(const CStdString &xmlFile, bool ignoreClosing = true) const;
   bool IsWindowVisible(const CStdString &xmlFile) const;
   bool IsWindowTopMost(const CStdString &xmlFile) const;
+  /*! \brief Append the active window and dialogs to state, with the control each has focused
+   and whether it is closing. Compared between frames to know whether any of it changed.
+   */
+  void GetActiveState(std::vector<int> &state) const;
   bool IsOverlayAllowed() const;
   void ShowOverlay(CGUIWindow::OVERLAY_STATE state);
   void GetActiveModelessWindows(std::vector<int> &ids);
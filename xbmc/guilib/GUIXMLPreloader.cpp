@@ -0,0 +1,413 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUIXMLPreloader.h"
+#include "filesystem/File.h"
+#include "filesystem/SpecialProtocol.h"
+#include "threads/SingleLock.h"
+#include "utils/Job.h"
+#include "utils/JobManager.h"
+#include "utils/StringUtils.h"
+#include "utils/URIUtils.h"
+#include "utils/XBMCTinyXML.h"
+#include "utils/XMLBinary.h"
+#include "utils/log.h"
+
+#include <string.h>
+
+using namespace std;
+
+#define PACK_MAGIC   0x50534258  // "XBSP"
+#define PACK_VERSION 1
+
+// compiled data kept for a skin, files beyond it are parsed every time
+#define PACK_MAX_BYTES (16 * 1024 * 1024)
+
+class CGUIXMLPreloadJob : public CJob
+{
+public:
+  CGUIXMLPreloadJob(const string &key, unsigned int generation)
+    : m_key(key), m_generation(generation) {}
+
+  virtual const char *GetType() const { return "xmlpreload"; }
+  virtual bool DoWork()
+  {
+    CGUIXMLPreloader::Get().Parse(m_key, m_generation);
+    return true;
+  }
+
+private:
+  string       m_key;
+  unsigned int m_generation;
+};
+
+class CGUIXMLPackWriteJob : public CJob
+{
+public:
+  CGUIXMLPackWriteJob(unsigned int generation)
+    : m_generation(generation) {}
+
+  virtual const char *GetType() const { return "xmlpackwrite"; }
+  virtual bool DoWork()
+  {
+    CGUIXMLPreloader::Get().WriteCache(m_generation);
+    return true;
+  }
+
+private:
+  unsigned int m_generation;
+};
+
+CGUIXMLPreloader::CGUIXMLPreloader()
+  : m_generation(0)
+  , m_packBytes(0)
+  , m_pending(0)
+  , m_packChanged(false)
+  , m_writeQueued(false)
+{
+}
+
+CGUIXMLPreloader &CGUIXMLPreloader::Get()
+{
+  static CGUIXMLPreloader s_preloader;
+  return s_preloader;
+}
+
+void CGUIXMLPreloader::Preload(const vector<string> &files, const string &cacheFile, const string &skinPath)
+{
+  PACK pack;
+  if (!cacheFile.empty())
+    ReadPack(cacheFile, pack);
+
+  CSingleLock lock(m_section);
+  if (!cacheFile.empty())
+  {
+    m_cacheFile = cacheFile;
+    if (!skinPath.empty())
+    {
+      m_skinKey = GetKey(skinPath);
+      URIUtils::AddSlashAtEnd(m_skinKey);
+    }
+    for (PACK::const_iterator i = pack.begin(); i != pack.end(); ++i)
+    {
+      if (m_pack.find(i->first) != m_pack.end() || m_packBytes + i->second.data.size() > PACK_MAX_BYTES)
+        continue;
+      m_pack.insert(*i);
+      m_packBytes += i->second.data.size();
+    }
+  }
+  for (vector<string>::const_iterator i = files.begin(); i != files.end(); ++i)
+  {
+    string key = GetKey(*i);
+    if (m_files.find(key) != m_files.end())
+      continue;
+
+    CFile file;
+    file.path  = *i;
+    file.state = QUEUED;
+    file.root  = NULL;
+    m_files.insert(make_pair(key, file));
+    m_pending++;
+    // the skin is waiting for these, so they go ahead of background work
+    CJobManager::GetInstance().AddJob(new CGUIXMLPreloadJob(key, m_generation), NULL, CJob::PRIORITY_HIGH);
+  }
+}
+
+TiXmlElement *CGUIXMLPreloader::Take(const string &file)
+{
+  string key = GetKey(file);
+
+  CSingleLock lock(m_section);
+  map<string, CFile>::iterator it = m_files.find(key);
+  while (it != m_files.end() && it->second.state == PARSING)
+  {
+    m_parsed.wait(lock);
+    it = m_files.find(key);
+  }
+  if (it == m_files.end())
+  { // not preloaded, skin files still go through the cache
+    if (m_cacheFile.empty() || m_skinKey.empty() || key.compare(0, m_skinKey.size(), m_skinKey) != 0)
+      return NULL;
+    unsigned int generation = m_generation;
+    lock.Leave();
+    return Load(key, file, generation, false);
+  }
+
+  if (it->second.state == QUEUED)
+  { // no worker got to it yet, its job finds it gone
+    string path = it->second.path;
+    unsigned int generation = m_generation;
+    m_files.erase(it);
+    lock.Leave();
+    return Load(key, path, generation, true);
+  }
+
+  TiXmlElement *root = it->second.root;
+  m_files.erase(it);
+  return root;
+}
+
+void CGUIXMLPreloader::Clear()
+{
+  CSingleLock lock(m_section);
+  for (map<string, CFile>::iterator it = m_files.begin(); it != m_files.end(); ++it)
+    delete it->second.root;
+  m_files.clear();
+  m_pack.clear();
+  m_packBytes = 0;
+  m_cacheFile.clear();
+  m_skinKey.clear();
+  m_pending = 0;
+  m_packChanged = false;
+  m_writeQueued = false;
+  // files still being parsed are dropped once done
+  m_generation++;
+  m_parsed.notifyAll();
+}
+
+void CGUIXMLPreloader::Parse(const string &key, unsigned int generation)
+{
+  string path;
+  {
+    CSingleLock lock(m_section);
+    map<string, CFile>::iterator it = m_files.find(key);
+    if (generation != m_generation || it == m_files.end() || it->second.state != QUEUED)
+      return;
+    it->second.state = PARSING;
+    path = it->second.path;
+  }
+
+  TiXmlElement *root = Load(key, path, generation, true);
+
+  CSingleLock lock(m_section);
+  map<string, CFile>::iterator it = m_files.find(key);
+  if (generation == m_generation && it != m_files.end())
+  {
+    it->second.root  = root;
+    it->second.state = DONE;
+    root = NULL;
+  }
+  m_parsed.notifyAll();
+  lock.Leave();
+
+  delete root;
+}
+
+string CGUIXMLPreloader::GetKey(const string &path)
+{
+  // skin files are asked for both as special:// and as translated paths
+  string key = CSpecialProtocol::TranslatePath(path);
+  StringUtils::ToLower(key);
+  return key;
+}
+
+TiXmlElement *CGUIXMLPreloader::Load(const string &key, const string &path, unsigned int generation, bool preloaded)
+{
+  CCompiled compiled;
+  {
+    CSingleLock lock(m_section);
+    PACK::const_iterator it = m_pack.find(key);
+    if (generation == m_generation && it != m_pack.end())
+      compiled = it->second;
+  }
+
+  bool changed = false;
+  TiXmlElement *root = Load(path, compiled, changed);
+
+  CSingleLock lock(m_section);
+  if (generation != m_generation)
+    return root;
+
+  if (changed)
+  {
+    PACK::iterator it = m_pack.find(key);
+    size_t oldBytes = it != m_pack.end() ? it->second.data.size() : 0;
+    if (m_packBytes - oldBytes + compiled.data.size() <= PACK_MAX_BYTES)
+    {
+      m_pack[key] = compiled;
+      m_packBytes = m_packBytes - oldBytes + compiled.data.size();
+      m_packChanged = true;
+    }
+    else
+      CLog::Log(LOGDEBUG, "%s - cache is full, not keeping %s", __FUNCTION__, path.c_str());
+  }
+  if (preloaded && m_pending > 0)
+    m_pending--;
+
+  // the skin is done loading its first files, keep the cache file up to date from now on
+  if (m_pending == 0 && m_packChanged && !m_writeQueued && !m_cacheFile.empty())
+  {
+    m_writeQueued = true;
+    CJobManager::GetInstance().AddJob(new CGUIXMLPackWriteJob(m_generation), NULL);
+  }
+  return root;
+}
+
+void CGUIXMLPreloader::WriteCache(unsigned int generation)
+{
+  // one writer at a time, they share the temporary file
+  CSingleLock writeLock(m_writeSection);
+
+  PACK pack;
+  string cacheFile;
+  {
+    CSingleLock lock(m_section);
+    if (generation != m_generation)
+      return;
+    m_writeQueued = false;
+    m_packChanged = false;
+    pack = m_pack;
+    cacheFile = m_cacheFile;
+  }
+  WritePack(cacheFile, pack);
+}
+
+TiXmlElement *CGUIXMLPreloader::Load(const string &path, CCompiled &compiled, bool &changed)
+{
+  changed = false;
+
+  struct __stat64 st;
+  if (XFILE::CFile::Stat(path, &st) == 0 &&
+      (int64_t)st.st_size == compiled.size && (int64_t)st.st_mtime == compiled.mtime)
+  {
+    TiXmlElement *root = CXMLBinary::Load(compiled.data);
+    if (root)
+      return root;
+    CLog::Log(LOGDEBUG, "%s - invalid compiled data for %s", __FUNCTION__, path.c_str());
+  }
+
+  CXBMCTinyXML doc;
+  if (!doc.LoadFile(path) || !doc.RootElement())
+  {
+    CLog::Log(LOGDEBUG, "%s - unable to load %s", __FUNCTION__, path.c_str());
+    return NULL;
+  }
+
+  if (XFILE::CFile::Stat(path, &st) == 0)
+  {
+    compiled.size  = st.st_size;
+    compiled.mtime = st.st_mtime;
+    CXMLBinary::Compile(doc.RootElement(), compiled.data);
+    changed = true;
+  }
+  return (TiXmlElement*)doc.RootElement()->Clone();
+}
+
+namespace
+{
+bool Read(const char *&pos, const char *end, void *value, size_t size)
+{
+  if (size > (size_t)(end - pos))
+    return false;
+  memcpy(value, pos, size);
+  pos += size;
+  return true;
+}
+
+bool ReadString(const char *&pos, const char *end, string &value)
+{
+  uint32_t length;
+  if (!Read(pos, end, &length, sizeof(length)) || length > (size_t)(end - pos))
+    return false;
+  value.assign(pos, length);
+  pos += length;
+  return true;
+}
+
+template<typename T>
+void Write(string &data, T value)
+{
+  data.append((const char *)&value, sizeof(value));
+}
+
+void WriteString(string &data, const string &value)
+{
+  Write<uint32_t>(data, value.size());
+  data += value;
+}
+}
+
+void CGUIXMLPreloader::ReadPack(const string &cacheFile, PACK &pack)
+{
+  XFILE::CFile file;
+  XFILE::auto_buffer buffer;
+  if (!XFILE::CFile::Exists(cacheFile) || !file.LoadFile(cacheFile, buffer))
+    return;
+
+  const char *pos = buffer.get();
+  const char *end = pos + buffer.length();
+  uint32_t magic, version, count;
+  if (!Read(pos, end, &magic, sizeof(magic)) || magic != PACK_MAGIC ||
+      !Read(pos, end, &version, sizeof(version)) || version != PACK_VERSION ||
+      !Read(pos, end, &count, sizeof(count)))
+  {
+    CLog::Log(LOGDEBUG, "%s - ignoring invalid cache %s", __FUNCTION__, cacheFile.c_str());
+    return;
+  }
+
+  for (uint32_t i = 0; i < count; i++)
+  {
+    string key;
+    CCompiled compiled;
+    if (!ReadString(pos, end, key) ||
+        !Read(pos, end, &compiled.size, sizeof(compiled.size)) ||
+        !Read(pos, end, &compiled.mtime, sizeof(compiled.mtime)) ||
+        !ReadString(pos, end, compiled.data))
+    {
+      CLog::Log(LOGDEBUG, "%s - ignoring truncated cache %s", __FUNCTION__, cacheFile.c_str());
+      pack.clear();
+      return;
+    }
+    pack[key] = compiled;
+  }
+}
+
+void CGUIXMLPreloader::WritePack(const string &cacheFile, const PACK &pack)
+{
+  string data;
+  Write<uint32_t>(data, PACK_MAGIC);
+  Write<uint32_t>(data, PACK_VERSION);
+  Write<uint32_t>(data, pack.size());
+  for (PACK::const_iterator i = pack.begin(); i != pack.end(); ++i)
+  {
+    WriteString(data, i->first);
+    Write<int64_t>(data, i->second.size);
+    Write<int64_t>(data, i->second.mtime);
+    WriteString(data, i->second.data);
+  }
+
+  // write next to it and swap, a skin loading at the same time never sees half of it
+  string tempFile = cacheFile + ".tmp";
+  XFILE::CFile file;
+  if (!file.OpenForWrite(tempFile, true) || file.Write(data.c_str(), data.size()) != (int)data.size())
+  {
+    CLog::Log(LOGERROR, "%s - unable to write %s", __FUNCTION__, tempFile.c_str());
+    file.Close();
+    XFILE::CFile::Delete(tempFile);
+    return;
+  }
+  file.Close();
+
+  XFILE::CFile::Delete(cacheFile);
+  if (!XFILE::CFile::Rename(tempFile, cacheFile))
+    CLog::Log(LOGERROR, "%s - unable to write %s", __FUNCTION__, cacheFile.c_str());
+  else
+    CLog::Log(LOGDEBUG, "%s - wrote %u compiled files to %s", __FUNCTION__, (unsigned int)pack.size(), cacheFile.c_str());
+}
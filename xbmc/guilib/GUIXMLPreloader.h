@@ -0,0 +1,142 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "threads/Condition.h"
+#include "threads/CriticalSection.h"
+
+class TiXmlElement;
+
+/*!
+ \ingroup windows
+ \brief Parses the xml files of a skin on worker jobs while it is loading
+
+ When a skin is loaded its includes and the windows shown first are queued
+ to be read and parsed in parallel, so that they only have to take the
+ parsed tree instead of reading the file on the GUI thread. Other windows
+ are loaded as before when they are opened. Includes are still resolved
+ when a window is loaded, as their conditions depend on the state at that
+ time.
+
+ A file is handed out once, to whoever takes it first. A file that hasn't
+ been picked up by a worker yet is parsed by the caller, one that is being
+ parsed is waited for.
+
+ Given a cache file, the parsed trees are kept there in compiled form (see
+ CXMLBinary) along with the size and modification time of their xml file.
+ A file that is unchanged is rebuilt from the cache instead of being parsed.
+ This holds for every file of the skin that is taken, whether it was
+ preloaded or not, so windows opened later are covered as well. The cache is
+ kept in memory while the skin is loaded, up to PACK_MAX_BYTES of compiled
+ data, and rewritten on a background job once the preloaded files are done
+ and whenever a file is added or changed after that.
+ */
+class CGUIXMLPreloader
+{
+public:
+  static CGUIXMLPreloader &Get();
+
+  /*! \brief Queue files to be parsed, in the given order
+   \param files full paths of the xml files
+   \param cacheFile file to keep the compiled trees in, should be unique to the skin and its version. Empty for no cache.
+   \param skinPath folder of the skin, files below it that weren't preloaded go through the cache too
+   */
+  void Preload(const std::vector<std::string> &files, const std::string &cacheFile = "", const std::string &skinPath = "");
+
+  /*! \brief Take the root element of a skin file
+   \param file full path of the file, case insensitive
+   \return the root element, owned by the caller, or NULL if the file is neither preloaded nor
+            below the skin path of the cache, or couldn't be parsed
+   */
+  TiXmlElement *Take(const std::string &file);
+
+  /*! \brief Drop all files that haven't been taken, e.g. when the skin is unloaded
+   */
+  void Clear();
+
+private:
+  CGUIXMLPreloader();
+  CGUIXMLPreloader(const CGUIXMLPreloader&);
+  CGUIXMLPreloader const& operator=(CGUIXMLPreloader const&);
+
+  friend class CGUIXMLPreloadJob;
+  friend class CGUIXMLPackWriteJob;
+
+  /*! \brief Parse a queued file, called from the jobs
+   \param key the key of the file in m_files
+   \param generation m_generation when the file was queued, the result is dropped if it changed
+   */
+  void Parse(const std::string &key, unsigned int generation);
+
+  /*! \brief Load a file from the cache or its xml and keep track of the cache
+   \param key the key of the file in m_pack
+   \param path full path of the file
+   \param generation m_generation when the file was queued or taken
+   \param preloaded whether the file was queued by Preload()
+   \return the root element, owned by the caller, or NULL if the file couldn't be parsed
+   */
+  TiXmlElement *Load(const std::string &key, const std::string &path, unsigned int generation, bool preloaded);
+
+  /*! \brief Write the cache file, called from the write job
+   \param generation m_generation when the job was queued, nothing is written if it changed
+   */
+  void WriteCache(unsigned int generation);
+
+  struct CCompiled
+  {
+    CCompiled() : size(-1), mtime(-1) {}
+    int64_t     size;   ///< size of the xml file
+    int64_t     mtime;  ///< modification time of the xml file
+    std::string data;   ///< compiled root element
+  };
+  typedef std::map<std::string, CCompiled> PACK;
+
+  static std::string GetKey(const std::string &path);
+  static TiXmlElement *Load(const std::string &path, CCompiled &compiled, bool &changed);
+  static void ReadPack(const std::string &cacheFile, PACK &pack);
+  static void WritePack(const std::string &cacheFile, const PACK &pack);
+
+  enum STATE { QUEUED, PARSING, DONE };
+  struct CFile
+  {
+    std::string   path;
+    STATE         state;
+    TiXmlElement *root;
+  };
+
+  std::map<std::string, CFile> m_files;   ///< files by lower case path
+  unsigned int m_generation;              ///< increased on Clear()
+  PACK         m_pack;                    ///< compiled files by lower case path
+  size_t       m_packBytes;               ///< size of the compiled data in m_pack
+  std::string  m_cacheFile;
+  std::string  m_skinKey;                 ///< key of the skin folder, files below it are cached
+  unsigned int m_pending;                 ///< queued files not loaded yet
+  bool         m_packChanged;
+  bool         m_writeQueued;             ///< a job to write the cache file is queued
+  CCriticalSection m_section;
+  CCriticalSection m_writeSection;        ///< held while the cache file is written
+  XbmcThreads::ConditionVariable m_parsed;
+};
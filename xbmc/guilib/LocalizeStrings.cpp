@@ -241,6 +241,17 @@ const CStdString& CLocalizeStrings::Get(uint32_t dwCode) const
   return i->second.strTranslated;
 }
 
+void CLocalizeStrings::CountCharacters(std::map<wchar_t, unsigned int> &counts) const
+{
+  for (ciStrings i = m_strings.begin(); i != m_strings.end(); ++i)
+  {
+    std::wstring text;
+    g_charsetConverter.utf8ToW(i->second.strTranslated, text, false);
+    for (std::wstring::const_iterator c = text.begin(); c != text.end(); ++c)
+      counts[*c]++;
+  }
+}
+
 void CLocalizeStrings::Clear()
 {
   m_strings.clear();
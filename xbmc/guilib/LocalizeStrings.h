@@ -56,6 +56,11 @@ public:
   bool LoadSkinStrings(const CStdString& path, const CStdString& language);
   void ClearSkinStrings();
   const CStdString& Get(uint32_t code) const;
+
+  /*! \brief Count how often each character is used by the loaded strings
+   \param counts [in/out] number of uses by character
+   */
+  void CountCharacters(std::map<wchar_t, unsigned int> &counts) const;
   void Clear();
 protected:
   void Clear(uint32_t start, uint32_t end);
@@ -0,0 +1,283 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "TextureAtlas.h"
+
+#include <algorithm>
+#include <stdint.h>
+#include <string.h>
+
+using namespace std;
+
+#define ATLAS_MAGIC   0x41544258  // "XBTA"
+#define ATLAS_VERSION 1
+#define ATLAS_NO_PAGE 0xffffffff  // stored for images that were left out
+
+namespace
+{
+struct CShelf
+{
+  unsigned int page;
+  unsigned int y;
+  unsigned int height;
+  unsigned int used;
+};
+
+bool HigherFirst(const CTextureAtlas::CImage *a, const CTextureAtlas::CImage *b)
+{
+  if (a->height != b->height)
+    return a->height > b->height;
+  if (a->width != b->width)
+    return a->width > b->width;
+  return a->name < b->name;
+}
+
+bool Read(const char *&pos, const char *end, uint32_t &value)
+{
+  if (sizeof(value) > (size_t)(end - pos))
+    return false;
+  memcpy(&value, pos, sizeof(value));
+  pos += sizeof(value);
+  return true;
+}
+
+bool ReadString(const char *&pos, const char *end, string &value)
+{
+  uint32_t length;
+  if (!Read(pos, end, length) || length > (size_t)(end - pos))
+    return false;
+  value.assign(pos, length);
+  pos += length;
+  return true;
+}
+
+void Write(string &data, uint32_t value)
+{
+  data.append((const char *)&value, sizeof(value));
+}
+
+void WriteString(string &data, const string &value)
+{
+  Write(data, value.size());
+  data += value;
+}
+}
+
+const unsigned int CTextureAtlas::PAGE_SIZE;
+const unsigned int CTextureAtlas::MAX_PAGES;
+const unsigned int CTextureAtlas::MAX_SIZE;
+const unsigned int CTextureAtlas::PADDING;
+
+CTextureAtlas::CTextureAtlas(unsigned int pageSize, unsigned int maxPages)
+  : m_pageSize(pageSize)
+  , m_maxPages(maxPages)
+  , m_pageCount(0)
+{
+}
+
+void CTextureAtlas::Clear()
+{
+  m_images.clear();
+  m_leftOut.clear();
+  m_pageCount = 0;
+}
+
+bool CTextureAtlas::IsPackable(const CImage &image) const
+{
+  return image.width > 0 && image.height > 0 && image.width <= MAX_SIZE && image.height <= MAX_SIZE &&
+         image.width + 2 * PADDING <= m_pageSize && image.height + 2 * PADDING <= m_pageSize;
+}
+
+void CTextureAtlas::Pack(const vector<CImage> &images)
+{
+  Clear();
+
+  vector<const CImage*> sorted;
+  for (vector<CImage>::const_iterator i = images.begin(); i != images.end(); ++i)
+  {
+    if (IsPackable(*i))
+      sorted.push_back(&*i);
+  }
+  sort(sorted.begin(), sorted.end(), HigherFirst);
+
+  vector<CShelf> shelves;
+  vector<unsigned int> pageHeights; // height of the shelves on each page
+  for (vector<const CImage*>::const_iterator i = sorted.begin(); i != sorted.end(); ++i)
+  {
+    if (m_images.find((*i)->name) != m_images.end() || m_leftOut.find((*i)->name) != m_leftOut.end())
+      continue;
+
+    unsigned int width  = (*i)->width + 2 * PADDING;
+    unsigned int height = (*i)->height + 2 * PADDING;
+
+    // the first shelf with room left, they are as high as the image or higher
+    vector<CShelf>::iterator shelf = shelves.begin();
+    while (shelf != shelves.end() && (shelf->height < height || m_pageSize - shelf->used < width))
+      ++shelf;
+
+    if (shelf == shelves.end())
+    { // open a shelf on the first page with room for it
+      unsigned int page = 0;
+      while (page < pageHeights.size() && m_pageSize - pageHeights[page] < height)
+        page++;
+      if (page == pageHeights.size())
+      {
+        if (pageHeights.size() >= m_maxPages)
+        {
+          m_leftOut.insert(make_pair((*i)->name, **i));
+          continue;
+        }
+        pageHeights.push_back(0);
+      }
+
+      CShelf newShelf;
+      newShelf.page   = page;
+      newShelf.y      = pageHeights[page];
+      newShelf.height = height;
+      newShelf.used   = 0;
+      pageHeights[page] += height;
+      shelf = shelves.insert(shelves.end(), newShelf);
+    }
+
+    CImage image(**i);
+    image.page = shelf->page;
+    image.x    = shelf->used + PADDING;
+    image.y    = shelf->y + PADDING;
+    shelf->used += width;
+    m_images.insert(make_pair(image.name, image));
+  }
+  m_pageCount = pageHeights.size();
+}
+
+void CTextureAtlas::Save(string &data) const
+{
+  data.clear();
+  Write(data, ATLAS_MAGIC);
+  Write(data, ATLAS_VERSION);
+  Write(data, m_pageSize);
+  Write(data, m_pageCount);
+  Write(data, m_images.size() + m_leftOut.size());
+  for (IMAGES::const_iterator i = m_images.begin(); i != m_images.end(); ++i)
+  {
+    WriteString(data, i->second.name);
+    Write(data, i->second.width);
+    Write(data, i->second.height);
+    Write(data, i->second.page);
+    Write(data, i->second.x);
+    Write(data, i->second.y);
+  }
+  // the images that didn't fit are kept too, the layout is made for them as well
+  for (IMAGES::const_iterator i = m_leftOut.begin(); i != m_leftOut.end(); ++i)
+  {
+    WriteString(data, i->second.name);
+    Write(data, i->second.width);
+    Write(data, i->second.height);
+    Write(data, ATLAS_NO_PAGE);
+    Write(data, 0);
+    Write(data, 0);
+  }
+}
+
+bool CTextureAtlas::Load(const string &data, const vector<CImage> &images)
+{
+  Clear();
+
+  const char *pos = data.c_str();
+  const char *end = pos + data.size();
+  uint32_t magic, version, pageSize, pageCount, count;
+  if (!Read(pos, end, magic) || magic != ATLAS_MAGIC ||
+      !Read(pos, end, version) || version != ATLAS_VERSION ||
+      !Read(pos, end, pageSize) || pageSize != m_pageSize ||
+      !Read(pos, end, pageCount) || pageCount > m_maxPages ||
+      !Read(pos, end, count) || count > data.size())
+    return false;
+
+  map<string, const CImage*> wanted;
+  for (vector<CImage>::const_iterator i = images.begin(); i != images.end(); ++i)
+  {
+    if (IsPackable(*i))
+      wanted.insert(make_pair(i->name, &*i));
+  }
+
+  IMAGES stored, leftOut;
+  for (uint32_t i = 0; i < count; i++)
+  {
+    CImage image;
+    if (!ReadString(pos, end, image.name) ||
+        !Read(pos, end, image.width) || !Read(pos, end, image.height) ||
+        !Read(pos, end, image.page) || !Read(pos, end, image.x) || !Read(pos, end, image.y))
+      return false;
+
+    // it has to be one of the images we have, of the same size
+    map<string, const CImage*>::const_iterator it = wanted.find(image.name);
+    if (it == wanted.end() || it->second->width != image.width || it->second->height != image.height)
+      return false;
+
+    if (image.page == ATLAS_NO_PAGE)
+    {
+      if (!leftOut.insert(make_pair(image.name, image)).second)
+        return false;
+      continue;
+    }
+
+    // and it has to be on one of the pages, padding included
+    if (image.page >= pageCount || image.x < PADDING || image.y < PADDING ||
+        image.x > m_pageSize || image.y > m_pageSize ||
+        image.x + image.width + PADDING > m_pageSize || image.y + image.height + PADDING > m_pageSize ||
+        !stored.insert(make_pair(image.name, image)).second)
+      return false;
+  }
+
+  // images that are missing from the layout were added since
+  if (pos != end || stored.size() + leftOut.size() != wanted.size())
+    return false;
+
+  m_images.swap(stored);
+  m_leftOut.swap(leftOut);
+  m_pageCount = pageCount;
+  return true;
+}
+
+void CTextureAtlas::Blit(unsigned char *page, const CImage &image, const unsigned char *pixels, unsigned int pitch) const
+{
+  const unsigned int pagePitch = m_pageSize * 4;
+  const unsigned int width = image.width * 4;
+  for (int row = -(int)PADDING; row < (int)(image.height + PADDING); row++)
+  {
+    int srcRow = std::max(0, std::min((int)image.height - 1, row));
+    const unsigned char *src = pixels + srcRow * pitch;
+    unsigned char *dst = page + (image.y + row) * pagePitch + image.x * 4;
+
+    memcpy(dst, src, width);
+    for (unsigned int i = 1; i <= PADDING; i++)
+    {
+      memcpy(dst - i * 4, src, 4);
+      memcpy(dst + width + (i - 1) * 4, src + width - 4, 4);
+    }
+  }
+}
+
+const CTextureAtlas::CImage *CTextureAtlas::Find(const string &name) const
+{
+  IMAGES::const_iterator it = m_images.find(name);
+  if (it == m_images.end())
+    return NULL;
+  return &it->second;
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <map>
+#include <string>
+#include <vector>
+
+/*!
+ \ingroup textures
+ \brief Layout of small images on the pages of a texture atlas
+
+ Small skin images are placed next to each other on a few large pages instead
+ of each getting a texture of its own. Images are packed on shelves, highest
+ first, and each one is surrounded by a border of its repeated edge pixels so
+ that filtering never picks up its neighbours.
+
+ The layout only deals with sizes and 32 bit pixels, creating the textures of
+ the pages is left to the caller.
+ */
+class CTextureAtlas
+{
+public:
+  static const unsigned int PAGE_SIZE = 1024; ///< width and height of a page
+  static const unsigned int MAX_PAGES = 4;    ///< images that don't fit on these are left out
+  static const unsigned int MAX_SIZE  = 128;  ///< images wider or higher than this are left out
+  static const unsigned int PADDING   = 1;    ///< border of repeated edge pixels around each image
+
+  struct CImage
+  {
+    CImage() : width(0), height(0), page(0), x(0), y(0) {}
+    CImage(const std::string &name, unsigned int width, unsigned int height)
+      : name(name), width(width), height(height), page(0), x(0), y(0) {}
+    std::string  name;
+    unsigned int width;
+    unsigned int height;
+    unsigned int page;  ///< page the image is placed on
+    unsigned int x;     ///< position of the image on its page, inside the padding
+    unsigned int y;
+  };
+  typedef std::map<std::string, CImage> IMAGES;
+
+  CTextureAtlas(unsigned int pageSize = PAGE_SIZE, unsigned int maxPages = MAX_PAGES);
+
+  /*! \brief Place images on the pages, replacing the current layout
+   Only the name and size of the images are used. Images larger than MAX_SIZE
+   or left over once all pages are full aren't placed.
+   \param images the images to place
+   */
+  void Pack(const std::vector<CImage> &images);
+
+  /*! \brief Store the layout to restore it with Load()
+   \param data [out] the layout
+   */
+  void Save(std::string &data) const;
+
+  /*! \brief Restore a layout stored by Save()
+   The layout is only taken if it was made for exactly the given images, so
+   that a changed skin is packed again.
+   \param data the stored layout
+   \param images the images that are to be placed
+   \return true if the layout was restored, false if it is invalid or for other images
+   */
+  bool Load(const std::string &data, const std::vector<CImage> &images);
+
+  /*! \brief Copy the pixels of a placed image onto its page
+   The edge pixels are repeated into the padding around the image.
+   \param page 32 bit pixels of the page, GetPageSize() * 4 bytes per row
+   \param image the placed image
+   \param pixels 32 bit pixels of the image
+   \param pitch bytes per row of the image
+   */
+  void Blit(unsigned char *page, const CImage &image, const unsigned char *pixels, unsigned int pitch) const;
+
+  /*! \brief Find a placed image
+   \param name the name of the image
+   \return the image, or NULL if it isn't on a page
+   */
+  const CImage *Find(const std::string &name) const;
+
+  const IMAGES &GetImages() const { return m_images; }
+  unsigned int GetPageCount() const { return m_pageCount; }
+  unsigned int GetPageSize() const { return m_pageSize; }
+  void Clear();
+
+private:
+  bool IsPackable(const CImage &image) const;
+
+  unsigned int m_pageSize;
+  unsigned int m_maxPages;
+  unsigned int m_pageCount;
+  IMAGES       m_images;   ///< images placed on the pages
+  IMAGES       m_leftOut;  ///< images that would have been placed if there were more pages
+};
@@ -103,6 +103,25 @@ int CTextureBundle::LoadAnim(const CStdString& Filename, CBaseTexture*** ppTextu
   }
 }
 
+void CTextureBundle::GetAtlasImages(unsigned int maxSize, std::vector<CTextureAtlas::CImage> &images)
+{
+  // only xbt bundles have uncompressed textures
+  if (m_useXPR)
+    return;
+
+  size_t count = images.size();
+  m_tbXBT.GetAtlasImages(maxSize, images);
+  if (images.size() > count)
+    m_useXBT = true;
+}
+
+unsigned char *CTextureBundle::LoadPixels(const CStdString& Filename)
+{
+  if (m_useXBT)
+    return m_tbXBT.LoadPixels(Filename);
+  return NULL;
+}
+
 void CTextureBundle::Cleanup()
 {
   m_tbXBT.Cleanup();
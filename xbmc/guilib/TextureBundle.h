@@ -41,6 +41,9 @@ public:
 
   int LoadAnim(const CStdString& Filename, CBaseTexture*** ppTextures, int &width, int &height, int& nLoops, int** ppDelays);
 
+  void GetAtlasImages(unsigned int maxSize, std::vector<CTextureAtlas::CImage> &images);
+  unsigned char *LoadPixels(const CStdString& Filename);
+
 private:
   CTextureBundleXPR m_tbXPR;
   CTextureBundleXBT m_tbXBT;
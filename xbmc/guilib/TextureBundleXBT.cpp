@@ -192,14 +192,41 @@ int CTextureBundleXBT::LoadAnim(const CStdString& Filename, CBaseTexture*** ppTe
   return nTextures;
 }
 
-bool CTextureBundleXBT::ConvertFrameToTexture(const CStdString& name, CXBTFFrame& frame, CBaseTexture** ppTexture)
+void CTextureBundleXBT::GetAtlasImages(unsigned int maxSize, std::vector<CTextureAtlas::CImage> &images)
+{
+  if (!m_XBTFReader.IsOpen() && !OpenBundle())
+    return;
+
+  std::vector<CXBTFFile>& files = m_XBTFReader.GetFiles();
+  for (size_t i = 0; i < files.size(); i++)
+  {
+    // animations keep their frames on textures of their own
+    if (files[i].GetFrames().size() != 1)
+      continue;
+
+    CXBTFFrame& frame = files[i].GetFrames()[0];
+    if (frame.GetFormat() == XB_FMT_A8R8G8B8 && frame.GetWidth() <= maxSize && frame.GetHeight() <= maxSize)
+      images.push_back(CTextureAtlas::CImage(files[i].GetPath(), frame.GetWidth(), frame.GetHeight()));
+  }
+}
+
+unsigned char *CTextureBundleXBT::LoadPixels(const CStdString& Filename)
+{
+  CXBTFFile* file = m_XBTFReader.Find(Normalize(Filename));
+  if (!file || file->GetFrames().size() != 1 || file->GetFrames()[0].GetFormat() != XB_FMT_A8R8G8B8)
+    return NULL;
+
+  return LoadFrame(Filename, file->GetFrames()[0]);
+}
+
+unsigned char *CTextureBundleXBT::LoadFrame(const CStdString& name, CXBTFFrame& frame)
 {
   // found texture - allocate the necessary buffers
   squish::u8 *buffer = new squish::u8[(size_t)frame.GetPackedSize()];
   if (buffer == NULL)
   {
     CLog::Log(LOGERROR, "Out of memory loading texture: %s (need %"PRIu64" bytes)", name.c_str(), frame.GetPackedSize());
-    return false;
+    return NULL;
   }
 
   // load the compressed texture
@@ -207,7 +234,7 @@ bool CTextureBundleXBT::ConvertFrameToTexture(const CStdString& name, CXBTFFrame
   {
     CLog::Log(LOGERROR, "Error loading texture: %s", name.c_str());
     delete[] buffer;
-    return false;
+    return NULL;
   }
 
   // check if it's packed with lzo
@@ -218,7 +245,7 @@ bool CTextureBundleXBT::ConvertFrameToTexture(const CStdString& name, CXBTFFrame
     {
       CLog::Log(LOGERROR, "Out of memory unpacking texture: %s (need %"PRIu64" bytes)", name.c_str(), frame.GetUnpackedSize());
       delete[] buffer;
-      return false;
+      return NULL;
     }
     lzo_uint s = (lzo_uint)frame.GetUnpackedSize();
     if (lzo1x_decompress_safe(buffer, (lzo_uint)frame.GetPackedSize(), unpacked, &s, NULL) != LZO_E_OK ||
@@ -227,11 +254,19 @@ bool CTextureBundleXBT::ConvertFrameToTexture(const CStdString& name, CXBTFFrame
       CLog::Log(LOGERROR, "Error loading texture: %s: Decompression error", name.c_str());
       delete[] buffer;
       delete[] unpacked;
-      return false;
+      return NULL;
     }
     delete[] buffer;
     buffer = unpacked;
   }
+  return buffer;
+}
+
+bool CTextureBundleXBT::ConvertFrameToTexture(const CStdString& name, CXBTFFrame& frame, CBaseTexture** ppTexture)
+{
+  unsigned char *buffer = LoadFrame(name, frame);
+  if (!buffer)
+    return false;
 
   // create an xbmc texture
   *ppTexture = new CTexture();
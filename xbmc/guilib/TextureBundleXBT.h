@@ -23,6 +23,7 @@
 #include "utils/StdString.h"
 #include <map>
 #include "XBTFReader.h"
+#include "TextureAtlas.h"
 
 class CBaseTexture;
 
@@ -44,8 +45,19 @@ public:
   int LoadAnim(const CStdString& Filename, CBaseTexture*** ppTextures,
                 int &width, int &height, int& nLoops, int** ppDelays);
 
+  /*! \brief Get the textures that can go on a texture atlas
+   These are the single frame, uncompressed 32 bit textures that are no larger than maxSize.
+   */
+  void GetAtlasImages(unsigned int maxSize, std::vector<CTextureAtlas::CImage> &images);
+
+  /*! \brief Load the pixels of a texture returned by GetAtlasImages()
+   \return the pixels, width * 4 bytes per row, to be freed with delete[] by the caller. NULL on failure.
+   */
+  unsigned char *LoadPixels(const CStdString& Filename);
+
 private:
   bool OpenBundle();
+  unsigned char *LoadFrame(const CStdString& name, CXBTFFrame& frame);
   bool ConvertFrameToTexture(const CStdString& name, CXBTFFrame& frame, CBaseTexture** ppTexture);
 
   time_t m_TimeStamp;
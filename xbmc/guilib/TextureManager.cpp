@@ -27,14 +27,14 @@
 #include "utils/URIUtils.h"
 #include "utils/StringUtils.h"
 #include "addons/Skin.h"
-#ifdef _DEBUG
 #include "utils/TimeUtils.h"
-#endif
 #include "threads/SystemClock.h"
 #include "filesystem/File.h"
 #include "filesystem/Directory.h"
 #include "URL.h"
 #include <assert.h>
+#include <map>
+#include <string.h>
 
 using namespace std;
 
@@ -50,6 +50,8 @@ CTextureArray::CTextureArray(int width, int height, int loops,  bool texCoordsAr
   m_orientation = 0;
   m_texWidth = 0;
   m_texHeight = 0;
+  m_texX = 0;
+  m_texY = 0;
   m_texCoordsArePixels = false;
 }
 
@@ -79,6 +81,8 @@ void CTextureArray::Reset()
   m_orientation = 0;
   m_texWidth = 0;
   m_texHeight = 0;
+  m_texX = 0;
+  m_texY = 0;
   m_texCoordsArePixels = false;
 }
 
@@ -92,6 +96,8 @@ void CTextureArray::Add(CBaseTexture *texture, int delay)
 
   m_texWidth = texture->GetTextureWidth();
   m_texHeight = texture->GetTextureHeight();
+  m_texX = 0;
+  m_texY = 0;
   m_texCoordsArePixels = false;
 }
 
@@ -128,6 +134,7 @@ CTextureMap::CTextureMap()
   m_textureName = "";
   m_referenceCount = 0;
   m_memUsage = 0;
+  m_atlasImage = false;
 }
 
 CTextureMap::CTextureMap(const CStdString& textureName, int width, int height, int loops)
@@ -136,6 +143,7 @@ CTextureMap::CTextureMap(const CStdString& textureName, int width, int height, i
   m_textureName = textureName;
   m_referenceCount = 0;
   m_memUsage = 0;
+  m_atlasImage = false;
 }
 
 CTextureMap::~CTextureMap()
@@ -192,7 +200,11 @@ void CTextureMap::Flush()
 
 void CTextureMap::FreeTexture()
 {
-  m_texture.Free();
+  // atlas pages are freed by the texture manager
+  if (m_atlasImage)
+    m_texture.Reset();
+  else
+    m_texture.Free();
 }
 
 bool CTextureMap::IsEmpty() const
@@ -208,6 +220,15 @@ void CTextureMap::Add(CBaseTexture* texture, int delay)
     m_memUsage += sizeof(CTexture) + (texture->GetTextureWidth() * texture->GetTextureHeight() * 4);
 }
 
+void CTextureMap::SetAtlasImage(CBaseTexture* page, int x, int y)
+{
+  assert(!m_texture.m_textures.size());
+  m_texture.Add(page, 100);
+  m_texture.m_texX = x;
+  m_texture.m_texY = y;
+  m_atlasImage = true;
+}
+
 /************************************************************************/
 /*                                                                      */
 /************************************************************************/
@@ -321,6 +342,18 @@ const CTextureArray& CGUITextureManager::Load(const CStdString& strTextureName,
   start = CurrentHostCounter();
 #endif
 
+  if (bundle >= 0)
+  {
+    const CTextureAtlas::CImage *image = m_atlas.Find(CTextureBundle::Normalize(strTextureName));
+    if (image && image->page < m_atlasPages.size())
+    {
+      CTextureMap* pMap = new CTextureMap(strTextureName, image->width, image->height, 0);
+      pMap->SetAtlasImage(m_atlasPages[image->page], image->x, image->y);
+      m_vecTextures.push_back(pMap);
+      return pMap->GetTexture();
+    }
+  }
+
   if (StringUtils::EndsWithNoCase(strPath, ".gif"))
   {
     CTextureMap* pMap;
@@ -506,6 +539,97 @@ void CGUITextureManager::Cleanup()
   for (int i = 0; i < 2; i++)
     m_TexBundle[i].Cleanup();
   FreeUnusedTextures();
+  FreeAtlas();
+}
+
+void CGUITextureManager::LoadAtlas(const std::string &cacheFile)
+{
+  CSingleLock lock(g_graphicsContext);
+  FreeAtlas();
+
+  // the theme comes first, like in HasTexture(), so skin textures it replaces are left out
+  std::vector<CTextureAtlas::CImage> images;
+  std::map<std::string, int> bundles;
+  for (int i = 0; i < 2; i++)
+  {
+    std::vector<CTextureAtlas::CImage> bundled;
+    m_TexBundle[i].GetAtlasImages(CTextureAtlas::MAX_SIZE, bundled);
+    for (std::vector<CTextureAtlas::CImage>::const_iterator it = bundled.begin(); it != bundled.end(); ++it)
+    {
+      if (i > 0 && m_TexBundle[0].HasFile(it->name))
+        continue;
+      if (bundles.insert(make_pair(it->name, i)).second)
+        images.push_back(*it);
+    }
+  }
+  if (images.empty())
+    return;
+
+  int64_t start = CurrentHostCounter();
+
+  bool cached = false;
+  if (!cacheFile.empty() && XFILE::CFile::Exists(cacheFile))
+  {
+    XFILE::CFile file;
+    XFILE::auto_buffer buffer;
+    if (file.LoadFile(cacheFile, buffer) > 0)
+      cached = m_atlas.Load(std::string(buffer.get(), buffer.size()), images);
+  }
+  if (!cached)
+  {
+    m_atlas.Pack(images);
+    if (!cacheFile.empty())
+    {
+      std::string data;
+      m_atlas.Save(data);
+      XFILE::CFile file;
+      if (!file.OpenForWrite(cacheFile, true) || file.Write(data.c_str(), data.size()) != (int)data.size())
+        CLog::Log(LOGERROR, "%s - unable to write %s", __FUNCTION__, cacheFile.c_str());
+    }
+  }
+
+  // draw the pages, they are loaded to the GPU when first used
+  const unsigned int pageSize = m_atlas.GetPageSize();
+  std::vector<unsigned char*> pages;
+  for (unsigned int i = 0; i < m_atlas.GetPageCount(); i++)
+  {
+    pages.push_back(new unsigned char[pageSize * pageSize * 4]);
+    memset(pages.back(), 0, pageSize * pageSize * 4);
+  }
+
+  const CTextureAtlas::IMAGES &placed = m_atlas.GetImages();
+  for (CTextureAtlas::IMAGES::const_iterator it = placed.begin(); it != placed.end(); ++it)
+  {
+    unsigned char *pixels = m_TexBundle[bundles[it->first]].LoadPixels(it->first);
+    if (!pixels)
+    {
+      CLog::Log(LOGERROR, "Texture manager unable to load bundled file: %s", it->first.c_str());
+      continue;
+    }
+    m_atlas.Blit(pages[it->second.page], it->second, pixels, it->second.width * 4);
+    delete[] pixels;
+  }
+
+  for (unsigned int i = 0; i < pages.size(); i++)
+  {
+    CTexture *page = new CTexture();
+    page->LoadFromMemory(pageSize, pageSize, pageSize * 4, XB_FMT_A8R8G8B8, true, pages[i]);
+    m_atlasPages.push_back(page);
+    delete[] pages[i];
+  }
+
+  CLog::Log(LOGDEBUG, "%s - %u of %u textures on %u pages%s in %.2fms", __FUNCTION__,
+            (unsigned int)placed.size(), (unsigned int)images.size(), (unsigned int)m_atlasPages.size(),
+            cached ? " (cached layout)" : "", 1000.f * (CurrentHostCounter() - start) / CurrentHostFrequency());
+}
+
+void CGUITextureManager::FreeAtlas()
+{
+  CSingleLock lock(g_graphicsContext);
+  for (unsigned int i = 0; i < m_atlasPages.size(); i++)
+    delete m_atlasPages[i];
+  m_atlasPages.clear();
+  m_atlas.Clear();
 }
 
 void CGUITextureManager::Dump() const
@@ -550,6 +674,8 @@ unsigned int CGUITextureManager::GetMemoryUsage() const
   {
     memUsage += m_vecTextures[i]->GetMemoryUsage();
   }
+  for (unsigned int i = 0; i < m_atlasPages.size(); i++)
+    memUsage += sizeof(CTexture) + (m_atlasPages[i]->GetTextureWidth() * m_atlasPages[i]->GetTextureHeight() * 4);
   return memUsage;
 }
 
@@ -28,6 +28,7 @@
 
 #include <vector>
 #include <list>
+#include "TextureAtlas.h"
 #include "TextureBundle.h"
 #include "threads/CriticalSection.h"
 
@@ -59,6 +60,8 @@ public:
   int m_loops;
   int m_texWidth;
   int m_texHeight;
+  int m_texX;     ///< position of the image on its texture, for images on an atlas page
+  int m_texY;
   bool m_texCoordsArePixels;
 };
 
@@ -77,6 +80,7 @@ public:
   virtual ~CTextureMap();
 
   void Add(CBaseTexture* texture, int delay);
+  void SetAtlasImage(CBaseTexture* page, int x, int y); ///< Use an image on an atlas page, the page isn't owned
   bool Release();
 
   const CStdString& GetName() const;
@@ -92,6 +96,7 @@ protected:
   CTextureArray m_texture;
   unsigned int m_referenceCount;
   uint32_t m_memUsage;
+  bool m_atlasImage;
 };
 
 /*!
@@ -124,7 +129,15 @@ public:
 
   void FreeUnusedTextures(unsigned int timeDelay = 0); ///< Free textures (called from app thread only)
   void ReleaseHwTexture(unsigned int texture);
+
+  /*! \brief Put the small bundled textures on the pages of a texture atlas
+   Called once the skin's media dir is set, the atlas is dropped by Cleanup().
+   \param cacheFile file to keep the layout of the atlas in. Empty for no cache.
+   */
+  void LoadAtlas(const std::string &cacheFile);
 protected:
+  void FreeAtlas();
+
   std::vector<CTextureMap*> m_vecTextures;
   std::list<std::pair<CTextureMap*, unsigned int> > m_unusedTextures;
   std::vector<unsigned int> m_unusedHwTextures;
@@ -132,6 +145,8 @@ protected:
   typedef std::list<std::pair<CTextureMap*, unsigned int> >::iterator ilistUnused;
   // we have 2 texture bundles (one for the base textures, one for the theme)
   CTextureBundle m_TexBundle[2];
+  CTextureAtlas m_atlas;
+  std::vector<CBaseTexture*> m_atlasPages;
 
   std::vector<CStdString> m_texturePaths;
   CCriticalSection m_section;
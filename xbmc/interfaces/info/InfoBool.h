@@ -27,6 +27,22 @@ class CGUIListItem;
 
 namespace INFO
 {
+/*!
+ \brief Inputs an info bool depends on, used to only set dirty the bools that may have changed
+ \sa CGUIInfoManager::ResetCache
+ */
+enum InfoDependency
+{
+  DEPENDS_NONE    = 0,          ///< constant while the skin is loaded, e.g. the platform
+  DEPENDS_FRAME   = 1 << 0,     ///< inputs that can't be told to have changed, updated every frame
+  DEPENDS_SKIN    = 1 << 1,     ///< skin settings and theme
+  DEPENDS_LIBRARY = 1 << 2,     ///< library content
+  DEPENDS_PLAYER  = 1 << 3,     ///< what the player plays, its pause state and speed
+  DEPENDS_WINDOW  = 1 << 4,     ///< active windows and dialogs, their focus and properties
+  DEPENDS_TIME    = 1 << 5,     ///< date and time of day, to the minute
+  DEPENDS_ALL     = 0xffffffff  ///< every info bool, whatever its dependencies
+};
+
 /*!
  \ingroup info
  \brief Base class, wrapping boolean conditions and expressions
@@ -54,8 +70,9 @@ public:
       Update(item);
     else if (m_dirty)
     {
-      Update(NULL);
+      // cleared first, so being set dirty by another thread while updating isn't lost
       m_dirty = false;
+      Update(NULL);
     }
     return m_value;
   }
@@ -73,11 +90,13 @@ public:
 
   const std::string &GetExpression() const { return m_expression; }
   bool ListItemDependent() const { return m_listItemDependent; }
+  unsigned int GetDependencies() const { return m_dependencies; }
 protected:
 
   bool m_value;                ///< current value
   int m_context;               ///< contextual information to go with the condition
   bool m_listItemDependent;    ///< do not cache if a listitem pointer is given
+  unsigned int m_dependencies; ///< InfoDependency flags of the inputs of the value
 
 private:
   std::string  m_expression;   ///< original expression
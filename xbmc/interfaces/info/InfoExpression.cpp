@@ -30,6 +30,7 @@ InfoSingle::InfoSingle(const std::string &expression, int context)
 : InfoBool(expression, context)
 {
   m_condition = g_infoManager.TranslateSingleString(expression, m_listItemDependent);
+  m_dependencies = g_infoManager.GetDependencies(m_condition);
 }
 
 void InfoSingle::Update(const CGUIListItem *item)
@@ -45,7 +46,7 @@ InfoExpression::InfoExpression(const std::string &expression, int context)
 
 void InfoExpression::Update(const CGUIListItem *item)
 {
-  Evaluate(item, m_value);
+  m_value = Evaluate(item);
 }
 
 #define OPERATOR_LB   5
@@ -72,6 +73,8 @@ short InfoExpression::GetOperator(const char ch) const
 
 void InfoExpression::Parse(const std::string &expression)
 {
+  vector<short> postfix;
+  m_dependencies = DEPENDS_NONE;
   stack<char> operators;
   std::string operand;
   for (unsigned int i = 0; i < expression.size(); i++)
@@ -85,7 +88,8 @@ void InfoExpression::Parse(const std::string &expression)
         if (info)
         {
           m_listItemDependent |= info->ListItemDependent();
-          m_postfix.push_back(m_operands.size());
+          m_dependencies |= info->GetDependencies();
+          postfix.push_back(m_operands.size());
           m_operands.push_back(info);
         }
         operand.clear();
@@ -101,7 +105,7 @@ void InfoExpression::Parse(const std::string &expression)
           if (oper == '[')
             break;
 
-          m_postfix.push_back(-GetOperator(oper)); // negative denotes operator
+          postfix.push_back(-GetOperator(oper)); // negative denotes operator
         }
       }
       else
@@ -114,7 +118,7 @@ void InfoExpression::Parse(const std::string &expression)
           if (operators.top() == '[' && expression[i] != ']')
             break;
 
-          m_postfix.push_back(-GetOperator(operators.top()));  // negative denotes operator
+          postfix.push_back(-GetOperator(operators.top()));  // negative denotes operator
           operators.pop();
         }
         operators.push(expression[i]);
@@ -132,7 +136,8 @@ void InfoExpression::Parse(const std::string &expression)
     if (info)
     {
       m_listItemDependent |= info->ListItemDependent();
-      m_postfix.push_back(m_operands.size());
+      m_dependencies |= info->GetDependencies();
+      postfix.push_back(m_operands.size());
       m_operands.push_back(info);
     }
   }
@@ -140,49 +145,76 @@ void InfoExpression::Parse(const std::string &expression)
   // finish up by adding any operators
   while (!operators.empty())
   {
-    m_postfix.push_back(-GetOperator(operators.top()));  // negative denotes operator
+    postfix.push_back(-GetOperator(operators.top()));  // negative denotes operator
     operators.pop();
   }
 
-  // test evaluate
-  bool test;
-  if (!Evaluate(NULL, test))
+  if (!Compile(postfix))
     CLog::Log(LOGERROR, "Error evaluating boolean expression %s", expression.c_str());
 }
 
-bool InfoExpression::Evaluate(const CGUIListItem *item, bool &result)
+bool InfoExpression::Compile(const vector<short> &postfix)
 {
-  stack<bool> save;
-  for (vector<short>::const_iterator it = m_postfix.begin(); it != m_postfix.end(); ++it)
+  // code of each subexpression, and whether its value is cached between frames
+  stack< pair<Program, bool> > code;
+  for (vector<short>::const_iterator it = postfix.begin(); it != postfix.end(); ++it)
   {
     short expr = *it;
     if (expr == -OPERATOR_NOT)
-    { // NOT the top item on the stack
-      if (save.empty()) return false;
-      bool expr = save.top();
-      save.pop();
-      save.push(!expr);
+    {
+      if (code.empty()) return false;
+      code.top().first.push_back(Instruction(Instruction::NOT));
     }
-    else if (expr == -OPERATOR_AND)
-    { // AND the top two items on the stack
-      if (save.size() < 2) return false;
-      bool right = save.top(); save.pop();
-      bool left = save.top(); save.pop();
-      save.push(left && right);
+    else if (expr == -OPERATOR_AND || expr == -OPERATOR_OR)
+    {
+      if (code.size() < 2) return false;
+      pair<Program, bool> right = code.top(); code.pop();
+      pair<Program, bool> &left = code.top();
+      // both orders give the same result, have the cached side spare the other
+      if (right.second && !left.second)
+        swap(left, right);
+      left.first.push_back(Instruction(expr == -OPERATOR_AND ? Instruction::JUMP_IF_FALSE : Instruction::JUMP_IF_TRUE, right.first.size()));
+      left.first.insert(left.first.end(), right.first.begin(), right.first.end());
+      left.second = left.second && right.second;
     }
-    else if (expr == -OPERATOR_OR)
-    { // OR the top two items on the stack
-      if (save.size() < 2) return false;
-      bool right = save.top(); save.pop();
-      bool left = save.top(); save.pop();
-      save.push(left || right);
+    else if (expr >= 0 && expr < (short)m_operands.size())
+    {
+      const InfoPtr &operand = m_operands[expr];
+      bool cached = !(operand->GetDependencies() & DEPENDS_FRAME) && !operand->ListItemDependent();
+      code.push(make_pair(Program(1, Instruction(Instruction::LOAD, expr)), cached));
     }
-    else  // operand
-      save.push(m_operands[expr]->Get(item));
+    else
+      return false;
   }
-  if (save.size() != 1)
+  if (code.size() != 1)
     return false;
-  result = save.top();
+  m_program = code.top().first;
   return true;
 }
 
+bool InfoExpression::Evaluate(const CGUIListItem *item) const
+{
+  bool result = false;
+  for (size_t i = 0; i < m_program.size(); i++)
+  {
+    const Instruction &instruction = m_program[i];
+    switch (instruction.op)
+    {
+      case Instruction::LOAD:
+        result = m_operands[instruction.arg]->Get(item);
+        break;
+      case Instruction::NOT:
+        result = !result;
+        break;
+      case Instruction::JUMP_IF_FALSE:
+        if (!result)
+          i += instruction.arg;
+        break;
+      case Instruction::JUMP_IF_TRUE:
+        if (result)
+          i += instruction.arg;
+        break;
+    }
+  }
+  return result;
+}
@@ -50,11 +50,25 @@ public:
 
   virtual void Update(const CGUIListItem *item);
 private:
+  /*! \brief Instruction of the compiled expression.
+   The compiled expression works on a single value, AND and OR jump over their
+   right operand once the left one decides the result, so it isn't evaluated.
+   */
+  struct Instruction
+  {
+    enum Op { LOAD, NOT, JUMP_IF_FALSE, JUMP_IF_TRUE };
+    Instruction(Op o, unsigned short a = 0) : op(o), arg(a) {};
+    Op op;
+    unsigned short arg;                 ///< operand index for LOAD, instructions to skip for jumps
+  };
+  typedef std::vector<Instruction> Program;
+
   void Parse(const std::string &expression);
-  bool Evaluate(const CGUIListItem *item, bool &result);
+  bool Compile(const std::vector<short> &postfix);
+  bool Evaluate(const CGUIListItem *item) const;
   short GetOperator(const char ch) const;
 
-  std::vector<short> m_postfix;         ///< the postfix form of the expression (operators and operand indicies)
+  Program m_program;                    ///< the compiled form of the expression
   std::vector<InfoPtr> m_operands;      ///< the operands in the expression
 };
 
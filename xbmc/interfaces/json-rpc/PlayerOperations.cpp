@@ -44,6 +44,7 @@
 #include "pvr/channels/PVRChannelGroupsContainer.h"
 #include "cores/IPlayer.h"
 #include "settings/MediaSettings.h"
+#include "cores/VideoRenderers/RenderManager.h"
 
 using namespace JSONRPC;
 using namespace PLAYLIST;
@@ -226,6 +227,49 @@ JSONRPC_STATUS CPlayerOperations::GetItem(const CStdString &method, ITransportLa
   return OK;
 }
 
+JSONRPC_STATUS CPlayerOperations::GetRenderStatistics(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
+{
+  switch (GetPlayer(parameterObject["playerid"]))
+  {
+    case Video:
+    {
+      SRenderStatistics stats;
+      g_renderManager.GetRenderStatistics(stats, parameterObject["reset"].asBoolean());
+
+      result["frames"]   = stats.frames;
+      result["repeated"] = stats.repeated;
+      result["dropped"]["late"]    = stats.dropped[RENDER_DROP_LATE];
+      result["dropped"]["flush"]   = stats.dropped[RENDER_DROP_FLUSH];
+      result["dropped"]["decoder"] = stats.dropped[RENDER_DROP_DECODER];
+      result["queuedepth"] = stats.queueDepth;
+
+      const struct { const char *name; const SRenderDistribution *dist; } distributions[] = {
+        { "presenterror", &stats.presentError },
+        { "jitter",       &stats.jitter       },
+        { "bufferwait",   &stats.bufferWait   },
+        { "queuewait",    &stats.queueWait    },
+        { "latency",      &stats.latency      }
+      };
+      for (unsigned int i = 0; i < sizeof(distributions) / sizeof(distributions[0]); i++)
+      {
+        CVariant &dist = result[distributions[i].name];
+        dist["mean"]   = distributions[i].dist->mean;
+        dist["median"] = distributions[i].dist->median;
+        dist["p95"]    = distributions[i].dist->p95;
+        dist["p99"]    = distributions[i].dist->p99;
+        dist["max"]    = distributions[i].dist->max;
+      }
+      return OK;
+    }
+
+    case Audio:
+    case Picture:
+    case None:
+    default:
+      return FailedToExecute;
+  }
+}
+
 JSONRPC_STATUS CPlayerOperations::PlayPause(const CStdString &method, ITransportLayer *transport, IClient *client, const CVariant &parameterObject, CVariant &result)
 {
   CGUIWindowSlideShow *slideshow = NULL;
@@ -22,7 +22,7 @@
 namespace JSONRPC
 {
   const char* const JSONRPC_SERVICE_ID          = "http://xbmc.org/jsonrpc/ServiceDescription.json";
-  const char* const JSONRPC_SERVICE_VERSION     = "6.14.1";
+  const char* const JSONRPC_SERVICE_VERSION     = "6.15.0";
   const char* const JSONRPC_SERVICE_DESCRIPTION = "JSON-RPC API of XBMC";
 
   const char* const JSONRPC_SERVICE_TYPES[] = {  
@@ -221,6 +221,36 @@ namespace JSONRPC
         "\"speed\": { \"type\": \"integer\" }"
       "}"
     "}",
+    "\"Player.RenderStatistics.Distribution\": {"
+      "\"type\": \"object\","
+      "\"properties\": {"
+        "\"mean\": { \"type\": \"number\", \"required\": true },"
+        "\"median\": { \"type\": \"number\", \"required\": true },"
+        "\"p95\": { \"type\": \"number\", \"required\": true },"
+        "\"p99\": { \"type\": \"number\", \"required\": true },"
+        "\"max\": { \"type\": \"number\", \"required\": true }"
+      "}"
+    "}",
+    "\"Player.RenderStatistics\": {"
+      "\"type\": \"object\","
+      "\"properties\": {"
+        "\"frames\": { \"type\": \"integer\", \"minimum\": 0, \"required\": true },"
+        "\"repeated\": { \"type\": \"integer\", \"minimum\": 0, \"required\": true },"
+        "\"dropped\": { \"type\": \"object\", \"required\": true,"
+          "\"properties\": {"
+            "\"late\": { \"type\": \"integer\", \"minimum\": 0, \"required\": true },"
+            "\"flush\": { \"type\": \"integer\", \"minimum\": 0, \"required\": true },"
+            "\"decoder\": { \"type\": \"integer\", \"minimum\": 0, \"required\": true }"
+          "}"
+        "},"
+        "\"queuedepth\": { \"type\": \"number\", \"minimum\": 0.0, \"required\": true },"
+        "\"presenterror\": { \"$ref\": \"Player.RenderStatistics.Distribution\", \"required\": true },"
+        "\"jitter\": { \"$ref\": \"Player.RenderStatistics.Distribution\", \"required\": true },"
+        "\"bufferwait\": { \"$ref\": \"Player.RenderStatistics.Distribution\", \"required\": true },"
+        "\"queuewait\": { \"$ref\": \"Player.RenderStatistics.Distribution\", \"required\": true },"
+        "\"latency\": { \"$ref\": \"Player.RenderStatistics.Distribution\", \"required\": true }"
+      "}"
+    "}",
     "\"Player.Repeat\": {"
       "\"type\": \"string\","
       "\"enum\": [ \"off\", \"one\", \"all\" ]"
@@ -1927,6 +1957,17 @@ namespace JSONRPC
         "}"
       "}"
     "}",
+    "\"Player.GetRenderStatistics\": {"
+      "\"type\": \"method\","
+      "\"description\": \"Retrieves frame pacing statistics of the video being rendered, times are in milliseconds\","
+      "\"transport\": \"Response\","
+      "\"permission\": \"ReadData\","
+      "\"params\": ["
+        "{ \"name\": \"playerid\", \"$ref\": \"Player.Id\", \"required\": true },"
+        "{ \"name\": \"reset\", \"type\": \"boolean\", \"default\": false, \"description\": \"Start collecting new statistics after returning these\" }"
+      "],"
+      "\"returns\": { \"$ref\": \"Player.RenderStatistics\" }"
+    "}",
     "\"Player.PlayPause\": {"
       "\"type\": \"method\","
       "\"description\": \"Pauses or unpause playback and returns the new state\","
@@ -66,6 +66,7 @@
 #include "utils/XMLUtils.h"
 #include "URL.h"
 #include "playlists/SmartPlayList.h"
+#include "cores/AudioEngine/Utils/AELoudnessMeter.h"
 
 using namespace std;
 using namespace AUTOPTR;
@@ -80,6 +81,18 @@ using ADDON::AddonPtr;
 using namespace CDDB;
 #endif
 
+/* gains are stored in hundredths of a dB relative to the ReplayGain 2.0
+   reference level, like the values read from the file tags */
+#define REPLAY_GAIN_REFERENCE_LOUDNESS -18.0
+#define REPLAY_GAIN_MAX_GAIN            51.0
+
+static int LoudnessToGain(double loudness)
+{
+  double gain = REPLAY_GAIN_REFERENCE_LOUDNESS - loudness;
+  gain = std::max(-REPLAY_GAIN_MAX_GAIN, std::min(REPLAY_GAIN_MAX_GAIN, gain));
+  return (int)floor(gain * 100.0 + 0.5);
+}
+
 static void AnnounceRemove(const std::string& content, int id)
 {
   CVariant data;
@@ -173,6 +186,10 @@ void CMusicDatabase::CreateTables()
   CLog::Log(LOGINFO, "create art table");
   m_pDS->exec("CREATE TABLE art(art_id INTEGER PRIMARY KEY, media_id INTEGER, media_type TEXT, type TEXT, url TEXT)");
 
+  CLog::Log(LOGINFO, "create songloudness table");
+  m_pDS->exec("CREATE TABLE songloudness (idSong integer primary key, fLoudness real, "
+              " iTrackGain integer, fTrackPeak real, iAlbumGain integer, fAlbumPeak real)");
+
   // Add 'Karaoke' genre
   AddGenre( "Karaoke" );
 }
@@ -239,6 +256,7 @@ void CMusicDatabase::CreateAnalytics()
               "  DELETE FROM song_artist WHERE song_artist.idSong = old.idSong;"
               "  DELETE FROM song_genre WHERE song_genre.idSong = old.idSong;"
               "  DELETE FROM karaokedata WHERE karaokedata.idSong = old.idSong;"
+              "  DELETE FROM songloudness WHERE songloudness.idSong = old.idSong;"
               "  DELETE FROM art WHERE media_id=old.idSong AND media_type='song';"
               " END");
 
@@ -266,14 +284,17 @@ void CMusicDatabase::CreateViews()
               "        strPath, "
               "        iKaraNumber, iKaraDelay, strKaraEncoding,"
               "        album.bCompilation AS bCompilation,"
-              "        album.strArtists AS strAlbumArtists "
+              "        album.strArtists AS strAlbumArtists,"
+              "        iTrackGain, fTrackPeak, iAlbumGain, fAlbumPeak "
               "FROM song"
               "  JOIN album ON"
               "    song.idAlbum=album.idAlbum"
               "  JOIN path ON"
               "    song.idPath=path.idPath"
               "  LEFT OUTER JOIN karaokedata ON"
-              "    song.idSong=karaokedata.idSong");
+              "    song.idSong=karaokedata.idSong"
+              "  LEFT OUTER JOIN songloudness ON"
+              "    song.idSong=songloudness.idSong");
 
   CLog::Log(LOGINFO, "create album view");
   m_pDS->exec("CREATE VIEW albumview AS SELECT "
@@ -1596,6 +1617,16 @@ void CMusicDatabase::GetFileItemFromDataset(const dbiplus::sql_record* const rec
   item->GetMusicInfoTag()->SetURL(strRealPath);
   item->GetMusicInfoTag()->SetCompilation(record->at(song_bCompilation).get_asInt() == 1);
   item->GetMusicInfoTag()->SetAlbumArtist(record->at(song_strAlbumArtists).get_asString());
+  if (!record->at(song_iTrackGain).get_isNull())
+  {
+    item->GetMusicInfoTag()->SetReplayGainTrackGain(record->at(song_iTrackGain).get_asInt());
+    item->GetMusicInfoTag()->SetReplayGainTrackPeak(record->at(song_fTrackPeak).get_asFloat());
+  }
+  if (!record->at(song_iAlbumGain).get_isNull())
+  {
+    item->GetMusicInfoTag()->SetReplayGainAlbumGain(record->at(song_iAlbumGain).get_asInt());
+    item->GetMusicInfoTag()->SetReplayGainAlbumPeak(record->at(song_fAlbumPeak).get_asFloat());
+  }
   item->GetMusicInfoTag()->SetLoaded(true);
   // Get filename with full path
   if (!baseUrl.IsValid())
@@ -3915,11 +3946,16 @@ void CMusicDatabase::UpdateTables(int version)
     m_pDS->exec("UPDATE song_artist SET strJoinPhrase = '' WHERE 100*idSong+iOrder IN (SELECT id FROM (SELECT 100*idSong+max(iOrder) AS id FROM song_artist GROUP BY idSong) AS sub)");
     m_pDS->exec("UPDATE album_artist SET strJoinPhrase = '' WHERE 100*idAlbum+iOrder IN (SELECT id FROM (SELECT 100*idAlbum+max(iOrder) AS id FROM album_artist GROUP BY idAlbum) AS sub)");
   }
+  if (version < 47)
+  {
+    m_pDS->exec("CREATE TABLE songloudness (idSong integer primary key, fLoudness real, "
+                " iTrackGain integer, fTrackPeak real, iAlbumGain integer, fAlbumPeak real)\n");
+  }
 }
 
 int CMusicDatabase::GetSchemaVersion() const
 {
-  return 46;
+  return 47;
 }
 
 unsigned int CMusicDatabase::GetSongIDs(const Filter &filter, vector<pair<int,int> > &songIDs)
@@ -5322,6 +5358,108 @@ int CMusicDatabase::GetKaraokeSongsCount()
   return 0;
 }
 
+bool CMusicDatabase::GetSongsWithoutLoudness(VECSONGS& songs, int limit /* = 0 */)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    CStdString strSQL = "SELECT songview.* FROM songview "
+                        "WHERE songview.idSong NOT IN (SELECT idSong FROM songloudness) "
+                        "ORDER BY songview.idAlbum, songview.idSong";
+    if (limit > 0)
+      strSQL += PrepareSQL(" LIMIT %i", limit);
+
+    if (!m_pDS->query(strSQL.c_str())) return false;
+    while (!m_pDS->eof())
+    {
+      songs.push_back(GetSongFromDataset());
+      m_pDS->next();
+    }
+    m_pDS->close();
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s failed", __FUNCTION__);
+  }
+  return false;
+}
+
+bool CMusicDatabase::SetSongLoudness(int idSong, double loudness, float peak, bool valid /* = true */)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    CStdString strSQL;
+    if (valid)
+      strSQL = PrepareSQL("REPLACE INTO songloudness (idSong, fLoudness, iTrackGain, fTrackPeak, iAlbumGain, fAlbumPeak) "
+                          "VALUES (%i, %f, %i, %f, NULL, NULL)", idSong, loudness, LoudnessToGain(loudness), peak);
+    else
+      strSQL = PrepareSQL("REPLACE INTO songloudness (idSong, fLoudness, iTrackGain, fTrackPeak, iAlbumGain, fAlbumPeak) "
+                          "VALUES (%i, NULL, NULL, NULL, NULL, NULL)", idSong);
+    m_pDS->exec(strSQL.c_str());
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s(%i) failed", __FUNCTION__, idSong);
+  }
+  return false;
+}
+
+bool CMusicDatabase::UpdateAlbumLoudness(int idAlbum)
+{
+  try
+  {
+    if (NULL == m_pDB.get()) return false;
+    if (NULL == m_pDS.get()) return false;
+
+    // wait until every song of the album has been analysed
+    CStdString strSQL = PrepareSQL("SELECT COUNT(1) FROM song WHERE idAlbum=%i AND idSong NOT IN (SELECT idSong FROM songloudness)", idAlbum);
+    if (!m_pDS->query(strSQL.c_str())) return false;
+    int pending = m_pDS->eof() ? 0 : m_pDS->fv(0).get_asInt();
+    m_pDS->close();
+    if (pending > 0)
+      return false;
+
+    // the album loudness is the duration weighted power mean of its tracks
+    strSQL = PrepareSQL("SELECT songloudness.fLoudness, songloudness.fTrackPeak, song.iDuration FROM song "
+                        "JOIN songloudness ON song.idSong = songloudness.idSong "
+                        "WHERE song.idAlbum=%i AND songloudness.fLoudness IS NOT NULL", idAlbum);
+    if (!m_pDS->query(strSQL.c_str())) return false;
+    double energy = 0.0;
+    double duration = 0.0;
+    float peak = 0.0f;
+    while (!m_pDS->eof())
+    {
+      double weight = std::max(1, m_pDS->fv(2).get_asInt());
+      energy   += weight * CAELoudnessMeter::LoudnessToEnergy(m_pDS->fv(0).get_asDouble());
+      duration += weight;
+      peak      = std::max(peak, m_pDS->fv(1).get_asFloat());
+      m_pDS->next();
+    }
+    m_pDS->close();
+    if (duration == 0.0)
+      return false;
+
+    double loudness = CAELoudnessMeter::EnergyToLoudness(energy / duration);
+    strSQL = PrepareSQL("UPDATE songloudness SET iAlbumGain=%i, fAlbumPeak=%f "
+                        "WHERE fLoudness IS NOT NULL AND idSong IN (SELECT idSong FROM song WHERE idAlbum=%i)",
+                        LoudnessToGain(loudness), peak, idAlbum);
+    m_pDS->exec(strSQL.c_str());
+    return true;
+  }
+  catch (...)
+  {
+    CLog::Log(LOGERROR, "%s(%i) failed", __FUNCTION__, idAlbum);
+  }
+  return false;
+}
+
 void CMusicDatabase::SetPropertiesFromArtist(CFileItem& item, const CArtist& artist)
 {
   item.SetProperty("artist_instrument", StringUtils::Join(artist.instruments, g_advancedSettings.m_musicItemSeparator));
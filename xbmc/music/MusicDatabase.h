@@ -378,6 +378,31 @@ public:
   void ExportKaraokeInfo(const CStdString &outFile, bool asHTML );
   void ImportKaraokeInfo(const CStdString &inputFile );
 
+  /////////////////////////////////////////////////
+  // Loudness
+  /////////////////////////////////////////////////
+  /*! \brief Fetch songs whose loudness has not been analysed yet
+   Songs are ordered by album, so that consecutive results complete an album.
+   \param songs [out] the songs still to be analysed
+   \param limit [in] the maximum number of songs to fetch, 0 for all of them
+   \return true on success, false on a database error
+   */
+  bool GetSongsWithoutLoudness(VECSONGS& songs, int limit = 0);
+
+  /*! \brief Store the analysed loudness of a song and derive its track gain
+   \param idSong [in] the song the values belong to
+   \param loudness [in] integrated loudness in LUFS
+   \param peak [in] sample peak, 1.0 being full scale
+   \param valid [in] false if the song could not be analysed, so that it is not retried
+   */
+  bool SetSongLoudness(int idSong, double loudness, float peak, bool valid = true);
+
+  /*! \brief Derive the album gain once every song of an album has been analysed
+   \param idAlbum [in] the album to update
+   \return true if the album gain was stored
+   */
+  bool UpdateAlbumLoudness(int idAlbum);
+
   /////////////////////////////////////////////////
   // Filters
   /////////////////////////////////////////////////
@@ -532,6 +557,10 @@ private:
     song_strKarEncoding,
     song_bCompilation,
     song_strAlbumArtists,
+    song_iTrackGain,
+    song_fTrackPeak,
+    song_iAlbumGain,
+    song_fAlbumPeak,
     song_enumCount // end of the enum, do not add past here
   } SongFields;
 
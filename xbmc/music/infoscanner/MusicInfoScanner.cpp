@@ -157,6 +157,17 @@ void CMusicInfoScanner::Process()
 
           m_musicDatabase.Compress(false);
         }
+
+        if (g_advancedSettings.m_bMusicLibraryLoudnessAnalysis)
+        {
+          if (m_handle)
+          {
+            m_handle->SetTitle(g_localizeStrings.Get(506));
+            m_handle->SetText("");
+          }
+
+          m_loudnessAnalyser.Analyse(m_musicDatabase, m_bStop, m_handle);
+        }
       }
 
       m_fileCountReader.StopThread();
@@ -22,6 +22,7 @@
 #include "music/MusicDatabase.h"
 #include "MusicAlbumInfo.h"
 #include "MusicInfoScraper.h"
+#include "MusicLoudnessAnalyser.h"
 
 class CAlbum;
 class CArtist;
@@ -211,6 +212,7 @@ protected:
   bool m_needsCleanup;
   int m_scanType; // 0 - load from files, 1 - albums, 2 - artists
   CMusicDatabase m_musicDatabase;
+  CMusicLoudnessAnalyser m_loudnessAnalyser;
 
   std::map<CAlbum, CAlbum> m_albumCache;
   std::map<CArtistCredit, CArtist> m_artistCache;
@@ -0,0 +1,270 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "MusicLoudnessAnalyser.h"
+#include "Application.h"
+#include "ApplicationPlayer.h"
+#include "cores/AudioEngine/Utils/AEConvert.h"
+#include "cores/AudioEngine/Utils/AELoudnessMeter.h"
+#include "cores/AudioEngine/Utils/AEUtil.h"
+#include "cores/paplayer/CodecFactory.h"
+#include "dialogs/GUIDialogExtendedProgressBar.h"
+#include "music/MusicDatabase.h"
+#include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
+#include "utils/JobManager.h"
+#include "utils/StringUtils.h"
+#include "utils/log.h"
+
+#include <algorithm>
+
+using namespace std;
+using namespace MUSIC_INFO;
+
+/* while something is playing, decode no faster than this multiple of real time */
+#define LOUDNESS_PLAYBACK_SPEED 4
+/* frames decoded per codec read */
+#define LOUDNESS_READ_FRAMES    4096
+
+static bool IsPlaybackActive()
+{
+  return g_application.m_pPlayer->IsPlaying() && !g_application.m_pPlayer->IsPaused();
+}
+
+CMusicLoudnessJob::CMusicLoudnessJob(const CSong &song)
+  : m_song(song)
+{
+  m_opened = false;
+  m_loudness = AE_LOUDNESS_SILENCE;
+  m_peak = 0.0f;
+}
+
+bool CMusicLoudnessJob::DoWork()
+{
+  ICodec *codec = CodecFactory::CreateCodecDemux(m_song.strFileName, "", 0);
+  if (!codec || !codec->Init(m_song.strFileName, 0))
+  {
+    CLog::Log(LOGERROR, "%s - unable to open %s", __FUNCTION__, m_song.strFileName.c_str());
+    delete codec;
+    return false;
+  }
+  m_opened = true;
+
+  CAELoudnessMeter meter;
+  CAEChannelInfo layout = codec->GetChannelInfo();
+  CAEConvert::AEConvertToFn convert = CAEConvert::ToFloat(codec->m_DataFormat);
+  unsigned int frameSize = (CAEUtil::DataFormatToBits(codec->m_DataFormat) >> 3) * layout.Count();
+  if (!convert || !frameSize || codec->m_SampleRate <= 0 || !meter.Initialize(codec->m_SampleRate, layout))
+  {
+    CLog::Log(LOGERROR, "%s - unsupported format in %s", __FUNCTION__, m_song.strFileName.c_str());
+    delete codec;
+    return false;
+  }
+
+  /* songs from cue sheets only cover part of the file, offsets are in 1/75 s */
+  int64_t start = (int64_t)m_song.iStartOffset * 1000 / 75;
+  int64_t end   = (int64_t)m_song.iEndOffset * 1000 / 75;
+  if (start)
+    codec->Seek(start);
+  uint64_t framesLeft = end > start ? (uint64_t)(end - start) * codec->m_SampleRate / 1000 : (uint64_t)-1;
+  uint64_t framesTotal = m_song.iDuration > 0 ? (uint64_t)m_song.iDuration * codec->m_SampleRate : 0;
+
+  vector<BYTE>  input(LOUDNESS_READ_FRAMES * frameSize);
+  vector<float> output(LOUDNESS_READ_FRAMES * layout.Count());
+
+  uint64_t framesDone = 0;
+  uint64_t throttleFrames = 0;
+  unsigned int throttleStart = XbmcThreads::SystemClockMillis();
+  int emptyReads = 0;
+  bool success = true;
+
+  while (framesLeft)
+  {
+    int size = 0;
+    int ret = codec->ReadPCM(&input[0], input.size(), &size);
+    if (ret == READ_ERROR)
+    {
+      success = false;
+      break;
+    }
+
+    unsigned int frames = (unsigned int)min((uint64_t)(size / frameSize), framesLeft);
+    if (frames)
+    {
+      convert(&input[0], frames * layout.Count(), &output[0]);
+      meter.AddFrames(&output[0], frames);
+      framesLeft -= frames;
+      framesDone += frames;
+      emptyReads = 0;
+    }
+    else if (++emptyReads > 100)
+      break;
+
+    if (ret == READ_EOF)
+      break;
+
+    if (ShouldCancel((unsigned int)(framesDone / codec->m_SampleRate), (unsigned int)(framesTotal / codec->m_SampleRate)))
+    {
+      success = false;
+      break;
+    }
+
+    if (IsPlaybackActive())
+    {
+      throttleFrames += frames;
+      unsigned int target  = (unsigned int)(throttleFrames * 1000 / codec->m_SampleRate / LOUDNESS_PLAYBACK_SPEED);
+      unsigned int elapsed = XbmcThreads::SystemClockMillis() - throttleStart;
+      if (elapsed < target)
+        Sleep(target - elapsed);
+    }
+    else
+    {
+      throttleFrames = 0;
+      throttleStart = XbmcThreads::SystemClockMillis();
+    }
+  }
+
+  codec->DeInit();
+  delete codec;
+
+  if (!success || !meter.GetBlockCount())
+    return false;
+
+  m_loudness = meter.GetIntegratedLoudness();
+  m_peak = meter.GetSamplePeak();
+  CLog::Log(LOGDEBUG, "%s - %s: %.2f LUFS, peak %.4f", __FUNCTION__, m_song.strFileName.c_str(), m_loudness, m_peak);
+  return true;
+}
+
+CMusicLoudnessAnalyser::CMusicLoudnessAnalyser()
+{
+}
+
+CMusicLoudnessAnalyser::~CMusicLoudnessAnalyser()
+{
+  CancelJobs();
+}
+
+bool CMusicLoudnessAnalyser::Analyse(CMusicDatabase &database, const volatile bool &stop, CGUIDialogProgressBarHandle *handle)
+{
+  VECSONGS songs;
+  if (!database.GetSongsWithoutLoudness(songs) || songs.empty())
+    return true;
+
+  CLog::Log(LOGDEBUG, "%s - analysing loudness of %u songs", __FUNCTION__, (unsigned int)songs.size());
+  unsigned int tick = XbmcThreads::SystemClockMillis();
+
+  unsigned int next = 0;
+  bool interrupted = stop;
+  while (!interrupted)
+  {
+    StoreResults(database);
+
+    {
+      CSingleLock lock(m_section);
+      while (next < songs.size() && m_jobs.size() < GetWorkers())
+      {
+        CJob *job = new CMusicLoudnessJob(songs[next++]);
+        unsigned int jobID = CJobManager::GetInstance().AddJob(job, this, CJob::PRIORITY_LOW);
+        if (!jobID)
+        { // the job manager is shutting down
+          delete job;
+          interrupted = true;
+          break;
+        }
+        m_jobs.insert(jobID);
+      }
+      if (m_jobs.empty())
+        break;
+    }
+
+    if (handle)
+    {
+      const CSong &song = songs[next - 1];
+      handle->SetText(StringUtils::Join(song.artist, g_advancedSettings.m_musicItemSeparator) + " - " + song.strTitle);
+      handle->SetProgress(next, songs.size());
+    }
+
+    m_jobDone.WaitMSec(500);
+    interrupted |= stop;
+  }
+
+  CancelJobs();
+  StoreResults(database);
+
+  tick = XbmcThreads::SystemClockMillis() - tick;
+  CLog::Log(LOGNOTICE, "%s - loudness analysis %s, took %s", __FUNCTION__, interrupted ? "interrupted" : "finished",
+            StringUtils::SecondsToTimeString(tick / 1000).c_str());
+  return !interrupted;
+}
+
+void CMusicLoudnessAnalyser::OnJobComplete(unsigned int jobID, bool success, CJob *job)
+{
+  CSingleLock lock(m_section);
+  if (m_jobs.erase(jobID) == 0)
+    return; // cancelled while completing
+
+  m_jobDone.Set();
+
+  // files that could not be opened may just be offline, leave them for the next scan
+  CMusicLoudnessJob *loudnessJob = (CMusicLoudnessJob *)job;
+  if (!success && !loudnessJob->WasOpened())
+    return;
+
+  Result result;
+  result.idSong   = loudnessJob->GetSong().idSong;
+  result.idAlbum  = loudnessJob->GetSong().idAlbum;
+  result.valid    = success;
+  result.loudness = loudnessJob->GetLoudness();
+  result.peak     = loudnessJob->GetPeak();
+  m_results.push_back(result);
+}
+
+unsigned int CMusicLoudnessAnalyser::GetWorkers() const
+{
+  // a single worker is enough to keep up while something is playing
+  if (IsPlaybackActive())
+    return 1;
+  return g_advancedSettings.m_iMusicLibraryLoudnessThreads;
+}
+
+void CMusicLoudnessAnalyser::StoreResults(CMusicDatabase &database)
+{
+  vector<Result> results;
+  {
+    CSingleLock lock(m_section);
+    results.swap(m_results);
+  }
+
+  for (vector<Result>::const_iterator it = results.begin(); it != results.end(); ++it)
+  {
+    database.SetSongLoudness(it->idSong, it->loudness, it->peak, it->valid);
+    database.UpdateAlbumLoudness(it->idAlbum);
+  }
+}
+
+void CMusicLoudnessAnalyser::CancelJobs()
+{
+  CSingleLock lock(m_section);
+  for (set<unsigned int>::const_iterator it = m_jobs.begin(); it != m_jobs.end(); ++it)
+    CJobManager::GetInstance().CancelJob(*it);
+  m_jobs.clear();
+}
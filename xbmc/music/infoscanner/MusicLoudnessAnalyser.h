@@ -0,0 +1,106 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <set>
+#include <vector>
+
+#include "music/Song.h"
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "utils/Job.h"
+
+class CGUIDialogProgressBarHandle;
+class CMusicDatabase;
+
+namespace MUSIC_INFO
+{
+/*!
+ \brief Measures the EBU R128 loudness of a single song
+
+ The song is decoded with the paplayer codecs. While something is being
+ played the job slows itself down to a fixed multiple of real time so it
+ does not compete with playback for disk, network and CPU.
+ */
+class CMusicLoudnessJob : public CJob
+{
+public:
+  CMusicLoudnessJob(const CSong &song);
+
+  virtual bool DoWork();
+  virtual const char *GetType() const { return "musicloudness"; }
+
+  const CSong &GetSong() const { return m_song; }
+  bool WasOpened() const       { return m_opened; }
+  double GetLoudness() const   { return m_loudness; }
+  float GetPeak() const        { return m_peak; }
+
+private:
+  CSong  m_song;
+  bool   m_opened;
+  double m_loudness;
+  float  m_peak;
+};
+
+/*!
+ \brief Loudness analysis stage of the music library scan
+
+ Analyses every song without loudness information on parallel workers and
+ stores track and album gain in the music database. Results are committed as
+ each song completes, so an interrupted analysis continues with the remaining
+ songs on the next scan.
+ */
+class CMusicLoudnessAnalyser : public IJobCallback
+{
+public:
+  CMusicLoudnessAnalyser();
+  virtual ~CMusicLoudnessAnalyser();
+
+  /*!
+   \brief Analyse all songs in the database that have not been analysed yet
+   \param database an opened music database, only used from the calling thread
+   \param stop set by the owner to interrupt the analysis
+   \param handle optional progress bar to update
+   \return false if the analysis was interrupted
+   */
+  bool Analyse(CMusicDatabase &database, const volatile bool &stop, CGUIDialogProgressBarHandle *handle = NULL);
+
+  virtual void OnJobComplete(unsigned int jobID, bool success, CJob *job);
+
+private:
+  struct Result
+  {
+    int    idSong;
+    int    idAlbum;
+    bool   valid;
+    double loudness;
+    float  peak;
+  };
+
+  unsigned int GetWorkers() const;
+  void StoreResults(CMusicDatabase &database);
+  void CancelJobs();
+
+  CCriticalSection       m_section;
+  CEvent                 m_jobDone;
+  std::set<unsigned int> m_jobs;
+  std::vector<Result>    m_results;
+};
+}
@@ -29,6 +29,7 @@
 #include "FileItem.h"
 #include "filesystem/File.h"
 #include "utils/log.h"
+#include "utils/PlaneCopy.h"
 #include "utils/URIUtils.h"
 #include "DllSwScale.h"
 #include "guilib/Texture.h"
@@ -230,6 +231,22 @@ void CPicture::GetScale(unsigned int width, unsigned int height, unsigned int &o
 bool CPicture::ScaleImage(uint8_t *in_pixels, unsigned int in_width, unsigned int in_height, unsigned int in_pitch,
                           uint8_t *out_pixels, unsigned int out_width, unsigned int out_height, unsigned int out_pitch)
 {
+  // halve large images with a box filter first, it is cheap and keeps
+  // the bilinear scaler from skipping over most of the source pixels
+  uint8_t *buffer = NULL;
+  while (out_width && out_height && in_width >= 2 * out_width && in_height >= 2 * out_height)
+  {
+    unsigned int width = in_width / 2, height = in_height / 2;
+    if (!buffer)
+      buffer = new uint8_t[width * height * 4];
+    // reads are ahead of writes, so further halving is done in place
+    CPlaneCopy::HalvePixels(buffer, width * 4, in_pixels, in_pitch, width, height);
+    in_pixels = buffer;
+    in_width  = width;
+    in_height = height;
+    in_pitch  = width * 4;
+  }
+
   DllSwScale dllSwScale;
   dllSwScale.Load();
   struct SwsContext *context = dllSwScale.sws_getContext(in_width, in_height, PIX_FMT_BGRA,
@@ -245,8 +262,10 @@ bool CPicture::ScaleImage(uint8_t *in_pixels, unsigned int in_width, unsigned in
   {
     dllSwScale.sws_scale(context, src, srcStride, 0, in_height, dst, dstStride);
     dllSwScale.sws_freeContext(context);
+    delete[] buffer;
     return true;
   }
+  delete[] buffer;
   return false;
 }
 
@@ -120,6 +120,11 @@ void CAdvancedSettings::Initialize()
   m_limiterHold = 0.025f;
   m_limiterRelease = 0.1f;
 
+  // prime the decoders of the next 2 playlist entries with up to 5s of audio
+  m_audioPrefetchTracks = 2;
+  m_audioPrefetchSeconds = 5.0f;
+  m_audioPrefetchMemorySize = 16 * 1024 * 1024;
+
   m_omxHWAudioDecode = false;
   m_omxDecodeStartWithValidFrame = false;
 
@@ -150,6 +155,7 @@ void CAdvancedSettings::Initialize()
   m_videoPercentSeekForwardBig = 10;
   m_videoPercentSeekBackwardBig = -10;
   m_videoBlackBarColour = 0;
+  m_videoSoftwareRenderer = false;
   m_videoPPFFmpegDeint = "linblenddeint";
   m_videoPPFFmpegPostProc = "ha:128:7,va,dr";
   m_videoDefaultPlayer = "dvdplayer";
@@ -163,6 +169,7 @@ void CAdvancedSettings::Initialize()
   m_videoAutoScaleMaxFps = 30.0f;
   m_videoDisableBackgroundDeinterlace = false;
   m_videoCaptureUseOcclusionQuery = -1; //-1 is auto detect
+  m_videoRenderTrace = false;
   m_videoVDPAUtelecine = false;
   m_videoVDPAUdeintSkipChromaHD = false;
   m_DXVACheckCompatibility = false;
@@ -171,6 +178,7 @@ void CAdvancedSettings::Initialize()
   m_DXVANoDeintProcForProgressive = false;
   m_videoFpsDetect = 1;
   m_videoBusyDialogDelay_ms = 500;
+  m_videoExtractThumbStrip = true;
   m_stagefrightConfig.useAVCcodec = -1;
   m_stagefrightConfig.useVC1codec = -1;
   m_stagefrightConfig.useVPXcodec = -1;
@@ -254,6 +262,11 @@ void CAdvancedSettings::Initialize()
   m_fanartRes = 1080;
   m_imageRes = 720;
   m_useDDSFanart = false;
+#if defined(TARGET_RASPBERRY_PI) || defined(TARGET_ANDROID) || defined(TARGET_DARWIN_IOS)
+  m_largeTextureCacheSize = 32;
+#else
+  m_largeTextureCacheSize = 128;
+#endif
 
   m_sambaclienttimeout = 10;
   m_sambadoscodepage = "";
@@ -270,6 +283,8 @@ void CAdvancedSettings::Initialize()
   m_bMusicLibraryAllItemsOnBottom = false;
   m_bMusicLibraryAlbumsSortByArtistThenYear = false;
   m_bMusicLibraryCleanOnUpdate = false;
+  m_bMusicLibraryLoudnessAnalysis = false;
+  m_iMusicLibraryLoudnessThreads = 2;
   m_iMusicLibraryRecentlyAddedItems = 25;
   m_strMusicLibraryAlbumFormat = "";
   m_strMusicLibraryAlbumFormatRight = "";
@@ -318,6 +333,7 @@ void CAdvancedSettings::Initialize()
   m_iEdlMaxStartGap = 5 * 60;              // 5 minutes.
   m_iEdlCommBreakAutowait = 0;             // Off by default
   m_iEdlCommBreakAutowind = 0;             // Off by default
+  m_bEdlDetectCommBreaks = false;          // Off by default
 
   m_curlconnecttimeout = 10;
   m_curllowspeedtime = 20;
@@ -509,6 +525,14 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
 
     XMLUtils::GetFloat(pElement, "limiterhold", m_limiterHold, 0.0f, 100.0f);
     XMLUtils::GetFloat(pElement, "limiterrelease", m_limiterRelease, 0.001f, 100.0f);
+
+    TiXmlElement *pPrefetch = pElement->FirstChildElement("prefetch");
+    if (pPrefetch)
+    {
+      XMLUtils::GetUInt(pPrefetch, "tracks", m_audioPrefetchTracks, 0, 10);
+      XMLUtils::GetFloat(pPrefetch, "seconds", m_audioPrefetchSeconds, 0.5f, 60.0f);
+      XMLUtils::GetUInt(pPrefetch, "memorysize", m_audioPrefetchMemorySize);
+    }
   }
 
   pElement = pRootElement->FirstChildElement("omx");
@@ -551,6 +575,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetFloat(pElement, "subsdelayrange", m_videoSubsDelayRange, 10, 600);
     XMLUtils::GetFloat(pElement, "audiodelayrange", m_videoAudioDelayRange, 10, 600);
     XMLUtils::GetInt(pElement, "blackbarcolour", m_videoBlackBarColour, 0, 255);
+    XMLUtils::GetBoolean(pElement, "softwarerenderer", m_videoSoftwareRenderer);
     XMLUtils::GetString(pElement, "defaultplayer", m_videoDefaultPlayer);
     XMLUtils::GetString(pElement, "defaultdvdplayer", m_videoDefaultDVDPlayer);
     XMLUtils::GetBoolean(pElement, "fullscreenonmoviestart", m_fullScreenOnMovieStart);
@@ -600,6 +625,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetBoolean(pElement,"disablehi10pmultithreading",m_videoDisableHi10pMultithreading);
     XMLUtils::GetBoolean(pElement, "disablebackgrounddeinterlace", m_videoDisableBackgroundDeinterlace);
     XMLUtils::GetInt(pElement, "useocclusionquery", m_videoCaptureUseOcclusionQuery, -1, 1);
+    XMLUtils::GetBoolean(pElement, "rendertrace", m_videoRenderTrace);
     XMLUtils::GetBoolean(pElement,"vdpauInvTelecine",m_videoVDPAUtelecine);
     XMLUtils::GetBoolean(pElement,"vdpauHDdeintSkipChroma",m_videoVDPAUdeintSkipChromaHD);
 
@@ -707,6 +733,8 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     // the busy dialog is shown when starting video playback.
     XMLUtils::GetInt(pElement, "busydialogdelayms", m_videoBusyDialogDelay_ms, 0, 1000);
 
+    XMLUtils::GetBoolean(pElement, "extractthumbstrip", m_videoExtractThumbStrip);
+
     // Store global display latency settings
     TiXmlElement* pVideoLatency = pElement->FirstChildElement("latency");
     if (pVideoLatency)
@@ -754,6 +782,8 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetBoolean(pElement, "allitemsonbottom", m_bMusicLibraryAllItemsOnBottom);
     XMLUtils::GetBoolean(pElement, "albumssortbyartistthenyear", m_bMusicLibraryAlbumsSortByArtistThenYear);
     XMLUtils::GetBoolean(pElement, "cleanonupdate", m_bMusicLibraryCleanOnUpdate);
+    XMLUtils::GetBoolean(pElement, "loudnessanalysis", m_bMusicLibraryLoudnessAnalysis);
+    XMLUtils::GetInt(pElement, "loudnessthreads", m_iMusicLibraryLoudnessThreads, 1, 16);
     XMLUtils::GetString(pElement, "albumformat", m_strMusicLibraryAlbumFormat);
     XMLUtils::GetString(pElement, "albumformatright", m_strMusicLibraryAlbumFormatRight);
     XMLUtils::GetString(pElement, "itemseparator", m_musicItemSeparator);
@@ -931,6 +961,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
     XMLUtils::GetInt(pElement, "maxstartgap", m_iEdlMaxStartGap, 0, 10 * 60);               // Between 0 and 10 minutes
     XMLUtils::GetInt(pElement, "commbreakautowait", m_iEdlCommBreakAutowait, 0, 10);        // Between 0 and 10 seconds
     XMLUtils::GetInt(pElement, "commbreakautowind", m_iEdlCommBreakAutowind, 0, 10);        // Between 0 and 10 seconds
+    XMLUtils::GetBoolean(pElement, "detectcommbreaks", m_bEdlDetectCommBreaks);
   }
 
   // picture exclude regexps
@@ -1040,6 +1071,7 @@ void CAdvancedSettings::ParseSettingsFile(const CStdString &file)
   XMLUtils::GetFloat(pRootElement, "controllerdeadzone", m_controllerDeadzone, 0.0f, 1.0f);
   XMLUtils::GetUInt(pRootElement, "fanartres", m_fanartRes, 0, 1080);
   XMLUtils::GetUInt(pRootElement, "imageres", m_imageRes, 0, 1080);
+  XMLUtils::GetUInt(pRootElement, "largetexturecachesize", m_largeTextureCacheSize, 0, 4096);
 #if !defined(TARGET_RASPBERRY_PI)
   XMLUtils::GetBoolean(pRootElement, "useddsfanart", m_useDDSFanart);
 #endif
@@ -140,6 +140,9 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_dvdplayerIgnoreDTSinWAV;
     float m_limiterHold;
     float m_limiterRelease;
+    unsigned int m_audioPrefetchTracks;
+    float m_audioPrefetchSeconds;
+    unsigned int m_audioPrefetchMemorySize;
 
     bool  m_omxHWAudioDecode;
     bool  m_omxDecodeStartWithValidFrame;
@@ -172,6 +175,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_musicPercentSeekForwardBig;
     int m_musicPercentSeekBackwardBig;
     int m_videoBlackBarColour;
+    bool m_videoSoftwareRenderer;
     int m_videoIgnoreSecondsAtStart;
     float m_videoIgnorePercentAtEnd;
     CStdString m_audioHost;
@@ -186,12 +190,14 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     float m_videoDefaultLatency;
     bool m_videoDisableBackgroundDeinterlace;
     int  m_videoCaptureUseOcclusionQuery;
+    bool m_videoRenderTrace;
     bool m_DXVACheckCompatibility;
     bool m_DXVACheckCompatibilityPresent;
     bool m_DXVAForceProcessorRenderer;
     bool m_DXVANoDeintProcForProgressive;
     int  m_videoFpsDetect;
     int  m_videoBusyDialogDelay_ms;
+    bool m_videoExtractThumbStrip;  // extract a strip of seek and chapter thumbs when extracting thumbs
     bool m_videoDisableHi10pMultithreading;
     StagefrightConfig m_stagefrightConfig;
 
@@ -246,6 +252,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
      */
     unsigned int GetThumbSize() const { return m_imageRes / 2; };
     bool m_useDDSFanart;
+    unsigned int m_largeTextureCacheSize; ///< \brief MB of decoded images to keep loaded for the GUI once unused, 0 to unload them after a delay
 
     int m_sambaclienttimeout;
     CStdString m_sambadoscodepage;
@@ -263,6 +270,8 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     bool m_bMusicLibraryAllItemsOnBottom;
     bool m_bMusicLibraryAlbumsSortByArtistThenYear;
     bool m_bMusicLibraryCleanOnUpdate;
+    bool m_bMusicLibraryLoudnessAnalysis;
+    int m_iMusicLibraryLoudnessThreads;
     CStdString m_strMusicLibraryAlbumFormat;
     CStdString m_strMusicLibraryAlbumFormatRight;
     bool m_prioritiseAPEv2tags;
@@ -315,6 +324,7 @@ class CAdvancedSettings : public ISettingCallback, public ISettingsHandler
     int m_iEdlMaxStartGap;          // seconds
     int m_iEdlCommBreakAutowait;    // seconds
     int m_iEdlCommBreakAutowind;    // seconds
+    bool m_bEdlDetectCommBreaks;    // analyse recordings without an EDL in the background
 
     int m_curlconnecttimeout;
     int m_curllowspeedtime;
@@ -87,6 +87,8 @@ void CSkinSettings::SetString(int setting, const string &label)
   if (it != m_strings.end())
   {
     it->second.value = label;
+    lock.Leave();
+    g_infoManager.ResetCache(INFO::DEPENDS_SKIN);
     return;
   }
 
@@ -134,6 +136,8 @@ void CSkinSettings::SetBool(int setting, bool set)
   if (it != m_bools.end())
   {
     it->second.value = set;
+    lock.Leave();
+    g_infoManager.ResetCache(INFO::DEPENDS_SKIN);
     return;
   }
 
@@ -152,6 +156,8 @@ void CSkinSettings::Reset(const string &setting)
     if (StringUtils::EqualsNoCase(settingName, it->second.name))
     {
       it->second.value.clear();
+      lock.Leave();
+      g_infoManager.ResetCache(INFO::DEPENDS_SKIN);
       return;
     }
   }
@@ -162,6 +168,8 @@ void CSkinSettings::Reset(const string &setting)
     if (StringUtils::EqualsNoCase(settingName, it->second.name))
     {
       it->second.value = false;
+      lock.Leave();
+      g_infoManager.ResetCache(INFO::DEPENDS_SKIN);
       return;
     }
   }
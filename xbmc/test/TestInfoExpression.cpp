@@ -0,0 +1,108 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "GUIInfoManager.h"
+#include "FileItem.h"
+#include "interfaces/info/InfoBool.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdlib>
+#include <string>
+
+/* Operands with a known value for an item labelled "foo". Constants are
+   cached between frames, list item conditions aren't, so expressions mix
+   both orders of cached and uncached operands. */
+struct TestOperand
+{
+  const char *condition;
+  bool value;
+};
+
+static const TestOperand operands[] =
+{
+  { "true",                              true  },
+  { "false",                             false },
+  { "isempty(listitem.label)",           false },
+  { "stringcompare(listitem.label,foo)", true  },
+};
+
+/* Builds a random expression and its value, evaluated directly with
+   ! binding tighter than +, and + tighter than | */
+static bool RandomExpression(int depth, std::string &expression);
+
+static bool RandomFactor(int depth, std::string &expression)
+{
+  bool negate = rand() % 3 == 0;
+  if (negate)
+    expression += "!";
+  bool value;
+  if (depth > 0 && rand() % 3 == 0)
+  {
+    expression += "[";
+    value = RandomExpression(depth - 1, expression);
+    expression += "]";
+  }
+  else
+  {
+    const TestOperand &operand = operands[rand() % (sizeof(operands) / sizeof(operands[0]))];
+    expression += operand.condition;
+    value = operand.value;
+  }
+  return negate ? !value : value;
+}
+
+static bool RandomTerm(int depth, std::string &expression)
+{
+  bool value = RandomFactor(depth, expression);
+  for (int factors = rand() % 3; factors > 0; factors--)
+  {
+    expression += "+";
+    value = RandomFactor(depth, expression) && value;
+  }
+  return value;
+}
+
+static bool RandomExpression(int depth, std::string &expression)
+{
+  bool value = RandomTerm(depth, expression);
+  for (int terms = rand() % 3; terms > 0; terms--)
+  {
+    expression += "|";
+    value = RandomTerm(depth, expression) || value;
+  }
+  return value;
+}
+
+TEST(TestInfoExpression, MatchesReferenceEvaluation)
+{
+  CFileItem item("foo");
+  srand(1);
+  for (int i = 0; i < 500; i++)
+  {
+    std::string expression;
+    bool expected = RandomExpression(3, expression);
+    INFO::InfoPtr info = g_infoManager.Register(expression, 0);
+    ASSERT_TRUE(info) << expression;
+    EXPECT_EQ(expected, info->Get(&item)) << expression;
+    // a second evaluation may use the cached operands
+    EXPECT_EQ(expected, info->Get(&item)) << expression;
+  }
+}
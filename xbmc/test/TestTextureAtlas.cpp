@@ -0,0 +1,166 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "guilib/TextureAtlas.h"
+
+#include "gtest/gtest.h"
+
+#include <stdint.h>
+#include <string.h>
+
+namespace
+{
+std::vector<CTextureAtlas::CImage> GetImages()
+{
+  std::vector<CTextureAtlas::CImage> images;
+  images.push_back(CTextureAtlas::CImage("a.png", 30, 20));
+  images.push_back(CTextureAtlas::CImage("b.png", 60, 60));
+  images.push_back(CTextureAtlas::CImage("c.png", 10, 40));
+  images.push_back(CTextureAtlas::CImage("d.png", 20, 20));
+  images.push_back(CTextureAtlas::CImage("e.png", 50, 10));
+  return images;
+}
+
+bool Overlap(const CTextureAtlas::CImage &a, const CTextureAtlas::CImage &b)
+{
+  const unsigned int p = CTextureAtlas::PADDING;
+  return a.page == b.page &&
+         a.x - p < b.x + b.width + p && b.x - p < a.x + a.width + p &&
+         a.y - p < b.y + b.height + p && b.y - p < a.y + a.height + p;
+}
+}
+
+TEST(TestTextureAtlas, Pack)
+{
+  CTextureAtlas atlas(128, 4);
+  atlas.Pack(GetImages());
+
+  const CTextureAtlas::IMAGES &images = atlas.GetImages();
+  EXPECT_EQ(5U, images.size());
+  EXPECT_EQ(1U, atlas.GetPageCount());
+  for (CTextureAtlas::IMAGES::const_iterator i = images.begin(); i != images.end(); ++i)
+  {
+    EXPECT_GE(i->second.x, CTextureAtlas::PADDING);
+    EXPECT_GE(i->second.y, CTextureAtlas::PADDING);
+    EXPECT_LE(i->second.x + i->second.width + CTextureAtlas::PADDING, 128U);
+    EXPECT_LE(i->second.y + i->second.height + CTextureAtlas::PADDING, 128U);
+    for (CTextureAtlas::IMAGES::const_iterator j = images.begin(); j != i; ++j)
+      EXPECT_FALSE(Overlap(i->second, j->second)) << i->first << " overlaps " << j->first;
+  }
+
+  // the highest image comes first
+  const CTextureAtlas::CImage *b = atlas.Find("b.png");
+  ASSERT_TRUE(b != NULL);
+  EXPECT_EQ(CTextureAtlas::PADDING, b->x);
+  EXPECT_EQ(CTextureAtlas::PADDING, b->y);
+  EXPECT_TRUE(atlas.Find("f.png") == NULL);
+}
+
+TEST(TestTextureAtlas, PackLeavesOut)
+{
+  std::vector<CTextureAtlas::CImage> images = GetImages();
+  images.push_back(CTextureAtlas::CImage("large.png", CTextureAtlas::MAX_SIZE + 1, 10));
+  images.push_back(CTextureAtlas::CImage("empty.png", 0, 0));
+
+  // a page of 64 only holds b.png, the rest doesn't fit on the second one
+  CTextureAtlas atlas(64, 2);
+  atlas.Pack(images);
+  EXPECT_EQ(2U, atlas.GetPageCount());
+  EXPECT_TRUE(atlas.Find("b.png") != NULL);
+  EXPECT_TRUE(atlas.Find("large.png") == NULL);
+  EXPECT_TRUE(atlas.Find("empty.png") == NULL);
+  EXPECT_LT(atlas.GetImages().size(), 5U);
+}
+
+TEST(TestTextureAtlas, SaveLoad)
+{
+  std::vector<CTextureAtlas::CImage> images = GetImages();
+  CTextureAtlas atlas(64, 2);
+  atlas.Pack(images);
+  std::string data;
+  atlas.Save(data);
+
+  CTextureAtlas loaded(64, 2);
+  EXPECT_TRUE(loaded.Load(data, images));
+  EXPECT_EQ(atlas.GetPageCount(), loaded.GetPageCount());
+  ASSERT_EQ(atlas.GetImages().size(), loaded.GetImages().size());
+  for (CTextureAtlas::IMAGES::const_iterator i = atlas.GetImages().begin(); i != atlas.GetImages().end(); ++i)
+  {
+    const CTextureAtlas::CImage *image = loaded.Find(i->first);
+    ASSERT_TRUE(image != NULL);
+    EXPECT_EQ(i->second.page, image->page);
+    EXPECT_EQ(i->second.x, image->x);
+    EXPECT_EQ(i->second.y, image->y);
+  }
+}
+
+TEST(TestTextureAtlas, LoadChanged)
+{
+  std::vector<CTextureAtlas::CImage> images = GetImages();
+  CTextureAtlas atlas(128, 4);
+  atlas.Pack(images);
+  std::string data;
+  atlas.Save(data);
+
+  CTextureAtlas loaded(128, 4);
+  std::vector<CTextureAtlas::CImage> changed(images);
+  changed[0].width++;
+  EXPECT_FALSE(loaded.Load(data, changed));
+  EXPECT_EQ(0U, loaded.GetImages().size());
+
+  changed = images;
+  changed.push_back(CTextureAtlas::CImage("f.png", 8, 8));
+  EXPECT_FALSE(loaded.Load(data, changed));
+
+  changed = images;
+  changed.pop_back();
+  EXPECT_FALSE(loaded.Load(data, changed));
+
+  EXPECT_FALSE(loaded.Load(data.substr(0, data.size() - 1), images));
+  EXPECT_FALSE(CTextureAtlas(256, 4).Load(data, images));
+  EXPECT_TRUE(loaded.Load(data, images));
+}
+
+TEST(TestTextureAtlas, Blit)
+{
+  CTextureAtlas atlas(16, 1);
+  std::vector<CTextureAtlas::CImage> images;
+  images.push_back(CTextureAtlas::CImage("a.png", 2, 2));
+  atlas.Pack(images);
+  const CTextureAtlas::CImage *image = atlas.Find("a.png");
+  ASSERT_TRUE(image != NULL);
+
+  const uint32_t pixels[4] = { 1, 2, 3, 4 };
+  uint32_t page[16 * 16];
+  memset(page, 0, sizeof(page));
+  atlas.Blit((unsigned char *)page, *image, (const unsigned char *)pixels, 2 * sizeof(uint32_t));
+
+  // the image with its edges repeated around it
+  const uint32_t expected[4][4] = { { 1, 1, 2, 2 },
+                                    { 1, 1, 2, 2 },
+                                    { 3, 3, 4, 4 },
+                                    { 3, 3, 4, 4 } };
+  for (unsigned int y = 0; y < 4; y++)
+  {
+    for (unsigned int x = 0; x < 4; x++)
+      EXPECT_EQ(expected[y][x], page[(image->y - 1 + y) * 16 + image->x - 1 + x]);
+  }
+  EXPECT_EQ(0U, page[(image->y + 3) * 16 + image->x]);
+}
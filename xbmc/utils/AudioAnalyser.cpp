@@ -0,0 +1,153 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "AudioAnalyser.h"
+#include "RFFT.h"
+#include "threads/SingleLock.h"
+
+#include <algorithm>
+
+// blocks kept waiting on either side of the worker, most of a second of audio
+#define MAX_PENDING_BLOCKS 128
+
+using namespace std;
+
+CAudioAnalyser::CAudioAnalyser()
+  : CThread("AudioAnalyser")
+{
+  m_fft = NULL;
+  m_samples = 0;
+  m_fftSize = 0;
+  m_bands = 0;
+  m_scale = 1.0f;
+}
+
+CAudioAnalyser::~CAudioAnalyser()
+{
+  Stop();
+}
+
+void CAudioAnalyser::Start(unsigned int samples, unsigned int fftSize, unsigned int bands, float scale)
+{
+  Stop();
+
+  m_samples = samples;
+  m_fftSize = fftSize;
+  m_bands   = fftSize ? bands : 0;
+  m_scale   = scale;
+  if (fftSize)
+    m_fft = new CRFFT(fftSize, min(samples / 2, fftSize));
+
+  Create();
+}
+
+void CAudioAnalyser::Stop()
+{
+  StopThread(false);
+  m_inputEvent.Set();
+  StopThread(true);
+
+  delete m_fft;
+  m_fft = NULL;
+  m_samples = 0;
+
+  {
+    CSingleLock lock(m_inputSection);
+    m_input.clear();
+  }
+  CSingleLock lock(m_outputSection);
+  m_output.clear();
+}
+
+void CAudioAnalyser::Submit(const float *samples, unsigned int count)
+{
+  if (!IsRunning())
+    return;
+
+  CSingleLock lock(m_inputSection);
+  if (m_input.size() >= MAX_PENDING_BLOCKS)
+    m_input.pop_front();
+  m_input.push_back(vector<float>(m_samples, 0.0f));
+  count = min(count, m_samples);
+  std::copy(samples, samples + count, m_input.back().begin());
+  m_inputEvent.Set();
+}
+
+bool CAudioAnalyser::GetAnalysis(AudioAnalysis &analysis)
+{
+  CSingleLock lock(m_outputSection);
+  if (m_output.empty())
+    return false;
+
+  analysis.samples.swap(m_output.front().samples);
+  analysis.spectrum.swap(m_output.front().spectrum);
+  analysis.bands.swap(m_output.front().bands);
+  m_output.pop_front();
+  return true;
+}
+
+void CAudioAnalyser::Process()
+{
+  vector<float> block;
+
+  while (!m_bStop)
+  {
+    {
+      CSingleLock lock(m_inputSection);
+      if (m_input.empty())
+      {
+        lock.Leave();
+        m_inputEvent.Wait();
+        continue;
+      }
+      block.swap(m_input.front());
+      m_input.pop_front();
+    }
+
+    AudioAnalysis analysis;
+    Analyse(block, analysis);
+
+    CSingleLock lock(m_outputSection);
+    if (m_output.size() >= MAX_PENDING_BLOCKS)
+      m_output.pop_front();
+    m_output.push_back(AudioAnalysis());
+    m_output.back().samples.swap(analysis.samples);
+    m_output.back().spectrum.swap(analysis.spectrum);
+    m_output.back().bands.swap(analysis.bands);
+  }
+}
+
+void CAudioAnalyser::Analyse(const vector<float> &input, AudioAnalysis &output)
+{
+  output.samples.assign(input.begin(), input.end());
+  if (!m_fft)
+    return;
+
+  output.spectrum.resize(m_fftSize + 2);
+  m_fft->TwoChannelPower(&input[0], &output.spectrum[0]);
+  for (vector<float>::iterator it = output.spectrum.begin(); it != output.spectrum.end(); ++it)
+    *it *= m_scale;
+
+  if (m_bands)
+  {
+    output.bands.resize(m_bands);
+    CRFFT::AggregateBands(&output.spectrum[0], m_fft->GetSize(), &output.bands[0], m_bands);
+  }
+}
@@ -0,0 +1,93 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <deque>
+#include <vector>
+
+#include "threads/CriticalSection.h"
+#include "threads/Event.h"
+#include "threads/Thread.h"
+
+class CRFFT;
+
+struct AudioAnalysis
+{
+  std::vector<float> samples;   ///< the analysed block of interleaved stereo samples
+  std::vector<float> spectrum;  ///< power spectrum as produced by CRFFT::TwoChannelPower, scaled
+  std::vector<float> bands;     ///< the spectrum summed into logarithmic bands
+};
+
+/*!
+ \brief Analyses audio blocks on a worker thread
+
+ Blocks are handed over with Submit() from the audio thread and transformed
+ on a worker thread. Every block is analysed, and the analyses are handed out
+ in the order their blocks were submitted, so the audio thread never waits on
+ the FFT. Should either side fall most of a second of audio behind, the oldest
+ blocks are dropped to keep memory bounded.
+ */
+class CAudioAnalyser : protected CThread
+{
+public:
+  CAudioAnalyser();
+  virtual ~CAudioAnalyser();
+
+  /*!
+   \brief Start the worker thread
+   \param samples number of interleaved stereo samples per block
+   \param fftSize number of points of the transform, 0 to pass the samples through only
+   \param bands number of logarithmic bands to aggregate the spectrum into
+   \param scale factor the power spectrum is multiplied with
+   */
+  void Start(unsigned int samples, unsigned int fftSize, unsigned int bands, float scale);
+  void Stop();
+
+  /*!
+   \brief Queue a block for analysis, short blocks are zero padded
+   */
+  void Submit(const float *samples, unsigned int count);
+
+  /*!
+   \brief Take the oldest analysis that is done
+   \param analysis receives the analysis
+   \return true if an analysis was taken, false if none is done
+   */
+  bool GetAnalysis(AudioAnalysis &analysis);
+
+protected:
+  virtual void Process();
+
+private:
+  void Analyse(const std::vector<float> &input, AudioAnalysis &output);
+
+  CRFFT             *m_fft;
+  unsigned int       m_samples;
+  unsigned int       m_fftSize;
+  unsigned int       m_bands;
+  float              m_scale;
+
+  CCriticalSection   m_inputSection;
+  CEvent             m_inputEvent;
+  std::deque< std::vector<float> > m_input;  ///< blocks waiting to be analysed
+
+  CCriticalSection   m_outputSection;
+  std::deque<AudioAnalysis> m_output;        ///< analyses waiting to be taken
+};
@@ -0,0 +1,197 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "FrameStats.h"
+#include "CPUInfo.h"
+
+#include <string.h>
+
+#if defined(TARGET_WINDOWS) && (_M_IX86_FP>1 || defined(_M_X64)) && !defined(__SSE2__)
+#define __SSE2__
+#endif
+
+bool CFrameStats::m_forcePortable = false;
+
+void CFrameStats::ForcePortable(bool portable)
+{
+  m_forcePortable = portable;
+}
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+
+static bool UseSSE2()
+{
+  return (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_SSE2) != 0;
+}
+
+static uint64_t Sum64(__m128i v)
+{
+  uint64_t lanes[2];
+  _mm_storeu_si128((__m128i*)lanes, v);
+  return lanes[0] + lanes[1];
+}
+#endif
+
+//-----------------------------------------------------------------------------
+// luma
+//-----------------------------------------------------------------------------
+
+void CFrameStats::Luma(const uint8_t *src, int srcStride,
+                       int width, int height, uint8_t level,
+                       uint64_t &sum, uint32_t &above)
+{
+  sum   = 0;
+  above = 0;
+  if (width <= 0 || height <= 0)
+    return;
+
+  int x0 = 0;
+#ifdef __SSE2__
+  if (!m_forcePortable && UseSSE2())
+  {
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i one  = _mm_set1_epi8(1);
+    const __m128i lvl  = _mm_set1_epi8((char)level);
+    __m128i sums  = zero;
+    __m128i below = zero;
+    x0 = width & ~15;
+    for (int y = 0; y < height; y++)
+    {
+      const uint8_t *row = src + y * srcStride;
+      for (int x = 0; x < x0; x += 16)
+      {
+        __m128i v = _mm_loadu_si128((const __m128i*)(row + x));
+        sums  = _mm_add_epi64(sums, _mm_sad_epu8(v, zero));
+        // samples at or below the level saturate to zero
+        __m128i low = _mm_cmpeq_epi8(_mm_subs_epu8(v, lvl), zero);
+        below = _mm_add_epi64(below, _mm_sad_epu8(_mm_and_si128(low, one), zero));
+      }
+    }
+    sum   = Sum64(sums);
+    above = (uint32_t)(x0 * height - Sum64(below));
+  }
+#endif
+
+  for (int y = 0; y < height; y++)
+  {
+    const uint8_t *row = src + y * srcStride;
+    for (int x = x0; x < width; x++)
+    {
+      sum += row[x];
+      if (row[x] > level)
+        above++;
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+// edges
+//-----------------------------------------------------------------------------
+
+void CFrameStats::Edges(uint8_t *dst, int dstStride,
+                        const uint8_t *src, int srcStride,
+                        int width, int height, uint8_t threshold)
+{
+  if (width <= 0 || height <= 0)
+    return;
+
+  for (int y = 0; y < height - 1; y++)
+  {
+    const uint8_t *row  = src + y * srcStride;
+    const uint8_t *next = row + srcStride;
+    uint8_t       *out  = dst + y * dstStride;
+    int x = 0;
+
+#ifdef __SSE2__
+    if (!m_forcePortable && UseSSE2())
+    {
+      const __m128i zero = _mm_setzero_si128();
+      const __m128i ones = _mm_set1_epi8((char)0xff);
+      const __m128i t    = _mm_set1_epi8((char)threshold);
+      // the right neighbours of the last sample of a block are one further
+      for (; x + 17 <= width; x += 16)
+      {
+        __m128i a = _mm_loadu_si128((const __m128i*)(row  + x));
+        __m128i r = _mm_loadu_si128((const __m128i*)(row  + x + 1));
+        __m128i d = _mm_loadu_si128((const __m128i*)(next + x));
+        __m128i dr = _mm_or_si128(_mm_subs_epu8(a, r), _mm_subs_epu8(r, a));
+        __m128i dd = _mm_or_si128(_mm_subs_epu8(a, d), _mm_subs_epu8(d, a));
+        __m128i e  = _mm_or_si128(_mm_subs_epu8(dr, t), _mm_subs_epu8(dd, t));
+        _mm_storeu_si128((__m128i*)(out + x), _mm_xor_si128(_mm_cmpeq_epi8(e, zero), ones));
+      }
+    }
+#endif
+
+    for (; x < width - 1; x++)
+    {
+      int dr = row[x] > row[x + 1] ? row[x] - row[x + 1] : row[x + 1] - row[x];
+      int dd = row[x] > next[x]    ? row[x] - next[x]    : next[x]    - row[x];
+      out[x] = (dr > threshold || dd > threshold) ? 0xff : 0;
+    }
+    out[width - 1] = 0;
+  }
+  memset(dst + (height - 1) * dstStride, 0, width);
+}
+
+//-----------------------------------------------------------------------------
+// audio levels
+//-----------------------------------------------------------------------------
+
+double CFrameStats::MeanSquare(const int16_t *samples, unsigned int count)
+{
+  if (count == 0)
+    return 0.0;
+
+  uint64_t sum = 0;
+  unsigned int i = 0;
+#ifdef __SSE2__
+  if (!m_forcePortable && UseSSE2())
+  {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i sums = zero;
+    for (; i + 8 <= count; i += 8)
+    {
+      __m128i v = _mm_loadu_si128((const __m128i*)(samples + i));
+      // pairs of squares are at most 2^31, exact when read as unsigned
+      __m128i sq = _mm_madd_epi16(v, v);
+      sums = _mm_add_epi64(sums, _mm_unpacklo_epi32(sq, zero));
+      sums = _mm_add_epi64(sums, _mm_unpackhi_epi32(sq, zero));
+    }
+    sum = Sum64(sums);
+  }
+#endif
+
+  for (; i < count; i++)
+    sum += (int32_t)samples[i] * samples[i];
+
+  return (double)sum / count / (32768.0 * 32768.0);
+}
+
+double CFrameStats::MeanSquare(const float *samples, unsigned int count)
+{
+  if (count == 0)
+    return 0.0;
+
+  double sum = 0.0;
+  for (unsigned int i = 0; i < count; i++)
+    sum += samples[i] * samples[i];
+  return sum / count;
+}
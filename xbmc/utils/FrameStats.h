@@ -0,0 +1,75 @@
+#pragma once
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+
+/*!
+ \brief Statistics of decoded pictures and audio for content analysis
+
+ Like CPlaneCopy each kernel has a SSE2 implementation and a portable one
+ with identical results, the SSE2 one is used when it was compiled in and
+ CCPUInfo reports the cpu supports it. Pointers and strides don't need any
+ alignment.
+ */
+class CFrameStats
+{
+public:
+  /*!
+   \brief Sum of the samples of a plane and the number of them above a level
+   \param width, height size of the plane in samples
+   \param level samples greater than this are counted in above
+   \param sum receives the sum of all samples
+   \param above receives the number of samples greater than level
+   */
+  static void Luma(const uint8_t *src, int srcStride,
+                   int width, int height, uint8_t level,
+                   uint64_t &sum, uint32_t &above);
+
+  /*!
+   \brief Mark the edges of a plane
+
+   A sample is an edge when it differs by more than threshold from its right
+   or its lower neighbour. Edges are set to 0xff, everything else to 0, the
+   last column and row have no neighbours and are never edges.
+   \param width, height size of both planes in samples
+   */
+  static void Edges(uint8_t *dst, int dstStride,
+                    const uint8_t *src, int srcStride,
+                    int width, int height, uint8_t threshold);
+
+  /*!
+   \brief Mean square of 16 bit samples, scaled to 0.0 - 1.0 of full scale
+   */
+  static double MeanSquare(const int16_t *samples, unsigned int count);
+
+  /*!
+   \brief Mean square of float samples in -1.0 - 1.0
+   */
+  static double MeanSquare(const float *samples, unsigned int count);
+
+  /*!
+   \brief Use the portable kernels even where the SSE2 ones could run, so both can be tested
+   */
+  static void ForcePortable(bool portable);
+
+private:
+  static bool m_forcePortable;
+};
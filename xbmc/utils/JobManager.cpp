@@ -166,6 +166,12 @@ bool CJobQueue::QueueEmpty() const
   return m_jobQueue.empty();
 }
 
+bool CJobQueue::IsProcessing() const
+{
+  CSingleLock lock(m_section);
+  return !m_processing.empty();
+}
+
 CJobManager &CJobManager::GetInstance()
 {
   static CJobManager sJobManager;
@@ -313,6 +319,12 @@ void CJobManager::UnPauseJobs()
   m_pauseJobs = false;
 }
 
+bool CJobManager::IsPaused() const
+{
+  CSingleLock lock(m_section);
+  return m_pauseJobs;
+}
+
 bool CJobManager::IsProcessing(const CJob::PRIORITY &priority) const
 {
   CSingleLock lock(m_section);
@@ -141,6 +141,11 @@ protected:
    NOTE: This function does not take into account the jobs that are currently processing 
    */
   bool QueueEmpty() const;
+
+  /*!
+   \brief Returns if any of our jobs are currently being processed
+   */
+  bool IsProcessing() const;
   
 private:
   void QueueNextJob();
@@ -262,6 +267,14 @@ public:
    */
   void UnPauseJobs();
 
+  /*!
+   \brief Checks whether jobs with priority PRIORITY_LOW_PAUSABLE are paused.
+   Long running pausable jobs can poll this to stop early and be queued again.
+   \return true if PauseJobs() was called and not undone by UnPauseJobs()
+   \sa PauseJobs(), UnPauseJobs()
+   */
+  bool IsPaused() const;
+
   /*!
    \brief Checks to see if any jobs with specific priority are currently processing.
    \param priority to search for
@@ -0,0 +1,377 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "PlaneCopy.h"
+#include "CPUInfo.h"
+#include "fastmemcpy.h"
+
+#include <string.h>
+
+#if defined(TARGET_WINDOWS) && (_M_IX86_FP>1 || defined(_M_X64)) && !defined(__SSE2__)
+#define __SSE2__
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// streaming loads are SSE4.1, used through inline assembly so the rest of
+// the file doesn't need to be built for SSE4.1
+#if defined(__SSE2__) && defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#define HAS_STREAM_LOAD
+#elif defined(__SSE2__) && defined(TARGET_WINDOWS)
+#include <smmintrin.h>
+#define HAS_STREAM_LOAD
+#endif
+
+bool CPlaneCopy::m_forcePortable = false;
+
+void CPlaneCopy::ForcePortable(bool portable)
+{
+  m_forcePortable = portable;
+}
+
+#ifdef __SSE2__
+static bool UseSSE2()
+{
+  return (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_SSE2) != 0;
+}
+#endif
+
+//-----------------------------------------------------------------------------
+// plane copy
+//-----------------------------------------------------------------------------
+
+#ifdef __SSE2__
+static void CopyRowSSE2(uint8_t *dst, const uint8_t *src, int width)
+{
+  int x = 0;
+  if (((uintptr_t)dst & 15) == 0)
+  {
+    for (; x + 64 <= width; x += 64)
+    {
+      __m128i a = _mm_loadu_si128((const __m128i*)(src + x));
+      __m128i b = _mm_loadu_si128((const __m128i*)(src + x + 16));
+      __m128i c = _mm_loadu_si128((const __m128i*)(src + x + 32));
+      __m128i d = _mm_loadu_si128((const __m128i*)(src + x + 48));
+      _mm_store_si128((__m128i*)(dst + x), a);
+      _mm_store_si128((__m128i*)(dst + x + 16), b);
+      _mm_store_si128((__m128i*)(dst + x + 32), c);
+      _mm_store_si128((__m128i*)(dst + x + 48), d);
+    }
+  }
+  for (; x + 16 <= width; x += 16)
+    _mm_storeu_si128((__m128i*)(dst + x), _mm_loadu_si128((const __m128i*)(src + x)));
+  memcpy(dst + x, src + x, width - x);
+}
+#endif
+
+void CPlaneCopy::Copy(uint8_t *dst, int dstStride,
+                      const uint8_t *src, int srcStride,
+                      int width, int height)
+{
+  if (width <= 0 || height <= 0)
+    return;
+
+  // a contiguous plane is one copy
+  if (width == srcStride && width == dstStride)
+  {
+    width *= height;
+    height = 1;
+  }
+
+#ifdef __SSE2__
+  if (!m_forcePortable && UseSSE2())
+  {
+    for (int y = 0; y < height; y++, dst += dstStride, src += srcStride)
+      CopyRowSSE2(dst, src, width);
+    return;
+  }
+#endif
+
+  for (int y = 0; y < height; y++, dst += dstStride, src += srcStride)
+    fast_memcpy(dst, src, width);
+}
+
+#ifdef HAS_STREAM_LOAD
+static void CopyRowUncached(uint8_t *dst, const uint8_t *src, int width)
+{
+  // movntdqa needs an aligned source
+  int x = (16 - ((uintptr_t)src & 15)) & 15;
+  if (x > width)
+    x = width;
+  memcpy(dst, src, x);
+
+  for (; x + 64 <= width; x += 64)
+  {
+#if defined(TARGET_WINDOWS)
+    __m128i a = _mm_stream_load_si128((__m128i*)(src + x));
+    __m128i b = _mm_stream_load_si128((__m128i*)(src + x + 16));
+    __m128i c = _mm_stream_load_si128((__m128i*)(src + x + 32));
+    __m128i d = _mm_stream_load_si128((__m128i*)(src + x + 48));
+    _mm_storeu_si128((__m128i*)(dst + x), a);
+    _mm_storeu_si128((__m128i*)(dst + x + 16), b);
+    _mm_storeu_si128((__m128i*)(dst + x + 32), c);
+    _mm_storeu_si128((__m128i*)(dst + x + 48), d);
+#else
+    __asm__ volatile(
+      "movntdqa   0(%0), %%xmm0\n"
+      "movntdqa  16(%0), %%xmm1\n"
+      "movntdqa  32(%0), %%xmm2\n"
+      "movntdqa  48(%0), %%xmm3\n"
+      "movdqu %%xmm0,  0(%1)\n"
+      "movdqu %%xmm1, 16(%1)\n"
+      "movdqu %%xmm2, 32(%1)\n"
+      "movdqu %%xmm3, 48(%1)\n"
+      :
+      : "r"(src + x), "r"(dst + x)
+      : "memory", "xmm0", "xmm1", "xmm2", "xmm3");
+#endif
+  }
+  memcpy(dst + x, src + x, width - x);
+}
+#endif
+
+void CPlaneCopy::CopyUncached(uint8_t *dst, int dstStride,
+                              const uint8_t *src, int srcStride,
+                              int width, int height)
+{
+#ifdef HAS_STREAM_LOAD
+  if (width > 0 && !m_forcePortable && (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_SSE4))
+  {
+    // order the loads after whatever wrote the surface
+    _mm_mfence();
+    for (int y = 0; y < height; y++, dst += dstStride, src += srcStride)
+      CopyRowUncached(dst, src, width);
+    return;
+  }
+#endif
+
+  Copy(dst, dstStride, src, srcStride, width, height);
+}
+
+//-----------------------------------------------------------------------------
+// NV12 chroma
+//-----------------------------------------------------------------------------
+
+void CPlaneCopy::InterleaveUV(uint8_t *dst, int dstStride,
+                              const uint8_t *srcU, int srcStrideU,
+                              const uint8_t *srcV, int srcStrideV,
+                              int width, int height)
+{
+#ifdef __SSE2__
+  bool sse2 = !m_forcePortable && UseSSE2();
+#endif
+
+  for (int y = 0; y < height; y++)
+  {
+    uint8_t       *d = dst  + y * dstStride;
+    const uint8_t *u = srcU + y * srcStrideU;
+    const uint8_t *v = srcV + y * srcStrideV;
+    int x = 0;
+
+#ifdef __SSE2__
+    if (sse2)
+    {
+      for (; x + 16 <= width; x += 16)
+      {
+        __m128i mu = _mm_loadu_si128((const __m128i*)(u + x));
+        __m128i mv = _mm_loadu_si128((const __m128i*)(v + x));
+        _mm_storeu_si128((__m128i*)(d + 2 * x)     , _mm_unpacklo_epi8(mu, mv));
+        _mm_storeu_si128((__m128i*)(d + 2 * x + 16), _mm_unpackhi_epi8(mu, mv));
+      }
+    }
+#endif
+
+    for (; x < width; x++)
+    {
+      d[2 * x]     = u[x];
+      d[2 * x + 1] = v[x];
+    }
+  }
+}
+
+void CPlaneCopy::DeinterleaveUV(uint8_t *dstU, int dstStrideU,
+                                uint8_t *dstV, int dstStrideV,
+                                const uint8_t *src, int srcStride,
+                                int width, int height)
+{
+#ifdef __SSE2__
+  bool sse2 = !m_forcePortable && UseSSE2();
+  const __m128i mask = _mm_set1_epi16(0x00ff);
+#endif
+
+  for (int y = 0; y < height; y++)
+  {
+    uint8_t       *u = dstU + y * dstStrideU;
+    uint8_t       *v = dstV + y * dstStrideV;
+    const uint8_t *s = src  + y * srcStride;
+    int x = 0;
+
+#ifdef __SSE2__
+    if (sse2)
+    {
+      for (; x + 16 <= width; x += 16)
+      {
+        __m128i a = _mm_loadu_si128((const __m128i*)(s + 2 * x));
+        __m128i b = _mm_loadu_si128((const __m128i*)(s + 2 * x + 16));
+        __m128i mu = _mm_packus_epi16(_mm_and_si128(a, mask), _mm_and_si128(b, mask));
+        __m128i mv = _mm_packus_epi16(_mm_srli_epi16(a, 8), _mm_srli_epi16(b, 8));
+        _mm_storeu_si128((__m128i*)(u + x), mu);
+        _mm_storeu_si128((__m128i*)(v + x), mv);
+      }
+    }
+#endif
+
+    for (; x < width; x++)
+    {
+      u[x] = s[2 * x];
+      v[x] = s[2 * x + 1];
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+// packed 4:2:2
+//-----------------------------------------------------------------------------
+
+void CPlaneCopy::PackYUV422(uint8_t *dst, int dstStride,
+                            const uint8_t *srcY, int srcStrideY,
+                            const uint8_t *srcU, int srcStrideU,
+                            const uint8_t *srcV, int srcStrideV,
+                            int width, int height, bool uyvy)
+{
+#ifdef __SSE2__
+  bool sse2 = !m_forcePortable && UseSSE2();
+#endif
+
+  // byte offsets of the samples in a packed pair of pixels
+  int oy = uyvy ? 1 : 0;
+  int oc = uyvy ? 0 : 1;
+
+  for (int y = 0; y < height; y++)
+  {
+    uint8_t       *d  = dst  + y * dstStride;
+    const uint8_t *sy = srcY + y * srcStrideY;
+    const uint8_t *su = srcU + (y >> 1) * srcStrideU;
+    const uint8_t *sv = srcV + (y >> 1) * srcStrideV;
+    int x = 0;
+
+#ifdef __SSE2__
+    if (sse2)
+    {
+      for (; x + 16 <= width; x += 16)
+      {
+        __m128i my = _mm_loadu_si128((const __m128i*)(sy + x));
+        __m128i mu = _mm_loadl_epi64((const __m128i*)(su + x / 2));
+        __m128i mv = _mm_loadl_epi64((const __m128i*)(sv + x / 2));
+        __m128i uv = _mm_unpacklo_epi8(mu, mv);
+        __m128i lo, hi;
+        if (uyvy)
+        {
+          lo = _mm_unpacklo_epi8(uv, my);
+          hi = _mm_unpackhi_epi8(uv, my);
+        }
+        else
+        {
+          lo = _mm_unpacklo_epi8(my, uv);
+          hi = _mm_unpackhi_epi8(my, uv);
+        }
+        _mm_storeu_si128((__m128i*)(d + 2 * x)     , lo);
+        _mm_storeu_si128((__m128i*)(d + 2 * x + 16), hi);
+      }
+    }
+#endif
+
+    for (; x + 1 < width; x += 2)
+    {
+      uint8_t *p = d + 2 * x;
+      p[oy]      = sy[x];
+      p[oc]      = su[x / 2];
+      p[oy + 2]  = sy[x + 1];
+      p[oc + 2]  = sv[x / 2];
+    }
+    // odd width, the last pixel has no pair to carry V
+    if (x < width)
+    {
+      d[2 * x + oy] = sy[x];
+      d[2 * x + oc] = su[x / 2];
+    }
+  }
+}
+
+//-----------------------------------------------------------------------------
+// 2x2 reduction
+//-----------------------------------------------------------------------------
+
+void CPlaneCopy::HalvePixels(uint8_t *dst, int dstStride,
+                             const uint8_t *src, int srcStride,
+                             int width, int height)
+{
+#ifdef __SSE2__
+  bool sse2 = !m_forcePortable && UseSSE2();
+#endif
+
+  for (int y = 0; y < height; y++)
+  {
+    uint8_t       *d  = dst + y * dstStride;
+    const uint8_t *s0 = src + 2 * y * srcStride;
+    const uint8_t *s1 = s0 + srcStride;
+    int x = 0;
+
+#ifdef __SSE2__
+    if (sse2)
+    {
+      const __m128i zero  = _mm_setzero_si128();
+      const __m128i round = _mm_set1_epi16(2);
+      for (; x + 4 <= width; x += 4)
+      {
+        // 8 source pixels of each row give 4 pixels
+        __m128i a0 = _mm_loadu_si128((const __m128i*)(s0 + 8 * x));
+        __m128i a1 = _mm_loadu_si128((const __m128i*)(s0 + 8 * x + 16));
+        __m128i b0 = _mm_loadu_si128((const __m128i*)(s1 + 8 * x));
+        __m128i b1 = _mm_loadu_si128((const __m128i*)(s1 + 8 * x + 16));
+
+        // vertical sums, two pixels per register as 16 bit channels
+        __m128i v0 = _mm_add_epi16(_mm_unpacklo_epi8(a0, zero), _mm_unpacklo_epi8(b0, zero));
+        __m128i v1 = _mm_add_epi16(_mm_unpackhi_epi8(a0, zero), _mm_unpackhi_epi8(b0, zero));
+        __m128i v2 = _mm_add_epi16(_mm_unpacklo_epi8(a1, zero), _mm_unpacklo_epi8(b1, zero));
+        __m128i v3 = _mm_add_epi16(_mm_unpackhi_epi8(a1, zero), _mm_unpackhi_epi8(b1, zero));
+
+        // horizontal sums of the pairs
+        __m128i h0 = _mm_add_epi16(_mm_unpacklo_epi64(v0, v1), _mm_unpackhi_epi64(v0, v1));
+        __m128i h1 = _mm_add_epi16(_mm_unpacklo_epi64(v2, v3), _mm_unpackhi_epi64(v2, v3));
+
+        h0 = _mm_srli_epi16(_mm_add_epi16(h0, round), 2);
+        h1 = _mm_srli_epi16(_mm_add_epi16(h1, round), 2);
+        _mm_storeu_si128((__m128i*)(d + 4 * x), _mm_packus_epi16(h0, h1));
+      }
+    }
+#endif
+
+    for (; x < width; x++)
+    {
+      const uint8_t *p0 = s0 + 8 * x;
+      const uint8_t *p1 = s1 + 8 * x;
+      for (int c = 0; c < 4; c++)
+        d[4 * x + c] = (uint8_t)((p0[c] + p0[c + 4] + p1[c] + p1[c + 4] + 2) >> 2);
+    }
+  }
+}
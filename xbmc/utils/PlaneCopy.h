@@ -0,0 +1,103 @@
+#pragma once
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+
+/*!
+ \brief Copy and conversion kernels for 8 bit picture planes
+
+ Each kernel has a SSE2 implementation and a portable one, the SSE2 one is
+ used when it was compiled in and CCPUInfo reports the cpu supports it.
+ Pointers and strides don't need any alignment, aligned rows are faster.
+ Widths are in bytes for copies and in samples of the destination or source
+ plane for conversions, as documented for each function.
+ */
+class CPlaneCopy
+{
+public:
+  /*!
+   \brief Copy a plane
+   \param width bytes to copy of each row
+   */
+  static void Copy(uint8_t *dst, int dstStride,
+                   const uint8_t *src, int srcStride,
+                   int width, int height);
+
+  /*!
+   \brief Copy a plane out of uncached, write combined memory (USWC)
+
+   Reading a mapped hardware surface with ordinary loads is very slow, the
+   copy uses SSE4.1 streaming loads instead when the cpu has them.
+   \param width bytes to copy of each row
+   */
+  static void CopyUncached(uint8_t *dst, int dstStride,
+                           const uint8_t *src, int srcStride,
+                           int width, int height);
+
+  /*!
+   \brief Interleave a U and a V plane into the UV plane of a NV12 picture
+   \param width samples of each chroma row
+   */
+  static void InterleaveUV(uint8_t *dst, int dstStride,
+                           const uint8_t *srcU, int srcStrideU,
+                           const uint8_t *srcV, int srcStrideV,
+                           int width, int height);
+
+  /*!
+   \brief Split the UV plane of a NV12 picture into a U and a V plane
+   \param width samples of each chroma row
+   */
+  static void DeinterleaveUV(uint8_t *dstU, int dstStrideU,
+                             uint8_t *dstV, int dstStrideV,
+                             const uint8_t *src, int srcStride,
+                             int width, int height);
+
+  /*!
+   \brief Pack a 4:2:0 planar picture into YUYV or UYVY
+
+   Each chroma row is used for two rows of the packed picture.
+   \param width, height size of the picture in luma samples
+   \param uyvy true for UYVY, false for YUYV
+   */
+  static void PackYUV422(uint8_t *dst, int dstStride,
+                         const uint8_t *srcY, int srcStrideY,
+                         const uint8_t *srcU, int srcStrideU,
+                         const uint8_t *srcV, int srcStrideV,
+                         int width, int height, bool uyvy);
+
+  /*!
+   \brief Halve a picture of 32 bit pixels, each pixel the average of a 2x2 block
+
+   Works on each byte of a pixel on its own, so any 4 byte pixel format will do.
+   \param width, height size of the destination in pixels, the source is at least twice that
+   */
+  static void HalvePixels(uint8_t *dst, int dstStride,
+                          const uint8_t *src, int srcStride,
+                          int width, int height);
+
+  /*!
+   \brief Use the portable kernels even where the SIMD ones could run, so both can be tested
+   */
+  static void ForcePortable(bool portable);
+
+private:
+  static bool m_forcePortable;
+};
@@ -0,0 +1,194 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "RFFT.h"
+
+#include <algorithm>
+#include <math.h>
+
+#if defined(TARGET_WINDOWS) && _M_IX86_FP>0 && !defined(__SSE__)
+#define __SSE__
+#endif
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+CRFFT::CRFFT(unsigned int size, unsigned int frames, WindowType window)
+{
+  m_size   = size;
+  m_frames = std::min(frames, size);
+
+  m_window.resize(m_frames);
+  for (unsigned int i = 0; i < m_frames; ++i)
+  {
+    double x = 2.0 * M_PI * i / m_frames;
+    switch (window)
+    {
+      case WINDOW_HANN:
+        m_window[i] = (float)(0.5 * (1.0 - cos(x)));
+        break;
+      case WINDOW_HAMMING:
+        m_window[i] = (float)(0.54 - 0.46 * cos(x));
+        break;
+      case WINDOW_BLACKMAN:
+        m_window[i] = (float)(0.42 - 0.5 * cos(x) + 0.08 * cos(2.0 * x));
+        break;
+      default:
+        m_window[i] = 1.0f;
+        break;
+    }
+  }
+
+  unsigned int bits = 0;
+  while ((1U << bits) < m_size)
+    bits++;
+  m_reverse.resize(m_size);
+  for (unsigned int i = 0; i < m_size; ++i)
+  {
+    unsigned int r = 0;
+    for (unsigned int b = 0; b < bits; ++b)
+      r |= ((i >> b) & 1) << (bits - 1 - b);
+    m_reverse[i] = r;
+  }
+
+  m_twiddleRe.resize(std::max(m_size, 1U) - 1);
+  m_twiddleIm.resize(std::max(m_size, 1U) - 1);
+  for (unsigned int half = 1; half < m_size; half <<= 1)
+  {
+    for (unsigned int k = 0; k < half; ++k)
+    {
+      double theta = -M_PI * k / half;
+      m_twiddleRe[half - 1 + k] = (float)cos(theta);
+      m_twiddleIm[half - 1 + k] = (float)sin(theta);
+    }
+  }
+
+  m_re.resize(m_size);
+  m_im.resize(m_size);
+}
+
+void CRFFT::TwoChannelPower(const float *input, float *output)
+{
+  if (m_size < 2)
+    return;
+
+  /* pack left into the real and right into the imaginary part, in bit reversed order */
+  std::fill(m_re.begin(), m_re.end(), 0.0f);
+  std::fill(m_im.begin(), m_im.end(), 0.0f);
+  for (unsigned int i = 0; i < m_frames; ++i)
+  {
+    m_re[m_reverse[i]] = input[2 * i]     * m_window[i];
+    m_im[m_reverse[i]] = input[2 * i + 1] * m_window[i];
+  }
+
+  Transform();
+
+  /* separate the two real spectra, X(k) and conj(X(n - k)) hold the sum and
+     difference of both channels */
+  const unsigned int n = m_size;
+  output[0]     = m_re[0] * m_re[0];
+  output[1]     = m_im[0] * m_im[0];
+  output[n]     = m_re[n / 2] * m_re[n / 2];
+  output[n + 1] = m_im[n / 2] * m_im[n / 2];
+  for (unsigned int k = 1; k < n / 2; ++k)
+  {
+    float rep = m_re[k] + m_re[n - k];
+    float rem = m_re[k] - m_re[n - k];
+    float aip = m_im[k] + m_im[n - k];
+    float aim = m_im[k] - m_im[n - k];
+    output[2 * k]     = 0.5f * (rep * rep + aim * aim);
+    output[2 * k + 1] = 0.5f * (rem * rem + aip * aip);
+  }
+}
+
+void CRFFT::Transform()
+{
+  float *re = &m_re[0];
+  float *im = &m_im[0];
+
+  for (unsigned int half = 1; half < m_size; half <<= 1)
+  {
+    const float *wr = &m_twiddleRe[half - 1];
+    const float *wi = &m_twiddleIm[half - 1];
+
+    for (unsigned int start = 0; start < m_size; start += half << 1)
+    {
+      float *ar = re + start;
+      float *ai = im + start;
+      float *br = ar + half;
+      float *bi = ai + half;
+      unsigned int k = 0;
+
+#ifdef __SSE__
+      /* from the third stage on the butterflies of a block are contiguous */
+      for (; k + 4 <= half; k += 4)
+      {
+        __m128 twr = _mm_loadu_ps(wr + k);
+        __m128 twi = _mm_loadu_ps(wi + k);
+        __m128 xbr = _mm_loadu_ps(br + k);
+        __m128 xbi = _mm_loadu_ps(bi + k);
+        __m128 tr  = _mm_sub_ps(_mm_mul_ps(xbr, twr), _mm_mul_ps(xbi, twi));
+        __m128 ti  = _mm_add_ps(_mm_mul_ps(xbr, twi), _mm_mul_ps(xbi, twr));
+        __m128 xar = _mm_loadu_ps(ar + k);
+        __m128 xai = _mm_loadu_ps(ai + k);
+        _mm_storeu_ps(br + k, _mm_sub_ps(xar, tr));
+        _mm_storeu_ps(bi + k, _mm_sub_ps(xai, ti));
+        _mm_storeu_ps(ar + k, _mm_add_ps(xar, tr));
+        _mm_storeu_ps(ai + k, _mm_add_ps(xai, ti));
+      }
+#endif
+      for (; k < half; ++k)
+      {
+        float tr = br[k] * wr[k] - bi[k] * wi[k];
+        float ti = br[k] * wi[k] + bi[k] * wr[k];
+        br[k] = ar[k] - tr;
+        bi[k] = ai[k] - ti;
+        ar[k] += tr;
+        ai[k] += ti;
+      }
+    }
+  }
+}
+
+void CRFFT::AggregateBands(const float *power, unsigned int size, float *bands, unsigned int count)
+{
+  const unsigned int nyquist = size / 2;
+  unsigned int lo = 1;
+  for (unsigned int b = 0; b < count; ++b)
+  {
+    unsigned int hi = (unsigned int)floor(pow((double)nyquist, (double)(b + 1) / count) + 0.5);
+    if (b == count - 1)
+      hi = nyquist + 1;
+    lo = std::min(lo, nyquist);
+    hi = std::min(std::max(hi, lo + 1), nyquist + 1);
+
+    float sum = 0.0f;
+    for (unsigned int k = lo; k < hi; ++k)
+      sum += power[2 * k] + power[2 * k + 1];
+    bands[b] = sum / (2 * (hi - lo));
+
+    lo = hi;
+  }
+}
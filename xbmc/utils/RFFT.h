@@ -0,0 +1,83 @@
+#pragma once
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <vector>
+
+/*!
+ \brief Power spectrum of two real channels
+
+ Both channels are transformed at once by packing them into the real and
+ imaginary part of one complex FFT, like twochanwithwindow() does. Window,
+ bit reversal and twiddle factors are computed once on construction, the
+ butterflies work on split real/imaginary arrays so that they vectorize with
+ SSE where available.
+ */
+class CRFFT
+{
+public:
+  enum WindowType
+  {
+    WINDOW_RECTANGULAR = 0,
+    WINDOW_HANN,
+    WINDOW_HAMMING,
+    WINDOW_BLACKMAN
+  };
+
+  /*!
+   \param size number of points of the transform, must be a power of two
+   \param frames number of input frames per channel, at most size. Input
+                 shorter than the transform is windowed and zero padded.
+   \param window window function applied to the input frames
+   */
+  CRFFT(unsigned int size, unsigned int frames, WindowType window = WINDOW_HANN);
+
+  unsigned int GetSize() const   { return m_size; }
+  unsigned int GetFrames() const { return m_frames; }
+
+  /*!
+   \brief Compute the power spectrum of interleaved stereo frames
+   \param input GetFrames() interleaved left/right frames
+   \param output GetSize() + 2 floats, the power of bins 0 to GetSize() / 2
+                 interleaved left/right, scaled like twochanwithwindow()
+   */
+  void TwoChannelPower(const float *input, float *output);
+
+  /*!
+   \brief Sum a two channel power spectrum into logarithmically spaced bands
+   \param power output of TwoChannelPower for a transform of size points
+   \param size the transform size
+   \param bands receives the mean power of both channels per band
+   \param count number of bands, the lowest band starts above DC
+   */
+  static void AggregateBands(const float *power, unsigned int size, float *bands, unsigned int count);
+
+private:
+  void Transform();
+
+  unsigned int              m_size;
+  unsigned int              m_frames;
+  std::vector<float>        m_window;
+  std::vector<unsigned int> m_reverse;
+  std::vector<float>        m_twiddleRe;  ///< per stage, stage with half size h starts at h - 1
+  std::vector<float>        m_twiddleIm;
+  std::vector<float>        m_re;
+  std::vector<float>        m_im;
+};
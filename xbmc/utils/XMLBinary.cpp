@@ -0,0 +1,265 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "XMLBinary.h"
+#include "utils/XBMCTinyXML.h"
+
+#include <map>
+#include <memory>
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+
+using namespace std;
+
+#define XMLBINARY_MAGIC     0x42584d58  // "XMXB"
+#define XMLBINARY_MAX_DEPTH 256
+
+enum XMLBINARY_NODE
+{
+  XMLBINARY_ELEMENT = 1,
+  XMLBINARY_TEXT,
+  XMLBINARY_CDATA,
+  XMLBINARY_COMMENT,
+  XMLBINARY_UNKNOWN
+};
+
+namespace
+{
+class CWriter
+{
+public:
+  void Put8(string &out, uint8_t value) { out.append((const char *)&value, sizeof(value)); }
+  void Put32(string &out, uint32_t value) { out.append((const char *)&value, sizeof(value)); }
+
+  void PutString(string &out, const string &str)
+  {
+    map<string, uint32_t>::const_iterator it = m_index.find(str);
+    if (it == m_index.end())
+    {
+      it = m_index.insert(make_pair(str, (uint32_t)m_strings.size())).first;
+      m_strings.push_back(str);
+    }
+    Put32(out, it->second);
+  }
+
+  void PutNode(string &out, const TiXmlNode *node)
+  {
+    switch (node->Type())
+    {
+      case TiXmlNode::TINYXML_ELEMENT:
+      {
+        const TiXmlElement *element = node->ToElement();
+        Put8(out, XMLBINARY_ELEMENT);
+        PutString(out, element->ValueStr());
+
+        uint32_t count = 0;
+        for (const TiXmlAttribute *attribute = element->FirstAttribute(); attribute; attribute = attribute->Next())
+          count++;
+        Put32(out, count);
+        for (const TiXmlAttribute *attribute = element->FirstAttribute(); attribute; attribute = attribute->Next())
+        {
+          PutString(out, attribute->NameTStr());
+          PutString(out, attribute->ValueStr());
+        }
+
+        count = 0;
+        for (const TiXmlNode *child = element->FirstChild(); child; child = child->NextSibling())
+        {
+          if (IsStored(child))
+            count++;
+        }
+        Put32(out, count);
+        for (const TiXmlNode *child = element->FirstChild(); child; child = child->NextSibling())
+        {
+          if (IsStored(child))
+            PutNode(out, child);
+        }
+        break;
+      }
+      case TiXmlNode::TINYXML_TEXT:
+        Put8(out, node->ToText()->CDATA() ? XMLBINARY_CDATA : XMLBINARY_TEXT);
+        PutString(out, node->ValueStr());
+        break;
+      case TiXmlNode::TINYXML_COMMENT:
+        Put8(out, XMLBINARY_COMMENT);
+        PutString(out, node->ValueStr());
+        break;
+      default:
+        Put8(out, XMLBINARY_UNKNOWN);
+        PutString(out, node->ValueStr());
+        break;
+    }
+  }
+
+  static bool IsStored(const TiXmlNode *node)
+  {
+    return node->Type() != TiXmlNode::TINYXML_DOCUMENT && node->Type() != TiXmlNode::TINYXML_DECLARATION;
+  }
+
+  vector<string> m_strings;
+
+private:
+  map<string, uint32_t> m_index;
+};
+
+class CReader
+{
+public:
+  CReader(const string &data) : m_data(data), m_pos(0) {}
+
+  bool Get8(uint8_t &value) { return Get(&value, sizeof(value)); }
+  bool Get32(uint32_t &value) { return Get(&value, sizeof(value)); }
+
+  bool GetStrings()
+  {
+    uint32_t count;
+    if (!Get32(count) || count > m_data.size())
+      return false;
+    m_strings.reserve(count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+      uint32_t length;
+      if (!Get32(length) || length > m_data.size() - m_pos)
+        return false;
+      m_strings.push_back(m_data.substr(m_pos, length));
+      m_pos += length;
+    }
+    return true;
+  }
+
+  const string *GetString()
+  {
+    uint32_t index;
+    if (!Get32(index) || index >= m_strings.size())
+      return NULL;
+    return &m_strings[index];
+  }
+
+  TiXmlNode *GetNode(int depth)
+  {
+    uint8_t type;
+    if (depth > XMLBINARY_MAX_DEPTH || !Get8(type))
+      return NULL;
+
+    const string *value = GetString();
+    if (!value)
+      return NULL;
+
+    switch (type)
+    {
+      case XMLBINARY_ELEMENT:
+      {
+        auto_ptr<TiXmlElement> element(new TiXmlElement(*value));
+        uint32_t count;
+        if (!Get32(count))
+          return NULL;
+        for (uint32_t i = 0; i < count; i++)
+        {
+          const string *name = GetString();
+          const string *attribute = GetString();
+          if (!name || !attribute)
+            return NULL;
+          element->SetAttribute(*name, *attribute);
+        }
+        if (!Get32(count))
+          return NULL;
+        for (uint32_t i = 0; i < count; i++)
+        {
+          TiXmlNode *child = GetNode(depth + 1);
+          if (!child)
+            return NULL;
+          element->LinkEndChild(child);
+        }
+        return element.release();
+      }
+      case XMLBINARY_TEXT:
+      case XMLBINARY_CDATA:
+      {
+        TiXmlText *text = new TiXmlText(*value);
+        text->SetCDATA(type == XMLBINARY_CDATA);
+        return text;
+      }
+      case XMLBINARY_COMMENT:
+      {
+        TiXmlComment *comment = new TiXmlComment();
+        comment->SetValue(*value);
+        return comment;
+      }
+      case XMLBINARY_UNKNOWN:
+      {
+        TiXmlUnknown *unknown = new TiXmlUnknown();
+        unknown->SetValue(*value);
+        return unknown;
+      }
+      default:
+        return NULL;
+    }
+  }
+
+  bool AtEnd() const { return m_pos == m_data.size(); }
+
+private:
+  bool Get(void *value, size_t size)
+  {
+    if (size > m_data.size() - m_pos)
+      return false;
+    memcpy(value, m_data.data() + m_pos, size);
+    m_pos += size;
+    return true;
+  }
+
+  const string  &m_data;
+  size_t         m_pos;
+  vector<string> m_strings;
+};
+}
+
+void CXMLBinary::Compile(const TiXmlElement *root, string &data)
+{
+  CWriter writer;
+  string nodes;
+  writer.PutNode(nodes, root);
+
+  data.clear();
+  writer.Put32(data, XMLBINARY_MAGIC);
+  writer.Put32(data, writer.m_strings.size());
+  for (vector<string>::const_iterator i = writer.m_strings.begin(); i != writer.m_strings.end(); ++i)
+  {
+    writer.Put32(data, i->size());
+    data += *i;
+  }
+  data += nodes;
+}
+
+TiXmlElement *CXMLBinary::Load(const string &data)
+{
+  CReader reader(data);
+  uint32_t magic;
+  if (!reader.Get32(magic) || magic != XMLBINARY_MAGIC || !reader.GetStrings())
+    return NULL;
+
+  TiXmlNode *root = reader.GetNode(0);
+  if (root && root->Type() == TiXmlNode::TINYXML_ELEMENT && reader.AtEnd())
+    return root->ToElement();
+
+  delete root;
+  return NULL;
+}
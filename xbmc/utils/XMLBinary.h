@@ -0,0 +1,50 @@
+#pragma once
+
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string>
+
+class TiXmlElement;
+
+/*!
+ \brief Compiled form of an xml element and its children
+
+ Rebuilding a tree from its compiled form skips reading, charset conversion,
+ tokenizing and entity decoding of the xml. All names and values are kept
+ once in a string table, the nodes follow in document order as indices into
+ it. The data is in the byte order of the machine, it is meant for caches
+ and not for exchange.
+ */
+class CXMLBinary
+{
+public:
+  /*! \brief Compile an element and everything below it
+   \param root the element to compile
+   \param data [out] the compiled data
+   */
+  static void Compile(const TiXmlElement *root, std::string &data);
+
+  /*! \brief Rebuild an element from its compiled form
+   \param data the compiled data
+   \return the element, owned by the caller, or NULL if the data is invalid
+   */
+  static TiXmlElement *Load(const std::string &data);
+};
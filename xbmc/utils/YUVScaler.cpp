@@ -0,0 +1,328 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "YUVScaler.h"
+#include "CPUInfo.h"
+
+#if defined(TARGET_WINDOWS) && (_M_IX86_FP>1 || defined(_M_X64)) && !defined(__SSE2__)
+#define __SSE2__
+#endif
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+static bool UseSSE2()
+{
+#ifdef __SSE2__
+  return (g_cpuInfo.GetCPUFeatures() & CPU_FEATURE_SSE2) != 0;
+#else
+  return false;
+#endif
+}
+
+static inline uint8_t Clamp8(int value)
+{
+  return value < 0 ? 0 : (value > 255 ? 255 : (uint8_t)value);
+}
+
+// interpolate between two rows, f is the weight of b in 1/128
+static const uint8_t* BlendRows(const uint8_t *a, const uint8_t *b, int f,
+                                int count, uint8_t *out, bool sse2)
+{
+  if (f == 0)
+    return a;
+
+  int x = 0;
+#ifdef __SSE2__
+  if (sse2)
+  {
+    const __m128i zero  = _mm_setzero_si128();
+    const __m128i wa    = _mm_set1_epi16(128 - f);
+    const __m128i wb    = _mm_set1_epi16(f);
+    const __m128i round = _mm_set1_epi16(64);
+    for (; x + 16 <= count; x += 16)
+    {
+      __m128i ma = _mm_loadu_si128((const __m128i*)(a + x));
+      __m128i mb = _mm_loadu_si128((const __m128i*)(b + x));
+      __m128i lo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(ma, zero), wa),
+                                 _mm_mullo_epi16(_mm_unpacklo_epi8(mb, zero), wb));
+      __m128i hi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(ma, zero), wa),
+                                 _mm_mullo_epi16(_mm_unpackhi_epi8(mb, zero), wb));
+      lo = _mm_srli_epi16(_mm_add_epi16(lo, round), 7);
+      hi = _mm_srli_epi16(_mm_add_epi16(hi, round), 7);
+      _mm_storeu_si128((__m128i*)(out + x), _mm_packus_epi16(lo, hi));
+    }
+  }
+#endif
+  for (; x < count; x++)
+    out[x] = (a[x] * (128 - f) + b[x] * f + 64) >> 7;
+
+  return out;
+}
+
+CYUVScaler::CYUVScaler()
+{
+  m_format    = FORMAT_YUV420P;
+  m_srcWidth  = 0;
+  m_srcHeight = 0;
+  m_dstWidth  = 0;
+  m_dstHeight = 0;
+  SetColorMatrix(1.403f, -0.344f, -0.714f, 1.773f, false);
+}
+
+void CYUVScaler::CalcTaps(std::vector<STap> &taps, int srcSize, int dstSize)
+{
+  taps.resize(dstSize);
+  for (int i = 0; i < dstSize; i++)
+  {
+    // centre of the output sample in the source, in 16.16 fixed point
+    int64_t pos = ((int64_t)(2 * i + 1) * srcSize << 16) / (2 * dstSize) - 32768;
+    if (pos < 0)
+      pos = 0;
+
+    STap &tap = taps[i];
+    tap.p0 = (int)(pos >> 16);
+    tap.f  = (int)(pos >> 9) & 127;
+    if (tap.p0 >= srcSize - 1)
+    {
+      tap.p0 = srcSize - 1;
+      tap.f  = 0;
+    }
+    tap.p1 = tap.p0 + (tap.p0 < srcSize - 1 ? 1 : 0);
+  }
+}
+
+void CYUVScaler::Configure(EFormat format, int srcWidth, int srcHeight, int dstWidth, int dstHeight)
+{
+  m_format = format;
+
+  if (srcWidth != m_srcWidth || dstWidth != m_dstWidth)
+  {
+    CalcTaps(m_lumaCols,   srcWidth, dstWidth);
+    CalcTaps(m_chromaCols, (srcWidth + 1) >> 1, dstWidth);
+  }
+  if (srcHeight != m_srcHeight || dstHeight != m_dstHeight)
+  {
+    CalcTaps(m_lumaRows,   srcHeight, dstHeight);
+    CalcTaps(m_chromaRows, (srcHeight + 1) >> 1, dstHeight);
+  }
+
+  m_srcWidth  = srcWidth;
+  m_srcHeight = srcHeight;
+  m_dstWidth  = dstWidth;
+  m_dstHeight = dstHeight;
+}
+
+void CYUVScaler::SetColorMatrix(float vr, float ug, float vg, float ub, bool fullRange)
+{
+  float yScale = fullRange ? 1.0f : 255.0f / 219.0f;
+  float cScale = fullRange ? 1.0f : 255.0f / 224.0f;
+
+  m_yOffset = fullRange ? 0 : 16;
+  m_yCoef   = (int16_t)(yScale * 8192.0f + 0.5f);
+  m_vrCoef  = (int16_t)(vr * cScale * 8192.0f + (vr < 0.0f ? -0.5f : 0.5f));
+  m_ugCoef  = (int16_t)(ug * cScale * 8192.0f + (ug < 0.0f ? -0.5f : 0.5f));
+  m_vgCoef  = (int16_t)(vg * cScale * 8192.0f + (vg < 0.0f ? -0.5f : 0.5f));
+  m_ubCoef  = (int16_t)(ub * cScale * 8192.0f + (ub < 0.0f ? -0.5f : 0.5f));
+}
+
+void CYUVScaler::ConvertRow(const uint8_t *y, const uint8_t *u, const uint8_t *v,
+                            uint8_t *dst, int count) const
+{
+  // samples are shifted up by 7 bits and multiplied with the 3.13 fixed point
+  // coefficients keeping the high 16 bits, which leaves 4 fractional bits
+  int x = 0;
+#ifdef __SSE2__
+  if (UseSSE2())
+  {
+    const __m128i zero   = _mm_setzero_si128();
+    const __m128i alpha  = _mm_set1_epi8((char)0xff);
+    const __m128i yoff   = _mm_set1_epi16(m_yOffset);
+    const __m128i coff   = _mm_set1_epi16(128);
+    const __m128i round  = _mm_set1_epi16(8);
+    const __m128i ycoef  = _mm_set1_epi16(m_yCoef);
+    const __m128i vrcoef = _mm_set1_epi16(m_vrCoef);
+    const __m128i ugcoef = _mm_set1_epi16(m_ugCoef);
+    const __m128i vgcoef = _mm_set1_epi16(m_vgCoef);
+    const __m128i ubcoef = _mm_set1_epi16(m_ubCoef);
+
+    for (; x + 8 <= count; x += 8)
+    {
+      __m128i my = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(y + x)), zero);
+      __m128i mu = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(u + x)), zero);
+      __m128i mv = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i*)(v + x)), zero);
+
+      my = _mm_mulhi_epi16(_mm_slli_epi16(_mm_sub_epi16(my, yoff), 7), ycoef);
+      mu = _mm_slli_epi16(_mm_sub_epi16(mu, coff), 7);
+      mv = _mm_slli_epi16(_mm_sub_epi16(mv, coff), 7);
+
+      __m128i r = _mm_add_epi16(my, _mm_mulhi_epi16(mv, vrcoef));
+      __m128i g = _mm_add_epi16(_mm_add_epi16(my, _mm_mulhi_epi16(mu, ugcoef)),
+                                _mm_mulhi_epi16(mv, vgcoef));
+      __m128i b = _mm_add_epi16(my, _mm_mulhi_epi16(mu, ubcoef));
+
+      r = _mm_srai_epi16(_mm_add_epi16(r, round), 4);
+      g = _mm_srai_epi16(_mm_add_epi16(g, round), 4);
+      b = _mm_srai_epi16(_mm_add_epi16(b, round), 4);
+
+      __m128i bg = _mm_unpacklo_epi8(_mm_packus_epi16(b, b), _mm_packus_epi16(g, g));
+      __m128i ra = _mm_unpacklo_epi8(_mm_packus_epi16(r, r), alpha);
+      _mm_storeu_si128((__m128i*)(dst + 4 * x)     , _mm_unpacklo_epi16(bg, ra));
+      _mm_storeu_si128((__m128i*)(dst + 4 * x + 16), _mm_unpackhi_epi16(bg, ra));
+    }
+  }
+#endif
+
+  for (; x < count; x++)
+  {
+    int my = ((y[x] - m_yOffset) * 128 * m_yCoef) >> 16;
+    int mu = (u[x] - 128) * 128;
+    int mv = (v[x] - 128) * 128;
+
+    int r = my + ((mv * m_vrCoef) >> 16);
+    int g = my + ((mu * m_ugCoef) >> 16) + ((mv * m_vgCoef) >> 16);
+    int b = my + ((mu * m_ubCoef) >> 16);
+
+    uint8_t *p = dst + 4 * x;
+    p[0] = Clamp8((b + 8) >> 4);
+    p[1] = Clamp8((g + 8) >> 4);
+    p[2] = Clamp8((r + 8) >> 4);
+    p[3] = 255;
+  }
+}
+
+void CYUVScaler::ResampleRow(const uint8_t *src, int step, const STap *taps, int count, uint8_t *dst)
+{
+  for (int x = 0; x < count; x++)
+  {
+    const STap &tap = taps[x];
+    dst[x] = (src[tap.p0 * step] * (128 - tap.f) + src[tap.p1 * step] * tap.f + 64) >> 7;
+  }
+}
+
+void CYUVScaler::Scale(uint8_t* const src[3], const int srcStride[3],
+                       uint8_t *dst, int dstStride,
+                       int x0, int y0, int x1, int y1) const
+{
+  if (m_srcWidth <= 0 || m_srcHeight <= 0 || x1 <= x0 || y1 <= y0)
+    return;
+
+  bool sse2 = UseSSE2();
+  int  count = x1 - x0;
+  int  chromaWidth = (m_srcWidth + 1) >> 1;
+
+  // rows interpolated between two source rows and then across the row
+  std::vector<uint8_t> buffer(m_srcWidth + 2 * chromaWidth + 3 * count);
+  uint8_t *rowY = &buffer[0];
+  uint8_t *rowU = rowY + m_srcWidth;
+  uint8_t *rowV = rowU + chromaWidth;
+  uint8_t *outY = rowU + 2 * chromaWidth;
+  uint8_t *outU = outY + count;
+  uint8_t *outV = outU + count;
+
+  const STap *lumaCols   = &m_lumaCols[x0];
+  const STap *chromaCols = &m_chromaCols[x0];
+
+  for (int y = y0; y < y1; y++, dst += dstStride)
+  {
+    const STap &ly = m_lumaRows[y];
+    const STap &cy = m_chromaRows[y];
+
+    const uint8_t *py = BlendRows(src[0] + ly.p0 * srcStride[0],
+                                  src[0] + ly.p1 * srcStride[0],
+                                  ly.f, m_srcWidth, rowY, sse2);
+
+    if (m_format == FORMAT_NV12)
+    {
+      const uint8_t *puv = BlendRows(src[1] + cy.p0 * srcStride[1],
+                                     src[1] + cy.p1 * srcStride[1],
+                                     cy.f, 2 * chromaWidth, rowU, sse2);
+      ResampleRow(puv,     2, chromaCols, count, outU);
+      ResampleRow(puv + 1, 2, chromaCols, count, outV);
+    }
+    else
+    {
+      const uint8_t *pu = BlendRows(src[1] + cy.p0 * srcStride[1],
+                                    src[1] + cy.p1 * srcStride[1],
+                                    cy.f, chromaWidth, rowU, sse2);
+      const uint8_t *pv = BlendRows(src[2] + cy.p0 * srcStride[2],
+                                    src[2] + cy.p1 * srcStride[2],
+                                    cy.f, chromaWidth, rowV, sse2);
+      ResampleRow(pu, 1, chromaCols, count, outU);
+      ResampleRow(pv, 1, chromaCols, count, outV);
+    }
+
+    // luma doesn't need to be resampled if the width is kept
+    if (m_srcWidth == m_dstWidth)
+      py += x0;
+    else
+    {
+      ResampleRow(py, 1, lumaCols, count, outY);
+      py = outY;
+    }
+
+    ConvertRow(py, outU, outV, dst, count);
+  }
+}
+
+void CYUVScaler::BlendPremultiplied(uint8_t *dst, const uint8_t *src, int count)
+{
+  // dst * (255 - alpha) / 255 rounded, with the division done as
+  // (t + (t >> 8)) >> 8
+  int x = 0;
+#ifdef __SSE2__
+  if (UseSSE2())
+  {
+    const __m128i zero  = _mm_setzero_si128();
+    const __m128i full  = _mm_set1_epi16(255);
+    const __m128i round = _mm_set1_epi16(128);
+    for (; x + 4 <= count; x += 4)
+    {
+      __m128i s = _mm_loadu_si128((const __m128i*)(src + 4 * x));
+      __m128i d = _mm_loadu_si128((const __m128i*)(dst + 4 * x));
+
+      __m128i slo = _mm_unpacklo_epi8(s, zero);
+      __m128i shi = _mm_unpackhi_epi8(s, zero);
+      __m128i ilo = _mm_sub_epi16(full, _mm_shufflehi_epi16(_mm_shufflelo_epi16(slo, 0xff), 0xff));
+      __m128i ihi = _mm_sub_epi16(full, _mm_shufflehi_epi16(_mm_shufflelo_epi16(shi, 0xff), 0xff));
+
+      __m128i tlo = _mm_add_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(d, zero), ilo), round);
+      __m128i thi = _mm_add_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(d, zero), ihi), round);
+      tlo = _mm_srli_epi16(_mm_add_epi16(tlo, _mm_srli_epi16(tlo, 8)), 8);
+      thi = _mm_srli_epi16(_mm_add_epi16(thi, _mm_srli_epi16(thi, 8)), 8);
+
+      _mm_storeu_si128((__m128i*)(dst + 4 * x), _mm_adds_epu8(s, _mm_packus_epi16(tlo, thi)));
+    }
+  }
+#endif
+
+  for (; x < count; x++)
+  {
+    const uint8_t *s = src + 4 * x;
+    uint8_t       *d = dst + 4 * x;
+    int ia = 255 - s[3];
+    for (int c = 0; c < 4; c++)
+    {
+      int t = d[c] * ia + 128;
+      d[c]  = Clamp8(s[c] + ((t + (t >> 8)) >> 8));
+    }
+  }
+}
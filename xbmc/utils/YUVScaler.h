@@ -0,0 +1,114 @@
+#pragma once
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdint.h>
+#include <vector>
+
+/*!
+ \brief Scales a 4:2:0 picture and converts it to BGRA on the cpu
+
+ Scaling is bilinear, each output row is interpolated from two rows of the
+ source and then across the row. Interpolation between rows, the colour
+ conversion and overlay blending have a SSE2 implementation, used when it
+ was compiled in and the cpu supports it. The portable implementation
+ gives the same results.
+
+ Once configured the scaler is only read, so disjoint parts of the output
+ can be scaled from several threads at the same time.
+ */
+class CYUVScaler
+{
+public:
+  enum EFormat
+  {
+    FORMAT_YUV420P, //!< Y, U and V planes
+    FORMAT_NV12     //!< Y plane and interleaved UV plane, plane 2 is unused
+  };
+
+  CYUVScaler();
+
+  /*!
+   \brief Set up the scaler, it only recalculates what changed since the last call
+   \param srcWidth, srcHeight size of the source picture in luma samples
+   \param dstWidth, dstHeight size the picture is scaled to, which may be
+          larger than the area the caller later asks for
+   */
+  void Configure(EFormat format, int srcWidth, int srcHeight, int dstWidth, int dstHeight);
+
+  /*!
+   \brief Set the colour conversion
+   \param vr, ug, vg, ub contribution of the chroma components to R, G and B
+   \param fullRange true if luma and chroma use the full 0-255 range
+   */
+  void SetColorMatrix(float vr, float ug, float vg, float ub, bool fullRange);
+
+  /*!
+   \brief Scale part of the picture
+   \param src, srcStride the planes of the source picture
+   \param dst, dstStride BGRA output, pointing at pixel x0, y0 of the scaled picture
+   \param x0, y0, x1, y1 part of the scaled picture to output, right and bottom are exclusive
+   */
+  void Scale(uint8_t* const src[3], const int srcStride[3],
+             uint8_t *dst, int dstStride,
+             int x0, int y0, int x1, int y1) const;
+
+  /*!
+   \brief Blend premultiplied BGRA pixels over BGRA pixels
+   */
+  static void BlendPremultiplied(uint8_t *dst, const uint8_t *src, int count);
+
+  /*!
+   \brief Convert a row of Y, U and V samples to BGRA pixels, alpha is set to 255
+   */
+  void ConvertRow(const uint8_t *y, const uint8_t *u, const uint8_t *v,
+                  uint8_t *dst, int count) const;
+
+private:
+  struct STap
+  {
+    int p0;  // first source sample
+    int p1;  // second source sample
+    int f;   // weight of the second one, 0-128
+  };
+
+  static void CalcTaps(std::vector<STap> &taps, int srcSize, int dstSize);
+  // interpolate across a row, step is the distance between samples
+  static void ResampleRow(const uint8_t *src, int step, const STap *taps, int count, uint8_t *dst);
+
+  EFormat m_format;
+  int m_srcWidth;
+  int m_srcHeight;
+  int m_dstWidth;
+  int m_dstHeight;
+
+  std::vector<STap> m_lumaCols;
+  std::vector<STap> m_lumaRows;
+  std::vector<STap> m_chromaCols;
+  std::vector<STap> m_chromaRows;
+
+  // conversion coefficients in 3.13 fixed point
+  int16_t m_yOffset;
+  int16_t m_yCoef;
+  int16_t m_vrCoef;
+  int16_t m_ugCoef;
+  int16_t m_vgCoef;
+  int16_t m_ubCoef;
+};
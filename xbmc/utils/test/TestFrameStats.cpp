@@ -0,0 +1,155 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/FrameStats.h"
+
+#include "gtest/gtest.h"
+
+#include <stdlib.h>
+#include <vector>
+
+namespace
+{
+std::vector<uint8_t> Noise(int size, unsigned int seed)
+{
+  std::vector<uint8_t> data(size);
+  for (int i = 0; i < size; i++)
+  {
+    seed = seed * 1103515245 + 12345;
+    data[i] = (uint8_t)(seed >> 16);
+  }
+  return data;
+}
+}
+
+// odd sizes run through the vector loops and their tails
+static const int widths[] = { 1, 2, 15, 16, 17, 33, 130 };
+
+// run every test with the SSE2 kernels, where available, and the portable ones
+class TestFrameStats : public ::testing::TestWithParam<bool>
+{
+protected:
+  virtual void SetUp()
+  {
+    CFrameStats::ForcePortable(GetParam());
+  }
+
+  virtual void TearDown()
+  {
+    CFrameStats::ForcePortable(false);
+  }
+};
+
+TEST_P(TestFrameStats, Luma)
+{
+  for (size_t i = 0; i < sizeof(widths) / sizeof(widths[0]); i++)
+  {
+    int w = widths[i];
+    int stride = w + 5;
+    std::vector<uint8_t> plane = Noise(stride * 7, w);
+
+    // one byte in, so the rows are unaligned
+    uint64_t sum;
+    uint32_t above;
+    CFrameStats::Luma(&plane[1], stride, w, 7, 100, sum, above);
+
+    uint64_t refSum = 0;
+    uint32_t refAbove = 0;
+    for (int y = 0; y < 7; y++)
+    {
+      for (int x = 0; x < w; x++)
+      {
+        refSum += plane[1 + y * stride + x];
+        if (plane[1 + y * stride + x] > 100)
+          refAbove++;
+      }
+    }
+    EXPECT_EQ(refSum, sum) << "width " << w;
+    EXPECT_EQ(refAbove, above) << "width " << w;
+  }
+}
+
+TEST_P(TestFrameStats, LumaLevels)
+{
+  std::vector<uint8_t> plane(64 * 4, 16);
+  plane[3] = 255;
+  plane[100] = 17;
+
+  uint64_t sum;
+  uint32_t above;
+  CFrameStats::Luma(&plane[0], 64, 64, 4, 16, sum, above);
+  EXPECT_EQ(16u * 254 + 255 + 17, sum);
+  EXPECT_EQ(2u, above);
+
+  CFrameStats::Luma(&plane[0], 64, 64, 4, 255, sum, above);
+  EXPECT_EQ(0u, above);
+}
+
+TEST_P(TestFrameStats, Edges)
+{
+  for (size_t i = 0; i < sizeof(widths) / sizeof(widths[0]); i++)
+  {
+    int w = widths[i];
+    int stride = w + 3;
+    std::vector<uint8_t> src = Noise(stride * 6, w * 3);
+    std::vector<uint8_t> dst(stride * 6, 0xa5);
+
+    CFrameStats::Edges(&dst[0], stride, &src[0], stride, w, 6, 40);
+    for (int y = 0; y < 6; y++)
+    {
+      for (int x = 0; x < w; x++)
+      {
+        uint8_t expected = 0;
+        if (x < w - 1 && y < 5)
+        {
+          int a = src[y * stride + x];
+          if (abs(a - src[y * stride + x + 1]) > 40 || abs(a - src[(y + 1) * stride + x]) > 40)
+            expected = 0xff;
+        }
+        ASSERT_EQ(expected, dst[y * stride + x]) << "width " << w << " x " << x << " y " << y;
+      }
+      for (int x = w; x < stride; x++)
+        EXPECT_EQ(0xa5, dst[y * stride + x]) << "width " << w << " wrote past the row";
+    }
+  }
+}
+
+TEST_P(TestFrameStats, MeanSquare)
+{
+  std::vector<int16_t> samples(37);
+  std::vector<float> floats(37);
+  double ref = 0.0;
+  for (size_t i = 0; i < samples.size(); i++)
+  {
+    samples[i] = (int16_t)(i & 1 ? -32768 : 32767 - i * 100);
+    floats[i]  = samples[i] / 32768.0f;
+    ref += (double)samples[i] * samples[i];
+  }
+  ref /= samples.size() * 32768.0 * 32768.0;
+
+  EXPECT_DOUBLE_EQ(ref, CFrameStats::MeanSquare(&samples[0], samples.size()));
+  EXPECT_NEAR(ref, CFrameStats::MeanSquare(&floats[0], floats.size()), 1e-6);
+  EXPECT_EQ(0.0, CFrameStats::MeanSquare(&samples[0], 0));
+
+  std::vector<int16_t> silence(64, 0);
+  EXPECT_EQ(0.0, CFrameStats::MeanSquare(&silence[0], silence.size()));
+}
+
+INSTANTIATE_TEST_CASE_P(Kernels, TestFrameStats, ::testing::Bool());
@@ -168,6 +168,15 @@ TEST_F(TestJobManager, PauseLowPriorityJob)
   job->FinishAndStopBlocking();
 }
 
+TEST_F(TestJobManager, IsPaused)
+{
+  EXPECT_FALSE(CJobManager::GetInstance().IsPaused());
+  CJobManager::GetInstance().PauseJobs();
+  EXPECT_TRUE(CJobManager::GetInstance().IsPaused());
+  CJobManager::GetInstance().UnPauseJobs();
+  EXPECT_FALSE(CJobManager::GetInstance().IsPaused());
+}
+
 TEST_F(TestJobManager, IsProcessing)
 {
   JobControlPackage package;
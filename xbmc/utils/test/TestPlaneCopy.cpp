@@ -0,0 +1,357 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/PlaneCopy.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <string.h>
+#include <vector>
+
+#define BENCH_FRAMES 20
+
+namespace
+{
+// a plane with a canary border, so writes outside of it are noticed
+struct Plane
+{
+  Plane(int width, int height, int stride, int offset = 0)
+    : stride(stride), height(height), offset(offset), buffer(stride * height + offset + 64, 0xa5)
+  {
+    for (int y = 0; y < height; y++)
+      for (int x = 0; x < width; x++)
+        Data()[y * stride + x] = (uint8_t)(x * 7 + y * 13 + (x >> 3));
+  }
+
+  uint8_t* Data()
+  {
+    return &buffer[offset];
+  }
+
+  int stride;
+  int height;
+  int offset;
+  std::vector<uint8_t> buffer;
+};
+
+void ExpectUntouched(Plane &plane, int width)
+{
+  for (int y = 0; y < plane.height; y++)
+    for (int x = width; x < plane.stride; x++)
+      EXPECT_EQ(0xa5, plane.Data()[y * plane.stride + x]) << "row " << y << " byte " << x;
+  for (size_t i = plane.offset + plane.stride * plane.height; i < plane.buffer.size(); i++)
+    EXPECT_EQ(0xa5, plane.buffer[i]) << "past the plane at " << i;
+}
+
+void Clear(Plane &plane)
+{
+  memset(&plane.buffer[0], 0xa5, plane.buffer.size());
+}
+
+void Report(const char *name, int width, int height, int64_t ticks, int64_t refTicks, size_t bytes)
+{
+  double seconds    = (double)ticks / CurrentHostFrequency();
+  double refSeconds = (double)refTicks / CurrentHostFrequency();
+  fprintf(stdout, "[ BENCH    ] %s %dx%d: %.3fms per frame, %.0f MB/s, %.2fx the scalar loop\n",
+          name, width, height, seconds * 1000.0 / BENCH_FRAMES,
+          seconds > 0.0 ? bytes * BENCH_FRAMES / seconds / 1e6 : 0.0,
+          seconds > 0.0 ? refSeconds / seconds : 0.0);
+}
+}
+
+// odd sizes and unaligned rows run through the vector loops and their tails
+static const int widths[] = { 1, 15, 16, 17, 63, 64, 65, 130, 719 };
+
+// each check runs with the SIMD kernels, where the cpu has them, and the portable ones
+class TestPlaneCopy : public ::testing::TestWithParam<bool>
+{
+protected:
+  virtual void SetUp()
+  {
+    CPlaneCopy::ForcePortable(GetParam());
+  }
+
+  virtual void TearDown()
+  {
+    CPlaneCopy::ForcePortable(false);
+  }
+};
+
+TEST_P(TestPlaneCopy, Copy)
+{
+  for (size_t i = 0; i < sizeof(widths) / sizeof(widths[0]); i++)
+  {
+    int w = widths[i];
+    for (int offset = 0; offset < 3; offset++)
+    {
+      Plane src(w, 5, w + 3, offset);
+      Plane dst(w, 5, w + 9, offset * 5);
+      Clear(dst);
+      CPlaneCopy::Copy(dst.Data(), dst.stride, src.Data(), src.stride, w, 5);
+      for (int y = 0; y < 5; y++)
+        ASSERT_EQ(0, memcmp(dst.Data() + y * dst.stride, src.Data() + y * src.stride, w)) << "width " << w << " row " << y;
+      ExpectUntouched(dst, w);
+    }
+  }
+}
+
+TEST_P(TestPlaneCopy, CopyContiguous)
+{
+  Plane src(100, 7, 100);
+  Plane dst(100, 7, 100, 1);
+  Clear(dst);
+  CPlaneCopy::Copy(dst.Data(), dst.stride, src.Data(), src.stride, 100, 7);
+  EXPECT_EQ(0, memcmp(dst.Data(), src.Data(), 700));
+  ExpectUntouched(dst, 100);
+}
+
+TEST_P(TestPlaneCopy, CopyUncached)
+{
+  for (size_t i = 0; i < sizeof(widths) / sizeof(widths[0]); i++)
+  {
+    int w = widths[i];
+    for (int offset = 0; offset < 3; offset++)
+    {
+      Plane src(w, 4, w + 5, offset * 3);
+      Plane dst(w, 4, w + 2, offset);
+      Clear(dst);
+      CPlaneCopy::CopyUncached(dst.Data(), dst.stride, src.Data(), src.stride, w, 4);
+      for (int y = 0; y < 4; y++)
+        ASSERT_EQ(0, memcmp(dst.Data() + y * dst.stride, src.Data() + y * src.stride, w)) << "width " << w << " row " << y;
+      ExpectUntouched(dst, w);
+    }
+  }
+}
+
+TEST_P(TestPlaneCopy, InterleaveAndDeinterleaveUV)
+{
+  for (size_t i = 0; i < sizeof(widths) / sizeof(widths[0]); i++)
+  {
+    int w = widths[i];
+    Plane u(w, 3, w + 1);
+    Plane v(w, 3, w + 4, 1);
+    for (int j = 0; j < (int)v.buffer.size() - v.offset; j++)
+      v.Data()[j] ^= 0x3c;
+
+    Plane uv(2 * w, 3, 2 * w + 6, 2);
+    Clear(uv);
+    CPlaneCopy::InterleaveUV(uv.Data(), uv.stride, u.Data(), u.stride, v.Data(), v.stride, w, 3);
+    for (int y = 0; y < 3; y++)
+    {
+      for (int x = 0; x < w; x++)
+      {
+        ASSERT_EQ(u.Data()[y * u.stride + x], uv.Data()[y * uv.stride + 2 * x]) << "width " << w;
+        ASSERT_EQ(v.Data()[y * v.stride + x], uv.Data()[y * uv.stride + 2 * x + 1]) << "width " << w;
+      }
+    }
+    ExpectUntouched(uv, 2 * w);
+
+    Plane u2(w, 3, w + 2, 1);
+    Plane v2(w, 3, w + 3);
+    Clear(u2);
+    Clear(v2);
+    CPlaneCopy::DeinterleaveUV(u2.Data(), u2.stride, v2.Data(), v2.stride, uv.Data(), uv.stride, w, 3);
+    for (int y = 0; y < 3; y++)
+    {
+      ASSERT_EQ(0, memcmp(u2.Data() + y * u2.stride, u.Data() + y * u.stride, w)) << "width " << w;
+      ASSERT_EQ(0, memcmp(v2.Data() + y * v2.stride, v.Data() + y * v.stride, w)) << "width " << w;
+    }
+    ExpectUntouched(u2, w);
+    ExpectUntouched(v2, w);
+  }
+}
+
+TEST_P(TestPlaneCopy, PackYUV422)
+{
+  for (size_t i = 0; i < sizeof(widths) / sizeof(widths[0]); i++)
+  {
+    int w  = widths[i];
+    int cw = (w + 1) / 2;
+    Plane py(w, 6, w + 3);
+    Plane pu(cw, 3, cw + 1, 1);
+    Plane pv(cw, 3, cw + 2, 2);
+    for (int j = 0; j < (int)pv.buffer.size() - pv.offset; j++)
+      pv.Data()[j] ^= 0x5a;
+
+    for (int uyvy = 0; uyvy < 2; uyvy++)
+    {
+      Plane packed(2 * w, 6, 2 * w + 4, 3);
+      Clear(packed);
+      CPlaneCopy::PackYUV422(packed.Data(), packed.stride,
+                             py.Data(), py.stride, pu.Data(), pu.stride, pv.Data(), pv.stride,
+                             w, 6, uyvy != 0);
+
+      int oy = uyvy ? 1 : 0;
+      int oc = uyvy ? 0 : 1;
+      for (int y = 0; y < 6; y++)
+      {
+        const uint8_t *row = packed.Data() + y * packed.stride;
+        for (int x = 0; x < w; x++)
+        {
+          ASSERT_EQ(py.Data()[y * py.stride + x], row[2 * x + oy]) << "width " << w << " x " << x;
+          const Plane &chroma = (x & 1) ? pv : pu;
+          ASSERT_EQ(chroma.buffer[chroma.offset + (y / 2) * chroma.stride + x / 2], row[2 * x + oc]) << "width " << w << " x " << x;
+        }
+      }
+      ExpectUntouched(packed, 2 * w);
+    }
+  }
+}
+
+TEST_P(TestPlaneCopy, HalvePixels)
+{
+  for (size_t i = 0; i < sizeof(widths) / sizeof(widths[0]); i++)
+  {
+    int w = widths[i];
+    // an odd source width and height, the last column and row are left out
+    Plane src(8 * w + 4, 9, 8 * w + 7, 1);
+    Plane dst(4 * w, 4, 4 * w + 5, 2);
+    Clear(dst);
+    CPlaneCopy::HalvePixels(dst.Data(), dst.stride, src.Data(), src.stride, w, 4);
+
+    for (int y = 0; y < 4; y++)
+    {
+      const uint8_t *s0 = src.Data() + 2 * y * src.stride;
+      const uint8_t *s1 = s0 + src.stride;
+      for (int x = 0; x < 4 * w; x++)
+      {
+        int sx = (x / 4) * 8 + (x & 3);
+        int expected = (s0[sx] + s0[sx + 4] + s1[sx] + s1[sx + 4] + 2) >> 2;
+        ASSERT_EQ(expected, dst.Data()[y * dst.stride + x]) << "width " << w << " x " << x << " y " << y;
+      }
+    }
+    ExpectUntouched(dst, 4 * w);
+  }
+}
+
+static void Bench(int width, int height)
+{
+  int cw = width / 2, ch = height / 2;
+  Plane y(width, height, width + 64), u(cw, ch, cw + 32), v(cw, ch, cw + 32);
+  Plane dst(2 * width, height, 2 * width + 64);
+  Plane dstU(cw, ch, cw + 32), dstV(cw, ch, cw + 32);
+  int64_t start, ticks, ref;
+
+  // plane copy of a 4:2:0 frame against the per row copy it replaces
+  start = CurrentHostCounter();
+  for (int i = 0; i < BENCH_FRAMES; i++)
+  {
+    CPlaneCopy::Copy(dst.Data(), dst.stride, y.Data(), y.stride, width, height);
+    CPlaneCopy::Copy(dstU.Data(), dstU.stride, u.Data(), u.stride, cw, ch);
+    CPlaneCopy::Copy(dstV.Data(), dstV.stride, v.Data(), v.stride, cw, ch);
+  }
+  ticks = CurrentHostCounter() - start;
+  start = CurrentHostCounter();
+  for (int i = 0; i < BENCH_FRAMES; i++)
+  {
+    for (int r = 0; r < height; r++)
+      memcpy(dst.Data() + r * dst.stride, y.Data() + r * y.stride, width);
+    for (int r = 0; r < ch; r++)
+    {
+      memcpy(dstU.Data() + r * dstU.stride, u.Data() + r * u.stride, cw);
+      memcpy(dstV.Data() + r * dstV.stride, v.Data() + r * v.stride, cw);
+    }
+  }
+  ref = CurrentHostCounter() - start;
+  Report("Copy", width, height, ticks, ref, width * height * 3 / 2);
+
+  // NV12 chroma
+  start = CurrentHostCounter();
+  for (int i = 0; i < BENCH_FRAMES; i++)
+    CPlaneCopy::InterleaveUV(dst.Data(), dst.stride, u.Data(), u.stride, v.Data(), v.stride, cw, ch);
+  ticks = CurrentHostCounter() - start;
+  start = CurrentHostCounter();
+  for (int i = 0; i < BENCH_FRAMES; i++)
+  {
+    for (int r = 0; r < ch; r++)
+    {
+      uint8_t *d = dst.Data() + r * dst.stride;
+      const uint8_t *su = u.Data() + r * u.stride, *sv = v.Data() + r * v.stride;
+      for (int x = 0; x < cw; x++)
+      {
+        *d++ = su[x];
+        *d++ = sv[x];
+      }
+    }
+  }
+  ref = CurrentHostCounter() - start;
+  Report("InterleaveUV", width, height, ticks, ref, cw * ch * 2);
+
+  start = CurrentHostCounter();
+  for (int i = 0; i < BENCH_FRAMES; i++)
+    CPlaneCopy::DeinterleaveUV(dstU.Data(), dstU.stride, dstV.Data(), dstV.stride, dst.Data(), dst.stride, cw, ch);
+  ticks = CurrentHostCounter() - start;
+  start = CurrentHostCounter();
+  for (int i = 0; i < BENCH_FRAMES; i++)
+  {
+    for (int r = 0; r < ch; r++)
+    {
+      const uint8_t *s = dst.Data() + r * dst.stride;
+      uint8_t *du = dstU.Data() + r * dstU.stride, *dv = dstV.Data() + r * dstV.stride;
+      for (int x = 0; x < cw; x++)
+      {
+        du[x] = *s++;
+        dv[x] = *s++;
+      }
+    }
+  }
+  ref = CurrentHostCounter() - start;
+  Report("DeinterleaveUV", width, height, ticks, ref, cw * ch * 2);
+
+  // YUY2
+  start = CurrentHostCounter();
+  for (int i = 0; i < BENCH_FRAMES; i++)
+    CPlaneCopy::PackYUV422(dst.Data(), dst.stride, y.Data(), y.stride, u.Data(), u.stride, v.Data(), v.stride,
+                           width, height, false);
+  ticks = CurrentHostCounter() - start;
+  start = CurrentHostCounter();
+  for (int i = 0; i < BENCH_FRAMES; i++)
+  {
+    for (int r = 0; r < height; r++)
+    {
+      uint8_t *d = dst.Data() + r * dst.stride;
+      const uint8_t *sy = y.Data() + r * y.stride;
+      const uint8_t *su = u.Data() + (r / 2) * u.stride, *sv = v.Data() + (r / 2) * v.stride;
+      for (int x = 0; x < width; x += 2)
+      {
+        *d++ = sy[x];
+        *d++ = su[x / 2];
+        *d++ = sy[x + 1];
+        *d++ = sv[x / 2];
+      }
+    }
+  }
+  ref = CurrentHostCounter() - start;
+  Report("PackYUV422", width, height, ticks, ref, width * height * 2);
+}
+
+INSTANTIATE_TEST_CASE_P(Kernels, TestPlaneCopy, ::testing::Bool());
+
+TEST(TestPlaneCopyBench, Benchmark1080p)
+{
+  Bench(1920, 1080);
+}
+
+TEST(TestPlaneCopyBench, Benchmark2160p)
+{
+  Bench(3840, 2160);
+}
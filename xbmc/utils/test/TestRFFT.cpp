@@ -0,0 +1,129 @@
+/*
+ *      Copyright (C) 2005-2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/RFFT.h"
+#include "utils/fft.h"
+
+#include "gtest/gtest.h"
+
+#include <math.h>
+#include <vector>
+
+#ifndef M_PI
+#define M_PI 3.14159265358979323846
+#endif
+
+static void GenerateStereo(std::vector<float> &data, unsigned int frames, double left, double right)
+{
+  data.resize(frames * 2);
+  for (unsigned int i = 0; i < frames; i++)
+  {
+    data[2 * i]     = (float)(0.8 * sin(2.0 * M_PI * left * i / frames));
+    data[2 * i + 1] = (float)(0.5 * sin(2.0 * M_PI * right * i / frames) + 0.1 * cos(0.37 * i));
+  }
+}
+
+static void ExpectNear(const float *expected, const float *actual, unsigned int count)
+{
+  for (unsigned int i = 0; i < count; i++)
+    EXPECT_NEAR(expected[i], actual[i], 1e-3f + fabs(expected[i]) * 1e-4f) << "at index " << i;
+}
+
+TEST(TestRFFT, MatchesTwoChanWithWindow)
+{
+  static const unsigned int sizes[] = { 2, 4, 8, 16, 64, 512 };
+  for (unsigned int s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++)
+  {
+    unsigned int n = sizes[s];
+    std::vector<float> input;
+    GenerateStereo(input, n, n / 8 + 1, n / 4 + 0.5);
+
+    std::vector<float> reference(input);
+    twochanwithwindow(&reference[0], n);
+
+    CRFFT fft(n, n);
+    std::vector<float> output(n + 2);
+    fft.TwoChannelPower(&input[0], &output[0]);
+
+    ExpectNear(&reference[0], &output[0], n + 2);
+  }
+}
+
+TEST(TestRFFT, ZeroPadding)
+{
+  const unsigned int n = 64;
+  std::vector<float> input;
+  GenerateStereo(input, n / 2, 3, 5);
+
+  std::vector<float> reference(input);
+  reference.resize(2 * n, 0.0f);
+
+  CRFFT padded(n, n / 2, CRFFT::WINDOW_RECTANGULAR);
+  CRFFT full(n, n, CRFFT::WINDOW_RECTANGULAR);
+  std::vector<float> expected(n + 2), output(n + 2);
+  full.TwoChannelPower(&reference[0], &expected[0]);
+  padded.TwoChannelPower(&input[0], &output[0]);
+
+  ExpectNear(&expected[0], &output[0], n + 2);
+}
+
+TEST(TestRFFT, ChannelSeparation)
+{
+  const unsigned int n = 256;
+  std::vector<float> input(2 * n, 0.0f);
+  for (unsigned int i = 0; i < n; i++)
+    input[2 * i] = (float)sin(2.0 * M_PI * 16 * i / n);
+
+  CRFFT fft(n, n, CRFFT::WINDOW_BLACKMAN);
+  std::vector<float> output(n + 2);
+  fft.TwoChannelPower(&input[0], &output[0]);
+
+  EXPECT_GT(output[2 * 16], 100.0f);
+  for (unsigned int k = 0; k <= n / 2; k++)
+    EXPECT_NEAR(0.0f, output[2 * k + 1], 1e-3f) << "right channel bin " << k;
+}
+
+TEST(TestRFFT, AggregateBands)
+{
+  const unsigned int n = 512;
+  std::vector<float> power(n + 2, 0.0f);
+  power[2 * 100] = 8.0f;
+  power[2 * 100 + 1] = 4.0f;
+
+  std::vector<float> bands(8, -1.0f);
+  CRFFT::AggregateBands(&power[0], n, &bands[0], bands.size());
+
+  float total = 0.0f;
+  unsigned int nonzero = 0;
+  for (unsigned int b = 0; b < bands.size(); b++)
+  {
+    EXPECT_GE(bands[b], 0.0f);
+    if (bands[b] > 0.0f)
+      nonzero++;
+    total += bands[b];
+  }
+  EXPECT_EQ(1U, nonzero);
+  EXPECT_GT(total, 0.0f);
+  // more bands than bins still covers every band with at least one bin
+  std::vector<float> many(300, -1.0f);
+  CRFFT::AggregateBands(&power[0], n, &many[0], many.size());
+  for (unsigned int b = 0; b < many.size(); b++)
+    EXPECT_GE(many[b], 0.0f);
+}
@@ -0,0 +1,76 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/XMLBinary.h"
+#include "utils/XBMCTinyXML.h"
+
+#include "gtest/gtest.h"
+
+static std::string Print(const TiXmlNode *node)
+{
+  TiXmlPrinter printer;
+  node->Accept(&printer);
+  return printer.Str();
+}
+
+TEST(TestXMLBinary, RoundTrip)
+{
+  CXBMCTinyXML doc;
+  doc.Parse("<window id=\"1\" type=\"dialog\"><!-- comment -->"
+            "<control type=\"label\"><label>$INFO[Player.Title]</label>"
+            "<visible>!Player.HasVideo + Window.IsActive(home)</visible></control>"
+            "<control type=\"label\"><label><![CDATA[<b>&</b>]]></label></control>"
+            "</window>");
+  ASSERT_TRUE(doc.RootElement() != NULL);
+
+  std::string data;
+  CXMLBinary::Compile(doc.RootElement(), data);
+  TiXmlElement *root = CXMLBinary::Load(data);
+  ASSERT_TRUE(root != NULL);
+  EXPECT_EQ(Print(doc.RootElement()), Print(root));
+
+  const TiXmlElement *control = root->FirstChildElement("control");
+  ASSERT_TRUE(control != NULL);
+  EXPECT_STREQ("label", control->Attribute("type"));
+  control = control->NextSiblingElement("control");
+  ASSERT_TRUE(control != NULL && control->FirstChildElement("label") != NULL);
+  const TiXmlNode *cdata = control->FirstChildElement("label")->FirstChild();
+  ASSERT_TRUE(cdata != NULL && cdata->ToText() != NULL);
+  EXPECT_TRUE(cdata->ToText()->CDATA());
+  EXPECT_EQ("<b>&</b>", cdata->ValueStr());
+  delete root;
+}
+
+TEST(TestXMLBinary, InvalidData)
+{
+  CXBMCTinyXML doc;
+  doc.Parse("<includes><include name=\"a\"><posx>10</posx></include></includes>");
+  ASSERT_TRUE(doc.RootElement() != NULL);
+
+  std::string data;
+  CXMLBinary::Compile(doc.RootElement(), data);
+
+  EXPECT_TRUE(CXMLBinary::Load("") == NULL);
+  EXPECT_TRUE(CXMLBinary::Load("<includes/>") == NULL);
+  // every truncation is caught
+  for (size_t length = 0; length < data.size(); length++)
+    EXPECT_TRUE(CXMLBinary::Load(data.substr(0, length)) == NULL);
+  EXPECT_TRUE(CXMLBinary::Load(data + "x") == NULL);
+}
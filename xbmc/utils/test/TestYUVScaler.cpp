@@ -0,0 +1,308 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "utils/YUVScaler.h"
+#include "utils/TimeUtils.h"
+
+#include "gtest/gtest.h"
+
+#include <cstdio>
+#include <string.h>
+#include <vector>
+
+#define BENCH_FRAMES 20
+
+namespace
+{
+// a 4:2:0 picture in both layouts the scaler reads
+struct Picture
+{
+  Picture(int width, int height)
+    : width(width), height(height),
+      cw((width + 1) / 2), ch((height + 1) / 2),
+      y(width * height), u(cw * ch), v(cw * ch), uv(cw * ch * 2)
+  {
+    for (int r = 0; r < height; r++)
+      for (int c = 0; c < width; c++)
+        y[r * width + c] = (uint8_t)(16 + (c * 3 + r * 5) % 220);
+    for (int r = 0; r < ch; r++)
+      for (int c = 0; c < cw; c++)
+      {
+        u[r * cw + c] = (uint8_t)(16 + (c * 7 + r) % 224);
+        v[r * cw + c] = (uint8_t)(240 - (c + r * 11) % 224);
+        uv[r * cw * 2 + c * 2]     = u[r * cw + c];
+        uv[r * cw * 2 + c * 2 + 1] = v[r * cw + c];
+      }
+  }
+
+  void Planes(CYUVScaler::EFormat format, uint8_t* planes[3], int strides[3])
+  {
+    planes[0]  = &y[0];
+    strides[0] = width;
+    if (format == CYUVScaler::FORMAT_NV12)
+    {
+      planes[1]  = &uv[0];
+      strides[1] = cw * 2;
+      planes[2]  = NULL;
+      strides[2] = 0;
+    }
+    else
+    {
+      planes[1]  = &u[0];
+      strides[1] = cw;
+      planes[2]  = &v[0];
+      strides[2] = cw;
+    }
+  }
+
+  int width, height, cw, ch;
+  std::vector<uint8_t> y, u, v, uv;
+};
+
+std::vector<uint8_t> Scale(CYUVScaler &scaler, Picture &pic, CYUVScaler::EFormat format,
+                           int dstWidth, int dstHeight)
+{
+  uint8_t* planes[3];
+  int      strides[3];
+  pic.Planes(format, planes, strides);
+
+  std::vector<uint8_t> out(dstWidth * dstHeight * 4, 0xa5);
+  scaler.Configure(format, pic.width, pic.height, dstWidth, dstHeight);
+  scaler.Scale(planes, strides, &out[0], dstWidth * 4, 0, 0, dstWidth, dstHeight);
+  return out;
+}
+}
+
+TEST(TestYUVScaler, ConvertRowLimitedRange)
+{
+  CYUVScaler scaler;
+  scaler.SetColorMatrix(1.403f, -0.344f, -0.714f, 1.773f, false);
+
+  // black, white and grey, followed by enough to use the vector loop
+  uint8_t y[19] = { 16, 235, 126 };
+  uint8_t u[19] = { 128, 128, 128 };
+  uint8_t v[19] = { 128, 128, 128 };
+  for (int i = 3; i < 19; i++)
+  {
+    y[i] = (uint8_t)(i * 13);
+    u[i] = (uint8_t)(255 - i * 11);
+    v[i] = (uint8_t)(i * 14);
+  }
+
+  uint8_t out[19 * 4];
+  scaler.ConvertRow(y, u, v, out, 19);
+
+  for (int c = 0; c < 3; c++)
+  {
+    EXPECT_EQ(0,   out[c]);
+    EXPECT_EQ(255, out[4 + c]);
+    EXPECT_NEAR(128, out[8 + c], 1);
+  }
+
+  for (int i = 0; i < 19; i++)
+  {
+    double yy = 255.0 / 219.0 * (y[i] - 16);
+    double cu = 255.0 / 224.0 * (u[i] - 128);
+    double cv = 255.0 / 224.0 * (v[i] - 128);
+    double r = yy + 1.403 * cv;
+    double g = yy - 0.344 * cu - 0.714 * cv;
+    double b = yy + 1.773 * cu;
+    r = r < 0 ? 0 : (r > 255 ? 255 : r);
+    g = g < 0 ? 0 : (g > 255 ? 255 : g);
+    b = b < 0 ? 0 : (b > 255 ? 255 : b);
+    EXPECT_NEAR(b, out[i * 4 + 0], 1.5) << "pixel " << i;
+    EXPECT_NEAR(g, out[i * 4 + 1], 1.5) << "pixel " << i;
+    EXPECT_NEAR(r, out[i * 4 + 2], 1.5) << "pixel " << i;
+    EXPECT_EQ(255, out[i * 4 + 3]) << "pixel " << i;
+  }
+}
+
+TEST(TestYUVScaler, ConvertRowFullRange)
+{
+  CYUVScaler scaler;
+  scaler.SetColorMatrix(1.5701f, -0.1870f, -0.4664f, 1.8556f, true);
+
+  uint8_t y[2] = { 0, 255 };
+  uint8_t u[2] = { 128, 128 };
+  uint8_t v[2] = { 128, 128 };
+  uint8_t out[8];
+  scaler.ConvertRow(y, u, v, out, 2);
+
+  for (int c = 0; c < 3; c++)
+  {
+    EXPECT_EQ(0,   out[c]);
+    EXPECT_EQ(255, out[4 + c]);
+  }
+}
+
+TEST(TestYUVScaler, KeepSize)
+{
+  // without scaling every luma sample maps to one pixel
+  Picture pic(38, 10);
+  memset(&pic.u[0], 128, pic.u.size());
+  memset(&pic.v[0], 128, pic.v.size());
+  CYUVScaler scaler;
+  std::vector<uint8_t> out = Scale(scaler, pic, CYUVScaler::FORMAT_YUV420P, pic.width, pic.height);
+
+  uint8_t neutral = 128;
+  for (int i = 0; i < pic.width * pic.height; i++)
+  {
+    uint8_t pixel[4];
+    scaler.ConvertRow(&pic.y[i], &neutral, &neutral, pixel, 1);
+    EXPECT_EQ(0, memcmp(pixel, &out[i * 4], 4)) << "pixel " << i;
+  }
+
+  // a flat picture stays flat
+  memset(&pic.y[0], 100, pic.y.size());
+  memset(&pic.u[0], 90,  pic.u.size());
+  memset(&pic.v[0], 180, pic.v.size());
+  out = Scale(scaler, pic, CYUVScaler::FORMAT_YUV420P, pic.width, pic.height);
+
+  uint8_t y = 100, cu = 90, cv = 180;
+  uint8_t pixel[4];
+  scaler.ConvertRow(&y, &cu, &cv, pixel, 1);
+  for (size_t i = 0; i < out.size(); i++)
+    EXPECT_EQ(pixel[i % 4], out[i]) << "byte " << i;
+}
+
+TEST(TestYUVScaler, NV12MatchesPlanar)
+{
+  Picture pic(45, 27);
+  CYUVScaler scaler;
+  std::vector<uint8_t> planar = Scale(scaler, pic, CYUVScaler::FORMAT_YUV420P, 71, 33);
+  std::vector<uint8_t> nv12   = Scale(scaler, pic, CYUVScaler::FORMAT_NV12,    71, 33);
+  EXPECT_TRUE(planar == nv12);
+}
+
+TEST(TestYUVScaler, PartsMatchWhole)
+{
+  // the renderer scales slices of the picture on several threads, and
+  // clips it to the screen
+  Picture pic(64, 48);
+  CYUVScaler scaler;
+  const int dw = 101, dh = 77;
+  std::vector<uint8_t> whole = Scale(scaler, pic, CYUVScaler::FORMAT_YUV420P, dw, dh);
+
+  uint8_t* planes[3];
+  int      strides[3];
+  pic.Planes(CYUVScaler::FORMAT_YUV420P, planes, strides);
+
+  const int x0 = 13, x1 = 90;
+  std::vector<uint8_t> parts(dw * dh * 4, 0xa5);
+  for (int y0 = 0; y0 < dh; y0 += 10)
+  {
+    int y1 = y0 + 10 < dh ? y0 + 10 : dh;
+    scaler.Scale(planes, strides, &parts[(y0 * dw + x0) * 4], dw * 4, x0, y0, x1, y1);
+  }
+
+  for (int y = 0; y < dh; y++)
+    for (int x = 0; x < dw * 4; x++)
+    {
+      uint8_t expected = (x >= x0 * 4 && x < x1 * 4) ? whole[y * dw * 4 + x] : 0xa5;
+      EXPECT_EQ(expected, parts[y * dw * 4 + x]) << "row " << y << " byte " << x;
+    }
+}
+
+TEST(TestYUVScaler, ScaleInterpolates)
+{
+  // a horizontal luma ramp scaled up stays a ramp within its range
+  Picture pic(32, 8);
+  for (int r = 0; r < pic.height; r++)
+    for (int c = 0; c < pic.width; c++)
+      pic.y[r * pic.width + c] = (uint8_t)(16 + c * 6);
+  memset(&pic.u[0], 128, pic.u.size());
+  memset(&pic.v[0], 128, pic.v.size());
+
+  CYUVScaler scaler;
+  std::vector<uint8_t> out = Scale(scaler, pic, CYUVScaler::FORMAT_YUV420P, 100, 20);
+  for (int r = 0; r < 20; r++)
+  {
+    int last = 0;
+    for (int c = 0; c < 100; c++)
+    {
+      int g = out[(r * 100 + c) * 4 + 1];
+      EXPECT_GE(g, last) << "row " << r << " pixel " << c;
+      last = g;
+    }
+    EXPECT_EQ(0, out[r * 100 * 4 + 1]);
+    EXPECT_NEAR(217, last, 1);
+  }
+
+  // and scaled down keeps its ends
+  out = Scale(scaler, pic, CYUVScaler::FORMAT_YUV420P, 9, 3);
+  EXPECT_LT(out[1], 40);
+  EXPECT_GT(out[8 * 4 + 1], 180);
+}
+
+TEST(TestYUVScaler, BlendPremultiplied)
+{
+  uint8_t dst[7 * 4];
+  uint8_t src[7 * 4];
+  for (int i = 0; i < 7; i++)
+  {
+    dst[i * 4 + 0] = 200; dst[i * 4 + 1] = 100; dst[i * 4 + 2] = 50; dst[i * 4 + 3] = 255;
+  }
+  // transparent, opaque, half and a premultiplied colour
+  memset(src, 0, sizeof(src));
+  src[4] = 10; src[5] = 20; src[6] = 30; src[7] = 255;
+  src[8] = 0;  src[9] = 0;  src[10] = 0; src[11] = 128;
+  for (int i = 3; i < 7; i++)
+  {
+    src[i * 4 + 0] = 64; src[i * 4 + 1] = 0; src[i * 4 + 2] = 32; src[i * 4 + 3] = 64;
+  }
+
+  CYUVScaler::BlendPremultiplied(dst, src, 7);
+
+  EXPECT_EQ(200, dst[0]); EXPECT_EQ(100, dst[1]); EXPECT_EQ(50, dst[2]); EXPECT_EQ(255, dst[3]);
+  EXPECT_EQ(10,  dst[4]); EXPECT_EQ(20,  dst[5]); EXPECT_EQ(30, dst[6]); EXPECT_EQ(255, dst[7]);
+  EXPECT_EQ(100, dst[8]); EXPECT_EQ(50,  dst[9]); EXPECT_EQ(25, dst[10]);
+  for (int i = 3; i < 7; i++)
+  {
+    EXPECT_EQ(64 + 150, dst[i * 4 + 0]) << "pixel " << i;
+    EXPECT_EQ(75,       dst[i * 4 + 1]) << "pixel " << i;
+    EXPECT_EQ(32 + 37,  dst[i * 4 + 2]) << "pixel " << i;
+    EXPECT_EQ(255,      dst[i * 4 + 3]) << "pixel " << i;
+  }
+}
+
+static void Bench(int srcWidth, int srcHeight, int dstWidth, int dstHeight)
+{
+  Picture pic(srcWidth, srcHeight);
+  CYUVScaler scaler;
+  uint8_t* planes[3];
+  int      strides[3];
+  pic.Planes(CYUVScaler::FORMAT_YUV420P, planes, strides);
+  scaler.Configure(CYUVScaler::FORMAT_YUV420P, srcWidth, srcHeight, dstWidth, dstHeight);
+
+  std::vector<uint8_t> out(dstWidth * dstHeight * 4);
+  int64_t start = CurrentHostCounter();
+  for (int i = 0; i < BENCH_FRAMES; i++)
+    scaler.Scale(planes, strides, &out[0], dstWidth * 4, 0, 0, dstWidth, dstHeight);
+  double seconds = (double)(CurrentHostCounter() - start) / CurrentHostFrequency();
+
+  fprintf(stdout, "[ BENCH    ] Scale %dx%d to %dx%d: %.3fms per frame on one thread\n",
+          srcWidth, srcHeight, dstWidth, dstHeight, seconds * 1000.0 / BENCH_FRAMES);
+}
+
+TEST(TestYUVScaler, Benchmark1080p)
+{
+  Bench(1920, 1080, 1920, 1080);
+  Bench(1280, 720, 1920, 1080);
+}
@@ -36,21 +36,27 @@
 #include "video/VideoInfoTag.h"
 #include "video/VideoDatabase.h"
 #include "cores/dvdplayer/DVDFileInfo.h"
+#include "cores/dvdplayer/DVDThumbCodecCache.h"
 #include "video/VideoInfoScanner.h"
+#include "video/VideoThumbStrip.h"
 #include "music/MusicDatabase.h"
 #include "utils/StringUtils.h"
 #include "settings/AdvancedSettings.h"
+#include "threads/SingleLock.h"
+#include "threads/SystemClock.h"
 
 using namespace XFILE;
 using namespace std;
 using namespace VIDEO;
 
-CThumbExtractor::CThumbExtractor(const CFileItem& item, const CStdString& listpath, bool thumb, const CStdString& target)
+CThumbExtractor::CThumbExtractor(const CFileItem& item, const CStdString& listpath, bool thumb, const CStdString& target,
+                                 const boost::shared_ptr<CDVDThumbCodecCache>& codecCache)
 {
   m_listpath = listpath;
   m_target = target;
   m_thumb = thumb;
   m_item = item;
+  m_codecCache = codecCache;
 
   if (item.IsVideoDb() && item.HasVideoInfoTag())
     m_item.SetPath(item.GetVideoInfoTag()->m_strFileNameAndPath);
@@ -74,25 +80,32 @@ bool CThumbExtractor::operator==(const CJob* job) const
   return false;
 }
 
-bool CThumbExtractor::DoWork()
+static bool CanExtract(const CFileItem &item)
 {
-  if (m_item.IsLiveTV()
-  ||  URIUtils::IsUPnP(m_item.GetPath())
-  ||  m_item.IsDAAP()
-  ||  m_item.IsDVD()
-  ||  m_item.IsDVDImage()
-  ||  m_item.IsDVDFile(false, true)
-  ||  m_item.IsInternetStream()
-  ||  m_item.IsDiscStub()
-  ||  m_item.IsPlayList())
+  if (item.IsLiveTV()
+  ||  URIUtils::IsUPnP(item.GetPath())
+  ||  item.IsDAAP()
+  ||  item.IsDVD()
+  ||  item.IsDVDImage()
+  ||  item.IsDVDFile(false, true)
+  ||  item.IsInternetStream()
+  ||  item.IsDiscStub()
+  ||  item.IsPlayList())
     return false;
 
-  if (URIUtils::IsRemote(m_item.GetPath()) && !URIUtils::IsOnLAN(m_item.GetPath()))
+  if (URIUtils::IsRemote(item.GetPath()) && !URIUtils::IsOnLAN(item.GetPath()))
   {
     // A quasi internet filesystem like webdav is generally fast enough for extracting stuff
-    if (!URIUtils::IsDAV(m_item.GetPath()))
+    if (!URIUtils::IsDAV(item.GetPath()))
       return false;
   }
+  return true;
+}
+
+bool CThumbExtractor::DoWork()
+{
+  if (!CanExtract(m_item))
+    return false;
 
   bool result=false;
   if (m_thumb)
@@ -101,7 +114,7 @@ bool CThumbExtractor::DoWork()
     // construct the thumb cache file
     CTextureDetails details;
     details.file = CTextureCache::GetCacheFile(m_target) + ".jpg";
-    result = CDVDFileInfo::ExtractThumb(m_item.GetPath(), details, &m_item.GetVideoInfoTag()->m_streamDetails);
+    result = CDVDFileInfo::ExtractThumb(m_item.GetPath(), details, &m_item.GetVideoInfoTag()->m_streamDetails, m_codecCache.get());
     if(result)
     {
       CTextureCache::Get().AddCachedTexture(m_target, details);
@@ -156,10 +169,16 @@ bool CThumbExtractor::DoWork()
   return false;
 }
 
+// extractions run at once, thumb decoding is single threaded
+#define THUMB_EXTRACT_WORKERS 2
+
 CVideoThumbLoader::CVideoThumbLoader() :
-  CThumbLoader(), CJobQueue(true, 1, CJob::PRIORITY_LOW_PAUSABLE)
+  CThumbLoader(), CJobQueue(true, THUMB_EXTRACT_WORKERS, CJob::PRIORITY_LOW_PAUSABLE),
+  m_codecCache(new CDVDThumbCodecCache)
 {
   m_videoDatabase = new CVideoDatabase();
+  m_extractStart = 0;
+  m_extractCount = 0;
 }
 
 CVideoThumbLoader::~CVideoThumbLoader()
@@ -371,8 +390,11 @@ bool CVideoThumbLoader::LoadItemLookup(CFileItem* pItem)
         if (URIUtils::IsInRAR(item.GetPath()))
           SetupRarOptions(item,path);
 
-        CThumbExtractor* extract = new CThumbExtractor(item, path, true, thumbURL);
-        AddJob(extract);
+        AddExtractJob(new CThumbExtractor(item, path, true, thumbURL, m_codecCache));
+
+        // seek and chapter previews, queued apart from the thumb so they never delay it
+        if (g_advancedSettings.m_videoExtractThumbStrip && !URIUtils::IsInRAR(item.GetPath()) && CanExtract(item))
+          CVideoThumbStrip::Queue(item.GetPath(), m_codecCache);
 
         m_videoDatabase->Close();
         return true;
@@ -388,8 +410,7 @@ bool CVideoThumbLoader::LoadItemLookup(CFileItem* pItem)
       CStdString path(item.GetPath());
       if (URIUtils::IsInRAR(item.GetPath()))
         SetupRarOptions(item,path);
-      CThumbExtractor* extract = new CThumbExtractor(item,path,false);
-      AddJob(extract);
+      AddExtractJob(new CThumbExtractor(item, path, false));
     }
   }
 
@@ -533,7 +554,27 @@ void CVideoThumbLoader::OnJobComplete(unsigned int jobID, bool success, CJob* jo
     CGUIMessage msg(GUI_MSG_NOTIFY_ALL, 0, 0, GUI_MSG_UPDATE_ITEM, 0, pItem);
     g_windowManager.SendThreadMessage(msg);
   }
+
+  CSingleLock lock(m_extractSection);
   CJobQueue::OnJobComplete(jobID, success, job);
+  m_extractCount++;
+  if (QueueEmpty() && !IsProcessing())
+  { // end of the batch, close the decoders until the next one
+    m_codecCache->Flush();
+    unsigned int elapsed = XbmcThreads::SystemClockMillis() - m_extractStart;
+    CLog::Log(LOGDEBUG, "%s - processed %u files in %u ms (%.2f files/s)", __FUNCTION__,
+              m_extractCount, elapsed, elapsed ? m_extractCount * 1000.0 / elapsed : 0.0);
+    m_extractCount = 0;
+    m_extractStart = 0;
+  }
+}
+
+void CVideoThumbLoader::AddExtractJob(CThumbExtractor *job)
+{
+  CSingleLock lock(m_extractSection);
+  if (!m_extractStart)
+    m_extractStart = XbmcThreads::SystemClockMillis();
+  AddJob(job);
 }
 
 void CVideoThumbLoader::DetectAndAddMissingItemData(CFileItem &item)
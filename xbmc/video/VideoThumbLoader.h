@@ -20,10 +20,12 @@
  */
 
 #include <map>
+#include <boost/shared_ptr.hpp>
 #include "ThumbLoader.h"
 #include "utils/JobManager.h"
 #include "FileItem.h"
 
+class CDVDThumbCodecCache;
 class CStreamDetails;
 class CVideoDatabase;
 
@@ -38,7 +40,8 @@ class CVideoDatabase;
 class CThumbExtractor : public CJob
 {
 public:
-  CThumbExtractor(const CFileItem& item, const CStdString& listpath, bool thumb, const CStdString& strTarget="");
+  CThumbExtractor(const CFileItem& item, const CStdString& listpath, bool thumb, const CStdString& strTarget="",
+                  const boost::shared_ptr<CDVDThumbCodecCache>& codecCache = boost::shared_ptr<CDVDThumbCodecCache>());
   virtual ~CThumbExtractor();
 
   /*!
@@ -57,6 +60,7 @@ public:
   CStdString m_listpath; ///< path used in fileitem list
   CFileItem  m_item;
   bool       m_thumb; ///< extract thumb?
+  boost::shared_ptr<CDVDThumbCodecCache> m_codecCache; ///< decoders shared with the other extractions of the loader
 };
 
 class CVideoThumbLoader : public CThumbLoader, public CJobQueue
@@ -128,6 +132,17 @@ protected:
   typedef std::map<int, std::map<std::string, std::string> > ArtCache;
   ArtCache m_showArt;
 
+  /*! \brief Queue a thumb or stream details extraction
+   The extractions of a batch share their decoders, the batch ends once the queue runs empty.
+   \param job the extraction job
+   */
+  void AddExtractJob(CThumbExtractor *job);
+
+  boost::shared_ptr<CDVDThumbCodecCache> m_codecCache;
+  CCriticalSection m_extractSection;
+  unsigned int m_extractStart; ///< start time of the current batch of extractions
+  unsigned int m_extractCount; ///< files processed in the current batch
+
   /*! \brief Tries to detect missing data/info from a file and adds those
    \param item The CFileItem to process
    \return void
@@ -0,0 +1,159 @@
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include "VideoThumbStrip.h"
+#include "TextureCache.h"
+#include "TextureDatabase.h"
+#include "URL.h"
+#include "cores/dvdplayer/DVDFileInfo.h"
+#include "guilib/Texture.h"
+#include "pictures/Picture.h"
+#include "utils/JobManager.h"
+#include "utils/log.h"
+
+#include <algorithm>
+#include <string.h>
+
+using namespace std;
+
+static CJobQueue& GetQueue()
+{
+  // one at a time, extraction seeks through the whole file
+  static CJobQueue queue(false, 1, CJob::PRIORITY_LOW_PAUSABLE);
+  return queue;
+}
+
+string CVideoThumbStrip::GetImageURL(const string &path)
+{
+  return CTextureUtils::GetWrappedImageURL(path, "videostrip");
+}
+
+vector<int> CVideoThumbStrip::GetTileTimes(int duration, const vector<int> &chapters)
+{
+  vector<int> times(COLUMNS * ROWS, -1);
+  if (duration <= 0)
+    return times;
+
+  // the middle of each part, the very first frame is often black
+  for (int i = 0; i < SEEK_TILES; i++)
+    times[i] = (int)((2 * i + 1) * (int64_t)duration / (2 * SEEK_TILES));
+
+  for (size_t i = 0; i < chapters.size() && i < CHAPTER_TILES; i++)
+  {
+    if (chapters[i] >= 0 && chapters[i] < duration)
+      times[SEEK_TILES + i] = chapters[i];
+  }
+  return times;
+}
+
+int CVideoThumbStrip::GetSeekTile(int time, int duration)
+{
+  if (duration <= 0)
+    return -1;
+  return std::max(0, std::min(SEEK_TILES - 1, (int)((int64_t)time * SEEK_TILES / duration)));
+}
+
+int CVideoThumbStrip::GetChapterTile(int chapter)
+{
+  if (chapter < 1 || chapter > CHAPTER_TILES)
+    return -1;
+  return SEEK_TILES + chapter - 1;
+}
+
+CRect CVideoThumbStrip::GetTileRect(int tile)
+{
+  float x = (float)(tile % COLUMNS) / COLUMNS;
+  float y = (float)(tile / COLUMNS) / ROWS;
+  return CRect(x, y, x + 1.0f / COLUMNS, y + 1.0f / ROWS);
+}
+
+bool CVideoThumbStrip::HasStrip(const string &path)
+{
+  return CTextureCache::Get().HasCachedImage(GetImageURL(path));
+}
+
+bool CVideoThumbStrip::SaveTile(const string &path, int tile, const string &file)
+{
+  if (tile < 0 || tile >= COLUMNS * ROWS)
+    return false;
+
+  bool needsRecaching;
+  CStdString cached = CTextureCache::Get().CheckCachedImage(GetImageURL(path), false, needsRecaching);
+  if (cached.empty())
+    return false;
+
+  CBaseTexture *texture = CBaseTexture::LoadFromFile(cached, 0, 0, false, true);
+  if (!texture)
+    return false;
+
+  bool ok = false;
+  CRect rect = GetTileRect(tile);
+  int x = (int)(rect.x1 * texture->GetWidth());
+  int y = (int)(rect.y1 * texture->GetHeight());
+  int w = (int)(rect.Width()  * texture->GetWidth());
+  int h = (int)(rect.Height() * texture->GetHeight());
+  if (texture->GetPixels() && w > 0 && h > 0)
+  {
+    const unsigned char *pixels = texture->GetPixels() + y * texture->GetPitch() + x * 4;
+    ok = CPicture::CreateThumbnailFromSurface(pixels, w, h, texture->GetPitch(), file);
+  }
+  delete texture;
+  return ok;
+}
+
+void CVideoThumbStrip::Queue(const string &path, const boost::shared_ptr<CDVDThumbCodecCache>& codecCache)
+{
+  if (HasStrip(path))
+    return;
+  GetQueue().AddJob(new CThumbStripJob(path, codecCache));
+}
+
+CThumbStripJob::CThumbStripJob(const string &path, const boost::shared_ptr<CDVDThumbCodecCache>& codecCache)
+  : m_path(path)
+  , m_codecCache(codecCache)
+{
+}
+
+CThumbStripJob::~CThumbStripJob()
+{
+}
+
+bool CThumbStripJob::operator==(const CJob* job) const
+{
+  if (strcmp(job->GetType(), GetType()) != 0)
+    return false;
+  return ((const CThumbStripJob*)job)->m_path == m_path;
+}
+
+bool CThumbStripJob::DoWork()
+{
+  string url = CVideoThumbStrip::GetImageURL(m_path);
+  if (CTextureCache::Get().HasCachedImage(url))
+    return true;
+
+  CLog::Log(LOGDEBUG, "%s - extracting thumbnail strip of %s", __FUNCTION__, CURL::GetRedacted(m_path).c_str());
+
+  CTextureDetails details;
+  details.file = CTextureCache::GetCacheFile(url) + ".jpg";
+  if (!CDVDFileInfo::ExtractThumbStrip(m_path, details, m_codecCache.get(), this))
+    return false;
+
+  return CTextureCache::Get().AddCachedTexture(url, details);
+}
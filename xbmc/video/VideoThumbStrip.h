@@ -0,0 +1,122 @@
+#pragma once
+/*
+ *      Copyright (C) 2013 Team XBMC
+ *      http://xbmc.org
+ *
+ *  This Program is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  This Program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with XBMC; see the file COPYING.  If not, see
+ *  <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "guilib/Geometry.h"
+#include "utils/Job.h"
+
+class CDVDThumbCodecCache;
+
+/*!
+ \ingroup thumbs
+ \brief Strip of thumbnails of a video, for seek previews and chapters
+
+ The strip is a single image in the texture cache, a grid of tiles taken
+ from the key frames of the video. The first SEEK_TILES tiles are spread
+ evenly over the duration of the video, the remaining CHAPTER_TILES are the
+ starts of the first chapters. The layout depends on nothing but the
+ duration, so any tile can be found without reading the strip.
+
+ Tile positions are relative to the size of the image, it may be scaled
+ when cached.
+ */
+class CVideoThumbStrip
+{
+public:
+  static const int TILE_WIDTH    = 128;
+  static const int TILE_HEIGHT   = 72;
+  static const int COLUMNS       = 10;
+  static const int ROWS          = 10;
+  static const int CHAPTER_TILES = 20;
+  static const int SEEK_TILES    = COLUMNS * ROWS - CHAPTER_TILES;
+
+  /*!
+   \brief Texture cache URL of the strip of a video
+   */
+  static std::string GetImageURL(const std::string &path);
+
+  /*!
+   \brief Times of the frames of all tiles, in ms
+   \param duration duration of the video in ms
+   \param chapters start of each chapter in ms, -1 if unknown
+   \return a time for every tile of the strip, -1 for tiles without a frame
+   */
+  static std::vector<int> GetTileTimes(int duration, const std::vector<int> &chapters);
+
+  /*!
+   \brief Tile closest to a time of the video
+   */
+  static int GetSeekTile(int time, int duration);
+
+  /*!
+   \brief Tile of the start of a chapter, starting at 1, -1 if it has none
+   */
+  static int GetChapterTile(int chapter);
+
+  /*!
+   \brief Area of a tile in the strip, relative to its size
+   */
+  static CRect GetTileRect(int tile);
+
+  /*!
+   \brief Whether the strip of a video is in the texture cache
+   */
+  static bool HasStrip(const std::string &path);
+
+  /*!
+   \brief Write a tile of the cached strip of a video to an image file
+   \param path the video
+   \param tile the tile to write
+   \param file the image to write, the type is taken from the extension
+   \return true if the strip was cached and the image written
+   */
+  static bool SaveTile(const std::string &path, int tile, const std::string &file);
+
+  /*!
+   \brief Queue the extraction of the strip of a video, if it isn't cached yet
+   \param codecCache decoders to use, shared with other extractions
+   */
+  static void Queue(const std::string &path,
+                    const boost::shared_ptr<CDVDThumbCodecCache>& codecCache = boost::shared_ptr<CDVDThumbCodecCache>());
+};
+
+/*!
+ \ingroup thumbs,jobs
+ \brief Job extracting the thumbnail strip of a video into the texture cache
+ \sa CVideoThumbStrip
+ */
+class CThumbStripJob : public CJob
+{
+public:
+  CThumbStripJob(const std::string &path, const boost::shared_ptr<CDVDThumbCodecCache>& codecCache);
+  virtual ~CThumbStripJob();
+
+  virtual const char* GetType() const { return "thumbstrip"; }
+  virtual bool operator==(const CJob* job) const;
+  virtual bool DoWork();
+
+private:
+  std::string m_path;
+  boost::shared_ptr<CDVDThumbCodecCache> m_codecCache;
+};
@@ -21,6 +21,7 @@
 #include "system.h"
 #include "GUIDialogVideoBookmarks.h"
 #include "video/VideoDatabase.h"
+#include "video/VideoThumbStrip.h"
 #include "Application.h"
 #ifdef HAS_VIDEO_PLAYBACK
 #include "cores/VideoRenderers/RenderManager.h"
@@ -33,6 +34,7 @@
 #include "dialogs/GUIDialogKaiToast.h"
 #include "settings/AdvancedSettings.h"
 #include "FileItem.h"
+#include "filesystem/File.h"
 #include "guilib/Texture.h"
 #include "guilib/GUIWindowManager.h"
 #include "utils/Crc32.h"
@@ -49,6 +51,8 @@
 using namespace std;
 
 #define BOOKMARK_THUMB_WIDTH g_advancedSettings.GetThumbSize()
+// a tile of the thumb strip is only used for a bookmark this close to its frame, in ms
+#define BOOKMARK_TILE_TOLERANCE 1000
 
 #define CONTROL_ADD_BOOKMARK           2
 #define CONTROL_CLEAR_BOOKMARKS        3
@@ -156,7 +160,8 @@ bool CGUIDialogVideoBookmarks::OnAction(const CAction &action)
 
 void CGUIDialogVideoBookmarks::OnPopupMenu(int item)
 {
-  if (item < 0 || item >= m_vecItems->Size())
+  // chapters follow the bookmarks and can't be removed
+  if (item < 0 || item >= m_vecItems->Size() || item >= (int)m_bookmarks.size())
     return;
   
     // highlight the item
@@ -228,6 +233,27 @@ void CGUIDialogVideoBookmarks::OnRefreshList()
     item->SetArt("thumb", m_bookmarks[i].thumbNailImage);
     m_vecItems->Add(item);
   }
+
+  // chapters, once their thumbs have been extracted with the thumb strip
+  CStdString file = g_application.CurrentFile();
+  int chapters = g_application.m_pPlayer->GetChapterCount();
+  if (chapters > 1 && CVideoThumbStrip::HasStrip(file))
+  {
+    Crc32 crc;
+    crc.ComputeFromLowerCase(file);
+    for (int i = 1; i <= chapters && i <= CVideoThumbStrip::CHAPTER_TILES; ++i)
+    {
+      CStdString thumb = StringUtils::Format("%08x_chapter%i.jpg", (unsigned __int32) crc, i);
+      thumb = URIUtils::AddFileToFolder(CProfilesManager::Get().GetBookmarksThumbFolder(), thumb);
+      if (!XFILE::CFile::Exists(thumb) &&
+          !CVideoThumbStrip::SaveTile(file, CVideoThumbStrip::GetChapterTile(i), thumb))
+        thumb.clear();
+
+      CFileItemPtr item(new CFileItem(StringUtils::Format("%s %i", g_localizeStrings.Get(21396).c_str(), i)));
+      item->SetArt("thumb", thumb);
+      m_vecItems->Add(item);
+    }
+  }
   m_viewControl.SetItems(*m_vecItems);
 }
 
@@ -277,7 +303,12 @@ void CGUIDialogVideoBookmarks::Clear()
 
 void CGUIDialogVideoBookmarks::GotoBookmark(int item)
 {
-  if (item < 0 || item >= (int)m_bookmarks.size()) return;
+  if (item < 0 || item >= m_vecItems->Size()) return;
+  if (item >= (int)m_bookmarks.size())
+  {
+    g_application.m_pPlayer->SeekChapter(item - m_bookmarks.size() + 1);
+    return;
+  }
   if (g_application.m_pPlayer->HasPlayer())
   {
     g_application.m_pPlayer->SetPlayerState(m_bookmarks[item].playerState);
@@ -327,6 +358,21 @@ bool CGUIDialogVideoBookmarks::AddBookmark(CVideoInfoTag* tag)
     height = BOOKMARK_THUMB_WIDTH;
     width = (int)(BOOKMARK_THUMB_WIDTH * aspectRatio);
   }
+  Crc32 crc;
+  crc.ComputeFromLowerCase(g_application.CurrentFile());
+  CStdString thumbPath = StringUtils::Format("%08x_%i.jpg", (unsigned __int32) crc, (int)bookmark.timeInSeconds);
+  thumbPath = URIUtils::AddFileToFolder(CProfilesManager::Get().GetBookmarksThumbFolder(), thumbPath);
+
+  // capturing the screen waits on the renderer, a tile of the thumb strip is
+  // free but only shows the bookmarked frame when it was taken close to it
+  int time     = (int)(g_application.GetTime() * 1000);
+  int duration = (int)(g_application.GetTotalTime() * 1000);
+  int tile     = CVideoThumbStrip::GetSeekTile(time, duration);
+  std::vector<int> tileTimes = CVideoThumbStrip::GetTileTimes(duration, std::vector<int>());
+  if (tile >= 0 && abs(tileTimes[tile] - time) <= BOOKMARK_TILE_TOLERANCE &&
+      CVideoThumbStrip::SaveTile(g_application.CurrentFile(), tile, thumbPath))
+    bookmark.thumbNailImage = thumbPath;
+  else
   {
 #ifdef HAS_VIDEO_PLAYBACK
     CRenderCapture* thumbnail = g_renderManager.AllocRenderCapture();
@@ -337,10 +383,7 @@ bool CGUIDialogVideoBookmarks::AddBookmark(CVideoInfoTag* tag)
 
       if (thumbnail->GetUserState() == CAPTURESTATE_DONE)
       {
-        Crc32 crc;
-        crc.ComputeFromLowerCase(g_application.CurrentFile());
-        bookmark.thumbNailImage = StringUtils::Format("%08x_%i.jpg", (unsigned __int32) crc, (int)bookmark.timeInSeconds);
-        bookmark.thumbNailImage = URIUtils::AddFileToFolder(CProfilesManager::Get().GetBookmarksThumbFolder(), bookmark.thumbNailImage);
+        bookmark.thumbNailImage = thumbPath;
         if (!CPicture::CreateThumbnailFromSurface(thumbnail->GetPixels(), width, height, thumbnail->GetWidth() * 4,
                                             bookmark.thumbNailImage))
           bookmark.thumbNailImage.clear();